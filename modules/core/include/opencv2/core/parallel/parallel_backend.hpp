@@ -46,6 +46,9 @@ namespace cv { namespace parallel {
  * - change backend priority: `OPENCV_PARALLEL_PRIORITY_<backend>=9999`
  * - disable backend: `OPENCV_PARALLEL_PRIORITY_<backend>=0`
  * - specify list of backends with high priority (>100000): `OPENCV_PARALLEL_PRIORITY_LIST=TBB,OPENMP`. Unknown backends are registered as new plugins.
+ * - builtin work-stealing scheduler is used on request only: `OPENCV_PARALLEL_BACKEND=WORKSTEALING` or `setParallelForBackend("WORKSTEALING")`.
+ *   It executes nested `parallel_for_()` calls in parallel. Options: `OPENCV_PARALLEL_WORKSTEALING_AFFINITY=1` (pin workers to CPU cores, Linux),
+ *   `OPENCV_PARALLEL_WORKSTEALING_SPIN=<iterations>` (active wait of idle workers).
  *
  */
 
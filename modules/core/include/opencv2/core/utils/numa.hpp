@@ -0,0 +1,63 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#ifndef OPENCV_CORE_UTILS_NUMA_HPP
+#define OPENCV_CORE_UTILS_NUMA_HPP
+
+#include <opencv2/core.hpp>
+
+namespace cv { namespace utils { namespace numa {
+
+//! @addtogroup core_utils
+//! @{
+
+/** @brief Returns number of NUMA nodes of the system
+
+Topology is detected on Linux (sysfs). Returns 1 on other platforms or if topology information is not available.
+*/
+CV_EXPORTS int getNumberOfNodes();
+
+/** @brief Returns list of CPU cores of the NUMA node (empty list for unknown node) */
+CV_EXPORTS std::vector<int> getNodeCPUs(int node);
+
+/** @brief Returns NUMA node of the CPU core which runs the calling thread (0 if unknown) */
+CV_EXPORTS int getCurrentNode();
+
+/** @brief Restricts the calling thread to CPU cores of the NUMA node
+ *
+ * @returns false if operation is not supported or failed
+ */
+CV_EXPORTS bool bindCurrentThreadToNode(int node);
+
+/** @brief Enables NUMA-aware scheduling of the builtin (pthreads) parallel_for_() thread pool
+ *
+ * - worker threads are evenly distributed over NUMA nodes and restricted to CPU cores of their node;
+ * - each job range is split into contiguous per-node blocks with the same mapping for the same range,
+ *   so stripes are processed on the node which owns pages "first touched" by previous jobs.
+ *   Threads process stripes of own node first, then help other nodes.
+ *
+ * Has no effect on systems with a single NUMA node.
+ * Default value is controlled by `OPENCV_THREAD_POOL_NUMA` (disabled by default).
+ * Pinning of worker threads can be turned off via `OPENCV_THREAD_POOL_NUMA_PIN=0`.
+ */
+CV_EXPORTS void setThreadPoolNUMAAware(bool enable);
+
+/** @brief Returns true if NUMA-aware scheduling of the builtin thread pool is enabled (see setThreadPoolNUMAAware) */
+CV_EXPORTS bool isThreadPoolNUMAAware();
+
+/** @brief Returns Mat allocator which places data on the specified NUMA node
+ *
+ * Large buffers are allocated page-aligned with "preferred node" memory policy (Linux).
+ * Allocator falls back on regular allocation if NUMA memory policies are not supported.
+ * Allocator objects are owned by the library.
+ *
+ * Usage: `Mat::setDefaultAllocator(cv::utils::numa::getNodeAllocator(1));` or `mat.allocator = ...` before `create()`.
+ */
+CV_EXPORTS MatAllocator* getNodeAllocator(int node);
+
+//! @}
+
+}}} // namespace
+
+#endif // OPENCV_CORE_UTILS_NUMA_HPP
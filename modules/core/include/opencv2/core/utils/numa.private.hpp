@@ -0,0 +1,23 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#ifndef OPENCV_CORE_UTILS_NUMA_PRIVATE_HPP
+#define OPENCV_CORE_UTILS_NUMA_PRIVATE_HPP
+
+#include "numa.hpp"
+
+namespace cv { namespace utils { namespace numa {
+
+/** @brief Replaces the detected NUMA topology (tests only, Linux)
+ *
+ * @param nodeCPUs CPU cores of each node. Empty list restores the detected topology.
+ *
+ * Affects getNumberOfNodes(), getNodeCPUs(), getCurrentNode(), the NUMA-aware thread pool
+ * and node allocators. Must not be called while parallel_for_() or node allocators are in use.
+ */
+CV_EXPORTS void setTopologyForTesting(const std::vector< std::vector<int> >& nodeCPUs);
+
+}}} // namespace
+
+#endif // OPENCV_CORE_UTILS_NUMA_PRIVATE_HPP
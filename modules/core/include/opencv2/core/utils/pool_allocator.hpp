@@ -0,0 +1,66 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#ifndef OPENCV_CORE_UTILS_POOL_ALLOCATOR_HPP
+#define OPENCV_CORE_UTILS_POOL_ALLOCATOR_HPP
+
+#include <opencv2/core.hpp>
+#include <opencv2/core/bufferpool.hpp>
+#include <opencv2/core/utils/allocator_stats.hpp>
+
+namespace cv { namespace utils {
+
+//! @addtogroup core_utils
+//! @{
+
+/** @brief Returns Mat allocator which reuses released buffers
+
+Buffers are rounded up to size classes (4 classes per power of two) and kept in per-thread caches
+and in a shared pool after release, so steady-state loops (the same set of temporary Mat sizes per iteration)
+don't call the system allocator after warm-up.
+
+Pool is controlled through BufferPoolController interface: `getPoolMatAllocator()->getBufferPoolController()`.
+Released buffers of other threads are returned to the system on their next pool access after `freeAllReservedBuffers()`.
+
+Runtime configuration options:
+- `OPENCV_MAT_POOL_MAX_RESERVED_SIZE` - limit of reserved (unused) memory in bytes, default 256Mb
+- `OPENCV_MAT_POOL_THREAD_CACHE` - number of buffers per size class in thread-local caches, default 4
+- `OPENCV_MAT_POOL_ALLOCATOR=1` - use this allocator as default Mat allocator
+*/
+CV_EXPORTS MatAllocator* getPoolMatAllocator();
+
+/** @brief Returns statistics of system memory requests of the pool allocator
+
+Allocations counter is incremented on pool misses only, current usage includes used and reserved buffers.
+*/
+CV_EXPORTS AllocatorStatisticsInterface& getPoolMatAllocatorStatistics();
+
+/** @brief Replaces default Mat allocator until the end of the scope
+
+@code
+    {
+        cv::utils::MatAllocatorScope scope(cv::utils::getPoolMatAllocator());
+        processFrame(frame);  // temporary matrices reuse pooled buffers
+    }
+@endcode
+
+@note Default allocator is a process-wide setting, so avoid concurrent scopes in different threads.
+*/
+class CV_EXPORTS MatAllocatorScope
+{
+public:
+    explicit MatAllocatorScope(MatAllocator* allocator);
+    ~MatAllocatorScope();
+protected:
+    MatAllocator* prevAllocator_;
+private:
+    MatAllocatorScope(const MatAllocatorScope&); // disabled
+    MatAllocatorScope& operator=(const MatAllocatorScope&); // disabled
+};
+
+//! @}
+
+}} // namespace
+
+#endif // OPENCV_CORE_UTILS_POOL_ALLOCATOR_HPP
@@ -4,6 +4,8 @@
 
 #include "precomp.hpp"
 #include "bufferpool.impl.hpp"
+#include <opencv2/core/utils/configuration.private.hpp>
+#include <opencv2/core/utils/pool_allocator.hpp>
 
 namespace cv {
 
@@ -179,7 +181,8 @@ public:
 static
 MatAllocator*& getDefaultAllocatorMatRef()
 {
-    static MatAllocator* g_matAllocator = Mat::getStdAllocator();
+    static MatAllocator* g_matAllocator = utils::getConfigurationParameterBool("OPENCV_MAT_POOL_ALLOCATOR", false)
+            ? utils::getPoolMatAllocator() : Mat::getStdAllocator();
     return g_matAllocator;
 }
 
@@ -0,0 +1,329 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "precomp.hpp"
+
+#include <opencv2/core/utils/numa.private.hpp>
+#include <opencv2/core/utils/configuration.private.hpp>
+
+#include <opencv2/core/utils/logger.defines.hpp>
+#include <opencv2/core/utils/logger.hpp>
+
+#include <atomic>
+#include <fstream>
+
+#if defined(__linux__) && !defined(__ANDROID__) && defined(__GLIBC__)
+#define CV_HAVE_NUMA_LINUX 1
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+namespace cv { namespace utils { namespace numa {
+
+#ifdef CV_HAVE_NUMA_LINUX
+
+// parse string of form "0-1,3,5-7,10,13-15"
+static std::vector<int> parseCPUList(const std::string& str)
+{
+    std::vector<int> result;
+    size_t pos = 0;
+    while (pos < str.size())
+    {
+        size_t next = str.find(',', pos);
+        if (next == std::string::npos)
+            next = str.size();
+        std::string item = str.substr(pos, next - pos);
+        pos = next + 1;
+        int rstart = 0, rend = 0;
+        int n = sscanf(item.c_str(), "%d-%d", &rstart, &rend);
+        if (n == 1)
+            rend = rstart;
+        else if (n != 2)
+            continue;
+        for (int i = rstart; i <= rend; i++)
+            result.push_back(i);
+    }
+    return result;
+}
+
+static std::string readLine(const std::string& filename)
+{
+    std::ifstream ifs(filename.c_str());
+    std::string line;
+    if (!ifs.is_open() || !std::getline(ifs, line))
+        return std::string();
+    return line;
+}
+
+struct Topology
+{
+    std::vector< std::vector<int> > nodeCPUs;
+    std::vector<int> cpuNode;
+    std::vector<int> sysNodes;  // kernel node ids (nodes without CPUs are skipped)
+
+    Topology()
+    {
+        std::vector<int> nodes = parseCPUList(readLine("/sys/devices/system/node/online"));
+        for (size_t i = 0; i < nodes.size(); i++)
+        {
+            std::vector<int> cpus = parseCPUList(readLine(cv::format("/sys/devices/system/node/node%d/cpulist", nodes[i])));
+            if (cpus.empty())
+                continue;  // memory-only node
+            int node = (int)nodeCPUs.size();
+            for (size_t j = 0; j < cpus.size(); j++)
+            {
+                if (cpus[j] >= (int)cpuNode.size())
+                    cpuNode.resize(cpus[j] + 1, 0);
+                cpuNode[cpus[j]] = node;
+            }
+            nodeCPUs.push_back(cpus);
+            sysNodes.push_back(nodes[i]);
+        }
+        if (nodeCPUs.size() > 1)
+        {
+            CV_LOG_INFO(NULL, "NUMA: detected " << nodeCPUs.size() << " nodes");
+        }
+    }
+
+    explicit Topology(const std::vector< std::vector<int> >& nodeCPUs_)
+        : nodeCPUs(nodeCPUs_)
+    {
+        for (size_t node = 0; node < nodeCPUs.size(); node++)
+        {
+            for (size_t j = 0; j < nodeCPUs[node].size(); j++)
+            {
+                const int cpu = nodeCPUs[node][j];
+                if (cpu >= (int)cpuNode.size())
+                    cpuNode.resize(cpu + 1, 0);
+                cpuNode[cpu] = (int)node;
+            }
+            sysNodes.push_back((int)node);
+        }
+    }
+};
+
+static std::atomic<const Topology*>& topologyOverride()
+{
+    static std::atomic<const Topology*> g_override(NULL);
+    return g_override;
+}
+
+static const Topology& getTopology()
+{
+    const Topology* topology = topologyOverride().load();
+    if (topology)
+        return *topology;
+    static Topology g_topology;
+    return g_topology;
+}
+
+#endif  // CV_HAVE_NUMA_LINUX
+
+void setTopologyForTesting(const std::vector< std::vector<int> >& nodeCPUs)
+{
+#ifdef CV_HAVE_NUMA_LINUX
+    static std::vector<Topology*> g_overrides;  // not released: readers may still hold a reference
+    cv::AutoLock lock(cv::getInitializationMutex());
+    const Topology* topology = NULL;
+    if (!nodeCPUs.empty())
+    {
+        g_overrides.push_back(new Topology(nodeCPUs));
+        topology = g_overrides.back();
+    }
+    topologyOverride() = topology;
+#else
+    CV_UNUSED(nodeCPUs);
+#endif
+}
+
+int getNumberOfNodes()
+{
+#ifdef CV_HAVE_NUMA_LINUX
+    return std::max(1, (int)getTopology().nodeCPUs.size());
+#else
+    return 1;
+#endif
+}
+
+std::vector<int> getNodeCPUs(int node)
+{
+#ifdef CV_HAVE_NUMA_LINUX
+    const Topology& topology = getTopology();
+    if (node >= 0 && node < (int)topology.nodeCPUs.size())
+        return topology.nodeCPUs[node];
+#else
+    CV_UNUSED(node);
+#endif
+    return std::vector<int>();
+}
+
+int getCurrentNode()
+{
+#ifdef CV_HAVE_NUMA_LINUX
+    const Topology& topology = getTopology();
+    int cpu = sched_getcpu();
+    if (cpu >= 0 && cpu < (int)topology.cpuNode.size())
+        return topology.cpuNode[cpu];
+#endif
+    return 0;
+}
+
+bool bindCurrentThreadToNode(int node)
+{
+#ifdef CV_HAVE_NUMA_LINUX
+    std::vector<int> cpus = getNodeCPUs(node);
+    if (cpus.empty())
+        return false;
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    for (size_t i = 0; i < cpus.size(); i++)
+    {
+        if (cpus[i] < CPU_SETSIZE)
+            CPU_SET(cpus[i], &cpuset);
+    }
+    int res = pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset);
+    if (res != 0)
+    {
+        CV_LOG_DEBUG(NULL, "NUMA: can't bind thread to node " << node << ": res = " << res);
+        return false;
+    }
+    return true;
+#else
+    CV_UNUSED(node);
+    return false;
+#endif
+}
+
+static std::atomic<bool>& threadPoolNUMAAwareFlag()
+{
+    static std::atomic<bool> g_flag(utils::getConfigurationParameterBool("OPENCV_THREAD_POOL_NUMA", false));
+    return g_flag;
+}
+
+void setThreadPoolNUMAAware(bool enable)
+{
+    threadPoolNUMAAwareFlag() = enable;
+}
+
+bool isThreadPoolNUMAAware()
+{
+    return threadPoolNUMAAwareFlag().load();
+}
+
+
+class NodeMatAllocator CV_FINAL : public MatAllocator
+{
+public:
+    explicit NodeMatAllocator(int node_) : node(node_) {}
+
+    UMatData* allocate(int dims, const int* sizes, int type,
+                       void* data0, size_t* step, AccessFlag /*flags*/, UMatUsageFlags /*usageFlags*/) const CV_OVERRIDE
+    {
+        size_t total = CV_ELEM_SIZE(type);
+        for( int i = dims-1; i >= 0; i-- )
+        {
+            if( step )
+            {
+                if( data0 && step[i] != CV_AUTOSTEP )
+                {
+                    CV_Assert(total <= step[i]);
+                    total = step[i];
+                }
+                else
+                    step[i] = total;
+            }
+            total *= sizes[i];
+        }
+        int allocatorFlags = 0;
+        uchar* data = data0 ? (uchar*)data0 : allocateOnNode(total, allocatorFlags);
+        UMatData* u = new UMatData(this);
+        u->data = u->origdata = data;
+        u->size = total;
+        u->allocatorFlags_ = allocatorFlags;
+        if(data0)
+            u->flags |= UMatData::USER_ALLOCATED;
+
+        return u;
+    }
+
+    bool allocate(UMatData* u, AccessFlag /*accessFlags*/, UMatUsageFlags /*usageFlags*/) const CV_OVERRIDE
+    {
+        if(!u) return false;
+        return true;
+    }
+
+    void deallocate(UMatData* u) const CV_OVERRIDE
+    {
+        if(!u)
+            return;
+
+        CV_Assert(u->urefcount == 0);
+        CV_Assert(u->refcount == 0);
+        if( !(u->flags & UMatData::USER_ALLOCATED) )
+        {
+#ifdef CV_HAVE_NUMA_LINUX
+            if (u->allocatorFlags_ & ALLOCATED_PAGES)
+                munmap(u->origdata, alignSize(u->size, (int)sysconf(_SC_PAGESIZE)));
+            else
+#endif
+                fastFree(u->origdata);
+            u->origdata = 0;
+        }
+        delete u;
+    }
+
+protected:
+    enum { ALLOCATED_PAGES = 1 };
+
+    uchar* allocateOnNode(size_t size, int& allocatorFlags) const
+    {
+#ifdef CV_HAVE_NUMA_LINUX
+        const Topology& topology = getTopology();
+        static const size_t minSize = utils::getConfigurationParameterSizeT("OPENCV_NUMA_ALLOCATOR_MIN_SIZE", 64 << 10);
+        if (topology.nodeCPUs.size() > 1 && size >= minSize && node < (int)topology.sysNodes.size())
+        {
+            // own mapping: the node policy must not stick to pages which malloc() would reuse later
+            // (buffers below its mmap threshold come from the shared arenas), and no page is touched before mbind()
+            const size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+            size_t alignedSize = alignSize(size, (int)pageSize);
+            void* ptr = mmap(NULL, alignedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (ptr == MAP_FAILED)
+                CV_Error_(Error::StsNoMem, ("Failed to allocate %llu bytes", (unsigned long long)size));
+            const int sysNode = topology.sysNodes[node];
+            unsigned long mask[16] = { 0 };
+            const unsigned long maskBits = sizeof(mask) * 8;
+            if ((unsigned long)sysNode < maskBits)
+            {
+                const int MPOL_PREFERRED_ = 1;  // <numaif.h>, libnuma is not required
+                mask[sysNode / (sizeof(unsigned long) * 8)] |= 1ul << (sysNode % (sizeof(unsigned long) * 8));
+                long res = syscall(SYS_mbind, ptr, alignedSize, MPOL_PREFERRED_, mask, maskBits + 1, 0);
+                if (res != 0)
+                {
+                    CV_LOG_ONCE_DEBUG(NULL, "NUMA: mbind() failed, errno = " << errno);
+                }
+            }
+            allocatorFlags |= ALLOCATED_PAGES;
+            return (uchar*)ptr;
+        }
+#endif
+        return (uchar*)fastMalloc(size);
+    }
+
+    int node;
+};
+
+MatAllocator* getNodeAllocator(int node)
+{
+    CV_Assert(node >= 0 && node < getNumberOfNodes());
+    static std::vector<MatAllocator*> g_allocators;  // not released: buffers may outlive static objects
+    cv::AutoLock lock(cv::getInitializationMutex());
+    while ((int)g_allocators.size() <= node)
+        g_allocators.push_back(new NodeMatAllocator((int)g_allocators.size()));
+    return g_allocators[node];
+}
+
+}}}  // namespace
@@ -513,6 +513,16 @@ void parallel_for_(const cv::Range& range, const cv::ParallelLoopBody& body, dou
     if (range.empty())
         return;
 
+    {
+        std::shared_ptr<cv::parallel::ParallelForAPI>& api = cv::parallel::getCurrentParallelForAPI();
+        if (api && dynamic_cast<cv::parallel::ParallelForNestedAPI*>(api.get()))
+        {
+            // backend handles nested and concurrent regions by itself
+            parallel_for_impl(range, body, nstripes);
+            return;
+        }
+    }
+
     static std::atomic<bool> flagNestedParallelFor(false);
     bool isNotNestedRegion = !flagNestedParallelFor.load();
     if (isNotNestedRegion)
@@ -12,6 +12,14 @@ extern int numThreads;
 
 std::shared_ptr<ParallelForAPI>& getCurrentParallelForAPI();
 
+/** @brief Base class of builtin backends which are able to execute nested parallel_for() regions
+ *
+ * parallel_for_() doesn't serialize nested calls if the current backend is derived from this class.
+ */
+class ParallelForNestedAPI : public ParallelForAPI
+{
+};
+
 #ifndef BUILD_PLUGIN
 
 #ifdef HAVE_TBB
@@ -22,6 +30,10 @@ std::shared_ptr<cv::parallel::ParallelForAPI> createParallelBackendTBB();
 std::shared_ptr<cv::parallel::ParallelForAPI> createParallelBackendOpenMP();
 #endif
 
+#ifndef OPENCV_DISABLE_THREAD_SUPPORT
+std::shared_ptr<cv::parallel::ParallelForAPI> createParallelBackendWorkStealing();
+#endif
+
 #endif  // BUILD_PLUGIN
 
 }}  // namespace
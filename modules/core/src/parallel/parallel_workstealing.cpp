@@ -0,0 +1,437 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+#include "../precomp.hpp"
+
+#ifndef OPENCV_DISABLE_THREAD_SUPPORT
+
+#include "parallel.hpp"
+#include "../parallel_impl.hpp"  // defaultNumberOfThreads()
+
+#include <opencv2/core/utils/configuration.private.hpp>
+#include <opencv2/core/utils/logger.defines.hpp>
+#include <opencv2/core/utils/logger.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#if defined(__linux__) && defined(__GLIBC__)
+#include <pthread.h>
+#include <sched.h>
+#define CV_WORKSTEALING_HAVE_AFFINITY 1
+#endif
+
+/*
+ Work-stealing scheduler for parallel_for_().
+
+ Each worker owns a deque of stripe ranges. The owner takes ranges from the back (LIFO: recently split,
+ cache-hot work), idle threads steal from the front (FIFO: the largest remaining ranges).
+ Ranges are split lazily: before processing a range the executing thread repeatedly pushes the upper half
+ back into its own deque, so idle workers always find something to steal and uneven stripes are balanced.
+
+ Threads which wait for completion of a parallel_for() call (the caller thread, or a worker which has entered
+ a nested region) keep executing queued tasks instead of blocking, so nested regions are processed in parallel
+ without deadlocks.
+
+ Affinity hints:
+ - top-level calls distribute contiguous chunks of stripes over all workers in the same order every time,
+   so the same data tends to be processed by the same core in consecutive calls;
+ - nested calls are queued in the deque of the current worker (processed locally unless stolen);
+ - OPENCV_PARALLEL_WORKSTEALING_AFFINITY=1 pins workers to CPU cores (Linux only).
+
+ setNumThreads() restarts the pool. The workers and queues are released only when there are no top-level
+ parallel_for() calls in flight: the pool waits for them, or postpones the restart to the end of the last one
+ if it is called from a parallel region.
+*/
+
+namespace cv { namespace parallel { namespace workstealing {
+
+static int getSpinCount()
+{
+    static int spin = (int)utils::getConfigurationParameterSizeT("OPENCV_PARALLEL_WORKSTEALING_SPIN", 2000);  // iterations
+    return spin;
+}
+
+static bool useThreadAffinity()
+{
+    static bool affinity = utils::getConfigurationParameterBool("OPENCV_PARALLEL_WORKSTEALING_AFFINITY", false);
+    return affinity;
+}
+
+struct Job
+{
+    ParallelForAPI::FN_parallel_for_body_cb_t body;
+    void* data;
+    int grain;  // don't split ranges below this number of stripes
+    std::atomic<int> pending;  // number of unprocessed stripes
+
+    Job(ParallelForAPI::FN_parallel_for_body_cb_t body_, void* data_, int tasks, int grain_)
+        : body(body_), data(data_), grain(grain_), pending(tasks)
+    {}
+};
+
+struct Task
+{
+    Job* job;
+    int begin;
+    int end;
+};
+
+class TaskQueue
+{
+public:
+    void push(const Task& task)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(task);
+    }
+
+    bool pop(Task& task)  // owner side
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (tasks.empty())
+            return false;
+        task = tasks.back();
+        tasks.pop_back();
+        return true;
+    }
+
+    bool steal(Task& task)  // thief side
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (tasks.empty())
+            return false;
+        task = tasks.front();
+        tasks.pop_front();
+        return true;
+    }
+
+private:
+    std::mutex mutex;
+    std::deque<Task> tasks;
+    char padding[64];  // avoid false sharing between queues of different workers (cache line size)
+};
+
+class ParallelForBackend;
+
+struct WorkerContext
+{
+    const ParallelForBackend* pool;
+    int slot;
+    unsigned rng;
+};
+
+static thread_local WorkerContext g_context = { NULL, 0, 0 };
+static thread_local int g_externalDepth = 0;  // top-level parallel_for() calls in progress on this external thread
+
+class ParallelForBackend : public ParallelForNestedAPI
+{
+public:
+    ParallelForBackend()
+        : numThreads((int)defaultNumberOfThreads()), started(false), activeJobs(0), restartPending(false),
+          stopping(false), queuedTasks(0), sleepingWorkers(0)
+    {}
+
+    virtual ~ParallelForBackend()
+    {
+        stop();
+    }
+
+    virtual void parallel_for(int tasks, FN_parallel_for_body_cb_t body_callback, void* callback_data) CV_OVERRIDE
+    {
+        if (tasks <= 0)
+            return;
+        if (tasks == 1 || numThreads.load() <= 1)
+        {
+            body_callback(0, tasks, callback_data);
+            return;
+        }
+        const bool nested = g_context.pool == this;
+        if (!nested)
+            beginJob();  // workers and queues stay alive until endJob()
+
+        const int nqueues = (int)queues.size();
+        Job job(body_callback, callback_data, tasks, std::max(1, tasks / (nqueues * 16)));
+
+        int slot = 0;
+        if (nested)
+        {
+            // nested region: keep work close to the current worker, let others steal it
+            slot = g_context.slot;
+            push(slot, Task{ &job, 0, tasks });
+            wakeup(false);
+        }
+        else
+        {
+            // top-level region: static initial distribution, so consecutive calls have similar data placement
+            int nchunks = std::min(tasks, nqueues);
+            for (int i = 0; i < nchunks; i++)
+            {
+                int begin = (int)((int64)tasks * i / nchunks);
+                int end = (int)((int64)tasks * (i + 1) / nchunks);
+                push(i, Task{ &job, begin, end });
+            }
+            wakeup(true);
+        }
+
+        // participate in processing until all stripes of this job are done
+        int spin = 0;
+        while (job.pending.load(std::memory_order_acquire) > 0)
+        {
+            Task task;
+            if (findTask(slot, task))
+            {
+                execute(slot, task);
+                spin = 0;
+            }
+            else if (++spin > 16)
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        if (!nested)
+            endJob();
+    }
+
+    // External (non-worker) threads share queue #0 and all of them get 0, so the result is not unique
+    // if several threads call parallel_for() at the same time.
+    virtual int getThreadNum() const CV_OVERRIDE
+    {
+        return g_context.pool == this ? g_context.slot : 0;
+    }
+
+    virtual int getNumThreads() const CV_OVERRIDE
+    {
+        return std::max(numThreads.load(), 1);
+    }
+
+    virtual int setNumThreads(int nThreads) CV_OVERRIDE
+    {
+        nThreads = nThreads < 0 ? (int)defaultNumberOfThreads() : nThreads;
+        int oldNumThreads = numThreads.exchange(nThreads);
+        if (nThreads != oldNumThreads)
+            stop();  // workers are restarted on the next parallel_for() call
+        return oldNumThreads;
+    }
+
+    virtual const char* getName() const CV_OVERRIDE
+    {
+        return "workstealing";
+    }
+
+protected:
+    void beginJob()
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        if (!started.load(std::memory_order_relaxed))
+            start_();
+        activeJobs++;
+        g_externalDepth++;
+    }
+
+    void endJob()
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        g_externalDepth--;
+        if (--activeJobs > 0)
+            return;
+        if (restartPending)
+            stop_();  // setNumThreads() has been called from a parallel region
+        idleCond.notify_all();
+    }
+
+    // poolMutex is locked by the caller
+    void start_()
+    {
+        const int nthreads = std::max(numThreads.load(), 1);
+        CV_LOG_DEBUG(NULL, "core(parallel): starting work-stealing pool: threads=" << nthreads);
+        // queue #0 is shared by external (non-worker) threads
+        queues.clear();
+        for (int i = 0; i < nthreads; i++)
+            queues.push_back(makePtr<TaskQueue>());
+        stopping = false;
+        for (int i = 1; i < nthreads; i++)
+            workers.push_back(std::thread(&ParallelForBackend::workerLoop, this, i));
+        started.store(true, std::memory_order_release);
+    }
+
+    // waits for parallel_for() calls in flight, they use the workers and the queues
+    void stop()
+    {
+        std::unique_lock<std::mutex> lock(poolMutex);
+        if (g_context.pool == this || g_externalDepth > 0)
+        {
+            // called from a parallel region: the current job would never finish
+            if (activeJobs > 0)
+            {
+                restartPending = true;
+                return;
+            }
+        }
+        idleCond.wait(lock, [&] { return activeJobs == 0; });
+        stop_();
+    }
+
+    // poolMutex is locked by the caller, there are no active jobs
+    void stop_()
+    {
+        restartPending = false;
+        if (!started.load(std::memory_order_relaxed))
+            return;
+        {
+            std::lock_guard<std::mutex> sleepLock(sleepMutex);
+            stopping = true;
+        }
+        sleepCond.notify_all();
+        for (size_t i = 0; i < workers.size(); i++)
+            workers[i].join();
+        workers.clear();
+        queues.clear();
+        started.store(false, std::memory_order_release);
+    }
+
+    void workerLoop(int slot)
+    {
+        g_context.pool = this;
+        g_context.slot = slot;
+        g_context.rng = (unsigned)slot * 0x9E3779B9u + 1;
+#ifdef CV_WORKSTEALING_HAVE_AFFINITY
+        if (useThreadAffinity())
+        {
+            cpu_set_t cpuset;
+            CPU_ZERO(&cpuset);
+            CPU_SET(slot % std::max(1, getNumberOfCPUs()), &cpuset);
+            if (pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset) != 0)
+            {
+                CV_LOG_DEBUG(NULL, "core(parallel): can't set affinity of work-stealing worker " << slot);
+            }
+        }
+#endif
+        const int spinCount = getSpinCount();
+        for (;;)
+        {
+            Task task;
+            if (findTask(slot, task))
+            {
+                execute(slot, task);
+                continue;
+            }
+            bool found = false;
+            for (int spin = 0; spin < spinCount && !found; spin++)
+            {
+                if (queuedTasks.load() > 0)
+                    found = true;
+                else if (spin >= 16)
+                    std::this_thread::yield();
+            }
+            if (found)
+                continue;
+
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            sleepingWorkers++;
+            sleepCond.wait(lock, [&] { return stopping || queuedTasks.load() > 0; });
+            sleepingWorkers--;
+            if (stopping)
+                break;
+        }
+        g_context.pool = NULL;
+        g_context.slot = 0;
+    }
+
+    void push(int slot, const Task& task)
+    {
+        queues[slot]->push(task);
+        queuedTasks++;
+    }
+
+    void wakeup(bool all)
+    {
+        if (sleepingWorkers.load() == 0)
+            return;
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        if (all)
+            sleepCond.notify_all();
+        else
+            sleepCond.notify_one();
+    }
+
+    bool findTask(int slot, Task& task)
+    {
+        if (queuedTasks.load(std::memory_order_relaxed) <= 0)
+            return false;
+        if (!queues[slot]->pop(task))
+        {
+            // steal: start from a random victim to avoid contention on the same queue
+            const int nqueues = (int)queues.size();
+            unsigned& rng = g_context.pool == this ? g_context.rng : externalRng;
+            rng = rng * 1664525u + 1013904223u;
+            int victim = (int)((rng >> 8) % (unsigned)nqueues);
+            bool found = false;
+            for (int i = 0; i < nqueues && !found; i++, victim = (victim + 1 == nqueues) ? 0 : victim + 1)
+            {
+                if (victim != slot)
+                    found = queues[victim]->steal(task);
+            }
+            if (!found)
+                return false;
+        }
+        queuedTasks--;
+        return true;
+    }
+
+    void execute(int slot, Task task)
+    {
+        Job& job = *task.job;
+        while (task.end - task.begin > job.grain)
+        {
+            // keep the lower half, expose the upper half to thieves
+            int mid = task.begin + (task.end - task.begin) / 2;
+            push(slot, Task{ &job, mid, task.end });
+            wakeup(false);
+            task.end = mid;
+        }
+        job.body(task.begin, task.end, job.data);
+        job.pending.fetch_sub(task.end - task.begin, std::memory_order_acq_rel);
+    }
+
+    std::atomic<int> numThreads;
+    std::atomic<bool> started;
+    std::mutex poolMutex;
+    std::condition_variable idleCond;  // activeJobs dropped to 0
+    int activeJobs;  // top-level parallel_for() calls in flight, guarded by poolMutex
+    bool restartPending;  // stop() is postponed to the end of the last active job
+    std::vector< Ptr<TaskQueue> > queues;  // [0] - external threads, [1..numThreads) - workers
+    std::vector<std::thread> workers;
+
+    std::mutex sleepMutex;
+    std::condition_variable sleepCond;
+    bool stopping;
+    std::atomic<int> queuedTasks;
+    std::atomic<int> sleepingWorkers;
+
+    static thread_local unsigned externalRng;
+};
+
+thread_local unsigned ParallelForBackend::externalRng = 1;
+
+}  // namespace workstealing
+
+static
+std::shared_ptr<workstealing::ParallelForBackend>& getInstance()
+{
+    static std::shared_ptr<workstealing::ParallelForBackend> g_instance = std::make_shared<workstealing::ParallelForBackend>();
+    return g_instance;
+}
+
+std::shared_ptr<cv::parallel::ParallelForAPI> createParallelBackendWorkStealing()
+{
+    return getInstance();
+}
+
+}}  // namespace
+
+#endif  // OPENCV_DISABLE_THREAD_SUPPORT
@@ -14,6 +14,7 @@ struct ParallelBackendInfo
     int priority;     // 1000-<index*10> - default builtin priority
                       // 0 - disabled (OPENCV_PARALLEL_PRIORITY_<name> = 0)
                       // >10000 - prioritized list (OPENCV_PARALLEL_PRIORITY_LIST)
+                      // <0 - used on request only (selected by name)
     std::string name;
     std::shared_ptr<IParallelBackendFactory> backendFactory;
 };
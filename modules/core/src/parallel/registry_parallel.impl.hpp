@@ -24,6 +24,12 @@ ParallelBackendInfo { \
     1000, name, std::make_shared<cv::parallel::StaticBackendFactory>([=] () -> std::shared_ptr<cv::parallel::ParallelForAPI> { return createBackendAPI(); }) \
 },
 
+// backend is not selected automatically: use OPENCV_PARALLEL_BACKEND, setParallelForBackend(name) or OPENCV_PARALLEL_PRIORITY_*
+#define DECLARE_STATIC_BACKEND_ON_REQUEST(name, createBackendAPI) \
+ParallelBackendInfo { \
+    -1, name, std::make_shared<cv::parallel::StaticBackendFactory>([=] () -> std::shared_ptr<cv::parallel::ParallelForAPI> { return createBackendAPI(); }) \
+},
+
 static
 std::vector<ParallelBackendInfo>& getBuiltinParallelBackendsInfo()
 {
@@ -41,6 +47,10 @@ std::vector<ParallelBackendInfo>& getBuiltinParallelBackendsInfo()
 #elif defined(PARALLEL_ENABLE_PLUGINS)
         DECLARE_DYNAMIC_BACKEND("OPENMP")  // TODO Intel OpenMP?
 #endif
+
+#ifndef OPENCV_DISABLE_THREAD_SUPPORT
+        DECLARE_STATIC_BACKEND_ON_REQUEST("WORKSTEALING", createParallelBackendWorkStealing)
+#endif
     };
     return g_backends;
 }
@@ -64,7 +74,8 @@ protected:
         for (int i = 0; i < N; i++)
         {
             ParallelBackendInfo& info = enabledBackends[i];
-            info.priority = 1000 - i * 10;
+            if (info.priority >= 0)
+                info.priority = 1000 - i * 10;
         }
         CV_LOG_DEBUG(NULL, "core(parallel): Builtin backends(" << N << "): " << dumpBackends());
         if (readPrioritySettings())
@@ -78,6 +89,16 @@ protected:
             ParallelBackendInfo& info = enabledBackends[enabled];
             if (enabled != i)
                 info = enabledBackends[i];
+            if (info.priority < 0)
+            {
+                // on-request backend: keep it available for explicit selection by name
+                size_t param_priority = utils::getConfigurationParameterSizeT(cv::format("OPENCV_PARALLEL_PRIORITY_%s", info.name.c_str()).c_str(), 0);
+                CV_Assert(param_priority == (size_t)(int)param_priority); // overflow check
+                if (param_priority > 0)
+                    info.priority = (int)param_priority;
+                enabled++;
+                continue;
+            }
             size_t param_priority = utils::getConfigurationParameterSizeT(cv::format("OPENCV_PARALLEL_PRIORITY_%s", info.name.c_str()).c_str(), (size_t)info.priority);
             CV_Assert(param_priority == (size_t)(int)param_priority); // overflow check
             if (param_priority > 0)
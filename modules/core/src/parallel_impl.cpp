@@ -10,6 +10,7 @@
 #include <pthread.h>
 
 #include <opencv2/core/utils/configuration.private.hpp>
+#include <opencv2/core/utils/numa.hpp>
 
 #include <opencv2/core/utils/logger.defines.hpp>
 //#undef CV_LOG_STRIP_LEVEL
@@ -79,6 +80,9 @@ static int CV_MAIN_THREAD_ACTIVE_WAIT = (int)utils::getConfigurationParameterSiz
 
 static int CV_WORKER_ACTIVE_WAIT_THREADS_LIMIT = (int)utils::getConfigurationParameterSizeT("OPENCV_THREAD_POOL_ACTIVE_WAIT_THREADS_LIMIT", 0); // number of real cores
 
+// NUMA-aware mode is controlled by OPENCV_THREAD_POOL_NUMA / utils::numa::setThreadPoolNUMAAware()
+static bool CV_THREAD_POOL_NUMA_PIN = utils::getConfigurationParameterBool("OPENCV_THREAD_POOL_NUMA_PIN", true);  // restrict workers to CPUs of their node
+
 class WorkerThread;
 class ParallelJob;
 
@@ -118,6 +122,14 @@ public:
 
     unsigned num_threads;
 
+    // NUMA-aware mode: number of nodes used for placement of worker threads (0 - disabled)
+    int numa_nodes;
+    unsigned numa_threads;  // value of num_threads used for placement of worker threads
+    int getThreadNode(unsigned thread_index) const  // 0 - main thread, 1..N - worker threads
+    {
+        return (int)((uint64)thread_index * numa_nodes / std::max(num_threads, 1u));
+    }
+
     pthread_mutex_t mutex;  // guards fields (job/threads) from non-worker threads (concurrent parallel_for calls)
 #if defined(CV_USE_GLOBAL_WORKERS_COND_VAR)
     pthread_cond_t cond_thread_wake;
@@ -204,6 +216,8 @@ public:
 
     std::atomic<bool> has_wake_signal;
 
+    int numa_node;  // -1 if NUMA-aware mode is disabled
+
     Ptr<ParallelJob> job;
 
     pthread_mutex_t mutex;
@@ -218,7 +232,8 @@ public:
         posix_thread(0),
         is_created(false),
         stop_thread(false),
-        has_wake_signal(false)
+        has_wake_signal(false),
+        numa_node(thread_pool_.numa_nodes > 0 ? thread_pool_.getThreadNode(id_ + 1) : -1)
 #if !defined(CV_USE_GLOBAL_WORKERS_COND_VAR)
         , isActive(true)
 #endif
@@ -292,6 +307,7 @@ public:
         body(body_),
         range(range_),
         nstripes((unsigned)nstripes_),
+        numa_nodes(std::min(thread_pool_.numa_nodes, range_.size())),
         is_completed(false)
     {
         CV_LOG_VERBOSE(NULL, 5, "ParallelJob::ParallelJob(" << (void*)this << ")");
@@ -299,6 +315,18 @@ public:
         active_thread_count.store(0, std::memory_order_relaxed);
         completed_thread_count.store(0, std::memory_order_relaxed);
         dummy0_[0] = 0, dummy1_[0] = 0, dummy2_[0] = 0; // compiler warning
+        if (numa_nodes > 1)
+        {
+            // contiguous per-node blocks: the same range is always mapped on nodes in the same way,
+            // so stripes are processed on the node which has touched their data first
+            node_task.reset(new std::atomic<int>[numa_nodes]);
+            for (int k = 0; k < numa_nodes; k++)
+                node_task[k].store((int)((int64)range.size() * k / numa_nodes), std::memory_order_relaxed);
+        }
+        else
+        {
+            numa_nodes = 0;
+        }
     }
 
     ~ParallelJob()
@@ -306,19 +334,39 @@ public:
         CV_LOG_VERBOSE(NULL, 5, "ParallelJob::~ParallelJob(" << (void*)this << ")");
     }
 
-    unsigned execute(bool is_worker_thread)
+    unsigned execute(bool is_worker_thread, int node = 0)
     {
-        unsigned executed_tasks = 0;
         const int task_count = range.size();
         const int remaining_multiplier = std::min(nstripes,
                 std::max(
                         std::min(100u, thread_pool.num_threads * 4),
                         thread_pool.num_threads * 2
                 ));  // experimental value
+        if (numa_nodes > 0)
+        {
+            // own node first, then help other nodes
+            unsigned executed_tasks = 0;
+            const int node_multiplier = std::max(1, remaining_multiplier / numa_nodes);
+            node = std::max(0, node) % numa_nodes;
+            for (int k = 0; k < numa_nodes; k++)
+            {
+                int n = (node + k) % numa_nodes;
+                int block_end = (int)((int64)task_count * (n + 1) / numa_nodes);
+                executed_tasks += execute(node_task[n], block_end, node_multiplier, is_worker_thread);
+            }
+            current_task.store(task_count);  // all tasks are distributed
+            return executed_tasks;
+        }
+        return execute(current_task, task_count, remaining_multiplier, is_worker_thread);
+    }
+
+    unsigned execute(std::atomic<int>& next_task, const int task_count, const int remaining_multiplier, bool is_worker_thread)
+    {
+        unsigned executed_tasks = 0;
         for (;;)
         {
-            int chunk_size = std::max(1, (task_count - current_task) / remaining_multiplier);
-            int id = current_task.fetch_add(chunk_size, std::memory_order_seq_cst);
+            int chunk_size = std::max(1, (task_count - next_task) / remaining_multiplier);
+            int id = next_task.fetch_add(chunk_size, std::memory_order_seq_cst);
             if (id >= task_count)
                 break; // no more free tasks
 
@@ -345,6 +393,9 @@ public:
     const Range range;
     const unsigned nstripes;
 
+    int numa_nodes;  // 0 - NUMA-aware mode is disabled
+    std::unique_ptr< std::atomic<int>[] > node_task;  // next free task of each node block
+
     std::atomic<int> current_task;  // next free part of job
     int64 dummy0_[8];  // avoid cache-line reusing for the same atomics
 
@@ -374,6 +425,13 @@ void WorkerThread::thread_body()
 {
     (void)cv::utils::getThreadID(); // notify OpenCV about new thread
     CV_LOG_VERBOSE(NULL, 5, "Thread: new thread: " << id);
+    if (numa_node >= 0 && CV_THREAD_POOL_NUMA_PIN)
+    {
+        if (!utils::numa::bindCurrentThreadToNode(numa_node))
+        {
+            CV_LOG_DEBUG(NULL, "Thread: can't bind thread " << id << " to NUMA node " << numa_node);
+        }
+    }
 
     bool allow_active_wait = true;
 
@@ -436,10 +494,10 @@ void WorkerThread::thread_body()
                     CV_LOG_VERBOSE(NULL, 5, "Thread: processing new job (with " << other << " other threads)"); CV_UNUSED(other);
 #ifdef CV_PROFILE_THREADS
                     stat.threadExecuteStart = getTickCount();
-                    stat.executedTasks = j->execute(true);
+                    stat.executedTasks = j->execute(true, numa_node);
                     stat.threadExecuteStop = getTickCount();
 #else
-                    j->execute(true);
+                    j->execute(true, numa_node);
 #endif
                     int completed = j->completed_thread_count.fetch_add(1, std::memory_order_seq_cst) + 1;
                     int active = j->active_thread_count.load(std::memory_order_acquire);
@@ -497,6 +555,8 @@ ThreadPool::ThreadPool()
         CV_LOG_FATAL(NULL, "Failed to initialize ThreadPool (pthreads)");
     }
     num_threads = defaultNumberOfThreads();
+    numa_nodes = 0;
+    numa_threads = 0;
 }
 
 bool ThreadPool::reconfigure_(unsigned new_threads_count)
@@ -572,6 +632,18 @@ void ThreadPool::run(const Range& range, const ParallelLoopBody& body, double ns
             body(range);
             return;
         }
+        {
+            int nodes = utils::numa::isThreadPoolNUMAAware() ? utils::numa::getNumberOfNodes() : 0;
+            if (nodes < 2)
+                nodes = 0;
+            if (nodes != numa_nodes || (nodes > 0 && numa_threads != num_threads))
+            {
+                CV_LOG_VERBOSE(NULL, 1, "MainThread: NUMA placement changed: nodes=" << nodes << " threads=" << num_threads);
+                reconfigure_(0);  // re-create workers with new placement
+                numa_nodes = nodes;
+                numa_threads = num_threads;
+            }
+        }
         reconfigure_(num_threads - 1);
 
         {
@@ -644,10 +716,10 @@ void ThreadPool::run(const Range& range, const ParallelLoopBody& body, double ns
                 ParallelJob& j = *(this->job);
 #ifdef CV_PROFILE_THREADS
                 threads_stat[0].threadExecuteStart = getTickCount();
-                threads_stat[0].executedTasks = j.execute(false);
+                threads_stat[0].executedTasks = j.execute(false, numa_nodes > 0 ? utils::numa::getCurrentNode() : 0);
                 threads_stat[0].threadExecuteStop = getTickCount();
 #else
-                j.execute(false);
+                j.execute(false, numa_nodes > 0 ? utils::numa::getCurrentNode() : 0);
 #endif
                 CV_Assert(j.current_task >= j.range.size());
                 CV_LOG_VERBOSE(NULL, 5, "MainThread: complete self-tasks: " << j.active_thread_count << " " << j.completed_thread_count);
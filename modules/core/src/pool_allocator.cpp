@@ -0,0 +1,292 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "precomp.hpp"
+
+#include <opencv2/core/utils/pool_allocator.hpp>
+#include <opencv2/core/utils/allocator_stats.impl.hpp>
+#include <opencv2/core/utils/configuration.private.hpp>
+#include <opencv2/core/utils/tls.hpp>
+
+#include <atomic>
+
+namespace cv { namespace utils {
+
+namespace {
+
+// Size classes: 64 bytes, then 4 classes per power of two up to 2Gb.
+// Larger buffers are not pooled.
+enum {
+    POOL_MIN_SIZE_LOG2 = 6,
+    POOL_MAX_SIZE_LOG2 = 31,
+    POOL_CLASSES_PER_OCTAVE = 4,  // rounding overhead is 25% at most
+    POOL_NUM_CLASSES = (POOL_MAX_SIZE_LOG2 - POOL_MIN_SIZE_LOG2) * POOL_CLASSES_PER_OCTAVE + 1
+};
+
+static inline int getSizeClass(size_t size)
+{
+    if (size <= ((size_t)1 << POOL_MIN_SIZE_LOG2))
+        return 0;
+    if (size > ((size_t)1 << POOL_MAX_SIZE_LOG2))
+        return -1;
+    int k = 0;  // size is in (2^k, 2^(k+1)]
+    for (size_t v = (size - 1) >> 1; v != 0; v >>= 1)
+        k++;
+    int sub = (int)(((size - 1 - ((size_t)1 << k)) * POOL_CLASSES_PER_OCTAVE) >> k);
+    return (k - POOL_MIN_SIZE_LOG2) * POOL_CLASSES_PER_OCTAVE + sub + 1;
+}
+
+static inline size_t getClassSize(int sizeClass)
+{
+    if (sizeClass == 0)
+        return (size_t)1 << POOL_MIN_SIZE_LOG2;
+    int k = POOL_MIN_SIZE_LOG2 + (sizeClass - 1) / POOL_CLASSES_PER_OCTAVE;
+    int sub = (sizeClass - 1) % POOL_CLASSES_PER_OCTAVE;
+    return ((size_t)1 << k) + (((size_t)(sub + 1) << k) / POOL_CLASSES_PER_OCTAVE);
+}
+
+static AllocatorStatistics pool_allocator_stats;  // system memory requests of the pool
+
+class PoolMatAllocator;
+
+struct ThreadCache
+{
+    ThreadCache() : pool(NULL), generation(0) {}
+    ~ThreadCache();  // thread termination: returns buffers to the system
+
+    PoolMatAllocator* pool;
+    int generation;
+    std::vector<void*> bins[POOL_NUM_CLASSES];
+};
+
+class PoolMatAllocator CV_FINAL : public MatAllocator, public BufferPoolController
+{
+public:
+    PoolMatAllocator()
+        : reservedSize(0), generation(0)
+    {
+        maxReservedSize = utils::getConfigurationParameterSizeT("OPENCV_MAT_POOL_MAX_RESERVED_SIZE", (size_t)256 << 20);
+        threadCacheSize = utils::getConfigurationParameterSizeT("OPENCV_MAT_POOL_THREAD_CACHE", 4);
+    }
+
+    UMatData* allocate(int dims, const int* sizes, int type,
+                       void* data0, size_t* step, AccessFlag /*flags*/, UMatUsageFlags /*usageFlags*/) const CV_OVERRIDE
+    {
+        size_t total = CV_ELEM_SIZE(type);
+        for( int i = dims-1; i >= 0; i-- )
+        {
+            if( step )
+            {
+                if( data0 && step[i] != CV_AUTOSTEP )
+                {
+                    CV_Assert(total <= step[i]);
+                    total = step[i];
+                }
+                else
+                    step[i] = total;
+            }
+            total *= sizes[i];
+        }
+        int sizeClass = -1;
+        uchar* data = data0 ? (uchar*)data0 : (uchar*)allocateBuffer(total, sizeClass);
+        UMatData* u = new UMatData(this);
+        u->data = u->origdata = data;
+        u->size = total;
+        u->allocatorFlags_ = sizeClass + 1;  // 0 - not pooled
+        if(data0)
+            u->flags |= UMatData::USER_ALLOCATED;
+
+        return u;
+    }
+
+    bool allocate(UMatData* u, AccessFlag /*accessFlags*/, UMatUsageFlags /*usageFlags*/) const CV_OVERRIDE
+    {
+        if(!u) return false;
+        return true;
+    }
+
+    void deallocate(UMatData* u) const CV_OVERRIDE
+    {
+        if(!u)
+            return;
+
+        CV_Assert(u->urefcount == 0);
+        CV_Assert(u->refcount == 0);
+        if( !(u->flags & UMatData::USER_ALLOCATED) )
+        {
+            releaseBuffer(u->origdata, u->size, u->allocatorFlags_ - 1);
+            u->origdata = 0;
+        }
+        delete u;
+    }
+
+    BufferPoolController* getBufferPoolController(const char* /*id*/) const CV_OVERRIDE
+    {
+        return const_cast<PoolMatAllocator*>(this);
+    }
+
+    // BufferPoolController
+    size_t getReservedSize() const CV_OVERRIDE { return reservedSize.load(); }
+    size_t getMaxReservedSize() const CV_OVERRIDE { return maxReservedSize; }
+    void setMaxReservedSize(size_t size) CV_OVERRIDE
+    {
+        maxReservedSize = size;
+        if (reservedSize.load() > size)
+            freeAllReservedBuffers();
+    }
+    void freeAllReservedBuffers() CV_OVERRIDE
+    {
+        {
+            cv::AutoLock lock(mutex);
+            generation++;  // caches of other threads are flushed on their next access
+            for (int c = 0; c < POOL_NUM_CLASSES; c++)
+                releaseToSystem(bins[c], c);
+        }
+        ThreadCache& cache = getThreadCache();
+        flush(cache);
+    }
+
+    void flush(ThreadCache& cache) const
+    {
+        for (int c = 0; c < POOL_NUM_CLASSES; c++)
+            releaseToSystem(cache.bins[c], c);
+    }
+
+protected:
+    void* allocateBuffer(size_t size, int& sizeClass) const
+    {
+        sizeClass = getSizeClass(size);
+        if (sizeClass < 0)
+        {
+            void* ptr = fastMalloc(size);
+            pool_allocator_stats.onAllocate(size);
+            return ptr;
+        }
+        const size_t classSize = getClassSize(sizeClass);
+        ThreadCache& cache = getThreadCache();
+        std::vector<void*>& localBin = cache.bins[sizeClass];
+        if (!localBin.empty())
+        {
+            void* ptr = localBin.back();
+            localBin.pop_back();
+            reservedSize -= classSize;
+            return ptr;
+        }
+        {
+            cv::AutoLock lock(mutex);
+            std::vector<void*>& bin = bins[sizeClass];
+            if (!bin.empty())
+            {
+                void* ptr = bin.back();
+                bin.pop_back();
+                reservedSize -= classSize;
+                return ptr;
+            }
+        }
+        void* ptr = fastMalloc(classSize);
+        pool_allocator_stats.onAllocate(classSize);
+        return ptr;
+    }
+
+    void releaseBuffer(void* ptr, size_t size, int sizeClass) const
+    {
+        if (sizeClass < 0)
+        {
+            fastFree(ptr);
+            pool_allocator_stats.onFree(size);
+            return;
+        }
+        const size_t classSize = getClassSize(sizeClass);
+        if (reservedSize.load() + classSize > maxReservedSize)
+        {
+            fastFree(ptr);
+            pool_allocator_stats.onFree(classSize);
+            return;
+        }
+        ThreadCache& cache = getThreadCache();
+        std::vector<void*>& localBin = cache.bins[sizeClass];
+        reservedSize += classSize;
+        if (localBin.size() < threadCacheSize)
+        {
+            localBin.push_back(ptr);
+            return;
+        }
+        cv::AutoLock lock(mutex);
+        bins[sizeClass].push_back(ptr);
+    }
+
+    void releaseToSystem(std::vector<void*>& bin, int sizeClass) const
+    {
+        const size_t classSize = getClassSize(sizeClass);
+        for (size_t i = 0; i < bin.size(); i++)
+        {
+            fastFree(bin[i]);
+            pool_allocator_stats.onFree(classSize);
+            reservedSize -= classSize;
+        }
+        bin.clear();
+    }
+
+    ThreadCache& getThreadCache() const
+    {
+        ThreadCache& cache = tlsCache.getRef();
+        int currentGeneration = generation.load();
+        if (cache.pool == NULL)
+        {
+            cache.pool = const_cast<PoolMatAllocator*>(this);
+            cache.generation = currentGeneration;
+        }
+        else if (cache.generation != currentGeneration)
+        {
+            flush(cache);
+            cache.generation = currentGeneration;
+        }
+        return cache;
+    }
+
+    mutable cv::Mutex mutex;  // guards shared bins
+    mutable std::vector<void*> bins[POOL_NUM_CLASSES];
+    mutable std::atomic<size_t> reservedSize;  // shared bins and thread caches
+    size_t maxReservedSize;
+    size_t threadCacheSize;
+    std::atomic<int> generation;
+    TLSData<ThreadCache> tlsCache;
+};
+
+ThreadCache::~ThreadCache()
+{
+    if (pool)
+        pool->flush(*this);
+}
+
+static PoolMatAllocator& getPoolMatAllocatorInstance()
+{
+    // not released: buffers may outlive static objects
+    CV_SINGLETON_LAZY_INIT_REF(PoolMatAllocator, new PoolMatAllocator())
+}
+
+}  // namespace
+
+MatAllocator* getPoolMatAllocator()
+{
+    return &getPoolMatAllocatorInstance();
+}
+
+AllocatorStatisticsInterface& getPoolMatAllocatorStatistics()
+{
+    return pool_allocator_stats;
+}
+
+MatAllocatorScope::MatAllocatorScope(MatAllocator* allocator)
+    : prevAllocator_(Mat::getDefaultAllocator())
+{
+    Mat::setDefaultAllocator(allocator);
+}
+
+MatAllocatorScope::~MatAllocatorScope()
+{
+    Mat::setDefaultAllocator(prevAllocator_);
+}
+
+}}  // namespace
@@ -10,6 +10,9 @@
 #endif
 
 #include "opencv2/core/cuda.hpp"
+#include "opencv2/core/utils/pool_allocator.hpp"
+
+#include <thread>
 
 namespace opencv_test { namespace {
 
@@ -2598,4 +2601,64 @@ TEST(Mat, Recreate1DMatWithSameMeta)
     EXPECT_NO_THROW(m.create(dims, depth));
 }
 
+TEST(Core_Mat, pool_allocator_steady_state)
+{
+    MatAllocator* pool = cv::utils::getPoolMatAllocator();
+    BufferPoolController* controller = pool->getBufferPoolController();
+    ASSERT_TRUE(controller != NULL);
+    cv::utils::AllocatorStatisticsInterface& stats = cv::utils::getPoolMatAllocatorStatistics();
+    controller->freeAllReservedBuffers();
+
+    Mat src(480, 640, CV_8UC3);
+    randu(src, 0, 255);
+    Mat gray_ref, blur_ref;
+    extractChannel(src, gray_ref, 1);
+    cv::add(gray_ref, Scalar::all(1), blur_ref);
+
+    uint64_t allocs = 0;
+    {
+        cv::utils::MatAllocatorScope scope(pool);
+        ASSERT_EQ(pool, Mat::getDefaultAllocator());
+        for (int frame = 0; frame < 5; frame++)
+        {
+            if (frame == 2)
+                allocs = stats.getNumberOfAllocations();  // warm-up is done
+            Mat gray, blur, tmp(17, 31, CV_32FC1, Scalar::all(frame));
+            extractChannel(src, gray, 1);
+            cv::add(gray, Scalar::all(1), blur);
+            EXPECT_EQ(pool, blur.u->currAllocator);
+            EXPECT_EQ(0, cvtest::norm(gray, gray_ref, NORM_INF));
+            EXPECT_EQ(0, cvtest::norm(blur, blur_ref, NORM_INF));
+        }
+        EXPECT_EQ(allocs, stats.getNumberOfAllocations());
+        EXPECT_GT(controller->getReservedSize(), (size_t)0);
+    }
+    EXPECT_NE(pool, Mat::getDefaultAllocator());
+
+    // buffers released by other threads are reused
+    Mat m;
+    m.allocator = pool;
+    std::thread t([&]() { m.create(100, 100, CV_8UC1); });
+    t.join();
+    m.release();
+    allocs = stats.getNumberOfAllocations();
+    m.allocator = pool;
+    m.create(99, 101, CV_8UC1);
+    EXPECT_EQ(allocs, stats.getNumberOfAllocations());
+    m.release();
+
+    // user data is not owned by the pool
+    uchar buf[16] = { 0 };
+    Mat user(4, 4, CV_8UC1, buf);
+    EXPECT_TRUE(user.u == NULL);
+
+    controller->freeAllReservedBuffers();
+    EXPECT_EQ((size_t)0, controller->getReservedSize());
+    Mat big;
+    big.allocator = pool;
+    allocs = stats.getNumberOfAllocations();
+    big.create(1000, 1000, CV_8UC1);
+    EXPECT_EQ(allocs + 1, stats.getNumberOfAllocations());
+}
+
 }} // namespace
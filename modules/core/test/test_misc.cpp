@@ -7,9 +7,12 @@
 #include "opencv2/core/utils/logger.hpp"
 
 #include <opencv2/core/utils/fp_control_utils.hpp>
+#include <opencv2/core/parallel/parallel_backend.hpp>
+#include <opencv2/core/utils/numa.private.hpp>
 
 #include <chrono>
 #include <thread>
+#include <atomic>
 
 namespace opencv_test { namespace {
 
@@ -304,6 +307,220 @@ TEST(Core_Parallel, propagate_fp_denormals_ignore_hint)
     }
 }
 
+TEST(Core_Parallel, workstealing_backend_nested)
+{
+    struct BackendRestore
+    {
+        ~BackendRestore() { cv::parallel::setParallelForBackend(""); }
+    } restore;
+    if (!cv::parallel::setParallelForBackend("WORKSTEALING"))
+        throw SkipTestException("Work-stealing parallel backend is not available");
+
+    const int nThreads = cv::getNumThreads();
+    const int N = 64, M = 97;
+    Mat counters(N, M, CV_32SC1, Scalar::all(0));
+    std::atomic<int> badThreadNum(0);
+    parallel_for_(Range(0, N), [&](const Range& r)
+    {
+        for (int i = r.start; i < r.end; i++)
+        {
+            // uneven inner workload with nested regions
+            parallel_for_(Range(0, M), [&](const Range& r2)
+            {
+                int t = cv::getThreadNum();
+                if (t < 0 || t >= nThreads)
+                    badThreadNum++;
+                for (int j = r2.start; j < r2.end; j++)
+                {
+                    int* c = counters.ptr<int>(i) + j;
+                    volatile double s = 0;
+                    for (int k = 0; k < ((i * 31 + j) % 7) * 100; k++)
+                        s = s + k;
+                    (*c)++;
+                }
+            });
+        }
+    });
+    EXPECT_EQ(0, badThreadNum.load());
+    EXPECT_EQ(0, cvtest::norm(counters, Mat(N, M, CV_32SC1, Scalar::all(1)), NORM_INF));
+
+    Mat dst(1000, 100, CV_8SC1, Scalar::all(0));
+    EXPECT_THROW({
+        parallel_for_(Range(0, 10), [&](const Range& r)
+        {
+            for (int i = r.start; i < r.end; i++)
+                parallel_for_(Range(0, dst.rows), ThrowErrorParallelLoopBody(dst, i == 7 ? dst.rows / 2 : -1));
+        });
+    }, cv::Exception);
+
+    cv::setNumThreads(1);
+    Mat dst1(100, 10, CV_8SC1, Scalar::all(0));
+    parallel_for_(Range(0, dst1.rows), ThrowErrorParallelLoopBody(dst1, -1));
+    EXPECT_EQ(dst1.total(), (size_t)countNonZero(dst1));
+    cv::setNumThreads(nThreads);
+}
+
+TEST(Core_Parallel, workstealing_backend_set_num_threads)
+{
+    struct BackendRestore
+    {
+        int nThreads;
+        BackendRestore() : nThreads(cv::getNumThreads()) {}
+        ~BackendRestore() { cv::setNumThreads(nThreads); cv::parallel::setParallelForBackend(""); }
+    } restore;
+    if (!cv::parallel::setParallelForBackend("WORKSTEALING"))
+        throw SkipTestException("Work-stealing parallel backend is not available");
+
+    // pool is restarted while another thread runs parallel regions
+    const int N = 200;
+    std::atomic<bool> done(false);
+    std::atomic<int> errors(0);
+    std::thread runner([&]()
+    {
+        for (int iter = 0; iter < N; iter++)
+        {
+            std::vector<int> counters(64, 0);
+            parallel_for_(Range(0, (int)counters.size()), [&](const Range& r)
+            {
+                for (int i = r.start; i < r.end; i++)
+                    counters[i]++;
+            });
+            for (size_t i = 0; i < counters.size(); i++)
+                if (counters[i] != 1)
+                    errors++;
+        }
+        done = true;
+    });
+    for (int iter = 0; !done; iter++)
+        cv::setNumThreads(iter % 2 ? 2 : 4);
+    runner.join();
+    EXPECT_EQ(0, errors.load());
+
+    // restart requested from a parallel region is postponed to the end of the region
+    cv::setNumThreads(4);
+    std::atomic<int> processed(0);
+    parallel_for_(Range(0, 16), [&](const Range& r)
+    {
+        if (r.start == 0)
+            cv::setNumThreads(3);
+        processed += r.size();
+    });
+    EXPECT_EQ(16, processed.load());
+    EXPECT_EQ(3, cv::getNumThreads());
+    processed = 0;
+    parallel_for_(Range(0, 16), [&](const Range& r) { processed += r.size(); });
+    EXPECT_EQ(16, processed.load());
+}
+
+TEST(Core_NUMA, topology)
+{
+    const int nodes = cv::utils::numa::getNumberOfNodes();
+    ASSERT_GE(nodes, 1);
+    int node = cv::utils::numa::getCurrentNode();
+    EXPECT_GE(node, 0);
+    EXPECT_LT(node, nodes);
+    EXPECT_TRUE(cv::utils::numa::getNodeCPUs(nodes).empty());
+}
+
+TEST(Core_NUMA, node_allocator)
+{
+    for (int node = 0; node < cv::utils::numa::getNumberOfNodes(); node++)
+    {
+        for (int rows = 1; rows <= 1024; rows *= 32)
+        {
+            Mat m;
+            m.allocator = cv::utils::numa::getNodeAllocator(node);
+            m.create(rows, 777, CV_8UC3);
+            ASSERT_EQ(m.u->currAllocator, cv::utils::numa::getNodeAllocator(node));
+            m.setTo(Scalar(1, 2, 3));
+            EXPECT_EQ(0, cvtest::norm(m, Mat(rows, 777, CV_8UC3, Scalar(1, 2, 3)), NORM_INF));
+        }
+    }
+    EXPECT_ANY_THROW(cv::utils::numa::getNodeAllocator(-1));
+}
+
+struct FakeNUMATopology
+{
+    explicit FakeNUMATopology(const std::vector< std::vector<int> >& nodeCPUs) { cv::utils::numa::setTopologyForTesting(nodeCPUs); }
+    ~FakeNUMATopology() { cv::utils::numa::setTopologyForTesting(std::vector< std::vector<int> >()); }
+};
+
+TEST(Core_NUMA, fake_topology)
+{
+    // two nodes with all CPUs of the system, so pinned workers can still run anywhere
+    const int nodes = cv::utils::numa::getNumberOfNodes();
+    std::vector<int> cpus;
+    for (int node = 0; node < nodes; node++)
+    {
+        std::vector<int> nodeCPUs = cv::utils::numa::getNodeCPUs(node);
+        cpus.insert(cpus.end(), nodeCPUs.begin(), nodeCPUs.end());
+    }
+    if (cpus.empty())
+        throw SkipTestException("NUMA topology is not available");
+    std::sort(cpus.begin(), cpus.end());
+
+    const int nthreads = cv::getNumThreads();
+    const bool prevAware = cv::utils::numa::isThreadPoolNUMAAware();
+    {
+        FakeNUMATopology fake(std::vector< std::vector<int> >(2, cpus));
+        ASSERT_EQ(2, cv::utils::numa::getNumberOfNodes());
+        EXPECT_EQ(cpus, cv::utils::numa::getNodeCPUs(1));
+        const int node = cv::utils::numa::getCurrentNode();
+        EXPECT_GE(node, 0);
+        EXPECT_LT(node, 2);
+
+        // large buffers are mapped and bound to the node, small ones come from fastMalloc()
+        for (int n = 0; n < 2; n++)
+        {
+            Mat big, small;
+            big.allocator = small.allocator = cv::utils::numa::getNodeAllocator(n);
+            big.create(512, 1024, CV_8UC1);
+            small.create(16, 16, CV_8UC1);
+            EXPECT_NE(0, big.u->allocatorFlags_);
+            EXPECT_EQ(0u, (size_t)big.data % 4096);
+            EXPECT_EQ(0, small.u->allocatorFlags_);
+            big.setTo(n + 1);
+            EXPECT_EQ(big.total() * (n + 1), (size_t)cv::sum(big)[0]);
+        }
+
+        // every stripe is processed exactly once with per-node blocks, including ranges smaller than the node count
+        cv::utils::numa::setThreadPoolNUMAAware(true);
+        cv::setNumThreads(4);
+        for (int n = 1; n <= 1000; n *= 10)
+        {
+            std::vector<int> counts(n, 0);
+            parallel_for_(Range(0, n), [&](const Range& r)
+            {
+                for (int i = r.start; i < r.end; i++)
+                    CV_XADD(&counts[i], 1);
+            }, n);
+            EXPECT_EQ(std::vector<int>(n, 1), counts) << "n=" << n;
+        }
+    }
+    cv::utils::numa::setThreadPoolNUMAAware(prevAware);
+    cv::setNumThreads(nthreads);
+    EXPECT_EQ(nodes, cv::utils::numa::getNumberOfNodes());
+    std::atomic<int> processed(0);
+    parallel_for_(Range(0, 100), [&](const Range& r) { processed += r.size(); });
+    EXPECT_EQ(100, processed.load());
+}
+
+TEST(Core_Parallel, numa_aware_thread_pool)
+{
+    const bool prev = cv::utils::numa::isThreadPoolNUMAAware();
+    cv::utils::numa::setThreadPoolNUMAAware(true);
+    for (int n = 1; n <= 1000; n *= 10)
+    {
+        Mat dst(n, 10, CV_8SC1, Scalar::all(0));
+        EXPECT_NO_THROW(parallel_for_(Range(0, dst.rows), ThrowErrorParallelLoopBody(dst, -1)));
+        EXPECT_EQ(dst.total(), (size_t)countNonZero(dst));
+    }
+    cv::utils::numa::setThreadPoolNUMAAware(prev);
+    Mat dst(100, 10, CV_8SC1, Scalar::all(0));
+    EXPECT_NO_THROW(parallel_for_(Range(0, dst.rows), ThrowErrorParallelLoopBody(dst, -1)));
+    EXPECT_EQ(dst.total(), (size_t)countNonZero(dst));
+}
+
 TEST(Core_Version, consistency)
 {
     // this test verifies that OpenCV version loaded in runtime
@@ -1165,6 +1165,17 @@ CV__DNN_INLINE_NS_BEGIN
         static Ptr<MatMulLayer> create(const LayerParams &params);
     };
 
+    /**
+     * Quantized `MatMul`, `Gemm` and `Einsum` (matrix multiplication equations) layers.
+     * Constant B is quantized per output channel, otherwise both inputs are int8 tensors.
+     */
+    class CV_EXPORTS MatMulLayerInt8 : public Layer {
+     public:
+        int input_zp, output_zp;
+        float input_sc, output_sc;
+        static Ptr<MatMulLayerInt8> create(const LayerParams &params);
+    };
+
     class CV_EXPORTS ExpandLayer : public Layer
     {
     public:
@@ -1178,9 +1189,36 @@ CV__DNN_INLINE_NS_BEGIN
         static Ptr<InstanceNormLayer> create(const LayerParams &params);
     };
 
+    /**
+     * Multi-head attention (com.microsoft.Attention). Softmax(Q*K^T/sqrt(d))*V is computed by a fused tiled kernel
+     * which doesn't keep the whole seq_len x seq_len score matrix. `unidirectional` parameter enables causal mask.
+     *
+     * With enabled key/value cache the layer keeps keys and values of all the processed tokens between forward calls,
+     * so the next call receives new tokens only and they attend to the cached ones (incremental decoding).
+     */
     class CV_EXPORTS AttentionLayer : public Layer {
      public:
         static Ptr<AttentionLayer> create(const LayerParams &params);
+
+        /** @brief Enables or disables key/value cache, the cache is cleared in both cases.
+         *  The default implementation does nothing (the cache is not supported).
+         */
+        virtual void setKVCacheEnabled(bool enabled);
+        /** @brief Clears key/value cache */
+        virtual void resetKVCache();
+        /** @brief Returns number of cached tokens, 0 by default */
+        virtual int getKVCacheLength() const;
+    };
+
+    /**
+     * Quantized `Attention` layer: int8 QKV projection with per-channel quantized weights,
+     * attention scores and softmax are computed in FP32. Key/value cache keeps FP32 keys and values.
+     */
+    class CV_EXPORTS AttentionLayerInt8 : public AttentionLayer {
+     public:
+        int input_zp, output_zp;
+        float input_sc, output_sc;
+        static Ptr<AttentionLayerInt8> create(const LayerParams &params);
     };
 
     class CV_EXPORTS GroupNormLayer : public Layer {
@@ -104,7 +104,7 @@ CV__DNN_INLINE_NS_BEGIN
         DNN_TARGET_CUDA_FP16,
         DNN_TARGET_HDDL,
         DNN_TARGET_NPU,
-        DNN_TARGET_CPU_FP16, // Only the ARM platform is supported. Low precision computing, accelerate model inference.
+        DNN_TARGET_CPU_FP16, //!< Low precision computing on CPU: FP16 arithmetic on ARMv8, opt-in FP16/BF16 weights with FP32 accumulation on other CPUs with FP16 conversions (enabled by `OPENCV_DNN_CPU_FP16_WEIGHTS=FP16|BF16`, otherwise falls back to DNN_TARGET_CPU).
     };
 
     /**
@@ -461,6 +461,30 @@ CV__DNN_INLINE_NS_BEGIN
         virtual ~Layer();
     };
 
+    /** @brief Measurements of one layer execution collected by Net::enableProfiling().
+     * @sa Net::getLayersProfile
+     */
+    struct CV_EXPORTS LayerProfile
+    {
+        LayerProfile();
+
+        int layerId;
+        String name;
+        String type;
+        String kernel;        //!< kernel selected by the layer and its instruction set (e.g. "winograd_f63 AVX2"), empty if not reported
+        int forwardIndex;     //!< index of the forward() call since profiling was enabled
+        double startTime;     //!< start time in microseconds since profiling was enabled
+        double wallTime;      //!< elapsed time in microseconds
+        double cpuTime;       //!< CPU time of the whole process (including parallel_for_() workers) in microseconds,
+                              //!< -1 if layers of concurrent forward() calls (see forwardAsync()) ran at the same time
+        int64 flops;          //!< floating point operations, see Layer::getFLOPS()
+        int64 bytes;          //!< total size of inputs, outputs and weights
+        double gflops;        //!< achieved GFLOP/s
+        double gbps;          //!< achieved GB/s, memory traffic is estimated by #bytes
+        int numThreads;       //!< number of threads available to the layer, see cv::getNumThreads()
+        double threadUtilization;  //!< cpuTime / (wallTime * numThreads), 1 means that all the threads were busy, -1 if cpuTime is unknown
+    };
+
     /** @brief This class allows to create and manipulate comprehensive artificial neural networks.
      *
      * Neural network is presented as directed acyclic graph (DAG), where vertices are Layer instances,
@@ -508,6 +532,18 @@ CV__DNN_INLINE_NS_BEGIN
         /** Returns true if there are no layers in the network. */
         CV_WRAP bool empty() const;
 
+        /** @brief Creates a copy of the network which shares weights with this one.
+         *
+         *  The copy has the same layers, connections and settings (backend, target, fusion, Winograd).
+         *  Layer weights are not copied: both networks refer to the same read-only data.
+         *  Prepacked CPU weights of convolution, Gemm and MatMul layers are shared too,
+         *  so memory consumption of each additional copy is mostly defined by its activation buffers.
+         *
+         *  Each copy can run forward() concurrently with others in a separate thread.
+         *  Prepacked weights sharing can be disabled via `OPENCV_DNN_SHARE_PACKED_WEIGHTS=0`.
+         */
+        CV_WRAP Net clone() const;
+
         /** @brief Dump net to String
          *  @returns String with structure, hyperparameters, backend, target and fusion
          *  Call method after setInput(). To see correct backend, target and fusion run after forward().
@@ -518,6 +554,16 @@ CV__DNN_INLINE_NS_BEGIN
          *  @see dump()
          */
         CV_WRAP void dumpToFile(CV_WRAP_FILE_PATH const String& path);
+        /** @brief Writes the network to a cache file for fast loading by readNetFromCache().
+         *
+         * The file contains the imported graph and the weights in a binary form, so the next start skips
+         * parsing and simplification of the original model. Weights which the CPU layers have already packed
+         * (Winograd and GEMM layouts, FP16 copies, weights of fused layers) are stored too, so call forward()
+         * once before writeCache() to skip the packing on the next start.
+         * @param path path to the output file
+         * @sa readNetFromCache
+         */
+        CV_WRAP void writeCache(CV_WRAP_FILE_PATH const String& path) const;
         /** @brief Adds new layer to the net.
          *  @param name   unique name of the adding layer.
          *  @param type   typename of the adding layer (type must be registered in LayerRegister).
@@ -625,7 +671,22 @@ CV__DNN_INLINE_NS_BEGIN
          *  @details By default runs forward pass for the whole network.
          *
          *  This is an asynchronous version of forward(const String&).
-         *  dnn::DNN_BACKEND_INFERENCE_ENGINE backend is required.
+         *  dnn::DNN_BACKEND_INFERENCE_ENGINE backend or dnn::DNN_BACKEND_OPENCV backend with CPU target is required.
+         *
+         *  With dnn::DNN_BACKEND_OPENCV requests are queued and taken in order by internal worker threads.
+         *  Up to `OPENCV_DNN_ASYNC_MAX_REQUESTS` (2 by default) requests are computed at the same time, each one
+         *  on its own set of intermediate blobs, the weights are shared. Requests may complete out of order.
+         *  Networks with enabled key/value cache (enableKVCache()) or modified by setParam() process requests one at a time.
+         *  After the first call inputs passed to setInput() are captured by the next forwardAsync() request,
+         *  so the next frame can be prepared while the previous ones are processed:
+         *  @code
+         *      net.setInput(blob1); AsyncArray r1 = net.forwardAsync();
+         *      net.setInput(blob2); AsyncArray r2 = net.forwardAsync();  // blob2 is prepared during inference of blob1
+         *      Mat out1, out2; r1.get(out1); r2.get(out2);
+         *  @endcode
+         *  All other methods of the Net except setInput() and empty() (forward(), getLayer(), setParam(), getFLOPS(),
+         *  writeCache(), etc.) wait for submitted requests before they inspect or modify the network.
+         *  Modification of the network (setParam(), setPreferableTarget(), etc.) releases the blob sets of the requests.
          */
         CV_WRAP AsyncArray forwardAsync(const String& outputName = String());
 
@@ -826,6 +887,17 @@ CV__DNN_INLINE_NS_BEGIN
          */
         void getMemoryConsumption(const std::vector<MatShape>& netInputShapes,
                                           CV_OUT size_t& weights, CV_OUT size_t& blobs) const; // FIXIT: CV_WRAP
+        /** @overload
+         * @param netInputShapes vector of shapes for all net inputs.
+         * @param weights output parameter to store resulting bytes for weights.
+         * @param blobs output parameter to store resulting bytes for intermediate blobs.
+         * @param plannedBlobs output parameter to store peak bytes for intermediate blobs
+         * if memory is reused between blobs with non-overlapping lifetimes (network inputs are not included).
+         * It is the size of memory arenas allocated by the OpenCV backend on CPU (see `OPENCV_DNN_MEMORY_PLANNER`).
+         */
+        void getMemoryConsumption(const std::vector<MatShape>& netInputShapes,
+                                  CV_OUT size_t& weights, CV_OUT size_t& blobs,
+                                  CV_OUT size_t& plannedBlobs) const;
         /** @overload */
         CV_WRAP void getMemoryConsumption(const MatShape& netInputShape,
                                           CV_OUT size_t& weights, CV_OUT size_t& blobs) const;
@@ -866,6 +938,45 @@ CV__DNN_INLINE_NS_BEGIN
         */
         CV_WRAP void enableWinograd(bool useWinograd);
 
+        /** @brief Enables caching of prepared networks for recently used input shapes.
+         *
+         * Changing the input shape usually leads to full re-initialization of the network on the next forward().
+         * With the cache, networks prepared for different input shapes are kept (they share weights with this one)
+         * and forward() switches between them without re-initialization.
+         * @param maxEntries maximal number of cached input shapes, 0 disables the cache (default).
+         * The default value can be changed via `OPENCV_DNN_SHAPE_CACHE_SIZE`.
+         * @note If the cache is enabled, getLayer() returns layers of the entry used by the last forward() call.
+         * Layer outputs and the getPerfProfile() of the other cached shapes are not available through this object.
+         * setParam() disables the cache. Methods which change the graph (addLayer(), connect(), registerOutput(),
+         * setInputsNames(), setInputShape()) drop the cached entries.
+         */
+        CV_WRAP void setShapeCacheSize(int maxEntries);
+
+        /** @brief Declares dynamic axes of a network input for the shape cache.
+         *
+         * Inputs which differ only along dynamic axes (e.g. batch size or sequence length) share one cache entry.
+         * Such entry is re-initialized on a shape change, but memory buffers are allocated for the largest shape
+         * and reused by smaller ones.
+         * @param inputName name of the network input, see setInputsNames().
+         * @param axes indexes of dynamic axes. Empty vector removes the declaration.
+         * @sa setShapeCacheSize
+         */
+        CV_WRAP void setInputDynamicAxes(const String& inputName, const std::vector<int>& axes);
+
+        /** @brief Enables key/value cache of attention layers for incremental (autoregressive) decoding.
+         *
+         * With enabled cache, keys and values of the processed tokens are kept by attention layers between forward() calls.
+         * The next forward() receives new tokens only (e.g. input of shape [batch, 1, hidden] for one token) which attend to
+         * all the cached tokens, so a decoding step costs O(seq_len) instead of processing of the whole prefix.
+         * The shape cache is disabled.
+         * @param enable enables or disables the cache, the cached tokens are dropped in both cases.
+         * @sa resetState, AttentionLayer
+         */
+        CV_WRAP void enableKVCache(bool enable = true);
+
+        /** @brief Clears state kept by layers between forward() calls (key/value cache), e.g. to start a new sequence. */
+        CV_WRAP void resetState();
+
         /** @brief Returns overall time for inference and timings (in ticks) for layers.
          *
          * Indexes in returned vector correspond to layers ids. Some layers can be fused with others,
@@ -876,6 +987,30 @@ CV__DNN_INLINE_NS_BEGIN
          */
         CV_WRAP int64 getPerfProfile(CV_OUT std::vector<double>& timings);
 
+        /** @brief Enables per-layer profiling of forward() calls.
+         *
+         * Every executed layer gets a record with wall and CPU time, FLOPs, bytes of inputs, outputs and weights,
+         * achieved GFLOP/s and GB/s, selected kernel and utilization of threads. It tells compute-bound layers from
+         * memory-bound ones. Layers fused into others are not reported. Supported by DNN_BACKEND_OPENCV.
+         * Only the last `OPENCV_DNN_PROFILE_MAX_RECORDS` (100000 by default) records are kept.
+         * @param enable enables or disables profiling, collected records are dropped in both cases.
+         * @sa getLayersProfile, dumpProfile
+         */
+        CV_WRAP void enableProfiling(bool enable = true);
+
+        /** @brief Returns records collected since profiling was enabled (up to the limit), in order of execution.
+         * @sa enableProfiling
+         */
+        void getLayersProfile(std::vector<LayerProfile>& records) const;
+
+        /** @brief Writes collected records as a timeline in Chrome trace event format (JSON).
+         *
+         * The file can be opened by chrome://tracing or Perfetto UI (https://ui.perfetto.dev).
+         * @param path path to the output .json file
+         * @sa enableProfiling
+         */
+        CV_WRAP void dumpProfile(CV_WRAP_FILE_PATH const String& path) const;
+
 
         struct Impl;
         inline Impl* getImpl() const { return impl.get(); }
@@ -985,6 +1120,20 @@ CV__DNN_INLINE_NS_BEGIN
       */
     CV_EXPORTS Net readNetFromTFLite(const char *bufferModel, size_t lenModel);
 
+    /** @brief Reads a network written by Net::writeCache().
+      * @param path path to the cache file
+      * @returns Net object.
+      *
+      * Weights of the layers refer to the file contents mapped into memory where the platform allows it
+      * (the file is read otherwise). Prepacked weights are copied into the buffers of the layers.
+      * The file records the OpenCV version it was created by: files of another version are rejected
+      * with an exception, the network should be imported from the original model and cached again in this case.
+      * Prepacked weights are used only if the file is created on a CPU with the same features and
+      * `OPENCV_DNN_SHARE_PACKED_WEIGHTS` is not disabled, otherwise they are ignored with a warning and the layers
+      * pack the weights again.
+      */
+    CV_EXPORTS_W Net readNetFromCache(CV_WRAP_FILE_PATH const String &path);
+
     /**
      *  @brief Reads a network model stored in <a href="http://torch.ch">Torch7</a> framework's format.
      *  @param model    path to the file, dumped from Torch by using torch.save() function.
@@ -1266,6 +1415,31 @@ CV__DNN_INLINE_NS_BEGIN
     /** @overload */
     CV_EXPORTS_W void blobFromImagesWithParams(InputArrayOfArrays images, OutputArray blob, const Image2BlobParams& param = Image2BlobParams());
 
+    /** @brief Creates 4-dimensional blob from geometrically transformed image in a single pass.
+     *
+     *  @details The function is equivalent to cv::warpAffine (or cv::warpPerspective) followed by
+     *  cv::cvtColor and @ref blobFromImageWithParams, but the output blob is computed stripe by stripe,
+     *  so no full-size intermediate images are allocated. Resize, crop and letterbox can be expressed
+     *  through the transformation matrix.
+     *
+     *  @param image input image.
+     *  @param M \f$2\times 3\f$ affine or \f$3\times 3\f$ perspective transformation matrix.
+     *  @param param preprocessing parameters. Output spatial size `param.size` must be set,
+     *  `param.paddingmode` is ignored, `param.borderValue` is used with BORDER_CONSTANT.
+     *  @param flags combination of interpolation methods (see #InterpolationFlags) and the optional
+     *  flag #WARP_INVERSE_MAP that means that M is the inverse transformation (dst->src).
+     *  @param code color space conversion code (see #ColorConversionCodes) applied after the warp,
+     *  or -1 to keep input channels as is.
+     *  @param borderMode pixel extrapolation method (see #BorderTypes).
+     *  @returns 4-dimensional Mat.
+     */
+    CV_EXPORTS_W Mat blobFromImageWithWarp(InputArray image, InputArray M, const Image2BlobParams& param,
+                                           int flags, int code = -1, int borderMode = BORDER_CONSTANT);
+
+    /** @overload */
+    CV_EXPORTS_W void blobFromImageWithWarp(InputArray image, OutputArray blob, InputArray M, const Image2BlobParams& param,
+                                            int flags, int code = -1, int borderMode = BORDER_CONSTANT);
+
     /** @brief Parse a 4D blob and output the images it contains as 2D arrays through a simpler data structure
      *  (std::vector<cv::Mat>).
      *  @param[in] blob_ 4 dimensional array (images, channels, height, width) in floating point precision (CV_32F) from
@@ -18,6 +18,16 @@ CV__DNN_INLINE_NS_BEGIN
  */
 CV_EXPORTS void skipModelImport(bool skip);
 
+/**
+ * @brief Returns addresses of prepacked weights (e.g. of convolution and GEMM layers) used by the network.
+ * @param[in] net network after forward()
+ * @param[out] addresses addresses of the weights by their keys
+ *
+ * Networks with the same weights share prepacked weights (see Net::clone()).
+ * This is an internal OpenCV function not intended for users.
+ */
+CV_EXPORTS void getPackedWeightsAddresses(const Net& net, std::map<std::string, const void*>& addresses);
+
 CV__DNN_INLINE_NS_END
 }} // namespace
 
@@ -10,6 +10,8 @@
 #include <opencv2/dnn/utils/debug_utils.hpp>
 #include <opencv2/core/utils/logger.hpp>
 
+#include "net_impl.hpp"
+
 namespace cv { namespace dnn {
 CV__DNN_INLINE_NS_BEGIN
 
@@ -35,6 +37,16 @@ void skipModelImport(bool skip)
     DNN_SKIP_REAL_IMPORT = skip;
 }
 
+void getPackedWeightsAddresses(const Net& net, std::map<std::string, const void*>& addresses)
+{
+    addresses.clear();
+    CV_Assert(net.getImpl());
+    std::map<std::string, Ptr<void> > packed;
+    net.getImpl()->collectPackedWeights(packed);
+    for (std::map<std::string, Ptr<void> >::const_iterator it = packed.begin(); it != packed.end(); ++it)
+        addresses[it->first] = it->second.get();
+}
+
 void detail::LayerHandler::addMissing(const std::string& name, const std::string& type)
 {
     // If we didn't add it, but can create it, it's custom and not missing.
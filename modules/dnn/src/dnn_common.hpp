@@ -31,6 +31,18 @@ size_t getParam_DNN_NETWORK_DUMP();
 /// This parameter is useful to run with valgrind memory errors detection
 bool getParam_DNN_DISABLE_MEMORY_OPTIMIZATIONS();
 
+/// Lifetime-based packing of intermediate blobs (CPU)
+bool getParam_DNN_MEMORY_PLANNER();
+
+/// Default size of the input shape cache (Net::setShapeCacheSize())
+size_t getParam_DNN_SHAPE_CACHE_SIZE();
+
+/// Number of asynchronous requests which are computed concurrently (Net::forwardAsync())
+size_t getParam_DNN_ASYNC_MAX_REQUESTS();
+
+/// Maximal number of records kept by the per-layer profiler (Net::enableProfiling())
+size_t getParam_DNN_PROFILE_MAX_RECORDS();
+
 #ifdef HAVE_OPENCL
 bool getParam_DNN_OPENCL_ALLOW_ALL_DEVICES();
 #endif
@@ -42,6 +54,13 @@ bool getParam_DNN_CHECK_NAN_INF();
 bool getParam_DNN_CHECK_NAN_INF_DUMP();
 bool getParam_DNN_CHECK_NAN_INF_RAISE_ERROR();
 
+//
+// net_serialization.cpp
+//
+
+/// Space separated names of the CPU features available at runtime
+std::string getCPUFeaturesKey();
+
 
 inline namespace detail {
 
@@ -70,6 +89,35 @@ public:
     static void unRegister();
 };
 
+// Consecutive element-wise layers evaluated in one pass over the data, tile by tile (see Net::Impl::fuseElementwiseChains()).
+// Data is processed as [N, C, planeSize] where N and C are the first dimensions of the chain input.
+class ElementwiseChainLayer : public Layer
+{
+public:
+    enum BinaryOp { OP_ADD, OP_SUB, OP_MUL, OP_DIV, OP_MAX, OP_MIN };
+
+    // inputIdx is the index of the chain data among the inputs of the first layer
+    static Ptr<ElementwiseChainLayer> create(const String& name, int inputIdx);
+
+    virtual void addActivation(const Ptr<ActivationLayer>& layer) = 0;
+    // dst = dst * scale + shift, scale and shift have 1 or C elements (empty is identity)
+    virtual void addScaleShift(const Mat& scale, const Mat& shift) = 0;
+    // dst = op(dst, value) or op(value, dst) if reversed, value has 1, C or the same number of elements as the data
+    virtual void addBinaryConst(BinaryOp op, const Mat& value, bool reversed) = 0;
+    // the same with the output blob of a layer computed before the chain (the same number of elements as the data)
+    virtual void addBinaryBlob(BinaryOp op, const Mat* blob, bool reversed) = 0;
+    virtual int getNumStages() const = 0;
+};
+
+// Implemented by layers which select one of several kernels, reported by the profiler (see Net::enableProfiling())
+class KernelInfo
+{
+public:
+    virtual ~KernelInfo() {}
+    // kernel used by the last forward() call and its instruction set, e.g. "winograd_f63 AVX2"
+    virtual String getKernelInfo() const = 0;
+};
+
 template <typename Importer, typename ... Args>
 Net readNet(Args&& ... args)
 {
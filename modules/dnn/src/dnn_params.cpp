@@ -25,6 +25,34 @@ bool getParam_DNN_DISABLE_MEMORY_OPTIMIZATIONS()
     return DNN_DISABLE_MEMORY_OPTIMIZATIONS;
 }
 
+// packing of intermediate blobs into arenas (CPU), see BlobManager::computePlan()
+bool getParam_DNN_MEMORY_PLANNER()
+{
+    static bool DNN_MEMORY_PLANNER = utils::getConfigurationParameterBool("OPENCV_DNN_MEMORY_PLANNER", true);
+    return DNN_MEMORY_PLANNER;
+}
+
+// default number of cached network instances per input shape, see Net::setShapeCacheSize()
+size_t getParam_DNN_SHAPE_CACHE_SIZE()
+{
+    static size_t DNN_SHAPE_CACHE_SIZE = utils::getConfigurationParameterSizeT("OPENCV_DNN_SHAPE_CACHE_SIZE", 0);
+    return DNN_SHAPE_CACHE_SIZE;
+}
+
+// number of concurrently computed asynchronous requests (blob sets) per network, see Net::forwardAsync()
+size_t getParam_DNN_ASYNC_MAX_REQUESTS()
+{
+    static size_t DNN_ASYNC_MAX_REQUESTS = utils::getConfigurationParameterSizeT("OPENCV_DNN_ASYNC_MAX_REQUESTS", 2);
+    return DNN_ASYNC_MAX_REQUESTS;
+}
+
+// the oldest records of the per-layer profiler are dropped above this number, see Net::enableProfiling()
+size_t getParam_DNN_PROFILE_MAX_RECORDS()
+{
+    static size_t DNN_PROFILE_MAX_RECORDS = utils::getConfigurationParameterSizeT("OPENCV_DNN_PROFILE_MAX_RECORDS", 100000);
+    return DNN_PROFILE_MAX_RECORDS;
+}
+
 #ifdef HAVE_OPENCL
 bool getParam_DNN_OPENCL_ALLOW_ALL_DEVICES()
 {
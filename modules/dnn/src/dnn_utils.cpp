@@ -357,6 +357,179 @@ void blobFromImageWithParams(InputArray image, OutputArray blob, const Image2Blo
     CV_Error(Error::StsBadArg, "Image an Blob are expected to be either a Mat or UMat");
 }
 
+template<typename T, typename DT>
+static void packStripeToBlob(const Mat& stripe, Mat& blob, int y0, const int* chIdx,
+                             const double* alpha, const double* beta, bool nchw)
+{
+    const int nch = stripe.channels(), width = stripe.cols;
+    for (int y = 0; y < stripe.rows; y++)
+    {
+        const T* src = stripe.ptr<T>(y);
+        if (nchw)
+        {
+            for (int c = 0; c < nch; c++)
+            {
+                DT* dst = blob.ptr<DT>(0, chIdx[c]) + (size_t)(y0 + y) * width;
+                const float a = (float)alpha[c], b = (float)beta[c];
+                for (int x = 0; x < width; x++)
+                    dst[x] = saturate_cast<DT>(src[x * nch + c] * a + b);
+            }
+        }
+        else
+        {
+            DT* dst = blob.ptr<DT>(0) + (size_t)(y0 + y) * width * nch;
+            for (int x = 0; x < width; x++, src += nch, dst += nch)
+                for (int c = 0; c < nch; c++)
+                    dst[chIdx[c]] = saturate_cast<DT>(src[c] * (float)alpha[c] + (float)beta[c]);
+        }
+    }
+}
+
+typedef void (*PackStripeFunc)(const Mat&, Mat&, int, const int*, const double*, const double*, bool);
+
+static PackStripeFunc getPackStripeFunc(int sdepth, int ddepth)
+{
+    if (ddepth == CV_32F)
+    {
+        switch (sdepth)
+        {
+        case CV_8U: return packStripeToBlob<uchar, float>;
+        case CV_16U: return packStripeToBlob<ushort, float>;
+        case CV_32F: return packStripeToBlob<float, float>;
+        }
+    }
+    else if (ddepth == CV_8U && sdepth == CV_8U)
+        return packStripeToBlob<uchar, uchar>;
+    return NULL;
+}
+
+Mat blobFromImageWithWarp(InputArray image, InputArray M, const Image2BlobParams& param,
+                          int flags, int code, int borderMode)
+{
+    CV_TRACE_FUNCTION();
+    Mat blob;
+    blobFromImageWithWarp(image, blob, M, param, flags, code, borderMode);
+    return blob;
+}
+
+void blobFromImageWithWarp(InputArray image_, OutputArray blob_, InputArray M_, const Image2BlobParams& param,
+                           int flags, int code, int borderMode)
+{
+    CV_TRACE_FUNCTION();
+
+    Mat image = image_.getMat();
+    CV_Assert(!image.empty() && image.dims == 2);
+    CV_CheckType(param.ddepth, param.ddepth == CV_32F || param.ddepth == CV_8U,
+                 "Blob depth should be CV_32F or CV_8U");
+    CV_Assert(!param.size.empty());
+    CV_Assert(param.datalayout == DNN_LAYOUT_NCHW || param.datalayout == DNN_LAYOUT_NHWC);
+    if (param.ddepth == CV_8U)
+    {
+        CV_Assert(param.scalefactor == Scalar::all(1.0) && "Scaling is not supported for CV_8U blob depth");
+        CV_Assert(param.mean == Scalar() && "Mean subtraction is not supported for CV_8U blob depth");
+    }
+
+    CV_Assert(borderMode != BORDER_TRANSPARENT);
+
+    Mat M0 = M_.getMat();
+    CV_Assert((M0.rows == 2 || M0.rows == 3) && M0.cols == 3);
+    const bool perspective = M0.rows == 3;
+
+    // Work with the inverse (dst->src) transformation: shifting it by the stripe origin
+    // gives the matrix which produces the stripe with the regular warp kernels.
+    Matx33d Minv = Matx33d::eye();
+    {
+        Mat Md(M0.rows, 3, CV_64F, Minv.val);
+        M0.convertTo(Md, CV_64F);
+        if (!(flags & WARP_INVERSE_MAP))
+            Minv = Minv.inv();
+    }
+    flags |= WARP_INVERSE_MAP;
+
+    int dcn = image.channels();
+    if (code >= 0)
+    {
+        Mat probe;
+        cvtColor(Mat(2, 2, image.type(), Scalar::all(0)), probe, code);
+        CV_Assert(probe.size() == Size(2, 2) && "Color conversion must not change image size");
+        dcn = probe.channels();
+        CV_CheckDepthEQ(probe.depth(), image.depth(), "Color conversion must preserve image depth");
+    }
+    CV_Check(dcn, dcn == 1 || dcn == 3 || dcn == 4, "Only 1-, 3- and 4-channel blobs are supported");
+
+    PackStripeFunc packFunc = getPackStripeFunc(image.depth(), param.ddepth);
+    CV_Assert(packFunc && "Unsupported combination of image depth and blob depth");
+
+    // (x - mean) * scale = x * scale - mean * scale
+    int chIdx[4] = { 0, 1, 2, 3 };
+    double alpha[4], beta[4];
+    for (int c = 0; c < 4; c++)
+    {
+        alpha[c] = param.scalefactor[c];
+        beta[c] = -param.mean[c] * param.scalefactor[c];
+    }
+    if (param.swapRB)
+    {
+        if (dcn > 2)
+        {
+            std::swap(chIdx[0], chIdx[2]);
+            std::swap(alpha[0], alpha[2]);
+            std::swap(beta[0], beta[2]);
+        }
+        else
+        {
+            CV_LOG_WARNING(NULL, "Red/blue color swapping requires at least three image channels.");
+        }
+    }
+
+    const Size size = param.size;
+    const bool nchw = param.datalayout == DNN_LAYOUT_NCHW;
+    if (nchw)
+    {
+        int sz[] = { 1, dcn, size.height, size.width };
+        blob_.create(4, sz, param.ddepth);
+    }
+    else
+    {
+        int sz[] = { 1, size.height, size.width, dcn };
+        blob_.create(4, sz, param.ddepth);
+    }
+    Mat blob = blob_.getMat();
+
+    // Keep a stripe (and its color converted copy) within L2 cache
+    const size_t stripeBytes = (size_t)size.width * std::max(dcn, image.channels()) * CV_ELEM_SIZE1(image.depth());
+    const int stripeHeight = std::max(1, std::min(size.height, (int)((1 << 17) / std::max(stripeBytes, (size_t)1))));
+    const int nstripes = (size.height + stripeHeight - 1) / stripeHeight;
+
+    parallel_for_(Range(0, nstripes), [&](const Range& r)
+    {
+        Mat warped, converted;
+        for (int s = r.start; s < r.end; s++)
+        {
+            const int y0 = s * stripeHeight;
+            const Size stripeSize(size.width, std::min(stripeHeight, size.height - y0));
+
+            // M * [x, y + y0, 1]^T == (M * T(0, y0)) * [x, y, 1]^T
+            Matx33d Ms = Minv;
+            for (int i = 0; i < 3; i++)
+                Ms(i, 2) += Ms(i, 1) * y0;
+
+            if (perspective)
+                warpPerspective(image, warped, Ms, stripeSize, flags, borderMode, param.borderValue);
+            else
+                warpAffine(image, warped, Matx23d(Ms.val), stripeSize, flags, borderMode, param.borderValue);
+
+            const Mat* stripe = &warped;
+            if (code >= 0)
+            {
+                cvtColor(warped, converted, code);
+                stripe = &converted;
+            }
+            packFunc(*stripe, blob, y0, chIdx, alpha, beta, nchw);
+        }
+    }, nstripes);
+}
+
 void imagesFromBlob(const cv::Mat& blob_, OutputArrayOfArrays images_)
 {
     CV_TRACE_FUNCTION();
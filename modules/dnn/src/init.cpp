@@ -219,6 +219,10 @@ void initializeLayerFactory()
     CV_DNN_REGISTER_LAYER_CLASS(AbsValInt8,       ActivationLayerInt8);
     CV_DNN_REGISTER_LAYER_CLASS(SoftmaxInt8,      SoftmaxLayerInt8);
     CV_DNN_REGISTER_LAYER_CLASS(SoftMaxInt8,      SoftmaxLayerInt8);
+    CV_DNN_REGISTER_LAYER_CLASS(MatMulInt8,       MatMulLayerInt8);
+    CV_DNN_REGISTER_LAYER_CLASS(GemmInt8,         MatMulLayerInt8);
+    CV_DNN_REGISTER_LAYER_CLASS(EinsumInt8,       MatMulLayerInt8);
+    CV_DNN_REGISTER_LAYER_CLASS(AttentionInt8,    AttentionLayerInt8);
 
     CV_DNN_REGISTER_LAYER_CLASS(ConcatInt8,       ConcatLayer);
     CV_DNN_REGISTER_LAYER_CLASS(FlattenInt8,      FlattenLayer);
@@ -0,0 +1,240 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "../precomp.hpp"
+#include "layers_common.hpp"
+#include "gemm_int8.hpp"
+#include "../layers/cpu_kernels/fast_gemm.hpp"
+#include "../layers/cpu_kernels/flash_attention.hpp"
+
+#include <opencv2/dnn/shape_utils.hpp>
+
+namespace cv
+{
+namespace dnn
+{
+
+// Quantized version of AttentionLayer (com.microsoft.Attention).
+// QKV projection, which takes the most of computations, is done by int8 GEMM with per-channel quantized weights
+// and dequantized output. Scores, softmax and weighted sum of V are computed in FP32, the result is quantized.
+// Key/value cache stores keys and values of the processed tokens in FP32 as AttentionLayer does.
+class AttentionLayerInt8Impl CV_FINAL : public AttentionLayerInt8
+{
+public:
+    AttentionLayerInt8Impl(const LayerParams& params)
+    {
+        setParamsFrom(params);
+
+        input_sc = params.get<float>("input_scale");
+        input_zp = params.get<int>("input_zeropoint");
+        output_sc = params.get<float>("scales");
+        output_zp = params.get<int>("zeropoints");
+
+        num_heads = params.get<int>("num_heads");
+        DictValue param_qkv_hidden_sizes = params.get("qkv_hidden_sizes");
+        CV_CheckEQ(param_qkv_hidden_sizes.size(), 3, "DNN/AttentionInt8: qkv_hidden_sizes must and only have three elements");
+        output_ndims = params.get<int>("output_ndims", 3);
+        unidirectional = params.get<int>("unidirectional", 0) != 0;
+
+        // blobs[0] - QKV weights (hidden_size x input_hidden_size)
+        // blobs[1] - QKV bias fused with offset
+        // blobs[2] - Multipliers which dequantize QKV
+        CV_Assert(blobs.size() == 3 && blobs[0].dims == 2 && blobs[0].type() == CV_8S);
+        hidden_size = blobs[0].rows;
+        input_hidden_size = blobs[0].cols;
+        qkv_hidden_sizes[0] = param_qkv_hidden_sizes.get<int>(0);
+        qkv_hidden_sizes[1] = param_qkv_hidden_sizes.get<int>(1);
+        qkv_hidden_sizes[2] = hidden_size - qkv_hidden_sizes[0] - qkv_hidden_sizes[1];
+        for (int i = 0; i < 3; i++)
+            qkv_head_sizes[i] = qkv_hidden_sizes[i] / num_heads;
+        scale = 1.f / params.get<float>("scale", std::sqrt((float)qkv_head_sizes[0]));
+
+        kv_cache_enabled = false;
+        kv_cache_len = 0;
+        kv_cache_capacity = 0;
+        cached_batch_size = 0;
+
+        packedWeights.create(hidden_size, (int)gemmInt8PackedStride(input_hidden_size), CV_8S);
+        gemmInt8PackB(hidden_size, input_hidden_size, blobs[0].ptr<int8_t>(), 1, blobs[0].step1(),
+                      packedWeights.ptr<int8_t>(), NULL);
+    }
+
+    virtual bool supportBackend(int backendId) CV_OVERRIDE
+    {
+        return backendId == DNN_BACKEND_OPENCV;
+    }
+
+    virtual bool getMemoryShapes(const std::vector<MatShape> &inputs,
+                                 const int requiredOutputs,
+                                 std::vector<MatShape> &outputs,
+                                 std::vector<MatShape> &internals) const CV_OVERRIDE
+    {
+        CV_CheckEQ(inputs.size(), (size_t)1, "DNN/AttentionInt8: one input is required");
+        const MatShape& input_shape = inputs[0];
+        CV_CheckEQ(input_shape.size(), (size_t)3, "DNN/AttentionInt8: invalid input dimension");
+        CV_CheckEQ(input_shape[2], input_hidden_size, "DNN/AttentionInt8: invalid input shape");
+        CV_CheckEQ(qkv_hidden_sizes[2], input_hidden_size, "DNN/AttentionInt8: invalid V hidden size");
+
+        if (output_ndims == 3)
+            outputs.assign(1, input_shape);
+        else if (output_ndims == 2)
+            outputs.assign(1, MatShape{input_shape[0] * input_shape[1], input_shape[2]});
+        else
+            CV_Error(Error::StsBadArg, format("DNN/AttentionInt8: invalid output dimension %d, valid value is 2 or 3", output_ndims));
+        return false;
+    }
+
+    virtual void finalize(InputArrayOfArrays, OutputArrayOfArrays) CV_OVERRIDE
+    {
+        opt.init();
+        opt.multi_thread = false;  // parallel over heads
+    }
+
+    void forward(InputArrayOfArrays inputs_arr, OutputArrayOfArrays outputs_arr, OutputArrayOfArrays internals_arr) CV_OVERRIDE
+    {
+        CV_TRACE_FUNCTION();
+        CV_TRACE_ARG_VALUE(name, "name", name.c_str());
+
+        std::vector<Mat> inputs, outputs;
+        inputs_arr.getMatVector(inputs);
+        outputs_arr.getMatVector(outputs);
+
+        const Mat& input = inputs[0];
+        CV_Assert(input.type() == CV_8S && input.isContinuous());
+        const int batch_size = input.size[0], seq_len = input.size[1];
+        const int rows = batch_size * seq_len;
+
+        // int8 QKV projection: [B*S, E] x [E, hidden_size]
+        qkv.create(rows, hidden_size, CV_32F);
+        {
+            const int8_t* x = input.ptr<int8_t>();
+            const int* bias = blobs[1].ptr<int>();
+            const float* mult = blobs[2].ptr<float>();
+            const int MB = 16;
+            parallel_for_(Range(0, (rows + MB - 1) / MB), [&](const Range& r) {
+                for (int i = r.start; i < r.end; i++)
+                {
+                    int m0 = i * MB, m1 = std::min(m0 + MB, rows);
+                    gemmInt8(m1 - m0, hidden_size, input_hidden_size, x + (size_t)m0 * input_hidden_size, input_hidden_size,
+                             packedWeights.ptr<int8_t>(), bias, NULL, mult, 0, NULL, qkv.ptr<float>(m0), hidden_size);
+                }
+            }, (double)rows * hidden_size * input_hidden_size * (1 / 65536.0));
+        }
+
+        // Keys and values of new tokens are appended to the cache if it is enabled
+        const int past_len = kv_cache_enabled ? kv_cache_len : 0;
+        const int total_len = past_len + seq_len;
+        if (kv_cache_enabled)
+            reserveKVCache(total_len, batch_size);
+
+        // Softmax(scale * Q*K^T) * V for each batch and head, Q/K/V are read from QKV with row stride hidden_size
+        const int qk_head_size = qkv_head_sizes[0], v_head_size = qkv_head_sizes[2];
+        const int loops = batch_size * num_heads;
+        attention.create(rows, qkv_hidden_sizes[2], CV_32F);
+        parallel_for_(Range(0, loops), [&](const Range& r) {
+            for (int i = r.start; i < r.end; i++)
+            {
+                const int batch_index = i / num_heads, head_index = i % num_heads;
+                const float* q = qkv.ptr<float>(batch_index * seq_len) + head_index * qk_head_size;
+                const float* k = q + qkv_hidden_sizes[0];
+                const float* v = qkv.ptr<float>(batch_index * seq_len) + qkv_hidden_sizes[0] + qkv_hidden_sizes[1] +
+                                 head_index * v_head_size;
+                size_t ldk = hidden_size, ldv = hidden_size;
+                if (kv_cache_enabled)
+                {
+                    // cache of the head: [capacity, head_size]
+                    float* kc = &k_cache[(size_t)i * kv_cache_capacity * qk_head_size];
+                    float* vc = &v_cache[(size_t)i * kv_cache_capacity * v_head_size];
+                    for (int j = 0; j < seq_len; j++)
+                    {
+                        std::memcpy(kc + (size_t)(past_len + j) * qk_head_size, k + (size_t)j * hidden_size, qk_head_size * sizeof(float));
+                        std::memcpy(vc + (size_t)(past_len + j) * v_head_size, v + (size_t)j * hidden_size, v_head_size * sizeof(float));
+                    }
+                    k = kc;
+                    v = vc;
+                    ldk = qk_head_size;
+                    ldv = v_head_size;
+                }
+                flashAttention(seq_len, total_len, qk_head_size, v_head_size, scale,
+                               q, hidden_size, k, ldk, v, ldv,
+                               attention.ptr<float>(batch_index * seq_len) + head_index * v_head_size, qkv_hidden_sizes[2],
+                               unidirectional ? past_len : -1, opt);
+            }
+        }, (double)loops * seq_len * total_len * (qk_head_size + v_head_size) * (1 / 65536.0));
+        if (kv_cache_enabled)
+            kv_cache_len = total_len;
+
+        Mat out = outputs[0].reshape(1, rows);
+        attention.convertTo(out, CV_8S, 1.f / output_sc, output_zp);
+    }
+
+    virtual void setKVCacheEnabled(bool enabled) CV_OVERRIDE
+    {
+        kv_cache_enabled = enabled;
+        resetKVCache();
+    }
+
+    virtual void resetKVCache() CV_OVERRIDE
+    {
+        kv_cache_len = 0;
+        kv_cache_capacity = 0;
+        std::vector<float>().swap(k_cache);
+        std::vector<float>().swap(v_cache);
+    }
+
+    virtual int getKVCacheLength() const CV_OVERRIDE
+    {
+        return kv_cache_len;
+    }
+
+private:
+    // grows key/value cache ([B, N, capacity, H]) keeping the cached tokens
+    void reserveKVCache(int len, int batch_size)
+    {
+        if (kv_cache_len > 0)
+            CV_CheckEQ(cached_batch_size, batch_size, "DNN/AttentionInt8: batch size can't be changed with non-empty key/value cache");
+        cached_batch_size = batch_size;
+        if (len <= kv_cache_capacity)
+            return;
+        const int capacity = std::max(len, kv_cache_capacity * 2);
+        const size_t heads = (size_t)batch_size * num_heads;
+        std::vector<float>* caches[2] = {&k_cache, &v_cache};
+        for (int c = 0; c < 2; c++)
+        {
+            const size_t head_size = qkv_head_sizes[c + 1];
+            std::vector<float> buf(heads * capacity * head_size);
+            for (size_t i = 0; i < heads && kv_cache_len > 0; i++)
+                std::memcpy(buf.data() + i * capacity * head_size, caches[c]->data() + i * kv_cache_capacity * head_size,
+                            kv_cache_len * head_size * sizeof(float));
+            caches[c]->swap(buf);
+        }
+        kv_cache_capacity = capacity;
+    }
+
+    int num_heads;
+    int qkv_hidden_sizes[3];  // order: {qk_hidden_size, qk_hidden_size, v_hidden_size}
+    int qkv_head_sizes[3];
+    int hidden_size, input_hidden_size;
+    int output_ndims;
+    bool unidirectional;
+    float scale;
+
+    Mat packedWeights;
+    Mat qkv, attention;  // FP32 buffers
+
+    bool kv_cache_enabled;
+    int kv_cache_len;
+    int kv_cache_capacity;
+    int cached_batch_size;
+    std::vector<float> k_cache, v_cache;
+    FastGemmOpt opt;
+};
+
+Ptr<AttentionLayerInt8> AttentionLayerInt8::create(const LayerParams& params)
+{
+    return Ptr<AttentionLayerInt8>(new AttentionLayerInt8Impl(params));
+}
+
+}
+}
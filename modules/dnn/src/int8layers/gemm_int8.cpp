@@ -0,0 +1,74 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "../precomp.hpp"
+#include "gemm_int8.hpp"
+
+#include "gemm_int8_kernels.simd.hpp"
+#define CV_CPU_OPTIMIZATION_DECLARATIONS_ONLY
+#include "int8layers/gemm_int8_kernels.simd_declarations.hpp"
+#undef CV_CPU_OPTIMIZATION_DECLARATIONS_ONLY
+
+namespace cv
+{
+namespace dnn
+{
+
+void gemmInt8PackB(int N, int K, const int8_t* B, size_t ldb0, size_t ldb1, int8_t* packedB, int* sums)
+{
+    const size_t ldp = gemmInt8PackedStride(K);
+    for (int n = 0; n < N; n++)
+    {
+        int8_t* dst = packedB + n*ldp;
+        const int8_t* src = B + n*ldb1;
+        if (ldb0 == 1)
+            memcpy(dst, src, K);
+        else
+        {
+            for (int k = 0; k < K; k++)
+                dst[k] = src[k*ldb0];
+        }
+        memset(dst + K, 0, ldp - K);
+
+        if (sums)
+        {
+            int s = 0;
+            for (int k = 0; k < K; k++)
+                s += dst[k];
+            sums[n] = s;
+        }
+    }
+}
+
+void gemmInt8(int M, int N, int K, const int8_t* A, size_t lda, const int8_t* packedB,
+              const int* bias, const int* rowBias, const float* multiplier, int outZp,
+              int8_t* C, float* Cf, size_t ldc)
+{
+    CV_Assert(C || Cf);
+    const size_t ldp = gemmInt8PackedStride(K);
+#if CV_TRY_AVX512_SKX
+    if (checkHardwareSupport(CPU_AVX512_SKX))
+        opt_AVX512_SKX::gemmInt8Kernel(M, N, K, A, lda, packedB, ldp, bias, rowBias, multiplier, outZp, C, Cf, ldc);
+    else
+#endif
+#if CV_TRY_AVX2
+    if (checkHardwareSupport(CPU_AVX2))
+        opt_AVX2::gemmInt8Kernel(M, N, K, A, lda, packedB, ldp, bias, rowBias, multiplier, outZp, C, Cf, ldc);
+    else
+#endif
+#if CV_TRY_NEON_DOTPROD
+    if (checkHardwareSupport(CPU_NEON_DOTPROD))
+        opt_NEON_DOTPROD::gemmInt8Kernel(M, N, K, A, lda, packedB, ldp, bias, rowBias, multiplier, outZp, C, Cf, ldc);
+    else
+#endif
+#if CV_TRY_LASX
+    if (checkHardwareSupport(CPU_LASX))
+        opt_LASX::gemmInt8Kernel(M, N, K, A, lda, packedB, ldp, bias, rowBias, multiplier, outZp, C, Cf, ldc);
+    else
+#endif
+        cpu_baseline::gemmInt8Kernel(M, N, K, A, lda, packedB, ldp, bias, rowBias, multiplier, outZp, C, Cf, ldc);
+}
+
+}
+}
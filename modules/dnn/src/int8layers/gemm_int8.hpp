@@ -0,0 +1,26 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#ifndef OPENCV_DNN_GEMM_INT8_HPP
+#define OPENCV_DNN_GEMM_INT8_HPP
+
+#include <opencv2/core.hpp>
+
+namespace cv { namespace dnn {
+
+// Int8 matrix multiplication of MatMul, Gemm, Einsum and Attention layers: C = A*B^T, see gemm_int8_kernels.simd.hpp.
+// B is packed by rows of gemmInt8PackedStride(K) elements.
+enum { GEMM_INT8_KALIGN = 64 };
+static inline size_t gemmInt8PackedStride(int K) { return alignSize(K, GEMM_INT8_KALIGN); }
+
+// packs K x N matrix B (element (k, n) is B[k*ldb0 + n*ldb1]), sums of packed rows are optional
+void gemmInt8PackB(int N, int K, const int8_t* B, size_t ldb0, size_t ldb1, int8_t* packedB, int* sums);
+
+void gemmInt8(int M, int N, int K, const int8_t* A, size_t lda, const int8_t* packedB,
+              const int* bias, const int* rowBias, const float* multiplier, int outZp,
+              int8_t* C, float* Cf, size_t ldc);
+
+}} // cv::dnn
+
+#endif // OPENCV_DNN_GEMM_INT8_HPP
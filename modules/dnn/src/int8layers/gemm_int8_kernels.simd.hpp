@@ -0,0 +1,117 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "opencv2/core/hal/intrin.hpp"
+
+namespace cv {
+namespace dnn {
+CV_CPU_OPTIMIZATION_NAMESPACE_BEGIN
+
+// C = A*B^T with int32 accumulation followed by the output stage:
+//   C[m, n]  = saturate_cast<int8_t>(round((acc[m, n] + bias[n] + rowBias[m]) * multiplier[n]) + outZp), or
+//   Cf[m, n] = (acc[m, n] + bias[n] + rowBias[m]) * multiplier[n] if C is NULL.
+// B is packed by rows (ldp is K aligned by GEMM_INT8_KALIGN, the tail is filled with zeros), rowBias is optional.
+void gemmInt8Kernel(int M, int N, int K, const int8_t* A, size_t lda, const int8_t* packedB, size_t ldp,
+                    const int* bias, const int* rowBias, const float* multiplier, int outZp,
+                    int8_t* C, float* Cf, size_t ldc);
+
+#ifndef CV_CPU_OPTIMIZATION_DECLARATIONS_ONLY
+
+enum { GEMM_INT8_MR = 2, GEMM_INT8_NR = 4 };
+
+static inline void gemmInt8Store(int acc, int m, int n, const int* bias, const int* rowBias, const float* multiplier,
+                                 int outZp, int8_t* C, float* Cf, size_t ldc)
+{
+    float v = (float)(acc + bias[n] + (rowBias ? rowBias[m] : 0)) * multiplier[n];
+    if (C)
+        C[m*ldc + n] = saturate_cast<int8_t>(cvRound(v) + outZp);
+    else
+        Cf[m*ldc + n] = v;
+}
+
+void gemmInt8Kernel(int M, int N, int K, const int8_t* A, size_t lda, const int8_t* packedB, size_t ldp,
+                    const int* bias, const int* rowBias, const float* multiplier, int outZp,
+                    int8_t* C, float* Cf, size_t ldc)
+{
+    const int Kp = (int)ldp;
+    CV_Assert(K > 0 && Kp >= K);
+
+    // rows of A are copied into aligned buffers padded with zeros like rows of B
+    AutoBuffer<int8_t> abuf(Kp*GEMM_INT8_MR + CV_SIMD_WIDTH);
+    int8_t* arows = alignPtr(abuf.data(), CV_SIMD_WIDTH);
+    memset(arows, 0, Kp*GEMM_INT8_MR);
+
+    // block of B rows stays in L2 cache while all rows of A are processed
+    const int NB = std::max((int)GEMM_INT8_NR, (int)((1 << 17) / Kp) & ~(GEMM_INT8_NR - 1));
+    for (int n0 = 0; n0 < N; n0 += NB)
+    {
+        int n1 = std::min(N, n0 + NB);
+        for (int m = 0; m < M; m += GEMM_INT8_MR)
+        {
+            const int mr = std::min(M - m, (int)GEMM_INT8_MR);
+            const int8_t* a0 = arows;
+            const int8_t* a1 = mr > 1 ? arows + Kp : arows;
+            for (int i = 0; i < mr; i++)
+                memcpy(arows + i*Kp, A + (m + i)*lda, K);
+
+            for (int n = n0; n < n1; n += GEMM_INT8_NR)
+            {
+                const int nr = std::min(n1 - n, (int)GEMM_INT8_NR);
+                const int8_t* b0 = packedB + n*ldp;
+                const int8_t* b1 = nr > 1 ? b0 + ldp : b0;
+                const int8_t* b2 = nr > 2 ? b1 + ldp : b1;
+                const int8_t* b3 = nr > 3 ? b2 + ldp : b2;
+                int acc[GEMM_INT8_MR][GEMM_INT8_NR];
+                int k = 0;
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+                {
+                    const int nlanes = VTraits<v_int8>::vlanes();
+                    v_int32 s00 = vx_setzero_s32(), s01 = vx_setzero_s32(), s02 = vx_setzero_s32(), s03 = vx_setzero_s32();
+                    v_int32 s10 = vx_setzero_s32(), s11 = vx_setzero_s32(), s12 = vx_setzero_s32(), s13 = vx_setzero_s32();
+                    for (; k <= Kp - nlanes; k += nlanes)
+                    {
+                        v_int8 va0 = vx_load_aligned(a0 + k), va1 = vx_load_aligned(a1 + k);
+                        v_int8 vb = vx_load(b0 + k);
+                        s00 = v_dotprod_expand_fast(va0, vb, s00);
+                        s10 = v_dotprod_expand_fast(va1, vb, s10);
+                        vb = vx_load(b1 + k);
+                        s01 = v_dotprod_expand_fast(va0, vb, s01);
+                        s11 = v_dotprod_expand_fast(va1, vb, s11);
+                        vb = vx_load(b2 + k);
+                        s02 = v_dotprod_expand_fast(va0, vb, s02);
+                        s12 = v_dotprod_expand_fast(va1, vb, s12);
+                        vb = vx_load(b3 + k);
+                        s03 = v_dotprod_expand_fast(va0, vb, s03);
+                        s13 = v_dotprod_expand_fast(va1, vb, s13);
+                    }
+                    acc[0][0] = v_reduce_sum(s00); acc[0][1] = v_reduce_sum(s01);
+                    acc[0][2] = v_reduce_sum(s02); acc[0][3] = v_reduce_sum(s03);
+                    acc[1][0] = v_reduce_sum(s10); acc[1][1] = v_reduce_sum(s11);
+                    acc[1][2] = v_reduce_sum(s12); acc[1][3] = v_reduce_sum(s13);
+                }
+#else
+                for (int i = 0; i < GEMM_INT8_MR; i++)
+                    for (int j = 0; j < GEMM_INT8_NR; j++)
+                        acc[i][j] = 0;
+#endif
+                for (; k < K; k++)
+                {
+                    int w0 = b0[k], w1 = b1[k], w2 = b2[k], w3 = b3[k];
+                    int x0 = a0[k], x1 = a1[k];
+                    acc[0][0] += x0*w0; acc[0][1] += x0*w1; acc[0][2] += x0*w2; acc[0][3] += x0*w3;
+                    acc[1][0] += x1*w0; acc[1][1] += x1*w1; acc[1][2] += x1*w2; acc[1][3] += x1*w3;
+                }
+
+                for (int i = 0; i < mr; i++)
+                    for (int j = 0; j < nr; j++)
+                        gemmInt8Store(acc[i][j], m + i, n + j, bias, rowBias, multiplier, outZp, C, Cf, ldc);
+            }
+        }
+    }
+}
+
+#endif  // CV_CPU_OPTIMIZATION_DECLARATIONS_ONLY
+
+CV_CPU_OPTIMIZATION_NAMESPACE_END
+}}  // namespace cv::dnn
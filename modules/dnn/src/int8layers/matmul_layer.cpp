@@ -0,0 +1,219 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "../precomp.hpp"
+#include "layers_common.hpp"
+#include "gemm_int8.hpp"
+#include "../layers/cpu_kernels/fast_gemm.hpp"
+
+#include <opencv2/dnn/shape_utils.hpp>
+
+namespace cv
+{
+namespace dnn
+{
+
+// Y = A*B for int8 tensors with numpy.matmul broadcasting.
+// Constant B is stored as N x K int8 weights with bias and per-channel multipliers (see quantizeMatMulWeights()),
+// otherwise B is the second input with its own scale and zeropoint.
+class MatMulLayerInt8Impl CV_FINAL : public MatMulLayerInt8
+{
+public:
+    MatMulLayerInt8Impl(const LayerParams& params)
+    {
+        setParamsFrom(params);
+
+        input_sc = params.get<float>("input_scale");
+        input_zp = params.get<int>("input_zeropoint");
+        output_sc = params.get<float>("scales");
+        output_zp = params.get<int>("zeropoints");
+
+        if (!blobs.empty())
+        {
+            // blobs[0] - Weights (N x K)
+            // blobs[1] - Bias fused with offset
+            // blobs[2] - Multipliers for output stage
+            CV_Assert(blobs.size() == 3 && blobs[0].dims == 2 && blobs[0].type() == CV_8S);
+            int N = blobs[0].rows, K = blobs[0].cols;
+            CV_Assert(blobs[1].total() == (size_t)N && blobs[2].total() == (size_t)N);
+            trans_b = false;
+            input_b_sc = 1.f;
+            input_b_zp = 0;
+            multiplier = 1.f;  // per-channel multipliers are in blobs[2]
+
+            packedWeights.create(N, (int)gemmInt8PackedStride(K), CV_8S);
+            gemmInt8PackB(N, K, blobs[0].ptr<int8_t>(), 1, blobs[0].step1(), packedWeights.ptr<int8_t>(), NULL);
+            biasMat = blobs[1].reshape(1, 1);
+            outputMultiplier = blobs[2].reshape(1, 1);
+        }
+        else
+        {
+            trans_b = params.get<bool>("transB", false);
+            input_b_sc = params.get<float>("input_b_scale");
+            input_b_zp = params.get<int>("input_b_zeropoint");
+            multiplier = params.get<float>("alpha", 1.f) * input_sc * input_b_sc / output_sc;
+        }
+    }
+
+    virtual bool supportBackend(int backendId) CV_OVERRIDE
+    {
+        return backendId == DNN_BACKEND_OPENCV;
+    }
+
+    MatShape getShapeB(const std::vector<MatShape> &inputs) const
+    {
+        if (blobs.empty())
+        {
+            CV_CheckEQ(inputs.size(), (size_t)2, "DNN/MatMulInt8: two inputs are required");
+            return inputs[1];
+        }
+        CV_CheckEQ(inputs.size(), (size_t)1, "DNN/MatMulInt8: one input is required");
+        return MatShape{blobs[0].cols, blobs[0].rows};
+    }
+
+    virtual bool getMemoryShapes(const std::vector<MatShape> &inputs,
+                                 const int requiredOutputs,
+                                 std::vector<MatShape> &outputs,
+                                 std::vector<MatShape> &internals) const CV_OVERRIDE
+    {
+        const MatShape shape_A = inputs[0], shape_B = getShapeB(inputs);
+        CV_CheckGE(shape_A.size(), (size_t)2, "DNN/MatMulInt8: invalid shape of input A");
+        CV_CheckGE(shape_B.size(), (size_t)2, "DNN/MatMulInt8: invalid shape of input B");
+
+        int M = shape_A[shape_A.size() - 2], K = shape_A.back();
+        int K_B = trans_b ? shape_B.back() : shape_B[shape_B.size() - 2];
+        int N = trans_b ? shape_B[shape_B.size() - 2] : shape_B.back();
+        CV_CheckEQ(K, K_B, "DNN/MatMulInt8: invalid dimension K");
+
+        // broadcast batch dimensions
+        const MatShape& shape_more_dims = shape_A.size() >= shape_B.size() ? shape_A : shape_B;
+        const MatShape& shape_less_dims = shape_A.size() >= shape_B.size() ? shape_B : shape_A;
+        size_t diff_dims = shape_more_dims.size() - shape_less_dims.size();
+        MatShape common_shape = shape_more_dims;
+        for (size_t i = 0; i + 2 < shape_less_dims.size(); i++)
+        {
+            int dl = shape_less_dims[i], dm = shape_more_dims[i + diff_dims];
+            if (dl != 1 && dm != 1 && dl != dm)
+                CV_Error(Error::StsBadSize, "DNN/MatMulInt8: invalid shapes for broadcasting");
+            if (dm == 1)
+                common_shape[i + diff_dims] = dl;
+        }
+        common_shape[common_shape.size() - 2] = M;
+        common_shape[common_shape.size() - 1] = N;
+
+        outputs.assign(1, common_shape);
+        return false;
+    }
+
+    virtual void finalize(InputArrayOfArrays inputs_arr, OutputArrayOfArrays outputs_arr) CV_OVERRIDE
+    {
+        std::vector<Mat> inputs, outputs;
+        inputs_arr.getMatVector(inputs);
+        outputs_arr.getMatVector(outputs);
+
+        MatShape shape_B = blobs.empty() ? shape(inputs[1]) : getShapeB(std::vector<MatShape>(1, shape(inputs[0])));
+        helper.compute(false, trans_b, shape(inputs[0]), shape_B, shape(outputs[0]));
+    }
+
+    void forward(InputArrayOfArrays inputs_arr, OutputArrayOfArrays outputs_arr, OutputArrayOfArrays internals_arr) CV_OVERRIDE
+    {
+        CV_TRACE_FUNCTION();
+        CV_TRACE_ARG_VALUE(name, "name", name.c_str());
+
+        std::vector<Mat> inputs, outputs;
+        inputs_arr.getMatVector(inputs);
+        outputs_arr.getMatVector(outputs);
+
+        const Mat& A = inputs[0];
+        Mat& Y = outputs[0];
+        CV_Assert(A.type() == CV_8S && Y.type() == CV_8S && A.isContinuous() && Y.isContinuous());
+
+        const int M = helper.M, N = helper.N, K = helper.K;
+        const size_t ldp = gemmInt8PackedStride(K);
+        const size_t batch = helper.batch;
+
+        // variable B: pack all the matrices of B, fold zeropoints into per-matrix bias
+        // sum((a - za)*(b - zb)) = sum(a*b) - za*sum(b) - zb*sum(a) + K*za*zb
+        const int8_t* packedB = packedWeights.ptr<int8_t>();
+        const int* bias = biasMat.ptr<int>();
+        const float* mult = outputMultiplier.ptr<float>();
+        std::vector<size_t> packedOffsets(batch, 0), biasOffsets(batch, 0);
+        if (blobs.empty())
+        {
+            const Mat& B = inputs[1];
+            CV_Assert(B.type() == CV_8S && B.isContinuous());
+            const int numB = (int)(B.total() / ((size_t)N*K));
+            packedBuf.resize(numB*N*ldp);
+            biasBuf.resize((size_t)numB*N);
+            multBuf.assign(N, multiplier);
+            parallel_for_(Range(0, numB), [&](const Range& r) {
+                for (int i = r.start; i < r.end; i++)
+                {
+                    int* sums = &biasBuf[(size_t)i*N];
+                    gemmInt8PackB(N, K, B.ptr<int8_t>() + (size_t)i*N*K, helper.ldb0, helper.ldb1,
+                                  &packedBuf[i*N*ldp], sums);
+                    for (int n = 0; n < N; n++)
+                        sums[n] = K*input_zp*input_b_zp - input_zp*sums[n];
+                }
+            });
+            for (size_t b = 0; b < batch; b++)
+            {
+                packedOffsets[b] = helper.B_rows[b]*N*ldp;
+                biasOffsets[b] = helper.B_rows[b]*N;
+            }
+            packedB = packedBuf.data();
+            bias = biasBuf.data();
+            mult = multBuf.data();
+        }
+
+        const int8_t* a = A.ptr<int8_t>();
+        int8_t* y = Y.ptr<int8_t>();
+        const int MB = 16;
+        const int mblocks = (M + MB - 1) / MB;
+        const bool varB = blobs.empty() && input_b_zp != 0;
+        double nstripes = (double)batch*M*N*K*(1 / 65536.0);
+        parallel_for_(Range(0, (int)batch*mblocks), [&](const Range& r) {
+            int rowBias[MB];
+            for (int task = r.start; task < r.end; task++)
+            {
+                int b = task / mblocks, m0 = (task % mblocks)*MB, m1 = std::min(m0 + MB, M);
+                const int8_t* aptr = a + helper.A_offsets[b] + (size_t)m0*K;
+                if (varB)
+                {
+                    for (int m = m0; m < m1; m++)
+                    {
+                        const int8_t* arow = aptr + (size_t)(m - m0)*K;
+                        int s = 0;
+                        for (int k = 0; k < K; k++)
+                            s += arow[k];
+                        rowBias[m - m0] = -input_b_zp*s;
+                    }
+                }
+                gemmInt8(m1 - m0, N, K, aptr, K, packedB + packedOffsets[b], bias + biasOffsets[b],
+                         varB ? rowBias : NULL, mult, output_zp,
+                         y + helper.C_offsets[b] + (size_t)m0*N, NULL, N);
+            }
+        }, nstripes);
+    }
+
+private:
+    bool trans_b;
+    float input_b_sc;
+    int input_b_zp;
+    float multiplier;
+
+    Mat packedWeights, biasMat, outputMultiplier;
+    std::vector<int8_t> packedBuf;
+    std::vector<int> biasBuf;
+    std::vector<float> multBuf;
+    MatMulHelper helper;
+};
+
+Ptr<MatMulLayerInt8> MatMulLayerInt8::create(const LayerParams& params)
+{
+    return Ptr<MatMulLayerInt8>(new MatMulLayerInt8Impl(params));
+}
+
+}
+}
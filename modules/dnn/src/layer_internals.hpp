@@ -93,6 +93,8 @@ struct LayerData
     std::map<int, Ptr<BackendNode>> backendNodes;
     // Flag for skip layer computation for specific backend.
     bool skip;
+    // Fused element-wise layers which are computed instead of layerInstance (OpenCV/CPU)
+    Ptr<Layer> elementwiseChain;
 
     int flag;
 
@@ -114,6 +116,7 @@ struct LayerData
         backendNodes.clear();
 
         skip = false;
+        elementwiseChain.release();
         flag = 0;
 
 #ifdef HAVE_CUDA
@@ -3,8 +3,10 @@
 // of this distribution and at http://opencv.org/license.html.
 
 #include "../precomp.hpp"
+#include "layers_common.hpp"
 #include "cpu_kernels/fast_gemm.hpp"
-#include "cpu_kernels/softmax.hpp"
+#include "cpu_kernels/flash_attention.hpp"
+#include "cpu_kernels/reduced_precision.hpp"
 
 #include <opencv2/dnn/shape_utils.hpp>
 
@@ -51,8 +53,14 @@ class AttentionLayerImpl CV_FINAL : public AttentionLayer {
         scale = 1.f / params.get<float>("scale", sqrt(qkv_head_sizes[0]));
 
         output_ndims = params.get<int>("output_ndims", 3);
+        unidirectional = params.get<int>("unidirectional", 0) != 0;
 
         is_prepacked = false;
+        kv_cache_enabled = false;
+        kv_cache_len = 0;
+        kv_cache_capacity = 0;
+        cached_batch_size = 0;
+        weights_precision = REDUCED_PRECISION_NONE;
     }
 
     virtual bool supportBackend(int backendId) CV_OVERRIDE {
@@ -84,17 +92,11 @@ class AttentionLayerImpl CV_FINAL : public AttentionLayer {
             CV_Error(Error::StsBadArg, format("DNN/Attention: invalid output dimension %zu, valid value is 2 or 3", output_ndims));
         }
 
+        // Q/K/V buffer, attention itself doesn't need seq_len x seq_len buffer
         const int batch_size_ = input_shape[0], seq_len_ = input_shape[1],
-                  hidden_size_ = weight_shape.back(),
-                  num_heads_ = static_cast<int>(num_heads),
-                  v_head_size_ = static_cast<int>((hidden_size_ - qkv_hidden_sizes[0] - qkv_hidden_sizes[1]) / num_heads);
-
-        MatShape gemm_buffer_shape{batch_size_, seq_len_, hidden_size_},
-                 attention_prob_shape{batch_size_ * num_heads_, seq_len_, seq_len_},
-                 output_buffer_shape{batch_size_ * num_heads_, seq_len_, v_head_size_};
+                  hidden_size_ = weight_shape.back();
+        MatShape gemm_buffer_shape{batch_size_, seq_len_, hidden_size_};
         internals.assign(1, gemm_buffer_shape);
-        internals.push_back(attention_prob_shape);
-        internals.push_back(output_buffer_shape);
 
         return false;
     }
@@ -139,11 +141,33 @@ class AttentionLayerImpl CV_FINAL : public AttentionLayer {
             packWeight(num_heads, qkv_head_sizes[1], input_hidden_size, weight_data + qkv_hidden_sizes[0],                       hidden_size, packed_weight_k, opt);
             packWeight(num_heads, qkv_head_sizes[2], input_hidden_size, weight_data + qkv_hidden_sizes[0] + qkv_hidden_sizes[1], hidden_size, packed_weight_v, opt);
 
+            // DNN_TARGET_CPU_FP16: keep packed weights in 16-bit format
+            weights_precision = preferableTarget == DNN_TARGET_CPU_FP16 ? getReducedPrecisionWeightsType() : (int)REDUCED_PRECISION_NONE;
+            if (weights_precision != REDUCED_PRECISION_NONE) {
+                std::vector<float> *packed[3] = {&packed_weight_q, &packed_weight_k, &packed_weight_v};
+                for (int i = 0; i < 3; i++) {
+                    packed_weight_reduced[i].resize(packed[i]->size());
+                    packReducedPrecision(packed[i]->data(), packed_weight_reduced[i].data(), packed[i]->size(), weights_precision);
+                    std::vector<float>().swap(*packed[i]);
+                }
+            }
+
             is_prepacked = true;
         }
 
+        const bool reduced = weights_precision != REDUCED_PRECISION_NONE;
         float *packed_weights[3] = {packed_weight_q.data(), packed_weight_k.data(), packed_weight_v.data()};
         size_t packed_weights_size[3] = {packed_weight_q.size() / num_heads, packed_weight_k.size() / num_heads, packed_weight_v.size() / num_heads};
+        if (reduced) {
+            for (int i = 0; i < 3; i++)
+                packed_weights_size[i] = packed_weight_reduced[i].size() / num_heads;
+        }
+
+        // Keys and values of new tokens are appended to the cache if it is enabled
+        const size_t past_len = kv_cache_enabled ? kv_cache_len : 0;
+        const size_t total_len = past_len + seq_len;
+        if (kv_cache_enabled)
+            reserveKVCache(total_len);
 
         // Compute Q/K/V
         auto &gemm_buffer = internals[0];
@@ -151,6 +175,14 @@ class AttentionLayerImpl CV_FINAL : public AttentionLayer {
         auto *K = Q + batch_size * seq_len * qkv_hidden_sizes[0];
         auto *V = K + batch_size * seq_len * qkv_hidden_sizes[1];
         float *QKV[3] = {Q, K, V}; // Q, K, V: [B, N, S, H]
+        size_t kv_len = seq_len;   // rows of K and V for each head
+        size_t kv_offset = 0;      // first row of the new tokens
+        if (kv_cache_enabled) {
+            QKV[1] = k_cache.data();
+            QKV[2] = v_cache.data();
+            kv_len = kv_cache_capacity;
+            kv_offset = past_len;
+        }
         {
             const auto &input = inputs[0];
             const auto &bias = inputs[2];
@@ -169,7 +201,8 @@ class AttentionLayerImpl CV_FINAL : public AttentionLayer {
 
                     int input_offset = batch_index * seq_len * input_hidden_size;
                     int bias_offset = qkv_index * qkv_hidden_sizes[0] + head_index * head_size;
-                    int dst_offset = (batch_index * num_heads + head_index) * (seq_len * head_size);
+                    size_t rows = qkv_index == 0 ? seq_len : kv_len;
+                    size_t dst_offset = ((batch_index * num_heads + head_index) * rows + (qkv_index == 0 ? 0 : kv_offset)) * head_size;
 
                     // broadcast bias ([NH] -> [BN, SH]) and make copy to dst
                     const auto *bias_data_src = bias_data + bias_offset;
@@ -179,11 +212,18 @@ class AttentionLayerImpl CV_FINAL : public AttentionLayer {
                         dst_data += head_size;
                     }
 
-                    auto *packed_weight = packed_weights[qkv_index] + packed_weights_size[qkv_index] * head_index;
                     // single-thread gemm kernel
-                    fastGemm(false, seq_len, head_size, input_hidden_size,
-                            1.f, input_data + input_offset, input_hidden_size,
-                            packed_weight, 1.f, dst + dst_offset, head_size, opt);
+                    if (reduced) {
+                        const ushort *packed_weight = packed_weight_reduced[qkv_index].data() + packed_weights_size[qkv_index] * head_index;
+                        fastGemm(false, seq_len, head_size, input_hidden_size,
+                                1.f, input_data + input_offset, input_hidden_size,
+                                packed_weight, weights_precision, 1.f, dst + dst_offset, head_size, opt);
+                    } else {
+                        auto *packed_weight = packed_weights[qkv_index] + packed_weights_size[qkv_index] * head_index;
+                        fastGemm(false, seq_len, head_size, input_hidden_size,
+                                1.f, input_data + input_offset, input_hidden_size,
+                                packed_weight, 1.f, dst + dst_offset, head_size, opt);
+                    }
                 }
             };
 
@@ -191,74 +231,90 @@ class AttentionLayerImpl CV_FINAL : public AttentionLayer {
             double nstripes = loops * seq_len * qkv_head_sizes[0] * input_hidden_size * (1 / 1024.0);
             parallel_for_(Range(0, loops), fn, nstripes);
         }
+        if (kv_cache_enabled)
+            kv_cache_len = total_len;
 
-        // Compute Softmax(scale * MatMul(Q, K))
-        auto &attention_prob = internals[1];
-        {
-            auto *output = attention_prob.ptr<float>();
-
-            auto loops = batch_size * num_heads;
-            auto seq_len_square = seq_len * seq_len;
-            auto qk_head_size = qkv_head_sizes[0];
-            auto qk_inner_size = seq_len * qk_head_size;
-
-            // Compute scale * matmul(Q, K)
-            opt.multi_thread = false;
-            parallel_for_(Range(0, loops), [&] (const Range r) {
-                for (int i = r.start; i < r.end; i++) {
-                    const int output_offset = i * seq_len_square;
-
-                    const auto *q = Q + qk_inner_size * i, *k = K + qk_inner_size * i;
-                    fastGemm(false, true, seq_len, qk_head_size, seq_len, qk_head_size,
-                             scale, q, qk_head_size, 1,
-                             k, qk_head_size, 1, 0.f,
-                             output + output_offset, seq_len, opt);
-                }
-            }, loops * seq_len * qk_head_size * seq_len * (1 / 1024.0));
-
-            // Compute softmax on the last dimension
-            softmax(attention_prob, attention_prob, shape(attention_prob).size() - 1);
-        }
-
-        // Compute MatMul(attention_prob, V)
-        auto &output_buffer = internals[2];
+        // Compute Softmax(scale * MatMul(Q, K)) * V by fused kernel, output heads are written in place: [B, S, N*H]
         {
             auto *output = outputs[0].ptr<float>();
-            auto *output_buff = output_buffer.ptr<float>();
-            const auto *prob = attention_prob.ptr<const float>();
 
             auto loops = batch_size * num_heads;
-            auto prob_inner_size = seq_len * seq_len;
+            auto qk_head_size = qkv_head_sizes[0];
             auto v_head_size = qkv_head_sizes[2];
-            auto v_inner_size = seq_len * v_head_size;
+            const int causal_offset = unidirectional ? static_cast<int>(past_len) : -1;
 
             opt.multi_thread = false;
             parallel_for_(Range(0, loops), [&] (const Range &r) {
                 for (int i = r.start; i < r.end; i++) {
-                    const int output_offset = i * v_inner_size;
-
-                    const auto *p = prob + i * prob_inner_size, *v = V + i * v_inner_size;
-                    fastGemm(false, false, seq_len, seq_len, seq_len, v_head_size,
-                             1.f, p, seq_len, 1,
-                             v, v_head_size, 1, 0.f,
-                             output_buff + output_offset, v_head_size, opt);
-
-                    // tranpose on the fly
                     const int batch_index = static_cast<int>(i / num_heads);
                     const int head_index = static_cast<int>(i % num_heads);
-                    auto *src = output_buff + output_offset;
+                    const auto *q = QKV[0] + i * seq_len * qk_head_size;
+                    const auto *k = QKV[1] + i * kv_len * qk_head_size;
+                    const auto *v = QKV[2] + i * kv_len * v_head_size;
                     auto *dst = output + (batch_index * seq_len * num_heads + head_index) * v_head_size;
-                    for (int j = 0; j < seq_len; j++) {
-                        std::memcpy(dst, src, v_head_size * sizeof(float));
-                        src += v_head_size;
-                        dst += qkv_hidden_sizes[2];
-                    }
+                    flashAttention(seq_len, total_len, qk_head_size, v_head_size, scale,
+                                   q, qk_head_size, k, qk_head_size, v, v_head_size,
+                                   dst, qkv_hidden_sizes[2], causal_offset, opt);
                 }
-            }, loops * seq_len * seq_len * v_head_size * (1 / 1024.0));
+            }, loops * seq_len * total_len * (qk_head_size + v_head_size) * (1 / 1024.0));
         }
     }
 
+    virtual void setKVCacheEnabled(bool enabled) CV_OVERRIDE {
+        kv_cache_enabled = enabled;
+        resetKVCache();
+    }
+
+    virtual void resetKVCache() CV_OVERRIDE {
+        kv_cache_len = 0;
+        kv_cache_capacity = 0;
+        std::vector<float>().swap(k_cache);
+        std::vector<float>().swap(v_cache);
+    }
+
+    virtual int getKVCacheLength() const CV_OVERRIDE {
+        return static_cast<int>(kv_cache_len);
+    }
+
+    virtual bool tryQuantize(const std::vector<std::vector<float> > &scales,
+                             const std::vector<std::vector<int> > &zeropoints, LayerParams& params) CV_OVERRIDE
+    {
+        // weight and bias are constant inputs, the QKV projection is dequantized (output scale is 1)
+        Mat weight = getQuantizationConstInput(params, 1), bias = getQuantizationConstInput(params, 2);
+        if (weight.empty() || bias.empty() || weight.dims != 2 || weight.type() != CV_32F || bias.type() != CV_32F)
+            return false;
+
+        float inputScale = scales[0][0];
+        int inputZp = zeropoints[0][0];
+        quantizeMatMulWeights(weight, false, bias, 1.f, inputScale, inputZp, 1.f,
+                              params.get<bool>("per_channel", true), params.blobs);
+        params.set("input_scale", inputScale);
+        params.set("input_zeropoint", inputZp);
+        return true;
+    }
+
  private:
+    // grows key/value cache ([B, N, capacity, H]) keeping the cached tokens
+    void reserveKVCache(size_t len) {
+        if (kv_cache_len > 0)
+            CV_CheckEQ(cached_batch_size, batch_size, "DNN/Attention: batch size can't be changed with non-empty key/value cache");
+        cached_batch_size = batch_size;
+        if (len <= kv_cache_capacity)
+            return;
+        size_t capacity = std::max(len, kv_cache_capacity * 2);
+        const size_t heads = batch_size * num_heads;
+        std::vector<float> *caches[2] = {&k_cache, &v_cache};
+        for (int c = 0; c < 2; c++) {
+            const size_t head_size = qkv_head_sizes[c + 1];
+            std::vector<float> buf(heads * capacity * head_size);
+            for (size_t i = 0; i < heads && kv_cache_len > 0; i++)
+                std::memcpy(buf.data() + i * capacity * head_size, caches[c]->data() + i * kv_cache_capacity * head_size,
+                            kv_cache_len * head_size * sizeof(float));
+            caches[c]->swap(buf);
+        }
+        kv_cache_capacity = capacity;
+    }
+
     size_t num_heads;
     std::vector<size_t> qkv_hidden_sizes; // order: {qk_hidden_size, qk_hidden_size, v_hidden_size}
     float scale;
@@ -275,6 +331,15 @@ class AttentionLayerImpl CV_FINAL : public AttentionLayer {
     std::vector<float> packed_weight_q;
     std::vector<float> packed_weight_k;
     std::vector<float> packed_weight_v;
+    std::vector<ushort> packed_weight_reduced[3];  // DNN_TARGET_CPU_FP16
+    int weights_precision;
+
+    bool unidirectional;
+    bool kv_cache_enabled;
+    size_t kv_cache_len;
+    size_t kv_cache_capacity;
+    size_t cached_batch_size;
+    std::vector<float> k_cache, v_cache;
 
     FastGemmOpt opt;
 };
@@ -283,4 +348,8 @@ Ptr<AttentionLayer> AttentionLayer::create(const LayerParams &params) {
     return makePtr<AttentionLayerImpl>(params);
 }
 
+void AttentionLayer::setKVCacheEnabled(bool) {}
+void AttentionLayer::resetKVCache() {}
+int AttentionLayer::getKVCacheLength() const { return 0; }
+
 }} // cv::dnn
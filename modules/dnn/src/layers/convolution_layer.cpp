@@ -70,6 +70,8 @@ using namespace cv::dnn::cuda4dnn;
 #endif
 
 #include "cpu_kernels/convolution.hpp"
+#include "cpu_kernels/shared_weights.hpp"
+#include "cpu_kernels/reduced_precision.hpp"
 
 namespace cv
 {
@@ -243,7 +245,7 @@ public:
 
 
 //TODO: simultaneously convolution and bias addition for cache optimization
-class ConvolutionLayerImpl CV_FINAL : public BaseConvolutionLayerImpl
+class ConvolutionLayerImpl CV_FINAL : public BaseConvolutionLayerImpl, public KernelInfo
 {
 public:
     enum { VEC_ALIGN = 8, DFT_TYPE = CV_32F };
@@ -1296,15 +1298,53 @@ public:
                 bool canUseWinograd = useWinograd && conv_dim == CONV_2D && inputs[0].size[2] >= 12 && inputs[0].size[3] >= 12;
 
                 CV_Assert(outputs[0].size[1] % ngroups == 0);
-                fastConvImpl = initFastConv(weightsMat, &biasvec[0], ngroups, K, C, kernel_size, strides,
-                                            dilations, pads_begin, pads_end, conv_dim,
-                                            preferableTarget == DNN_TARGET_CPU_FP16, canUseWinograd);
+                const bool useFP16 = preferableTarget == DNN_TARGET_CPU_FP16;
+                auto createFastConv = [&]() {
+                    return initFastConv(weightsMat, &biasvec[0], ngroups, K, C, kernel_size, strides,
+                                        dilations, pads_begin, pads_end, conv_dim,
+                                        useFP16, canUseWinograd);
+                };
+                if (variableWeight)
+                    fastConvImpl = createFastConv();
+                else
+                {
+                    // packed weights are shared with the same layers of other Net instances
+                    SharedWeightsKey key("FastConv");
+                    key.add(weightsMat).add(&biasvec[0], outCn).add(ngroups).add(K).add(C)
+                       .add(kernel_size).add(strides).add(dilations).add(pads_begin).add(pads_end)
+                       .add(conv_dim).add(useFP16).add(canUseWinograd);
+                    if (useFP16)
+                        key.add(getReducedPrecisionWeightsType());  // FP16 or BF16 weights storage
+                    fastConvImpl = getSharedWeights<FastConv>(key, createFastConv, [&](const FastConv& conv) {
+                        return checkFastConv(conv, ngroups, K, C, kernel_size, strides, dilations, pads_begin, pads_end,
+                                             conv_dim, useFP16, canUseWinograd);
+                    });
+                }
             }
 
             runFastConv(inputs[0], outputs[0], fastConvImpl, nstripes, activ, reluslope, fusedAdd);
         }
     }
 
+    String getKernelInfo() const CV_OVERRIDE
+    {
+        if (!fastConvImpl)
+            return String();
+        const FastConv& conv = *fastConvImpl;
+        String kind = conv.conv_type == CONV_TYPE_WINOGRAD3X3 ? "winograd_f63" :
+                      conv.conv_type == CONV_TYPE_DEPTHWISE ? "depthwise_3x3" :
+                      conv.conv_type == CONV_TYPE_DEPTHWISE_REMAIN ? "depthwise" : "generic";
+        if (conv.conv_dim != CONV_2D)
+            kind += conv.conv_dim == CONV_1D ? "_1d" : "_3d";
+        if (conv.useFP16)
+            kind += "_fp16";
+        else if (conv.weightsPrecision != 0)
+            kind += "_16bit_weights";
+        const char* isa = conv.useAVX2 ? "AVX2" : conv.useAVX ? "AVX" : conv.useNEON ? "NEON" :
+                          conv.useRVV ? "RVV" : conv.useSIMD128 ? "SIMD128" : "scalar";
+        return kind + " " + isa;
+    }
+
 #ifdef HAVE_CUDA
     Ptr<BackendNode> initCUDA(
         void *context_,
@@ -11,6 +11,7 @@
 
 #include "../../precomp.hpp"
 #include "convolution.hpp"
+#include "reduced_precision.hpp"
 
 #include "conv_block.simd.hpp"
 #include "layers/cpu_kernels/conv_block.simd_declarations.hpp" // defines CV_CPU_DISPATCH_MODES_ALL=AVX2,...,BASELINE based on CMakeLists.txt content
@@ -84,9 +85,159 @@ float16_t* FastConv::getWeightsWinoFP16()
     return alignPtr(weightsWinoBuf_FP16.data(), VEC_ALIGN);
 }
 
-Ptr<FastConv> initFastConv(
-        InputArray _weightsMat,
-        float* srcBias,
+// Buffers accessed through alignPtr() (getWeights() etc.) are stored from the aligned position
+template<typename T> static
+Mat alignedBufferToMat(const std::vector<T>& buf, int type)
+{
+    if (buf.empty())
+        return Mat();
+    const T* data = alignPtr(buf.data(), VEC_ALIGN);
+    const size_t count = buf.size() - (data - buf.data());
+    CV_Assert(count <= (size_t)INT_MAX);
+    return Mat(1, (int)count, type, (void*)data);
+}
+
+template<typename T> static
+void matToAlignedBuffer(const Mat& m, std::vector<T>& buf)
+{
+    buf.clear();
+    if (m.empty())
+        return;
+    CV_Assert(m.isContinuous() && m.elemSize() == sizeof(T));
+    buf.resize(m.total() + VEC_ALIGN);
+    memcpy(alignPtr(buf.data(), VEC_ALIGN), m.data, m.total() * sizeof(T));
+}
+
+template<typename T> static
+Mat bufferToMat(const std::vector<T>& buf, int type)
+{
+    CV_Assert(buf.size() <= (size_t)INT_MAX);
+    return buf.empty() ? Mat() : Mat(1, (int)buf.size(), type, (void*)buf.data());
+}
+
+template<typename T> static
+void matToBuffer(const Mat& m, std::vector<T>& buf)
+{
+    buf.clear();
+    if (m.empty())
+        return;
+    CV_Assert(m.isContinuous() && m.elemSize() == sizeof(T));
+    buf.assign(m.ptr<T>(), m.ptr<T>() + m.total());
+}
+
+void serializeFastConv(const FastConv& conv, std::vector<int>& params, std::vector<Mat>& buffers)
+{
+    const int values[] = {
+        conv.ngroups, conv.K, conv.C, conv.Hk, conv.Wk, conv.Dk,
+        conv.stride_h, conv.stride_w, conv.stride_d, conv.dilation_h, conv.dilation_w, conv.dilation_d,
+        conv.pad_top, conv.pad_bottom, conv.pad_left, conv.pad_right, conv.pad_front, conv.pad_behind,
+        conv.weightsPrecision, conv.conv_type, conv.conv_dim, conv.useFP16,
+        CONV_MR_FP32, CONV_NR_FP32  // packing layout
+    };
+    params.assign(values, values + sizeof(values) / sizeof(values[0]));
+    buffers.clear();
+    buffers.push_back(alignedBufferToMat(conv.weightsBuf, CV_32F));
+    buffers.push_back(alignedBufferToMat(conv.weightsWinoBuf, CV_32F));
+    buffers.push_back(bufferToMat(conv.biasBuf, CV_32F));
+    buffers.push_back(alignedBufferToMat(conv.weightsBuf_FP16, CV_16F));
+    buffers.push_back(alignedBufferToMat(conv.weightsWinoBuf_FP16, CV_16F));
+    buffers.push_back(bufferToMat(conv.weightsBuf_RP, CV_16U));
+}
+
+// Sizes of the buffers of packed weights in elements (in order of serializeFastConv()), without alignment padding
+static void getFastConvBufferSizes(const FastConv& conv, size_t sizes[6])
+{
+    for (int i = 0; i < 6; i++)
+        sizes[i] = 0;
+    const size_t K = conv.K, C = conv.C, ngroups = conv.ngroups;
+    const size_t karea = (size_t)conv.Hk * conv.Wk * conv.Dk;
+    if (conv.conv_type == CONV_TYPE_DEPTHWISE || conv.conv_type == CONV_TYPE_DEPTHWISE_REMAIN)
+        sizes[conv.useFP16 ? 3 : 0] = C * alignSize(karea, VEC_ALIGN);
+    else if (conv.conv_type == CONV_TYPE_WINOGRAD3X3)
+    {
+        const size_t CONV_WINO_KBLOCK = 4;
+        const size_t Kg_nblocks = (K / ngroups + CONV_WINO_KBLOCK - 1) / CONV_WINO_KBLOCK;
+        sizes[conv.useFP16 ? 4 : 1] = ngroups * Kg_nblocks * (C / ngroups) * CONV_WINO_KBLOCK * CONV_WINO_AREA;
+    }
+    else if (conv.conv_type == CONV_TYPE_GENERIC)
+    {
+        const size_t Kg = K / ngroups, DkHkWkCg = karea * std::max(C / ngroups, (size_t)1);
+#ifdef CONV_ARM_FP16
+        if (conv.useFP16)
+            sizes[3] = ngroups * alignSize(Kg, CONV_MR_FP16) * DkHkWkCg;
+        else
+#endif
+        sizes[conv.weightsPrecision != REDUCED_PRECISION_NONE ? 5 : 0] = ngroups * alignSize(Kg, CONV_MR_FP32) * DkHkWkCg;
+    }
+    sizes[2] = K + VEC_ALIGN;
+}
+
+Ptr<FastConv> deserializeFastConv(const std::vector<int>& params, const std::vector<Mat>& buffers)
+{
+    if (params.size() != 24 || buffers.size() != 6)
+        CV_Error(Error::StsParseError, "DNN: invalid serialized FastConv");
+    if (params[22] != CONV_MR_FP32 || params[23] != CONV_NR_FP32)
+        CV_Error(Error::StsNotImplemented, "DNN: serialized FastConv has another packing layout");
+    Ptr<FastConv> conv = makePtr<FastConv>();
+    int i = 0;
+    conv->ngroups = params[i++]; conv->K = params[i++]; conv->C = params[i++];
+    conv->Hk = params[i++]; conv->Wk = params[i++]; conv->Dk = params[i++];
+    conv->stride_h = params[i++]; conv->stride_w = params[i++]; conv->stride_d = params[i++];
+    conv->dilation_h = params[i++]; conv->dilation_w = params[i++]; conv->dilation_d = params[i++];
+    conv->pad_top = params[i++]; conv->pad_bottom = params[i++]; conv->pad_left = params[i++];
+    conv->pad_right = params[i++]; conv->pad_front = params[i++]; conv->pad_behind = params[i++];
+    conv->weightsPrecision = params[i++];
+    conv->conv_type = params[i++];
+    conv->conv_dim = params[i++];
+    conv->useFP16 = params[i++] != 0;
+
+    bool valid = conv->ngroups > 0 && conv->K > 0 && conv->C > 0 && conv->K % conv->ngroups == 0 &&
+                 conv->Hk > 0 && conv->Wk > 0 && conv->Dk > 0 &&
+                 conv->stride_h >= 0 && conv->stride_w > 0 && conv->stride_d >= 0 &&
+                 conv->dilation_h > 0 && conv->dilation_w > 0 && conv->dilation_d > 0 &&
+                 conv->pad_top >= 0 && conv->pad_bottom >= 0 && conv->pad_left >= 0 &&
+                 conv->pad_right >= 0 && conv->pad_front >= 0 && conv->pad_behind >= 0 &&
+                 conv->weightsPrecision >= REDUCED_PRECISION_NONE && conv->weightsPrecision <= REDUCED_PRECISION_BF16 &&
+                 conv->conv_type >= CONV_TYPE_GENERIC && conv->conv_type <= CONV_TYPE_DEPTHWISE_REMAIN &&
+                 conv->conv_dim >= CONV_1D && conv->conv_dim <= CONV_3D &&
+                 // sizes of the packed weights don't overflow
+                 (double)conv->K * conv->C * conv->Hk * conv->Wk * conv->Dk <= (double)(1ull << 48);
+#ifndef CONV_ARM_FP16
+    valid = valid && !conv->useFP16;
+#endif
+    if (!valid)
+        CV_Error(Error::StsParseError, "DNN: invalid parameters of serialized FastConv");
+
+    // the buffers must hold the packed weights of the convolution with these parameters
+    size_t sizes[6];
+    getFastConvBufferSizes(*conv, sizes);
+    const int types[6] = { CV_32F, CV_32F, CV_32F, CV_16F, CV_16F, CV_16U };
+    const bool aligned[6] = { true, true, false, true, true, false };
+    for (int j = 0; j < 6; j++)
+    {
+        const Mat& m = buffers[j];
+        const size_t count = m.empty() ? 0 : m.total();
+        valid = m.empty() || (m.type() == types[j] && m.isContinuous());
+        if (aligned[j] && sizes[j] > 0)
+            valid = valid && count >= sizes[j] && count <= sizes[j] + VEC_ALIGN;
+        else
+            valid = valid && count == sizes[j];
+        if (!valid)
+            CV_Error(Error::StsParseError, cv::format("DNN: invalid size of buffer %d of serialized FastConv", j));
+    }
+
+    matToAlignedBuffer(buffers[0], conv->weightsBuf);
+    matToAlignedBuffer(buffers[1], conv->weightsWinoBuf);
+    matToBuffer(buffers[2], conv->biasBuf);
+    matToAlignedBuffer(buffers[3], conv->weightsBuf_FP16);
+    matToAlignedBuffer(buffers[4], conv->weightsWinoBuf_FP16);
+    matToBuffer(buffers[5], conv->weightsBuf_RP);
+    return conv;
+}
+
+// Sets parameters of the convolution and selects the kind of packing, the weights are not packed
+static void initFastConvLayout(
+        FastConv* conv,
         int ngroups,
         int K, int C,
         const std::vector<size_t>& kernel_size,
@@ -98,14 +249,12 @@ Ptr<FastConv> initFastConv(
         const bool _useFP16,
         bool useWinograd)
 {
-    Ptr<FastConv> conv = makePtr<FastConv>();
     CV_Assert(ngroups > 0 && K > 0 && C > 0 && K % ngroups == 0);
 
     // Weight shape, [K, C, Dk, Hk, Wk] for Conv3D, [K, C, Hk, Wk] for Conv2D, [K, C, Wk] for Conv1D.
     int Dk = conv_dim == CONV_3D ? (int)kernel_size[0] : 1;
     int Hk = conv_dim == CONV_1D ? 1 : (int)kernel_size[kernel_size.size() - 2];
     int Wk = (int)kernel_size.back();
-    int karea = Wk*Hk*Dk;
 
     conv->pad_front = conv_dim == CONV_3D ? (int)pads_begin[0] : 0;
     conv->pad_top = conv_dim == CONV_1D ? 0 : (int)pads_begin[pads_begin.size() - 2];
@@ -174,10 +323,6 @@ Ptr<FastConv> initFastConv(
         conv->conv_type = CONV_TYPE_GENERIC;
 #endif
 
-    Mat weightsMat = _weightsMat.getMat();
-    auto wShape = shape(weightsMat);
-    const size_t wstep = weightsMat.step1();
-
     conv->useFP16 = false;
 #ifdef CONV_ARM_FP16
     if (_useFP16 && (conv->conv_type == CONV_TYPE_GENERIC || conv->conv_type == CONV_TYPE_DEPTHWISE_REMAIN
@@ -192,6 +337,36 @@ Ptr<FastConv> initFastConv(
     }
 #endif
 
+    // FP16 weights storage with FP32 arithmetic
+    conv->weightsPrecision = REDUCED_PRECISION_NONE;
+    if (_useFP16 && !conv->useFP16 && conv->conv_type == CONV_TYPE_GENERIC)
+        conv->weightsPrecision = getReducedPrecisionWeightsType();
+}
+
+Ptr<FastConv> initFastConv(
+        InputArray _weightsMat,
+        float* srcBias,
+        int ngroups,
+        int K, int C,
+        const std::vector<size_t>& kernel_size,
+        const std::vector<size_t>& strides,
+        const std::vector<size_t>& dilations,
+        const std::vector<size_t>& pads_begin,
+        const std::vector<size_t>& pads_end,
+        int conv_dim,
+        const bool _useFP16,
+        bool useWinograd)
+{
+    Ptr<FastConv> conv = makePtr<FastConv>();
+    initFastConvLayout(conv.get(), ngroups, K, C, kernel_size, strides, dilations, pads_begin, pads_end,
+                       conv_dim, _useFP16, useWinograd);
+    const int Dk = conv->Dk, Hk = conv->Hk, Wk = conv->Wk;
+    const int karea = Wk*Hk*Dk;
+
+    Mat weightsMat = _weightsMat.getMat();
+    auto wShape = shape(weightsMat);
+    const size_t wstep = weightsMat.step1();
+
     float *srcWeights = (float *)weightsMat.data;
     if (conv->conv_type == CONV_TYPE_DEPTHWISE || conv->conv_type == CONV_TYPE_DEPTHWISE_REMAIN)
     {
@@ -447,6 +622,13 @@ Ptr<FastConv> initFastConv(
                     }
                 }
             }});
+
+            if (conv->weightsPrecision != REDUCED_PRECISION_NONE)
+            {
+                conv->weightsBuf_RP.resize(nweights);
+                packReducedPrecision(weightsPtr, conv->weightsBuf_RP.data(), nweights, conv->weightsPrecision);
+                std::vector<float>().swap(conv->weightsBuf);
+            }
         }
     }
     else
@@ -466,6 +648,42 @@ Ptr<FastConv> initFastConv(
     return conv;
 }
 
+bool checkFastConv(
+        const FastConv& conv,
+        int ngroups,
+        int K, int C,
+        const std::vector<size_t>& kernel_size,
+        const std::vector<size_t>& strides,
+        const std::vector<size_t>& dilations,
+        const std::vector<size_t>& pads_begin,
+        const std::vector<size_t>& pads_end,
+        int conv_dim,
+        const bool useFP16,
+        bool useWinograd)
+{
+    FastConv ref;
+    initFastConvLayout(&ref, ngroups, K, C, kernel_size, strides, dilations, pads_begin, pads_end,
+                       conv_dim, useFP16, useWinograd);
+    if (conv.ngroups != ref.ngroups || conv.K != ref.K || conv.C != ref.C ||
+        conv.Hk != ref.Hk || conv.Wk != ref.Wk || conv.Dk != ref.Dk ||
+        conv.stride_h != ref.stride_h || conv.stride_w != ref.stride_w || conv.stride_d != ref.stride_d ||
+        conv.dilation_h != ref.dilation_h || conv.dilation_w != ref.dilation_w || conv.dilation_d != ref.dilation_d ||
+        conv.pad_top != ref.pad_top || conv.pad_bottom != ref.pad_bottom || conv.pad_left != ref.pad_left ||
+        conv.pad_right != ref.pad_right || conv.pad_front != ref.pad_front || conv.pad_behind != ref.pad_behind ||
+        conv.weightsPrecision != ref.weightsPrecision || conv.conv_type != ref.conv_type ||
+        conv.conv_dim != ref.conv_dim || conv.useFP16 != ref.useFP16)
+        return false;
+    // sizes of the buffers match the parameters (see deserializeFastConv()), check them for objects created otherwise
+    size_t sizes[6];
+    getFastConvBufferSizes(conv, sizes);
+    return (conv.weightsBuf.empty() ? 0 : conv.weightsBuf.size() - VEC_ALIGN) >= sizes[0] &&
+           (conv.weightsWinoBuf.empty() ? 0 : conv.weightsWinoBuf.size() - VEC_ALIGN) >= sizes[1] &&
+           conv.biasBuf.size() == sizes[2] &&
+           (conv.weightsBuf_FP16.empty() ? 0 : conv.weightsBuf_FP16.size() - VEC_ALIGN) >= sizes[3] &&
+           (conv.weightsWinoBuf_FP16.empty() ? 0 : conv.weightsWinoBuf_FP16.size() - VEC_ALIGN) >= sizes[4] &&
+           conv.weightsBuf_RP.size() == sizes[5];
+}
+
 static inline void packData8(char*& inpbuf, float*& inptrIn, int& in_w, int& x0, int& s0, const int* ofstab,
                              const int stride_w, const int ksize, const int esz)
 {
@@ -1297,7 +1515,11 @@ void runFastConv(InputArray _input, OutputArray _output, const Ptr<FastConv>& co
     size_t stripesize = alignSize(CONV_NR * ksize * Cg, VEC_ALIGN);
     size_t cbufsize = alignSize(CONV_NR * K_BLOCK_SIZE * MAX_STRIPES, VEC_ALIGN);
 
-    size_t taskbufsize = cbufsize * sizeof(float );
+    // weights stored with reduced precision are expanded to FP32 by K_BLOCK_SIZE x C_BLOCK_SIZE blocks
+    const int weightsPrecision = conv->weightsPrecision;
+    size_t wbufsize = weightsPrecision != REDUCED_PRECISION_NONE ? alignSize(K_BLOCK_SIZE * C_BLOCK_SIZE, VEC_ALIGN) : 0;
+
+    size_t taskbufsize = (cbufsize + wbufsize) * sizeof(float );
 
     if (!separateIm2col)
         taskbufsize += MAX_STRIPES * stripesize * esz;
@@ -1380,7 +1602,8 @@ void runFastConv(InputArray _input, OutputArray _output, const Ptr<FastConv>& co
     for (int task_id = r0.start; task_id < r0.end; task_id++)
     {
         float * cbuf_task = (float *)(inpbuf_all + taskbufsize * task_id);
-        char * inpbuf_task = (char*)(cbuf_task + cbufsize);
+        float * wbuf_task = cbuf_task + cbufsize;
+        char * inpbuf_task = (char*)(wbuf_task + wbufsize);
 
         int ngs0 = (int)((size_t)nsubtasks * task_id / ntasks);
         int ngs1 = (int)((size_t)nsubtasks * (task_id+1) / ntasks);
@@ -1432,6 +1655,7 @@ void runFastConv(InputArray _input, OutputArray _output, const Ptr<FastConv>& co
                 }
 
                 char *weights = nullptr;
+                const ushort *weightsRP = nullptr;
 #ifdef CONV_ARM_FP16
                 if (useFP16)
                 {
@@ -1440,6 +1664,13 @@ void runFastConv(InputArray _input, OutputArray _output, const Ptr<FastConv>& co
                 }
                 else
 #endif
+                if (weightsPrecision != REDUCED_PRECISION_NONE)
+                {
+                    CV_Assert(!conv->weightsBuf_RP.empty());
+                    weightsRP = conv->weightsBuf_RP.data() + (size_t)g * Kg_aligned * DkHkWkCg;
+                    weights = (char *)wbuf_task;
+                }
+                else
                 {
                     CV_Assert(!conv->weightsBuf.empty());
                     weights = (char *)conv->getWeights();
@@ -1497,7 +1728,8 @@ void runFastConv(InputArray _input, OutputArray _output, const Ptr<FastConv>& co
                 }
 
                 CV_Assert(weights);
-                weights += g * Kg_aligned * DkHkWkCg * esz;
+                if (!weightsRP)
+                    weights += g * Kg_aligned * DkHkWkCg * esz;
 
                 const float *biasptr = conv->biasBuf.data() + Kg * g;
                 int ldc = nstripes * CONV_NR;
@@ -1510,6 +1742,18 @@ void runFastConv(InputArray _input, OutputArray _output, const Ptr<FastConv>& co
                     for (int c0 = 0; c0 < DkHkWkCg; c0 += C_BLOCK_SIZE)
                     {
                         int c1 = c0 + C_BLOCK_SIZE < DkHkWkCg ? c0 + C_BLOCK_SIZE : DkHkWkCg;
+                        // weights of MR-strips: [k0_block, k1_block) x [c0, c1)
+                        size_t wstripstep = (size_t)DkHkWkCg * CONV_MR * esz;
+                        char *wptr0 = weights + (k0_block * DkHkWkCg + c0 * CONV_MR) * esz;
+                        if (weightsRP)
+                        {
+                            wstripstep = (size_t)(c1 - c0) * CONV_MR * esz;
+                            for (int k = k0_block; k < k1_block; k += CONV_MR)
+                                expandReducedPrecision(weightsRP + k * DkHkWkCg + c0 * CONV_MR,
+                                                       wbuf_task + (k - k0_block) * (c1 - c0),
+                                                       (c1 - c0) * CONV_MR, weightsPrecision);
+                            wptr0 = weights;
+                        }
                         const char *inptr = separateIm2col ? inpbuf_all_0 + (ng * stripes_per_plane0 + zyx0 / CONV_NR) * stripesize * esz :
                                             inpbuf_task;
                         inptr += (c0 * CONV_NR) * esz;
@@ -1517,11 +1761,11 @@ void runFastConv(InputArray _input, OutputArray _output, const Ptr<FastConv>& co
                         {
                             const int outLen = std::min(out_width - stripe * CONV_NR, CONV_NR);
 
-                            char *wptr = weights + (k0_block * DkHkWkCg + c0 * CONV_MR) * esz;
+                            char *wptr = wptr0;
                             float *cptr = cbuf_task + stripe * CONV_NR;
                             float16_t* cptr_f16 = (float16_t*)cbuf_task + stripe*CONV_NR;
                             for (int k = k0_block; k < k1_block; k += CONV_MR,
-                                    wptr += DkHkWkCg * CONV_MR * esz, cptr += CONV_MR * ldc, cptr_f16 += CONV_MR * ldc)
+                                    wptr += wstripstep, cptr += CONV_MR * ldc, cptr_f16 += CONV_MR * ldc)
                             {
 #if CV_TRY_AVX2
                                 if (conv->useAVX2)
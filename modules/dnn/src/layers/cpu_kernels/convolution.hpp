@@ -67,6 +67,11 @@ struct FastConv
     float16_t* getWeightsFP16();
     float16_t* getWeightsWinoFP16();
 
+    // DNN_TARGET_CPU_FP16 without FP16 arithmetic (x86): generic convolution keeps packed weights
+    // in 16-bit format and expands them by blocks (see reduced_precision.hpp).
+    std::vector<ushort> weightsBuf_RP;
+    int weightsPrecision = 0;  // ReducedPrecisionType
+
     int conv_type;
     int conv_dim;  // Flag for conv1d, conv2d, or conv3d.
     bool useFP16 = false; // Only ARMv8 is supported.
@@ -102,6 +107,25 @@ Ptr<FastConv> initFastConv(
         const bool useFP16,
         bool useWinograd);
 
+// checks that packed weights (e.g. of the network cache file) are created by initFastConv() with these parameters
+bool checkFastConv(
+        const FastConv& conv,
+        int ngroups,
+        int K, int C,
+        const std::vector<size_t>& kernel_size,
+        const std::vector<size_t>& strides,
+        const std::vector<size_t>& dilations,
+        const std::vector<size_t>& pads_begin,
+        const std::vector<size_t>& pads_end,
+        int conv_dim,
+        const bool useFP16,
+        bool useWinograd);
+
+// Contents of FastConv for the network cache file (see serializeSharedWeights()), buffers refer to the data of 'conv'.
+// deserializeFastConv() validates the parameters and sizes of the buffers, the data is copied.
+void serializeFastConv(const FastConv& conv, std::vector<int>& params, std::vector<Mat>& buffers);
+Ptr<FastConv> deserializeFastConv(const std::vector<int>& params, const std::vector<Mat>& buffers);
+
 // It contains different computing branches, like winograd, 1x1 conv.
 void runFastConv(InputArray _input, OutputArray _output, const Ptr<FastConv>& conv, int ntasks,
                    const Ptr<ActivationLayer>& actLayer, const std::vector<float>& reluslope, bool fusedAdd);
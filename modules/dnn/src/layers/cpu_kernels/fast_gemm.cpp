@@ -11,6 +11,8 @@
 
 #include "../../precomp.hpp"
 #include "fast_gemm.hpp"
+#include "shared_weights.hpp"
+#include "reduced_precision.hpp"
 
 #define CV_CPU_OPTIMIZATION_DECLARATIONS_ONLY
 #include "fast_gemm_kernels.simd.hpp"
@@ -46,6 +48,32 @@ size_t fastGemmPackBSize(size_t N, size_t K, const FastGemmOpt &opt) {
     }
 }
 
+static int fastGemmPackBTileN(int N, const FastGemmOpt &opt) {
+#if CV_TRY_NEON
+    if (opt.use_neon) {
+        return opt_NEON::fastGemmPackBTileN(N);
+    } else
+#endif
+#if CV_TRY_AVX2
+    if (opt.use_avx2) {
+        return opt_AVX2::fastGemmPackBTileN(N);
+    } else
+#endif
+#if CV_TRY_AVX
+    if (opt.use_avx) {
+        return opt_AVX::fastGemmPackBTileN(N);
+    } else
+#endif
+#if CV_TRY_LASX
+    if (opt.use_lasx) {
+        return opt_LASX::fastGemmPackBTileN(N);
+    } else
+#endif
+    {
+        return cpu_baseline::fastGemmPackBTileN(N);
+    }
+}
+
 void fastGemmPackB(const Mat &B, std::vector<float> &packed_B, bool trans, FastGemmOpt &opt) {
     CV_CheckTypeEQ(B.type(), CV_32F, "fastGemmPackB: only float32 is supported for now");
 
@@ -120,6 +148,48 @@ void fastGemmPackB(const Mat &B, std::vector<float> &packed_B, bool trans, FastG
     }
 }
 
+// number of elements of B packed by fastGemmPackB()
+static size_t fastGemmPackedBTotal(const Mat &B, bool trans, const FastGemmOpt &opt) {
+    auto B_shape = shape(B);
+    size_t batch = total(B_shape, 0, B_shape.size() - 2);
+    int K = B_shape[B_shape.size() - 2], N = B_shape.back();
+    if (trans) {
+        std::swap(K, N);
+    }
+    return batch * fastGemmPackBSize(N, K, opt);
+}
+
+Ptr<const std::vector<float> > fastGemmPackBShared(const Mat &B, bool trans, FastGemmOpt &opt) {
+    SharedWeightsKey key("FastGemmPackB");
+    key.add(B).add(trans).add(opt.use_avx).add(opt.use_avx2).add(opt.use_neon).add(opt.use_lasx);
+    return getSharedWeights<const std::vector<float> >(key, [&]() {
+        Ptr<std::vector<float> > packed_B = makePtr<std::vector<float> >();
+        fastGemmPackB(B, *packed_B, trans, opt);
+        return Ptr<const std::vector<float> >(packed_B);
+    }, [&](const std::vector<float> &packed_B) {
+        return packed_B.size() == fastGemmPackedBTotal(B, trans, opt);
+    });
+}
+
+void fastGemmPackBReduced(const Mat &B, std::vector<ushort> &packed_B, int precision, bool trans, FastGemmOpt &opt) {
+    std::vector<float> packed_B_f32;
+    fastGemmPackB(B, packed_B_f32, trans, opt);
+    packed_B.resize(packed_B_f32.size());
+    packReducedPrecision(packed_B_f32.data(), packed_B.data(), packed_B_f32.size(), precision);
+}
+
+Ptr<const std::vector<ushort> > fastGemmPackBReducedShared(const Mat &B, int precision, bool trans, FastGemmOpt &opt) {
+    SharedWeightsKey key("FastGemmPackBReduced");
+    key.add(B).add(precision).add(trans).add(opt.use_avx).add(opt.use_avx2).add(opt.use_neon).add(opt.use_lasx);
+    return getSharedWeights<const std::vector<ushort> >(key, [&]() {
+        Ptr<std::vector<ushort> > packed_B = makePtr<std::vector<ushort> >();
+        fastGemmPackBReduced(B, *packed_B, precision, trans, opt);
+        return Ptr<const std::vector<ushort> >(packed_B);
+    }, [&](const std::vector<ushort> &packed_B) {
+        return packed_B.size() == fastGemmPackedBTotal(B, trans, opt);
+    });
+}
+
 void fastGemmPackB(bool trans, size_t N, size_t K, const float *B, size_t ldb, float *packed_B, const FastGemmOpt &opt) {
     size_t ldb0 = ldb, ldb1 = 1;
     if (trans) {
@@ -187,42 +257,87 @@ static void fast_gemm_thin(float alpha, float beta, int M, int N, int K,
     }
 }
 
-void fastGemm(bool trans_a, int M, int N, int K,
-              float alpha, const float *A, int lda,
-              const float *packed_B, float beta,
-              float *C, int ldc, FastGemmOpt &opt) {
+static void fastGemmPackedKernel(int M, int N, int K,
+                                 float alpha, const float *A, int lda0, int lda1,
+                                 const float *packed_B, float beta,
+                                 float *C, int ldc, bool multi_thread, const FastGemmOpt &opt) {
     const char *a = (const char *)A;
     const char *packed_b = (const char *)packed_B;
     char *c = (char *)C;
 
-    int lda0 = lda, lda1 = 1;
-    if (trans_a) {
-        std::swap(lda0, lda1);
-    }
-
 #if CV_TRY_NEON
     if (opt.use_neon) {
-        opt_NEON::fastGemmKernel(M, N, K, alpha, a, lda0, lda1, packed_b, beta, c, ldc, sizeof(float), opt.multi_thread);
+        opt_NEON::fastGemmKernel(M, N, K, alpha, a, lda0, lda1, packed_b, beta, c, ldc, sizeof(float), multi_thread);
     } else
 #endif
 #if CV_TRY_AVX2
     if (opt.use_avx2) {
-        opt_AVX2::fastGemmKernel(M, N, K, alpha, a, lda0, lda1, packed_b, beta, c, ldc, sizeof(float), opt.multi_thread);
+        opt_AVX2::fastGemmKernel(M, N, K, alpha, a, lda0, lda1, packed_b, beta, c, ldc, sizeof(float), multi_thread);
     } else
 #endif
 #if CV_TRY_AVX
     if (opt.use_avx) {
-        opt_AVX::fastGemmKernel(M, N, K, alpha, a, lda0, lda1, packed_b, beta, c, ldc, sizeof(float), opt.multi_thread);
+        opt_AVX::fastGemmKernel(M, N, K, alpha, a, lda0, lda1, packed_b, beta, c, ldc, sizeof(float), multi_thread);
     } else
 #endif
 #if CV_TRY_LASX
     if (opt.use_lasx) {
-        opt_LASX::fastGemmKernel(M, N, K, alpha, a, lda0, lda1, packed_b, beta, c, ldc, sizeof(float), opt.multi_thread);
+        opt_LASX::fastGemmKernel(M, N, K, alpha, a, lda0, lda1, packed_b, beta, c, ldc, sizeof(float), multi_thread);
     } else
 #endif
     {
-        cpu_baseline::fastGemmKernel(M, N, K, alpha, a, lda0, lda1, packed_b, beta, c, ldc, sizeof(float), opt.multi_thread);
+        cpu_baseline::fastGemmKernel(M, N, K, alpha, a, lda0, lda1, packed_b, beta, c, ldc, sizeof(float), multi_thread);
+    }
+}
+
+void fastGemm(bool trans_a, int M, int N, int K,
+              float alpha, const float *A, int lda,
+              const float *packed_B, float beta,
+              float *C, int ldc, FastGemmOpt &opt) {
+    int lda0 = lda, lda1 = 1;
+    if (trans_a) {
+        std::swap(lda0, lda1);
+    }
+    fastGemmPackedKernel(M, N, K, alpha, A, lda0, lda1, packed_B, beta, C, ldc, opt.multi_thread, opt);
+}
+
+// Column panels of packed B are expanded to FP32 one by one and processed by the FP32 kernel.
+// Panels are distributed between threads if there are enough of them, otherwise the kernel is parallel.
+static void fastGemmReducedKernel(int M, int N, int K,
+                                  float alpha, const float *A, int lda0, int lda1,
+                                  const ushort *packed_B, int precision, float beta,
+                                  float *C, int ldc, const FastGemmOpt &opt) {
+    const int NC = fastGemmPackBTileN(N, opt);
+    const int n_panels = (N + NC - 1) / NC;
+    const bool parallel_panels = opt.multi_thread && n_panels > 1 && n_panels >= getNumThreads();
+    const size_t panel_size = fastGemmPackBSize(NC, K, opt);
+
+    auto fn = [&](const Range &r) {
+        AutoBuffer<float> panel(panel_size);
+        for (int p = r.start; p < r.end; p++) {
+            int j0 = p * NC;
+            int nc = N - j0 < NC ? N - j0 : NC;
+            expandReducedPrecision(packed_B + (size_t)j0 * K, panel.data(), fastGemmPackBSize(nc, K, opt), precision);
+            fastGemmPackedKernel(M, nc, K, alpha, A, lda0, lda1, panel.data(), beta, C + j0, ldc,
+                                 opt.multi_thread && !parallel_panels, opt);
+        }
+    };
+    if (parallel_panels) {
+        parallel_for_(Range(0, n_panels), fn, n_panels);
+    } else {
+        fn(Range(0, n_panels));
+    }
+}
+
+void fastGemm(bool trans_a, int M, int N, int K,
+              float alpha, const float *A, int lda,
+              const ushort *packed_B, int precision, float beta,
+              float *C, int ldc, FastGemmOpt &opt) {
+    int lda0 = lda, lda1 = 1;
+    if (trans_a) {
+        std::swap(lda0, lda1);
     }
+    fastGemmReducedKernel(M, N, K, alpha, A, lda0, lda1, packed_B, precision, beta, C, ldc, opt);
 }
 
 void fastGemm(bool trans_a, bool trans_b, int ma, int na, int mb, int nb,
@@ -374,6 +489,15 @@ void fastGemmBatch(size_t batch, const size_t *A_offsets, const size_t *packed_B
     }
 }
 
+void fastGemmBatch(size_t batch, const size_t *A_offsets, const size_t *packed_B_offsets, const size_t *C_offsets,
+                   int M, int N, int K, float alpha, const float *A, int lda0, int lda1,
+                   const ushort *packed_B, int precision, float beta, float *C, int ldc, FastGemmOpt &opt) {
+    for (size_t i = 0; i < batch; i++) {
+        fastGemmReducedKernel(M, N, K, alpha, A + A_offsets[i], lda0, lda1, packed_B + packed_B_offsets[i], precision,
+                              beta, C + C_offsets[i], ldc, opt);
+    }
+}
+
 void fastGemmBatch(bool trans_a, bool trans_b,
                    float alpha, const Mat &A, const Mat &B,
                    float beta, Mat &C, FastGemmOpt &opt) {
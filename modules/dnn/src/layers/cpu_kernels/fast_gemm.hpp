@@ -43,6 +43,11 @@ struct FastGemmOpt {
     bool all() {
         return use_avx || use_avx2 || use_neon || use_lasx;
     }
+
+    // instruction set of the kernels, reported by the profiler
+    const char* getISA() const {
+        return use_avx2 ? "AVX2" : use_avx ? "AVX" : use_neon ? "NEON" : use_lasx ? "LASX" : "baseline";
+    }
 };
 
 struct MatMulHelper {
@@ -154,12 +159,22 @@ struct MatMulHelper {
 size_t fastGemmPackBSize(size_t N, size_t K, const FastGemmOpt &opt);
 
 void fastGemmPackB(const Mat &m, std::vector<float> &packed_B, bool trans, FastGemmOpt &opt);
+// packs constant B, the result is shared with layers of other Net instances having the same B
+Ptr<const std::vector<float> > fastGemmPackBShared(const Mat &m, bool trans, FastGemmOpt &opt);
 void fastGemmPackB(bool trans, size_t N, size_t K, const float *B, size_t ldb, float *packed_B, const FastGemmOpt &opt);
 
+// packs constant B in 16-bit format (ReducedPrecisionType), it is expanded to FP32 by column panels during computation
+void fastGemmPackBReduced(const Mat &m, std::vector<ushort> &packed_B, int precision, bool trans, FastGemmOpt &opt);
+Ptr<const std::vector<ushort> > fastGemmPackBReducedShared(const Mat &m, int precision, bool trans, FastGemmOpt &opt);
+
 void fastGemm(bool trans_a, int M, int N, int K,
               float alpha, const float *A, int lda,
               const float *packed_B, float beta,
               float *C, int ldc, FastGemmOpt &opt);
+void fastGemm(bool trans_a, int M, int N, int K,
+              float alpha, const float *A, int lda,
+              const ushort *packed_B, int precision, float beta,
+              float *C, int ldc, FastGemmOpt &opt);
 void fastGemm(bool trans_a, bool trans_b, int ma, int na, int mb, int nb,
               float alpha, const float *A, int lda0, int lda1, const float *B, int ldb0, int ldb1,
               float beta, float *C, int ldc, FastGemmOpt &opt);
@@ -173,6 +188,9 @@ void fastGemmBatch(size_t batch, const size_t *A_offsets, const size_t *B_offset
 void fastGemmBatch(size_t batch, const size_t *A_offsets, const size_t *B_offsets, const size_t *C_offsets,
                    int M, int N, int K, float alpha, const float *A, int lda0, int lda1,
                    const float *packed_B, float beta, float *C, int ldc, FastGemmOpt &opt);
+void fastGemmBatch(size_t batch, const size_t *A_offsets, const size_t *packed_B_offsets, const size_t *C_offsets,
+                   int M, int N, int K, float alpha, const float *A, int lda0, int lda1,
+                   const ushort *packed_B, int precision, float beta, float *C, int ldc, FastGemmOpt &opt);
 void fastGemmBatch(bool trans_a, bool trans_b, float alpha, const Mat &A,
                    const Mat &B, float beta, Mat &C, FastGemmOpt &opt);
 
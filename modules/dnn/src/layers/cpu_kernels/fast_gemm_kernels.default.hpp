@@ -77,6 +77,7 @@ static void fast_gemm_pack##N##suffix( int m, int k, const void* A_, \
 namespace cv { namespace dnn { namespace cpu_baseline {
 
 int fastGemmPackBSize(int N, int K);
+int fastGemmPackBTileN(int N);
 
 void fastGemmPackBKernel(const char *B, char *packed_B, int N, int K, int ldb0, int ldb1, int esz);
 
@@ -105,6 +106,12 @@ int fastGemmPackBSize(int N, int K) {
     return static_cast<int>((N + NC - 1) / NC) * NC * K;
 }
 
+// width of column panels of packed B
+int fastGemmPackBTileN(int N) {
+    int GEMM_NC = FAST_GEMM_F32_NC, GEMM_NR = FAST_GEMM_F32_NR;
+    return (((GEMM_NC < N ? GEMM_NC : N) + GEMM_NR - 1) / GEMM_NR) * GEMM_NR;
+}
+
 void fastGemmPackBKernel(const char *B, char *packed_B, int N, int K, int ldb0, int ldb1, int esz) {
     int GEMM_NC = FAST_GEMM_F32_NC, GEMM_NR = FAST_GEMM_F32_NR;
     int NC = (((GEMM_NC < N ? GEMM_NC : N) + GEMM_NR - 1) / GEMM_NR) * GEMM_NR;
@@ -116,6 +116,7 @@ namespace cv { namespace dnn {
 CV_CPU_OPTIMIZATION_NAMESPACE_BEGIN
 
 int fastGemmPackBSize(int N, int K);
+int fastGemmPackBTileN(int N);
 
 void fastGemmPackBKernel(const char *B, char *packed_B, int N, int K, int ldb0, int ldb1, int esz);
 
@@ -538,6 +539,12 @@ int fastGemmPackBSize(int N, int K) {
     return static_cast<int>((N + NC - 1) / NC) * NC * K;
 }
 
+// width of column panels of packed B
+int fastGemmPackBTileN(int N) {
+    int GEMM_NC = FAST_GEMM_F32_NC, GEMM_NR = FAST_GEMM_F32_NR;
+    return (((GEMM_NC < N ? GEMM_NC : N) + GEMM_NR - 1) / GEMM_NR) * GEMM_NR;
+}
+
 void fastGemmPackBKernel(const char *B, char *packed_B, int N, int K, int ldb0, int ldb1, int esz) {
     int GEMM_NC = FAST_GEMM_F32_NC, GEMM_NR = FAST_GEMM_F32_NR;
     int NC = (((GEMM_NC < N ? GEMM_NC : N) + GEMM_NR - 1) / GEMM_NR) * GEMM_NR;
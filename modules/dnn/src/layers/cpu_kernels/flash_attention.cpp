@@ -0,0 +1,110 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "../../precomp.hpp"
+#include "flash_attention.hpp"
+#include "softmax.hpp"
+
+namespace cv { namespace dnn {
+
+// tile sizes: scores tile (32 x 64 floats) and output accumulators stay in L1
+enum { FLASH_ATTN_BLOCK_Q = 32, FLASH_ATTN_BLOCK_KV = 64 };
+
+// p[j] = exp(p[j] - maxval), returns the sum
+static float expShifted(float *p, int n, float maxval)
+{
+    int j = 0;
+    float s = 0.f;
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+    const int nlanes = VTraits<v_float32>::vlanes();
+    v_float32 vmax = vx_setall_f32(maxval), vs = vx_setzero_f32();
+    for (; j <= n - nlanes; j += nlanes)
+    {
+        v_float32 v = v_exp_approx(v_sub(vx_load(p + j), vmax));
+        vs = v_add(vs, v);
+        v_store(p + j, v);
+    }
+    s = v_reduce_sum(vs);
+#endif
+    for (; j < n; j++)
+    {
+        p[j] = std::exp(p[j] - maxval);
+        s += p[j];
+    }
+    return s;
+}
+
+void flashAttention(int q_len, int kv_len, int qk_head_size, int v_head_size, float scale,
+                    const float *Q, size_t ldq, const float *K, size_t ldk, const float *V, size_t ldv,
+                    float *O, size_t ldo, int causal_offset, FastGemmOpt &opt)
+{
+    const int BQ = FLASH_ATTN_BLOCK_Q, BKV = FLASH_ATTN_BLOCK_KV;
+    AutoBuffer<float> buf(BQ * BKV + BQ * v_head_size + BQ * 2);
+    float *scores = buf.data();
+    float *acc = scores + BQ * BKV;
+    float *rowmax = acc + BQ * v_head_size;
+    float *rowsum = rowmax + BQ;
+
+    for (int q0 = 0; q0 < q_len; q0 += BQ)
+    {
+        const int bq = std::min(q_len - q0, BQ);
+        // keys after the last visible one of the tile are skipped entirely
+        const int kv_end = causal_offset >= 0 ? std::min(kv_len, causal_offset + q0 + bq) : kv_len;
+        for (int i = 0; i < bq; i++)
+        {
+            rowmax[i] = -FLT_MAX;
+            rowsum[i] = 0.f;
+        }
+        std::memset(acc, 0, bq * v_head_size * sizeof(float));
+
+        for (int k0 = 0; k0 < kv_end; k0 += BKV)
+        {
+            const int bkv = std::min(kv_end - k0, BKV);
+            fastGemm(false, true, bq, qk_head_size, bkv, qk_head_size,
+                     scale, Q + q0 * ldq, (int)ldq, 1, K + k0 * ldk, (int)ldk, 1,
+                     0.f, scores, bkv, opt);
+
+            // online softmax: rescale accumulated rows by exp(old_max - new_max)
+            for (int i = 0; i < bq; i++)
+            {
+                float *s = scores + i * bkv;
+                const int n = causal_offset >= 0 ? std::min(bkv, causal_offset + q0 + i + 1 - k0) : bkv;
+                if (n <= 0)
+                {
+                    std::memset(s, 0, bkv * sizeof(float));
+                    continue;
+                }
+                float m = rowmax[i];
+                for (int j = 0; j < n; j++)
+                    m = std::max(m, s[j]);
+                const float alpha = rowmax[i] == -FLT_MAX ? 0.f : std::exp(rowmax[i] - m);
+                rowsum[i] = rowsum[i] * alpha + expShifted(s, n, m);
+                rowmax[i] = m;
+                for (int j = n; j < bkv; j++)
+                    s[j] = 0.f;
+                if (alpha != 1.f)
+                {
+                    float *a = acc + i * v_head_size;
+                    for (int j = 0; j < v_head_size; j++)
+                        a[j] *= alpha;
+                }
+            }
+
+            fastGemm(false, false, bq, bkv, bkv, v_head_size,
+                     1.f, scores, bkv, 1, V + k0 * ldv, (int)ldv, 1,
+                     1.f, acc, v_head_size, opt);
+        }
+
+        for (int i = 0; i < bq; i++)
+        {
+            const float *a = acc + i * v_head_size;
+            float *o = O + (q0 + i) * ldo;
+            const float r = rowsum[i] > 0.f ? 1.f / rowsum[i] : 0.f;
+            for (int j = 0; j < v_head_size; j++)
+                o[j] = a[j] * r;
+        }
+    }
+}
+
+}} // cv::dnn
@@ -0,0 +1,23 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#ifndef OPENCV_DNN_FLASH_ATTENTION_HPP
+#define OPENCV_DNN_FLASH_ATTENTION_HPP
+
+#include "fast_gemm.hpp"
+
+namespace cv { namespace dnn {
+
+// Fused single-head attention O = Softmax(scale * Q*K^T) * V computed by tiles of queries and keys
+// with online softmax, so the q_len x kv_len score matrix is never materialized.
+// Q: q_len x qk_head_size, K: kv_len x qk_head_size, V: kv_len x v_head_size, O: q_len x v_head_size (row strides are ldq, ldk, ldv, ldo).
+// If causal_offset >= 0, query i attends to keys 0..causal_offset+i only (decoding with cached keys uses causal_offset = kv_len - q_len).
+// opt.multi_thread should be false, callers parallelize over heads.
+void flashAttention(int q_len, int kv_len, int qk_head_size, int v_head_size, float scale,
+                    const float *Q, size_t ldq, const float *K, size_t ldk, const float *V, size_t ldv,
+                    float *O, size_t ldo, int causal_offset, FastGemmOpt &opt);
+
+}} // cv::dnn
+
+#endif // OPENCV_DNN_FLASH_ATTENTION_HPP
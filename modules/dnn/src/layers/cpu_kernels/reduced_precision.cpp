@@ -0,0 +1,88 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "../../precomp.hpp"
+#include "reduced_precision.hpp"
+
+#include <opencv2/core/hal/hal.hpp>
+#include <opencv2/core/hal/intrin.hpp>
+#include <opencv2/core/utils/configuration.private.hpp>
+#include <opencv2/core/utils/logger.hpp>
+
+namespace cv { namespace dnn {
+
+bool haveReducedPrecisionWeights()
+{
+    return checkHardwareSupport(CPU_FP16) && getReducedPrecisionWeightsType() != REDUCED_PRECISION_NONE;
+}
+
+int getReducedPrecisionWeightsType()
+{
+    // not cached: it is read once per layer initialization, tests switch it at runtime
+    std::string format = utils::getConfigurationParameterString("OPENCV_DNN_CPU_FP16_WEIGHTS", "");
+    if (format.empty())
+        return REDUCED_PRECISION_NONE;
+    if (format == "BF16")
+        return REDUCED_PRECISION_BF16;
+    if (format != "FP16")
+    {
+        CV_LOG_ONCE_WARNING(NULL, "DNN: unknown OPENCV_DNN_CPU_FP16_WEIGHTS=" << format << ", FP16 is used");
+    }
+    return REDUCED_PRECISION_FP16;
+}
+
+static inline ushort float2bfloat(float value)
+{
+    Cv32suf v;
+    v.f = value;
+    if ((v.u & 0x7fffffff) > 0x7f800000)
+        return (ushort)((v.u >> 16) | 0x40);  // quiet NaN
+    v.u += 0x7fff + ((v.u >> 16) & 1);  // round to nearest even
+    return (ushort)(v.u >> 16);
+}
+
+void packReducedPrecision(const float* src, ushort* dst, size_t count, int type)
+{
+    if (type == REDUCED_PRECISION_FP16)
+    {
+        CV_Assert(count <= (size_t)INT_MAX);
+        hal::cvt32f16f(src, (float16_t*)dst, (int)count);
+    }
+    else
+    {
+        CV_Assert(type == REDUCED_PRECISION_BF16);
+        for (size_t i = 0; i < count; i++)
+            dst[i] = float2bfloat(src[i]);
+    }
+}
+
+void expandReducedPrecision(const ushort* src, float* dst, size_t count, int type)
+{
+    if (type == REDUCED_PRECISION_FP16)
+    {
+        CV_Assert(count <= (size_t)INT_MAX);
+        hal::cvt16f32f((const float16_t*)src, dst, (int)count);
+        return;
+    }
+    CV_Assert(type == REDUCED_PRECISION_BF16);
+    size_t i = 0;
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+    const int nlanes = VTraits<v_uint16>::vlanes();
+    for (; i + nlanes <= count; i += nlanes)
+    {
+        v_uint32 lo, hi;
+        v_expand(vx_load(src + i), lo, hi);
+        v_store(dst + i, v_reinterpret_as_f32(v_shl<16>(lo)));
+        v_store(dst + i + nlanes / 2, v_reinterpret_as_f32(v_shl<16>(hi)));
+    }
+#endif
+    for (; i < count; i++)
+    {
+        Cv32suf v;
+        v.u = (unsigned)src[i] << 16;
+        dst[i] = v.f;
+    }
+}
+
+}}  // namespace cv::dnn
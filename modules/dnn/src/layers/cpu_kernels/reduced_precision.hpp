@@ -0,0 +1,35 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#ifndef OPENCV_DNN_REDUCED_PRECISION_HPP
+#define OPENCV_DNN_REDUCED_PRECISION_HPP
+
+#include <opencv2/core.hpp>
+
+namespace cv { namespace dnn {
+
+// Storage of constant weights for DNN_TARGET_CPU_FP16 on CPUs without FP16 arithmetic kernels (x86):
+// weights are kept in a 16-bit format and expanded to FP32 by small blocks right before FP32 micro-kernels.
+// Memory footprint and bandwidth of weights are halved, accumulation is performed in FP32.
+enum ReducedPrecisionType
+{
+    REDUCED_PRECISION_NONE = 0,
+    REDUCED_PRECISION_FP16 = 1,  // IEEE 754 half
+    REDUCED_PRECISION_BF16 = 2   // bfloat16: FP32 range, 8-bit mantissa
+};
+
+// DNN_TARGET_CPU_FP16 is provided through 16-bit weights storage if the CPU has fast FP16 conversions (F16C)
+// and the weights format is selected explicitly (opt-in, accuracy of models is reduced)
+bool haveReducedPrecisionWeights();
+
+// Weights format for DNN_TARGET_CPU_FP16: `OPENCV_DNN_CPU_FP16_WEIGHTS=FP16` or `BF16`,
+// REDUCED_PRECISION_NONE if it is not set.
+int getReducedPrecisionWeightsType();
+
+void packReducedPrecision(const float* src, ushort* dst, size_t count, int type);
+void expandReducedPrecision(const ushort* src, float* dst, size_t count, int type);
+
+}}  // namespace cv::dnn
+
+#endif  // OPENCV_DNN_REDUCED_PRECISION_HPP
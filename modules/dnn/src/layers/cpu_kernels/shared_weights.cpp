@@ -0,0 +1,322 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "../../precomp.hpp"
+#include "shared_weights.hpp"
+#include "convolution.hpp"  // FastConv serialization
+
+#include <opencv2/core/utils/configuration.private.hpp>
+#include <opencv2/core/utils/logger.hpp>
+
+#include <map>
+#include <memory>
+
+namespace cv { namespace dnn {
+
+// Two independent 64-bit hashes of the data (FNV-1a and multiply-rotate over 64-bit words).
+struct WeightsDigest
+{
+    uint64 h1, h2, length;
+
+    WeightsDigest() : h1(14695981039346656037ull), h2(0x9E3779B97F4A7C15ull), length(0) {}
+
+    void update(const uchar* data, size_t size)
+    {
+        size_t i = 0;
+        for (; i + 8 <= size; i += 8)
+        {
+            uint64 w;
+            memcpy(&w, data + i, sizeof(w));
+            mix(w);
+        }
+        if (i < size)
+        {
+            uint64 w = 0;
+            memcpy(&w, data + i, size - i);
+            mix(w);
+        }
+        length += size;
+    }
+
+    inline void mix(uint64 w)
+    {
+        h1 = (h1 ^ w) * 1099511628211ull;
+        h2 += w * 0xC2B2AE3D27D4EB4Full;
+        h2 = ((h2 << 31) | (h2 >> 33)) * 0x9E3779B97F4A7C15ull;
+    }
+};
+
+SharedWeightsKey::SharedWeightsKey(const char* kind)
+    : key(kind)
+{
+}
+
+SharedWeightsKey& SharedWeightsKey::add(int value)
+{
+    key += cv::format(":%d", value);
+    return *this;
+}
+
+SharedWeightsKey& SharedWeightsKey::add(const std::vector<size_t>& values)
+{
+    key += ":[";
+    for (size_t i = 0; i < values.size(); i++)
+        key += cv::format(i == 0 ? "%llu" : ",%llu", (unsigned long long)values[i]);
+    key += "]";
+    return *this;
+}
+
+SharedWeightsKey& SharedWeightsKey::add(const Mat& data)
+{
+    WeightsDigest digest;
+    if (!data.empty())
+    {
+        const Mat* arrays[] = { &data, 0 };
+        uchar* ptrs[1] = { 0 };
+        NAryMatIterator it(arrays, ptrs);
+        const size_t planeSize = it.size * data.elemSize();
+        for (size_t i = 0; i < it.nplanes; i++, ++it)
+            digest.update(ptrs[0], planeSize);
+    }
+    key += ":" + typeToString(data.type());
+    std::vector<size_t> dims(data.size.p, data.size.p + data.dims);
+    add(dims);
+    key += cv::format(":%016llx%016llx", (unsigned long long)digest.h1, (unsigned long long)digest.h2);
+    sources.push_back(data.u || data.empty() ? data : data.clone());  // user data may be released
+    return *this;
+}
+
+SharedWeightsKey& SharedWeightsKey::add(const float* data, size_t count)
+{
+    WeightsDigest digest;
+    if (count > 0)
+        digest.update((const uchar*)data, count * sizeof(float));
+    key += cv::format(":f[%llu]:%016llx%016llx", (unsigned long long)count,
+                      (unsigned long long)digest.h1, (unsigned long long)digest.h2);
+    CV_Assert(count <= (size_t)INT_MAX);
+    sources.push_back(count > 0 ? Mat(1, (int)count, CV_32F, (void*)data).clone() : Mat());
+    return *this;
+}
+
+static bool isSameData(const Mat& a, const Mat& b)
+{
+    if (a.type() != b.type() || a.size != b.size)
+        return false;
+    if (a.empty() || (a.data == b.data && a.isContinuous() && b.isContinuous()))
+        return true;
+    const Mat* arrays[] = { &a, &b, 0 };
+    uchar* ptrs[2] = { 0, 0 };
+    NAryMatIterator it(arrays, ptrs);
+    const size_t planeSize = it.size * a.elemSize();
+    for (size_t i = 0; i < it.nplanes; i++, ++it)
+    {
+        if (memcmp(ptrs[0], ptrs[1], planeSize) != 0)
+            return false;
+    }
+    return true;
+}
+
+static bool isSameData(const std::vector<Mat>& a, const std::vector<Mat>& b)
+{
+    if (a.size() != b.size())
+        return false;
+    for (size_t i = 0; i < a.size(); i++)
+    {
+        if (!isSameData(a[i], b[i]))
+            return false;
+    }
+    return true;
+}
+
+bool isPackedWeightsSharingEnabled()
+{
+    static bool enabled = utils::getConfigurationParameterBool("OPENCV_DNN_SHARE_PACKED_WEIGHTS", true);
+    return enabled;
+}
+
+namespace {
+
+struct SharedWeightsEntry
+{
+    Ptr<void> value;
+    std::vector<Mat> sources;  // data the weights are packed from, see SharedWeightsKey
+};
+
+struct SharedWeightsRegistry
+{
+    cv::Mutex mutex;
+    std::map<std::string, std::weak_ptr<SharedWeightsEntry> > entries;
+
+    // drops entries of released objects
+    void cleanup()
+    {
+        for (std::map<std::string, std::weak_ptr<SharedWeightsEntry> >::iterator it = entries.begin(); it != entries.end();)
+        {
+            if (it->second.expired())
+                it = entries.erase(it);
+            else
+                ++it;
+        }
+    }
+};
+
+static SharedWeightsRegistry& getSharedWeightsRegistry()
+{
+    static SharedWeightsRegistry* g_registry = new SharedWeightsRegistry();  // not released: layers may be destroyed after static objects
+    return *g_registry;
+}
+
+}  // namespace
+
+// users hold the entry, so the source data lives as long as the weights
+static inline Ptr<void> getEntryValue(const Ptr<SharedWeightsEntry>& entry)
+{
+    return Ptr<void>(entry, entry->value.get());
+}
+
+Ptr<void> findSharedWeights(const SharedWeightsKey& key)
+{
+    Ptr<SharedWeightsEntry> entry;
+    {
+        SharedWeightsRegistry& registry = getSharedWeightsRegistry();
+        cv::AutoLock lock(registry.mutex);
+        std::map<std::string, std::weak_ptr<SharedWeightsEntry> >::iterator it = registry.entries.find(key.str());
+        if (it == registry.entries.end())
+            return Ptr<void>();
+        entry = it->second.lock();
+    }
+    if (!entry)
+        return Ptr<void>();
+    // the data is compared outside of the lock, entries are immutable
+    if (!isSameData(entry->sources, key.getSources()))
+    {
+        CV_LOG_DEBUG(NULL, "DNN: prepacked weights with the same key have other source data, not shared: " << key.str());
+        return Ptr<void>();
+    }
+    return getEntryValue(entry);
+}
+
+Ptr<void> registerSharedWeights(const SharedWeightsKey& key, const Ptr<void>& value)
+{
+    CV_Assert(value);
+    Ptr<SharedWeightsEntry> entry = makePtr<SharedWeightsEntry>();
+    entry->value = value;
+    entry->sources = key.getSources();
+    Ptr<SharedWeightsEntry> existing;
+    {
+        SharedWeightsRegistry& registry = getSharedWeightsRegistry();
+        cv::AutoLock lock(registry.mutex);
+        std::weak_ptr<SharedWeightsEntry>& slot = registry.entries[key.str()];
+        existing = slot.lock();
+        if (!existing)
+        {
+            slot = entry;
+            if (registry.entries.size() % 256 == 0)
+                registry.cleanup();
+        }
+    }
+    if (!existing)
+        return getEntryValue(entry);
+    if (isSameData(existing->sources, entry->sources))
+        return getEntryValue(existing);
+    CV_LOG_DEBUG(NULL, "DNN: prepacked weights with the same key have other source data, not shared: " << key.str());
+    return value;
+}
+
+static thread_local SharedWeightsMap* g_sharedWeightsCollector = NULL;
+static thread_local const std::map<std::string, Ptr<void> >* g_preloadedWeights = NULL;
+
+SharedWeightsCollector::SharedWeightsCollector(SharedWeightsMap& map, const std::map<std::string, Ptr<void> >& preloaded)
+    : prevMap(g_sharedWeightsCollector), prevPreloaded(g_preloadedWeights)
+{
+    g_sharedWeightsCollector = &map;
+    g_preloadedWeights = &preloaded;
+}
+
+SharedWeightsCollector::~SharedWeightsCollector()
+{
+    g_sharedWeightsCollector = prevMap;
+    g_preloadedWeights = prevPreloaded;
+}
+
+void collectSharedWeights(const std::string& key, const Ptr<void>& value)
+{
+    if (g_sharedWeightsCollector && value)
+        (*g_sharedWeightsCollector)[key] = value;
+}
+
+Ptr<void> findPreloadedWeights(const std::string& key)
+{
+    if (!g_preloadedWeights)
+        return Ptr<void>();
+    std::map<std::string, Ptr<void> >::const_iterator it = g_preloadedWeights->find(key);
+    return it != g_preloadedWeights->end() ? it->second : Ptr<void>();
+}
+
+void warnInvalidPreloadedWeights(const std::string& key)
+{
+    CV_LOG_WARNING(NULL, "DNN/cache: prepacked weights don't match the layer and will be packed again: " << key);
+}
+
+template<typename T> static inline
+Mat vectorToMat(const std::vector<T>& v, int type)
+{
+    CV_Assert(v.size() <= (size_t)INT_MAX);
+    return v.empty() ? Mat() : Mat(1, (int)v.size(), type, (void*)v.data());
+}
+
+template<typename T> static inline
+std::vector<T> matToVector(const Mat& m)
+{
+    if (m.empty())
+        return std::vector<T>();
+    CV_Assert(m.isContinuous() && m.elemSize() == sizeof(T));
+    const T* data = m.ptr<T>();
+    return std::vector<T>(data, data + m.total());
+}
+
+static std::string getSharedWeightsKind(const std::string& key)
+{
+    return key.substr(0, key.find(':'));
+}
+
+bool serializeSharedWeights(const std::string& key, const Ptr<void>& value,
+                            std::vector<int>& params, std::vector<Mat>& buffers)
+{
+    CV_Assert(value);
+    params.clear();
+    buffers.clear();
+    const std::string kind = getSharedWeightsKind(key);
+    if (kind == "FastGemmPackB")
+        buffers.push_back(vectorToMat(*static_cast<const std::vector<float>*>(value.get()), CV_32F));
+    else if (kind == "FastGemmPackBReduced")
+        buffers.push_back(vectorToMat(*static_cast<const std::vector<ushort>*>(value.get()), CV_16U));
+    else if (kind == "FastConv")
+        serializeFastConv(*static_cast<const FastConv*>(value.get()), params, buffers);
+    else
+        return false;
+    return true;
+}
+
+Ptr<void> deserializeSharedWeights(const std::string& key,
+                                   const std::vector<int>& params, const std::vector<Mat>& buffers)
+{
+    const std::string kind = getSharedWeightsKind(key);
+    if (kind == "FastGemmPackB" || kind == "FastGemmPackBReduced")
+    {
+        // sizes of the buffers depend on the layer, they are checked when the layer requests the weights
+        const int type = kind == "FastGemmPackB" ? CV_32F : CV_16U;
+        if (!params.empty() || buffers.size() != 1 ||
+            (!buffers[0].empty() && (buffers[0].type() != type || !buffers[0].isContinuous())))
+            CV_Error(Error::StsParseError, "DNN: invalid serialized " + kind);
+        if (type == CV_32F)
+            return makePtr<std::vector<float> >(matToVector<float>(buffers[0]));
+        return makePtr<std::vector<ushort> >(matToVector<ushort>(buffers[0]));
+    }
+    if (kind == "FastConv")
+        return deserializeFastConv(params, buffers);
+    CV_Error(Error::StsParseError, "DNN: unknown kind of prepacked weights: " + kind);
+}
+
+}}  // namespace cv::dnn
@@ -0,0 +1,110 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#ifndef OPENCV_DNN_SHARED_WEIGHTS_HPP
+#define OPENCV_DNN_SHARED_WEIGHTS_HPP
+
+#include <opencv2/core.hpp>
+
+#include <map>
+#include <memory>
+#include <type_traits>
+
+namespace cv { namespace dnn {
+
+// Builds a key of prepacked weights: packing kind, parameters and content digest of the source data.
+// The digest is not cryptographic, so the source data is kept with the key and compared on lookups.
+class SharedWeightsKey
+{
+public:
+    explicit SharedWeightsKey(const char* kind);
+
+    SharedWeightsKey& add(int value);
+    SharedWeightsKey& add(const std::vector<size_t>& values);
+    SharedWeightsKey& add(const Mat& data);  // content digest, 'data' is referenced (copied if it is not refcounted)
+    SharedWeightsKey& add(const float* data, size_t count);  // content digest, 'data' is copied
+
+    const std::string& str() const { return key; }
+    const std::vector<Mat>& getSources() const { return sources; }
+
+protected:
+    std::string key;
+    std::vector<Mat> sources;
+};
+
+// Process-wide registry of immutable prepacked weights (e.g. FastConv, packed GEMM matrices).
+// Layers of different Net instances with the same weights (Net::clone(), the same model loaded several times)
+// reuse the same buffers. Entries are not owned by the registry and disappear with the last user,
+// the source data of an entry is referenced while it exists. Objects with the same key but other source data
+// (digest collision) are not shared.
+//
+// Can be disabled via OPENCV_DNN_SHARE_PACKED_WEIGHTS=0.
+bool isPackedWeightsSharingEnabled();
+Ptr<void> findSharedWeights(const SharedWeightsKey& key);
+// returns already registered object with the same key and source data (concurrent initialization) or 'value'
+Ptr<void> registerSharedWeights(const SharedWeightsKey& key, const Ptr<void>& value);
+
+typedef std::map<std::string, std::weak_ptr<void> > SharedWeightsMap;
+
+// Records the prepacked weights requested by the current thread while the object exists
+// (weights of a network for Net::writeCache(), see Net::Impl::packedWeights) and provides the weights
+// of the network cache file to the layers (Net::Impl::preloadedWeights). Scopes may be nested.
+class SharedWeightsCollector
+{
+public:
+    SharedWeightsCollector(SharedWeightsMap& map, const std::map<std::string, Ptr<void> >& preloaded);
+    ~SharedWeightsCollector();
+
+protected:
+    SharedWeightsMap* prevMap;
+    const std::map<std::string, Ptr<void> >* prevPreloaded;
+};
+void collectSharedWeights(const std::string& key, const Ptr<void>& value);
+// Weights of the cache file are not registered: they are visible only to the layers of the network
+// which has loaded them, under the keys computed by the layers from their own weights.
+Ptr<void> findPreloadedWeights(const std::string& key);
+void warnInvalidPreloadedWeights(const std::string& key);
+
+// Network cache file support: contents of prepacked weights as scalar parameters and buffers.
+// serializeSharedWeights() returns false for kinds of weights which are not serializable,
+// buffers may refer to the data of 'value'. deserializeSharedWeights() copies the buffers.
+bool serializeSharedWeights(const std::string& key, const Ptr<void>& value,
+                            std::vector<int>& params, std::vector<Mat>& buffers);
+Ptr<void> deserializeSharedWeights(const std::string& key,
+                                   const std::vector<int>& params, const std::vector<Mat>& buffers);
+
+// 'check' validates weights of the network cache file (e.g. sizes of the buffers), they are packed again if it fails
+template<typename T, typename Fn, typename Check> static inline
+Ptr<T> getSharedWeights(const SharedWeightsKey& key, Fn create, Check check)
+{
+    typedef typename std::remove_const<T>::type MutableT;
+    Ptr<T> value;
+    if (!isPackedWeightsSharingEnabled())
+        value = create();
+    else
+    {
+        Ptr<T> preloaded = std::static_pointer_cast<T>(findPreloadedWeights(key.str()));
+        if (preloaded && !check(*preloaded))
+        {
+            warnInvalidPreloadedWeights(key.str());
+            preloaded.reset();
+        }
+        if (preloaded)
+            value = preloaded;
+        else if (Ptr<void> found = findSharedWeights(key))
+            value = std::static_pointer_cast<T>(found);
+        else
+        {
+            Ptr<T> created = create();
+            Ptr<void> registered = registerSharedWeights(key, Ptr<MutableT>(std::const_pointer_cast<MutableT>(created)));
+            value = std::static_pointer_cast<T>(registered);
+        }
+    }
+    collectSharedWeights(key.str(), Ptr<MutableT>(std::const_pointer_cast<MutableT>(value)));
+    return value;
+}
+
+}}  // namespace cv::dnn
+
+#endif  // OPENCV_DNN_SHARED_WEIGHTS_HPP
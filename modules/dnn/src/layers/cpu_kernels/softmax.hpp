@@ -17,6 +17,46 @@
 
 namespace cv { namespace dnn {
 
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+// polynomial approximation of exp(x) used by softmax() and flashAttention(), x is clamped to [-88.38, 88.38].
+// The constants are hoisted out of the caller's loop once the function is inlined.
+static inline v_float32 v_exp_approx(const v_float32 &val)
+{
+    const v_float32 _vexp_lo = vx_setall_f32(-88.3762626647949f);
+    const v_float32 _vexp_hi = vx_setall_f32(88.3762626647949f);
+    const v_float32 _vexp_half = vx_setall_f32(0.5f);
+    const v_float32 _vexp_one = vx_setall_f32(1.f);
+    const v_float32 _vexp_LOG2EF = vx_setall_f32(1.44269504088896341f);
+    const v_float32 _vexp_C1 = vx_setall_f32(-0.693359375f);
+    const v_float32 _vexp_C2 = vx_setall_f32(2.12194440e-4f);
+    const v_float32 _vexp_p0 = vx_setall_f32(1.9875691500E-4f);
+    const v_float32 _vexp_p1 = vx_setall_f32(1.3981999507E-3f);
+    const v_float32 _vexp_p2 = vx_setall_f32(8.3334519073E-3f);
+    const v_float32 _vexp_p3 = vx_setall_f32(4.1665795894E-2f);
+    const v_float32 _vexp_p4 = vx_setall_f32(1.6666665459E-1f);
+    const v_float32 _vexp_p5 = vx_setall_f32(5.0000001201E-1f);
+
+    v_float32 _vexp_x = v_min(val, _vexp_hi);
+    _vexp_x = v_max(_vexp_x, _vexp_lo);
+    v_float32 _vexp_ = v_fma(_vexp_x, _vexp_LOG2EF, _vexp_half);
+    v_int32 _vexp_mm = v_floor(_vexp_);
+    _vexp_ = v_cvt_f32(_vexp_mm);
+    _vexp_mm = v_add(_vexp_mm, vx_setall_s32(0x7f));
+    _vexp_mm = v_shl(_vexp_mm, 23);
+    _vexp_x = v_fma(_vexp_, _vexp_C1, _vexp_x);
+    _vexp_x = v_fma(_vexp_, _vexp_C2, _vexp_x);
+    v_float32 _vexp_z = v_mul(_vexp_x, _vexp_x);
+    v_float32 _vexp_y = v_fma(_vexp_x, _vexp_p0, _vexp_p1);
+    _vexp_y = v_fma(_vexp_y, _vexp_x, _vexp_p2);
+    _vexp_y = v_fma(_vexp_y, _vexp_x, _vexp_p3);
+    _vexp_y = v_fma(_vexp_y, _vexp_x, _vexp_p4);
+    _vexp_y = v_fma(_vexp_y, _vexp_x, _vexp_p5);
+    _vexp_y = v_fma(_vexp_y, _vexp_z, _vexp_x);
+    _vexp_y = v_add(_vexp_y, _vexp_one);
+    return v_mul(_vexp_y, v_reinterpret_as_f32(_vexp_mm));
+}
+#endif
+
 void softmax(Mat &dst, const Mat &src, int axis, int axisBias, int axisStep);
 
 void softmax(Mat &dst, const Mat &src, int axis);
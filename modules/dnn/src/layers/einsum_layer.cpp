@@ -446,6 +446,63 @@ public:
 
     } // getMemoryShape
 
+    // Equations of matrix multiplication "bmk,bkn->bmn" or "bmk,bnk->bmn" (with any number of batch labels)
+    // are quantized as MatMulInt8 layer.
+    virtual bool tryQuantize(const std::vector<std::vector<float> > &scales,
+                             const std::vector<std::vector<int> > &zeropoints, LayerParams& params) CV_OVERRIDE
+    {
+        if (numInputs != 2 || lhs_eq_tokens.size() != 2 || rhs_eq.empty())
+            return false;
+        const String& a = lhs_eq_tokens[0];
+        const String& b = lhs_eq_tokens[1];
+        const String& y = rhs_eq;
+        const size_t ndims = a.size();
+        if (ndims < 2 || b.size() != ndims || y.size() != ndims || a.find('.') != String::npos)
+            return false;
+        if (a.compare(0, ndims - 2, b, 0, ndims - 2) != 0 || a.compare(0, ndims - 2, y, 0, ndims - 2) != 0)
+            return false;
+
+        char m = a[ndims - 2], k = a[ndims - 1], n = 0;
+        bool transB = false;
+        if (b[ndims - 2] == k)
+            n = b[ndims - 1];
+        else if (b[ndims - 1] == k)
+        {
+            n = b[ndims - 2];
+            transB = true;
+        }
+        if (n == 0 || y[ndims - 2] != m || y[ndims - 1] != n || m == n || m == k || n == k)
+            return false;
+        for (size_t i = 0; i < ndims - 2; i++)
+        {
+            if (a[i] == m || a[i] == n || a[i] == k || a.find(a[i], i + 1) < ndims - 2)
+                return false;  // reduction or diagonal along batch labels
+        }
+
+        if (!getQuantizationConstInput(params, 0).empty())
+            return false;
+        float inputScale = scales[0][0], outputScale = scales[1][0];
+        int inputZp = zeropoints[0][0];
+        Mat constB = getQuantizationConstInput(params, 1);
+        if (!constB.empty())
+        {
+            if (ndims != 2 || constB.type() != CV_32F)
+                return false;
+            quantizeMatMulWeights(constB, transB, Mat(), 1.f, inputScale, inputZp, outputScale,
+                                  params.get<bool>("per_channel", true), params.blobs);
+        }
+        else
+        {
+            params.blobs.clear();
+            params.set("transB", transB);
+            params.set("input_b_scale", scales[0][1]);
+            params.set("input_b_zeropoint", zeropoints[0][1]);
+        }
+        params.set("input_scale", inputScale);
+        params.set("input_zeropoint", inputZp);
+        return true;
+    }
+
     // forward
     void forward(InputArrayOfArrays inputs_arr,
                  OutputArrayOfArrays outputs_arr,
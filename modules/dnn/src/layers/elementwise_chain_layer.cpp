@@ -0,0 +1,289 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "../precomp.hpp"
+#include "../dnn_common.hpp"
+
+namespace cv { namespace dnn {
+CV__DNN_INLINE_NS_BEGIN
+
+inline namespace detail {
+
+// number of elements processed by all the stages before moving to the next tile (fits L1 together with an operand)
+enum { ELEMENTWISE_CHAIN_TILE = 2048 };
+
+struct ChainAdd { inline float operator()(float a, float b) const { return a + b; } };
+struct ChainSub { inline float operator()(float a, float b) const { return a - b; } };
+struct ChainMul { inline float operator()(float a, float b) const { return a * b; } };
+struct ChainDiv { inline float operator()(float a, float b) const { return a / b; } };
+struct ChainMax { inline float operator()(float a, float b) const { return std::max(a, b); } };
+struct ChainMin { inline float operator()(float a, float b) const { return std::min(a, b); } };
+
+// dst[j] = op(src[j], operand[j * step]) for j in [0, len)
+template<typename Op>
+static void binaryRow(const float* src, const float* operand, int step, float* dst, int len, bool reversed)
+{
+    Op op;
+    if (step == 0)
+    {
+        const float b = operand[0];
+        if (reversed)
+            for (int j = 0; j < len; j++)
+                dst[j] = op(b, src[j]);
+        else
+            for (int j = 0; j < len; j++)
+                dst[j] = op(src[j], b);
+    }
+    else
+    {
+        if (reversed)
+            for (int j = 0; j < len; j++)
+                dst[j] = op(operand[j], src[j]);
+        else
+            for (int j = 0; j < len; j++)
+                dst[j] = op(src[j], operand[j]);
+    }
+}
+
+class ElementwiseChainLayerImpl CV_FINAL : public ElementwiseChainLayer, public KernelInfo
+{
+public:
+    struct Stage
+    {
+        enum Kind { ACTIVATION, SCALE_SHIFT, BINARY };
+
+        Stage() : kind(ACTIVATION), op(OP_ADD), reversed(false), blob(0) {}
+
+        Kind kind;
+        Ptr<ActivationLayer> activ;
+        Mat scale, shift;
+        BinaryOp op;
+        bool reversed;
+        Mat value;  // constant operand
+        const Mat* blob;  // operand computed by another layer
+    };
+
+    ElementwiseChainLayerImpl(const String& name_, int inputIdx_)
+    {
+        name = name_;
+        type = "ElementwiseChain";
+        inputIdx = inputIdx_;
+    }
+
+    virtual bool supportBackend(int backendId) CV_OVERRIDE
+    {
+        return backendId == DNN_BACKEND_OPENCV;
+    }
+
+    void addActivation(const Ptr<ActivationLayer>& layer) CV_OVERRIDE
+    {
+        CV_Assert(layer);
+        Stage s;
+        s.kind = Stage::ACTIVATION;
+        s.activ = layer;
+        stages.push_back(s);
+    }
+
+    void addScaleShift(const Mat& scale, const Mat& shift) CV_OVERRIDE
+    {
+        CV_Assert(scale.empty() || scale.type() == CV_32F);
+        CV_Assert(shift.empty() || shift.type() == CV_32F);
+        Stage s;
+        s.kind = Stage::SCALE_SHIFT;
+        s.scale = scale.empty() ? Mat() : scale.reshape(1, 1).clone();
+        s.shift = shift.empty() ? Mat() : shift.reshape(1, 1).clone();
+        stages.push_back(s);
+    }
+
+    void addBinaryConst(BinaryOp op, const Mat& value, bool reversed) CV_OVERRIDE
+    {
+        CV_Assert(!value.empty() && value.type() == CV_32F);
+        Stage s;
+        s.kind = Stage::BINARY;
+        s.op = op;
+        s.reversed = reversed;
+        s.value = value.reshape(1, 1).clone();
+        stages.push_back(s);
+    }
+
+    void addBinaryBlob(BinaryOp op, const Mat* blob, bool reversed) CV_OVERRIDE
+    {
+        CV_Assert(blob);
+        Stage s;
+        s.kind = Stage::BINARY;
+        s.op = op;
+        s.reversed = reversed;
+        s.blob = blob;
+        stages.push_back(s);
+    }
+
+    int getNumStages() const CV_OVERRIDE
+    {
+        return (int)stages.size();
+    }
+
+    String getKernelInfo() const CV_OVERRIDE
+    {
+        return format("elementwise_chain (%d stages)", (int)stages.size());
+    }
+
+    class ChainInvoker : public ParallelLoopBody
+    {
+    public:
+        ChainInvoker(const std::vector<Stage>& stages_, const float* src_, float* dst_, int nsamples_, int channels_,
+                     size_t planeSize_)
+            : stages(stages_), src(src_), dst(dst_), nsamples(nsamples_), channels(channels_), planeSize(planeSize_)
+        {
+            // a tile is either a part of one plane or several whole planes of the same sample
+            if (planeSize >= (size_t)ELEMENTWISE_CHAIN_TILE)
+            {
+                blockCn = 1;
+                blockLen = ELEMENTWISE_CHAIN_TILE;
+            }
+            else
+            {
+                blockCn = std::max(1, (int)(ELEMENTWISE_CHAIN_TILE / std::max(planeSize, (size_t)1)));
+                blockLen = (int)planeSize;
+            }
+            blocksPerPlane = planeSize == 0 ? 0 : (int)((planeSize + blockLen - 1) / blockLen);
+            blocksPerSample = ((channels + blockCn - 1) / blockCn) * blocksPerPlane;
+
+            operands.resize(stages.size());
+            for (size_t i = 0; i < stages.size(); i++)
+            {
+                const Stage& s = stages[i];
+                if (s.kind != Stage::BINARY)
+                    continue;
+                const Mat& m = s.blob ? *s.blob : s.value;
+                CV_Assert(m.isContinuous() && m.type() == CV_32F);
+                size_t n = m.total();
+                CV_Assert(n == 1 || n == (size_t)channels || n == (size_t)nsamples * channels * planeSize);
+                operands[i] = m.ptr<float>();
+            }
+        }
+
+        int getNumTiles() const { return nsamples * blocksPerSample; }
+
+        void operator()(const Range& r) const CV_OVERRIDE
+        {
+            for (int tile = r.start; tile < r.end; tile++)
+            {
+                const int n = tile / blocksPerSample;
+                const int cb = (tile - n * blocksPerSample) / blocksPerPlane;
+                const int pb = tile - n * blocksPerSample - cb * blocksPerPlane;
+                const int cn0 = cb * blockCn, cn1 = std::min(cn0 + blockCn, channels);
+                const size_t p0 = (size_t)pb * blockLen;
+                const int len = (int)std::min((size_t)blockLen, planeSize - p0);
+                const size_t ofs = ((size_t)n * channels + cn0) * planeSize + p0;
+
+                const float* inp = src + ofs;
+                float* out = dst + ofs;
+                for (size_t i = 0; i < stages.size(); i++)
+                {
+                    applyStage(i, inp, out, ofs, len, cn0, cn1);
+                    inp = out;
+                }
+            }
+        }
+
+    private:
+        void applyStage(size_t i, const float* inp, float* out, size_t ofs, int len, int cn0, int cn1) const
+        {
+            const Stage& s = stages[i];
+            if (s.kind == Stage::ACTIVATION)
+            {
+                s.activ->forwardSlice(inp, out, len, planeSize, cn0, cn1);
+                return;
+            }
+            for (int c = cn0; c < cn1; c++)
+            {
+                const size_t delta = (size_t)(c - cn0) * planeSize;
+                const float* sp = inp + delta;
+                float* dp = out + delta;
+                if (s.kind == Stage::SCALE_SHIFT)
+                {
+                    const float a = s.scale.empty() ? 1.f : s.scale.ptr<float>()[s.scale.total() == 1 ? 0 : c];
+                    const float b = s.shift.empty() ? 0.f : s.shift.ptr<float>()[s.shift.total() == 1 ? 0 : c];
+                    for (int j = 0; j < len; j++)
+                        dp[j] = sp[j] * a + b;
+                    continue;
+                }
+
+                const size_t n = (s.blob ? *s.blob : s.value).total();
+                const float* operand = operands[i];
+                int step = 0;
+                if (n == (size_t)nsamples * channels * planeSize)
+                {
+                    operand += ofs + delta;
+                    step = 1;
+                }
+                else if (n != 1)
+                    operand += c;
+                switch (s.op)
+                {
+                case OP_ADD: binaryRow<ChainAdd>(sp, operand, step, dp, len, s.reversed); break;
+                case OP_SUB: binaryRow<ChainSub>(sp, operand, step, dp, len, s.reversed); break;
+                case OP_MUL: binaryRow<ChainMul>(sp, operand, step, dp, len, s.reversed); break;
+                case OP_DIV: binaryRow<ChainDiv>(sp, operand, step, dp, len, s.reversed); break;
+                case OP_MAX: binaryRow<ChainMax>(sp, operand, step, dp, len, s.reversed); break;
+                case OP_MIN: binaryRow<ChainMin>(sp, operand, step, dp, len, s.reversed); break;
+                default: CV_Error(Error::StsNotImplemented, "");
+                }
+            }
+        }
+
+        const std::vector<Stage>& stages;
+        std::vector<const float*> operands;
+        const float* src;
+        float* dst;
+        int nsamples, channels;
+        size_t planeSize;
+        int blockCn, blockLen, blocksPerPlane, blocksPerSample;
+    };
+
+    void forward(InputArrayOfArrays inputs_arr, OutputArrayOfArrays outputs_arr, OutputArrayOfArrays internals_arr) CV_OVERRIDE
+    {
+        CV_TRACE_FUNCTION();
+        CV_TRACE_ARG_VALUE(name, "name", name.c_str());
+
+        std::vector<Mat> inputs, outputs;
+        inputs_arr.getMatVector(inputs);
+        outputs_arr.getMatVector(outputs);
+        CV_Assert(inputIdx < (int)inputs.size() && outputs.size() == 1);
+
+        const Mat& src = inputs[inputIdx];
+        Mat& dst = outputs[0];
+        CV_Assert(src.type() == CV_32F && dst.type() == CV_32F && src.total() == dst.total() &&
+                  src.isContinuous() && dst.isContinuous());
+
+        int nsamples = 1, channels = 1;
+        if (src.dims > 1)
+        {
+            nsamples = src.size[0];
+            channels = src.size[1];
+        }
+        else if (src.dims == 1)
+            channels = src.size[0];
+        const size_t planeSize = src.dims > 2 ? src.total(2) : 1;
+
+        ChainInvoker invoker(stages, src.ptr<float>(), dst.ptr<float>(), nsamples, channels, planeSize);
+        const int ntiles = invoker.getNumTiles();
+        if (ntiles > 0)
+            parallel_for_(Range(0, ntiles), invoker, std::min(ntiles, getNumThreads() * 4));
+    }
+
+private:
+    int inputIdx;
+    std::vector<Stage> stages;
+};
+
+Ptr<ElementwiseChainLayer> ElementwiseChainLayer::create(const String& name, int inputIdx)
+{
+    return makePtr<ElementwiseChainLayerImpl>(name, inputIdx);
+}
+
+}  // namespace detail
+
+CV__DNN_INLINE_NS_END
+}}  // namespace cv::dnn
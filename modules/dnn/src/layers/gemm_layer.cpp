@@ -17,10 +17,12 @@ using namespace cv::dnn::cuda4dnn;
 
 #include <opencv2/dnn/shape_utils.hpp>
 #include "cpu_kernels/fast_gemm.hpp"
+#include "cpu_kernels/shared_weights.hpp"
+#include "cpu_kernels/reduced_precision.hpp"
 
 namespace cv { namespace dnn {
 
-class GemmLayerImpl CV_FINAL : public GemmLayer {
+class GemmLayerImpl CV_FINAL : public GemmLayer, public KernelInfo {
 public:
     GemmLayerImpl(const LayerParams& params) {
         setParamsFrom(params);
@@ -35,6 +37,7 @@ public:
         have_bias = params.get<bool>("have_bias", false); // NOTE: have_bias being true does not mean bias is constant
 
         real_ndims_C = params.get<int>("real_ndims_C", -1);
+        weights_precision = REDUCED_PRECISION_NONE;
     }
 
     virtual bool supportBackend(int backendId) CV_OVERRIDE {
@@ -148,7 +151,14 @@ public:
 
         // pack B if it is const
         if (const_B) {
-            fastGemmPackB(blobs[0], packed_B, trans_b, opt);
+            weights_precision = preferableTarget == DNN_TARGET_CPU_FP16 ? getReducedPrecisionWeightsType() : (int)REDUCED_PRECISION_NONE;
+            if (weights_precision != REDUCED_PRECISION_NONE) {
+                packed_B_reduced = fastGemmPackBReducedShared(blobs[0], weights_precision, trans_b, opt);
+                packed_B.reset();
+            } else {
+                packed_B = fastGemmPackBShared(blobs[0], trans_b, opt);
+                packed_B_reduced.reset();
+            }
         }
 
         // also pre-broadcast bias
@@ -207,9 +217,14 @@ public:
             std::memset(ptr_y, 0, total * sizeof(float));
         }
 
-        if (const_B) {
-            CV_CheckGT(packed_B.size(), static_cast<size_t>(0), "DNN/Gemm: constant B is not pre-packed");
-            fastGemm(trans_a, M, N, K, alpha, A.ptr<const float>(), na, packed_B.data(), 1.f, Y.ptr<float>(), N, opt);
+        if (const_B && packed_B_reduced) {
+            CV_CheckGT(packed_B_reduced->size(), static_cast<size_t>(0), "DNN/Gemm: constant B is not pre-packed");
+            fastGemm(trans_a, M, N, K, alpha, A.ptr<const float>(), na, packed_B_reduced->data(), weights_precision,
+                     1.f, Y.ptr<float>(), N, opt);
+        } else if (const_B) {
+            CV_Assert(packed_B);
+            CV_CheckGT(packed_B->size(), static_cast<size_t>(0), "DNN/Gemm: constant B is not pre-packed");
+            fastGemm(trans_a, M, N, K, alpha, A.ptr<const float>(), na, packed_B->data(), 1.f, Y.ptr<float>(), N, opt);
         } else {
             fastGemmBatch(trans_a, trans_b, alpha, A, inputs[1], 1.f, Y, opt);
         }
@@ -353,11 +368,54 @@ public:
     }
 #endif
 
+    virtual bool tryQuantize(const std::vector<std::vector<float> > &scales,
+                             const std::vector<std::vector<int> > &zeropoints, LayerParams& params) CV_OVERRIDE
+    {
+        if (trans_a || alpha == 0.f)
+            return false;
+
+        float inputScale = scales[0][0], outputScale = scales[1][0];
+        int inputZp = zeropoints[0][0];
+        if (const_B)
+        {
+            Mat bias;
+            if (have_bias)
+            {
+                int N = trans_b ? blobs[0].size[0] : blobs[0].size[1];
+                const Mat& C = blobs.back();
+                // only bias which is broadcasted along rows
+                if (!const_C || (C.total() != 1 && (C.total() != (size_t)N || (C.dims == 2 && C.size[1] != N))))
+                    return false;
+                bias = C * beta;
+            }
+            quantizeMatMulWeights(blobs[0], trans_b, bias, alpha, inputScale, inputZp, outputScale,
+                                  params.get<bool>("per_channel", true), params.blobs);
+        }
+        else
+        {
+            if (have_bias)
+                return false;
+            params.blobs.clear();
+            params.set("input_b_scale", scales[0][1]);
+            params.set("input_b_zeropoint", zeropoints[0][1]);
+        }
+        params.set("input_scale", inputScale);
+        params.set("input_zeropoint", inputZp);
+        return true;
+    }
+
+    String getKernelInfo() const CV_OVERRIDE {
+        const char* kind = !const_B ? "fast_gemm_batch" : packed_B_reduced ? "fast_gemm_packed_16bit" : "fast_gemm_packed";
+        return format("%s %s", kind, opt.getISA());
+    }
+
 private:
     bool const_B;
     bool const_C;
     bool have_bias;
-    std::vector<float> packed_B;
+    Ptr<const std::vector<float> > packed_B;  // shared between Net instances
+    Ptr<const std::vector<ushort> > packed_B_reduced;  // DNN_TARGET_CPU_FP16
+    int weights_precision;
     std::vector<float> broadcast_C;
     int real_ndims_C;
     FastGemmOpt opt;
@@ -264,5 +264,55 @@ double getWeightScale(const Mat& weightsMat)
     return (realMax == realMin) ? 1.0 : std::max(-realMin, realMax)/127;
 }
 
+Mat getQuantizationConstInput(const LayerParams& params, int inputIdx)
+{
+    if (!params.has("const_inputs"))
+        return Mat();
+    const DictValue& ids = params.get("const_inputs");
+    CV_Assert((size_t)ids.size() <= params.blobs.size());
+    for (int i = 0; i < ids.size(); i++)
+    {
+        if (ids.get<int>(i) == inputIdx)
+            return params.blobs[params.blobs.size() - ids.size() + i];
+    }
+    return Mat();
+}
+
+void quantizeMatMulWeights(const Mat& B, bool transB, const Mat& bias, float alpha,
+                           float inputScale, int inputZp, float outputScale, bool perChannel,
+                           std::vector<Mat>& blobs)
+{
+    CV_Assert(B.dims == 2 && B.type() == CV_32F);
+    Mat weights = B;
+    if (!transB)
+        weights = B.t();
+    int numOutput = weights.rows;
+    CV_Assert(bias.empty() || bias.total() == 1 || bias.total() == (size_t)numOutput);
+    Mat biasMat;
+    if (!bias.empty())
+        bias.reshape(1, 1).convertTo(biasMat, CV_32F);
+
+    Mat weightsQuantized(numOutput, weights.cols, CV_8S);
+    Mat biasQuantized(1, numOutput, CV_32S);
+    Mat outputMultiplier(1, numOutput, CV_32F);
+    double tensorScale = perChannel ? 0. : getWeightScale(weights);
+
+    for (int i = 0; i < numOutput; i++)
+    {
+        double weightsScale = perChannel ? getWeightScale(weights.row(i)) : tensorScale;
+
+        weights.row(i).convertTo(weightsQuantized.row(i), CV_8S, 1.f/weightsScale);
+        float biasScale = (float)(alpha * inputScale * weightsScale);
+        float b = biasMat.empty() ? 0.f : biasMat.at<float>(biasMat.total() == 1 ? 0 : i);
+        biasQuantized.at<int>(i) = cvRound(b/biasScale) - inputZp*(cv::sum(weightsQuantized.row(i))[0]);
+        outputMultiplier.at<float>(i) = biasScale / outputScale;
+    }
+
+    blobs.clear();
+    blobs.push_back(weightsQuantized);
+    blobs.push_back(biasQuantized);
+    blobs.push_back(outputMultiplier);
+}
+
 }
 }
@@ -76,6 +76,16 @@ void getConvPoolPaddings(const std::vector<int>& inp, const std::vector<size_t>&
 
 // Used in quantized model. It will return the (Max_element - Min_element)/127.
 double getWeightScale(const Mat& weightsMat);
+
+// Constant inputs (Const layers) of some layers are passed to tryQuantize() at the end of params.blobs,
+// "const_inputs" lists their input indices. Returns empty Mat if the input is not constant.
+Mat getQuantizationConstInput(const LayerParams& params, int inputIdx);
+
+// Quantizes constant B (K x N or N x K if transB) of matrix multiplication for MatMulInt8/AttentionInt8 layers.
+// Produces int8 weights (N x K), bias with folded input zeropoint (int32) and multipliers of int32 sums (float).
+void quantizeMatMulWeights(const Mat& B, bool transB, const Mat& bias, float alpha,
+                           float inputScale, int inputZp, float outputScale, bool perChannel,
+                           std::vector<Mat>& blobs);
 }
 }
 
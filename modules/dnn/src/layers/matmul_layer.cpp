@@ -5,7 +5,10 @@
 #include "../precomp.hpp"
 
 #include <opencv2/dnn/shape_utils.hpp>
+#include "layers_common.hpp"
 #include "cpu_kernels/fast_gemm.hpp"
+#include "cpu_kernels/shared_weights.hpp"
+#include "cpu_kernels/reduced_precision.hpp"
 
 // OpenVINO backend
 #include "../op_inf_engine.hpp"
@@ -25,7 +28,7 @@ using namespace cv::dnn::cuda4dnn;
 
 namespace cv { namespace dnn {
 
-class MatMulLayerImpl CV_FINAL : public MatMulLayer {
+class MatMulLayerImpl CV_FINAL : public MatMulLayer, public KernelInfo {
  public:
     MatMulLayerImpl(const LayerParams& params) {
         setParamsFrom(params);
@@ -34,6 +37,7 @@ class MatMulLayerImpl CV_FINAL : public MatMulLayer {
         trans_b = params.get<bool>("transB", false);
         alpha = params.get<float>("alpha", 1.f);
         beta = params.get<float>("beta", 1.f);
+        weights_precision = REDUCED_PRECISION_NONE;
     }
 
     virtual bool supportBackend(int backendId) CV_OVERRIDE {
@@ -106,8 +110,16 @@ class MatMulLayerImpl CV_FINAL : public MatMulLayer {
         helper.compute(trans_a, trans_b, A_shape, B_shape, C_shape);
 
         if (!blobs.empty()) {
-            fastGemmPackB(blobs[0], packed_input_B, trans_b, opt);
-            helper.updatePackedBOffsets(packed_input_B.size());
+            weights_precision = preferableTarget == DNN_TARGET_CPU_FP16 ? getReducedPrecisionWeightsType() : (int)REDUCED_PRECISION_NONE;
+            if (weights_precision != REDUCED_PRECISION_NONE) {
+                packed_input_B_reduced = fastGemmPackBReducedShared(blobs[0], weights_precision, trans_b, opt);
+                packed_input_B.reset();
+                helper.updatePackedBOffsets(packed_input_B_reduced->size());
+            } else {
+                packed_input_B = fastGemmPackBShared(blobs[0], trans_b, opt);
+                packed_input_B_reduced.reset();
+                helper.updatePackedBOffsets(packed_input_B->size());
+            }
         }
     }
 
@@ -142,10 +154,14 @@ class MatMulLayerImpl CV_FINAL : public MatMulLayer {
             fastGemmBatch(helper.batch, helper.A_offsets.data(), helper.B_offsets.data(), helper.C_offsets.data(),
                           helper.M, helper.N, helper.K, alpha, a, helper.lda0, helper.lda1,
                           b, helper.ldb0, helper.ldb1, beta, y, helper.ldc, opt);
+        } else if (packed_input_B_reduced) {
+            fastGemmBatch(helper.batch, helper.A_offsets.data(), helper.packed_B_offsets.data(), helper.C_offsets.data(),
+                          helper.M, helper.N, helper.K, alpha, a, helper.lda0, helper.lda1,
+                          packed_input_B_reduced->data(), weights_precision, beta, y, helper.ldc, opt);
         } else {
             fastGemmBatch(helper.batch, helper.A_offsets.data(), helper.packed_B_offsets.data(), helper.C_offsets.data(),
                           helper.M, helper.N, helper.K, alpha, a, helper.lda0, helper.lda1,
-                          packed_input_B.data(), beta, y, helper.ldc, opt);
+                          packed_input_B->data(), beta, y, helper.ldc, opt);
         }
     }
 
@@ -306,13 +322,46 @@ class MatMulLayerImpl CV_FINAL : public MatMulLayer {
     }
 #endif // HAVE_CANN
 
+    virtual bool tryQuantize(const std::vector<std::vector<float> > &scales,
+                             const std::vector<std::vector<int> > &zeropoints, LayerParams& params) CV_OVERRIDE
+    {
+        if (trans_a || alpha == 0.f)
+            return false;
+
+        float inputScale = scales[0][0], outputScale = scales[1][0];
+        int inputZp = zeropoints[0][0];
+        if (!blobs.empty())
+        {
+            if (blobs[0].dims != 2)  // constant B with batch dimensions
+                return false;
+            quantizeMatMulWeights(blobs[0], trans_b, Mat(), alpha, inputScale, inputZp, outputScale,
+                                  params.get<bool>("per_channel", true), params.blobs);
+        }
+        else
+        {
+            params.blobs.clear();
+            params.set("input_b_scale", scales[0][1]);
+            params.set("input_b_zeropoint", zeropoints[0][1]);
+        }
+        params.set("input_scale", inputScale);
+        params.set("input_zeropoint", inputZp);
+        return true;
+    }
+
+    String getKernelInfo() const CV_OVERRIDE {
+        const char* kind = blobs.empty() ? "fast_gemm_batch" : packed_input_B_reduced ? "fast_gemm_packed_16bit" : "fast_gemm_packed";
+        return format("%s %s", kind, opt.getISA());
+    }
+
  private:
     bool trans_a;
     bool trans_b;
     float alpha;
     float beta;
 
-    std::vector<float> packed_input_B;
+    Ptr<const std::vector<float> > packed_input_B;  // shared between Net instances
+    Ptr<const std::vector<ushort> > packed_input_B_reduced;  // DNN_TARGET_CPU_FP16
+    int weights_precision;
 
     FastGemmOpt opt;
     MatMulHelper helper;
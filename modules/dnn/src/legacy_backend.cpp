@@ -126,6 +126,157 @@ Ptr<BackendWrapper> wrapMat(int backendId, int targetId, cv::Mat& m)
 }  // wrapMat()
 
 
+void BlobManager::planBlobsForLayer(const LayerData& ld, const LayerShapes& layerShapes,
+        std::vector<LayerPin>& pinsForInternalBlobs)
+{
+    CV_TRACE_FUNCTION();
+    CV_Assert(planning);
+
+    pinsForInternalBlobs.clear();
+
+    const ShapesVec& outShapes = layerShapes.out;
+    const ShapesVec& internalShapes = layerShapes.internal;
+    const size_t numOutputs = std::max((size_t)1, outShapes.size());
+
+    // the same conditions as in allocateBlobsForLayer()
+    bool inPlace = layerShapes.supportInPlace && ld.inputBlobsId.size() == 1 &&
+                   numReferences(ld.inputBlobsId[0]) == 1;
+
+    for (size_t i = 0; i < internalShapes.size(); i++)
+    {
+        if (total(internalShapes[i]))
+            pinsForInternalBlobs.push_back(LayerPin(ld.id, (int)(numOutputs + i)));
+    }
+    addReferences(pinsForInternalBlobs);
+
+    for (size_t i = 0; i < outShapes.size() + internalShapes.size(); i++)
+    {
+        const MatShape& shape = i < outShapes.size() ? outShapes[i] : internalShapes[i - outShapes.size()];
+        const size_t blobTotal = total(shape);
+        if (!blobTotal)
+            continue;
+        LayerPin blobPin(ld.id, (int)i);
+        if (i < outShapes.size() && inPlace)
+        {
+            reuse(ld.inputBlobsId[0], blobPin);
+            continue;
+        }
+        reuseMap[blobPin] = blobPin;
+        if (ld.id == 0)
+            continue;  // network inputs
+        PlannedHost host;
+        host.pin = blobPin;
+        host.dtype = ld.dtype;
+        host.total = blobTotal;
+        host.start = step;
+        host.end = INT_MAX;  // not released: network output or blob to keep
+        host.offset = 0;
+        plannedHostsIdx[blobPin] = (int)plannedHosts.size();
+        plannedHosts.push_back(host);
+    }
+}
+
+size_t BlobManager::computePlan()
+{
+    CV_TRACE_FUNCTION();
+
+    std::map<int, size_t> arenaTotals;
+    std::vector<int> order(plannedHosts.size());
+    for (size_t i = 0; i < order.size(); i++)
+        order[i] = (int)i;
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        return plannedHosts[a].total > plannedHosts[b].total;
+    });
+
+    std::vector<int> placed;
+    std::vector<std::pair<size_t, size_t> > busy;  // [offset, offset + size) of live placed hosts
+    for (size_t k = 0; k < order.size(); k++)
+    {
+        PlannedHost& host = plannedHosts[order[k]];
+        const size_t align = std::max((size_t)1, (size_t)64 / CV_ELEM_SIZE(host.dtype));
+        const size_t size = alignSize(host.total, (int)align);
+
+        busy.clear();
+        for (size_t j = 0; j < placed.size(); j++)
+        {
+            const PlannedHost& other = plannedHosts[placed[j]];
+            if (other.dtype == host.dtype && other.start <= host.end && host.start <= other.end)
+                busy.push_back(std::make_pair(other.offset, other.offset + alignSize(other.total, (int)align)));
+        }
+        std::sort(busy.begin(), busy.end());
+
+        size_t bestOffset = 0, bestGap = 0, prevEnd = 0;
+        bool found = false;
+        for (size_t j = 0; j < busy.size(); j++)
+        {
+            if (busy[j].first > prevEnd)
+            {
+                size_t gap = busy[j].first - prevEnd;
+                if (gap >= size && (!found || gap < bestGap))
+                {
+                    found = true;
+                    bestOffset = prevEnd;
+                    bestGap = gap;
+                }
+            }
+            prevEnd = std::max(prevEnd, busy[j].second);
+        }
+        host.offset = found ? bestOffset : prevEnd;
+        size_t& arenaTotal = arenaTotals[host.dtype];
+        arenaTotal = std::max(arenaTotal, host.offset + host.total);
+        placed.push_back(order[k]);
+    }
+
+    size_t bytes = 0;
+    for (std::map<int, size_t>::const_iterator it = arenaTotals.begin(); it != arenaTotals.end(); ++it)
+        bytes += it->second * CV_ELEM_SIZE(it->first);
+    return bytes;
+}
+
+void BlobManager::applyPlan()
+{
+    CV_TRACE_FUNCTION();
+    CV_Assert(planning);
+
+    std::map<int, size_t> arenaTotals;
+    for (size_t i = 0; i < plannedHosts.size(); i++)
+    {
+        const PlannedHost& host = plannedHosts[i];
+        size_t& arenaTotal = arenaTotals[host.dtype];
+        arenaTotal = std::max(arenaTotal, host.offset + host.total);
+    }
+    if (!keepArenas)
+        arenas.clear();
+    for (std::map<int, size_t>::const_iterator it = arenaTotals.begin(); it != arenaTotals.end(); ++it)
+    {
+        CV_Assert(it->second <= (size_t)INT_MAX);
+        Mat& arena = arenas[it->first];
+        if (arena.empty() || arena.total() < it->second)
+            arena.create(1, (int)it->second, it->first);
+    }
+
+    refCounter.clear();
+    reuseMap.clear();
+    memHosts.clear();
+    planning = false;
+    usePlan = true;
+}
+
+bool BlobManager::createFromPlan(const MatShape& shape, const LayerPin& lp, Mat& dst, const int& dtype)
+{
+    std::map<LayerPin, int>::const_iterator it = plannedHostsIdx.find(lp);
+    if (it == plannedHostsIdx.end())
+        return false;
+    const PlannedHost& host = plannedHosts[it->second];
+    if (host.dtype != dtype || host.total != (size_t)total(shape))
+        return false;  // unexpected shape change, fallback on regular allocation
+    const Mat& arena = arenas[dtype];
+    dst = arena.colRange((int)host.offset, (int)(host.offset + host.total)).reshape(1, shape);
+    CV_Assert(reuseMap.find(lp) == reuseMap.end());
+    reuseMap[lp] = lp;
+    return true;
+}
+
 }  // namespace detail
 CV__DNN_INLINE_NS_END
 }}  // namespace cv::dnn
@@ -109,6 +109,8 @@ private:
 struct BlobManager
 {
 public:
+    BlobManager() : planning(false), usePlan(false), keepArenas(false), step(0) {}
+
     // Increase references counter to layer output.
     void addReference(const LayerPin& lp)
     {
@@ -170,6 +172,8 @@ public:
         CV_Assert(refIt != refCounter.end());
         CV_Assert(refIt->second > 0);
         refIt->second -= 1;
+        if (planning && refIt->second == 0)
+            onHostReleased(refIt->first);
     }
 
     void releaseReferences(const std::vector<LayerPin>& pins)
@@ -182,6 +186,9 @@ public:
 
     void reuseOrCreate(const MatShape& shape, const LayerPin& lp, Mat& dst, const int& dtype)
     {
+        if (usePlan && lp.lid != 0 && createFromPlan(shape, lp, dst, dtype))
+            return;
+
         if (!getParam_DNN_DISABLE_MEMORY_OPTIMIZATIONS())
         {
             Mat bestBlob;
@@ -311,9 +318,72 @@ public:
         refCounter.clear();
         reuseMap.clear();
         memHosts.clear();
+        planning = false;
+        usePlan = false;
+        step = 0;
+        plannedHosts.clear();
+        plannedHostsIdx.clear();
+        if (!keepArenas)
+            arenas.clear();
+    }
+
+    // Arenas are not released on reallocation and reused by smaller plans (dynamic input shapes)
+    void setKeepArenas(bool keep) { keepArenas = keep; }
+
+    // Memory planner: packs intermediate blobs into a single arena per data type.
+    //
+    // 1. beginPlanning(), then the same sequence of calls as for allocation, but with planBlobsForLayer()
+    //    and nextStep() after each layer. This dry run collects lifetimes of memory hosts (from allocation
+    //    of the blob to release of its last reference, including in-place users).
+    // 2. computePlan() assigns arena offsets: hosts with overlapping lifetimes don't overlap in memory.
+    //    Hosts are placed from the largest one into the best fitting gap between overlapping hosts.
+    // 3. applyPlan() allocates arenas and resets references. Following allocateBlobsForLayer() calls
+    //    bind blobs to arena slices.
+    //
+    // Network inputs (layer 0) are not planned.
+    void beginPlanning()
+    {
+        reset();
+        planning = true;
+    }
+
+    void planBlobsForLayer(const LayerData& ld, const LayerShapes& layerShapes,
+            std::vector<LayerPin>& pinsForInternalBlobs);
+
+    void nextStep() { step++; }
+
+    // Returns planned size of arenas in bytes
+    size_t computePlan();
+
+    void applyPlan();
+
+    size_t getArenasSize() const
+    {
+        size_t size = 0;
+        for (std::map<int, Mat>::const_iterator it = arenas.begin(); it != arenas.end(); ++it)
+            size += it->second.total() * it->second.elemSize();
+        return size;
     }
 
 private:
+    struct PlannedHost
+    {
+        LayerPin pin;
+        int dtype;
+        size_t total;  // elements
+        int start, end;  // lifetime (steps), inclusive
+        size_t offset;  // elements
+    };
+
+    void onHostReleased(const LayerPin& host)
+    {
+        std::map<LayerPin, int>::const_iterator it = plannedHostsIdx.find(host);
+        if (it != plannedHostsIdx.end())
+            plannedHosts[it->second].end = step;
+    }
+
+    bool createFromPlan(const MatShape& shape, const LayerPin& lp, Mat& dst, const int& dtype);
+
     // Register allocated memory.
     void addHost(const LayerPin& lp, const Mat& mat)
     {
@@ -327,6 +397,14 @@ private:
     // For origin blobs key == value.
     std::map<LayerPin, LayerPin> reuseMap;
     std::map<LayerPin, Mat> memHosts;
+
+    bool planning;  // dry run, blobs are not allocated
+    bool usePlan;
+    bool keepArenas;
+    int step;
+    std::vector<PlannedHost> plannedHosts;
+    std::map<LayerPin, int> plannedHostsIdx;
+    std::map<int, Mat> arenas;  // per data type
 };  // BlobManager
 
 
@@ -24,6 +24,7 @@ int Net::addLayer(const String& name, const String& type, const int& dtype, Laye
 {
     CV_TRACE_FUNCTION();
     CV_Assert(impl);
+    impl->resetAsyncQueue();
     return impl->addLayer(name, type, dtype, params);
 }
 
@@ -37,6 +38,7 @@ int Net::addLayerToPrev(const String& name, const String& type, const int& dtype
 {
     CV_TRACE_FUNCTION();
     CV_Assert(impl);
+    impl->resetAsyncQueue();
     return impl->addLayerToPrev(name, type, dtype, params);
 }
 
@@ -50,6 +52,7 @@ void Net::connect(int outLayerId, int outNum, int inpLayerId, int inpNum)
 {
     CV_TRACE_FUNCTION();
     CV_Assert(impl);
+    impl->resetAsyncQueue();
     impl->connect(outLayerId, outNum, inpLayerId, inpNum);
 }
 
@@ -58,6 +61,7 @@ void Net::connect(String _outPin, String _inPin)
     CV_TRACE_FUNCTION();
 
     CV_Assert(impl);
+    impl->resetAsyncQueue();
     LayerPin outPin = impl->getPinByAlias(_outPin);
     LayerPin inpPin = impl->getPinByAlias(_inPin);
 
@@ -70,6 +74,7 @@ int Net::registerOutput(const std::string& outputName, int layerId, int outputPo
 {
     CV_TRACE_FUNCTION();
     CV_Assert(impl);
+    impl->resetAsyncQueue();
     return impl->registerOutput(outputName, layerId, outputPort);
 }
 
@@ -78,6 +83,7 @@ Mat Net::forward(const String& outputName)
     CV_TRACE_FUNCTION();
     CV_Assert(impl);
     CV_Assert(!empty());
+    impl->finishAsyncRequests();
     return impl->forward(outputName);
 }
 
@@ -94,6 +100,7 @@ void Net::forward(OutputArrayOfArrays outputBlobs, const String& outputName)
     CV_TRACE_FUNCTION();
     CV_Assert(impl);
     CV_Assert(!empty());
+    impl->finishAsyncRequests();
     return impl->forward(outputBlobs, outputName);
 }
 
@@ -103,6 +110,7 @@ void Net::forward(OutputArrayOfArrays outputBlobs,
     CV_TRACE_FUNCTION();
     CV_Assert(impl);
     CV_Assert(!empty());
+    impl->finishAsyncRequests();
     return impl->forward(outputBlobs, outBlobNames);
 }
 
@@ -112,6 +120,7 @@ void Net::forward(std::vector<std::vector<Mat>>& outputBlobs,
     CV_TRACE_FUNCTION();
     CV_Assert(impl);
     CV_Assert(!empty());
+    impl->finishAsyncRequests();
     return impl->forward(outputBlobs, outBlobNames);
 }
 
@@ -121,6 +130,7 @@ Net Net::quantize(InputArrayOfArrays calibData, int inputsDtype, int outputsDtyp
     CV_TRACE_FUNCTION();
     CV_Assert(impl);
     CV_Assert(!empty());
+    impl->finishAsyncRequests();
     return impl->quantize(*this, calibData, inputsDtype, outputsDtype, perChannel);
 }
 
@@ -130,6 +140,7 @@ void Net::getInputDetails(std::vector<float>& scales, std::vector<int>& zeropoin
     CV_TRACE_FUNCTION();
     CV_Assert(impl);
     CV_Assert(!empty());
+    impl->finishAsyncRequests();
     return impl->getInputDetails(scales, zeropoints);
 }
 
@@ -139,6 +150,7 @@ void Net::getOutputDetails(std::vector<float>& scales, std::vector<int>& zeropoi
     CV_TRACE_FUNCTION();
     CV_Assert(impl);
     CV_Assert(!empty());
+    impl->finishAsyncRequests();
     return impl->getOutputDetails(scales, zeropoints);
 }
 
@@ -162,6 +174,7 @@ void Net::setInputsNames(const std::vector<String>& inputBlobNames)
 {
     CV_TRACE_FUNCTION();
     CV_Assert(impl);
+    impl->resetAsyncQueue();
     return impl->setInputsNames(inputBlobNames);
 }
 
@@ -169,6 +182,7 @@ void Net::setInputShape(const String& inputName, const MatShape& shape)
 {
     CV_TRACE_FUNCTION();
     CV_Assert(impl);
+    impl->resetAsyncQueue();
     return impl->setInputShape(inputName, shape);
 }
 
@@ -177,24 +191,29 @@ void Net::setInput(InputArray blob, const String& name, double scalefactor, cons
     CV_TRACE_FUNCTION();
     CV_TRACE_ARG_VALUE(name, "name", name.c_str());
     CV_Assert(impl);
+    if (impl->setInputAsync(blob, name, scalefactor, mean))
+        return;  // applied by the next forwardAsync() request
     return impl->setInput(blob, name, scalefactor, mean);
 }
 
 Mat Net::getParam(int layer, int numParam) const
 {
     CV_Assert(impl);
+    impl->finishAsyncRequests();
     return impl->getParam(layer, numParam);
 }
 
 void Net::setParam(int layer, int numParam, const Mat& blob)
 {
     CV_Assert(impl);
+    impl->resetAsyncQueue();
     return impl->setParam(layer, numParam, blob);
 }
 
 int Net::getLayerId(const String& layer) const
 {
     CV_Assert(impl);
+    impl->finishAsyncRequests();
     return impl->getLayerId(layer);
 }
 
@@ -203,6 +222,7 @@ String Net::dump()
     CV_TRACE_FUNCTION();
     CV_Assert(impl);
     CV_Assert(!empty());
+    impl->finishAsyncRequests();
     return impl->dump(true);
 }
 
@@ -211,45 +231,70 @@ void Net::dumpToFile(const String& path)
     CV_TRACE_FUNCTION();
     CV_Assert(impl);
     CV_Assert(!empty());
+    impl->finishAsyncRequests();
     std::ofstream file(path.c_str());
     file << dump();
     file.close();
 }
 
+void Net::writeCache(const String& path) const
+{
+    CV_TRACE_FUNCTION();
+    CV_Assert(impl);
+    impl->finishAsyncRequests();
+    impl->writeCache(path);
+}
+
 Ptr<Layer> Net::getLayer(int layerId) const
 {
     CV_Assert(impl);
-    return impl->getLayer(layerId);
+    impl->finishAsyncRequests();
+    return impl->getActiveInstance().getLayer(layerId);
 }
 Ptr<Layer> Net::getLayer(const LayerId& layerId) const
 {
     CV_Assert(impl);
-    return impl->getLayer(layerId);
+    impl->finishAsyncRequests();
+    return impl->getActiveInstance().getLayer(layerId);
 }
 
 std::vector<Ptr<Layer>> Net::getLayerInputs(int layerId) const
 {
     CV_Assert(impl);
+    impl->finishAsyncRequests();
     return impl->getLayerInputs(layerId);
 }
 
 std::vector<String> Net::getLayerNames() const
 {
     CV_Assert(impl);
+    impl->finishAsyncRequests();
     return impl->getLayerNames();
 }
 
 bool Net::empty() const
 {
     CV_Assert(impl);
+    // doesn't wait for asynchronous requests: they don't change the set of layers, forwardAsync() relies on that
     return impl->empty();
 }
 
+Net Net::clone() const
+{
+    CV_TRACE_FUNCTION();
+    CV_Assert(impl);
+    impl->finishAsyncRequests();
+    Net net;
+    impl->cloneTo(net);
+    return net;
+}
+
 // FIXIT drop "unconnected" API
 std::vector<int> Net::getUnconnectedOutLayers() const
 {
     CV_TRACE_FUNCTION();
     CV_Assert(impl);
+    impl->finishAsyncRequests();
     return impl->getUnconnectedOutLayers();
 }
 
@@ -258,6 +303,7 @@ std::vector<String> Net::getUnconnectedOutLayersNames() const
 {
     CV_TRACE_FUNCTION();
     CV_Assert(impl);
+    impl->finishAsyncRequests();
     return impl->getUnconnectedOutLayersNames();
 }
 
@@ -267,6 +313,7 @@ void Net::getLayersShapes(const ShapesVec& netInputShapes,
         std::vector<ShapesVec>& outLayersShapes) const
 {
     CV_Assert(impl);
+    impl->finishAsyncRequests();
     return impl->getLayersShapes(netInputShapes, layersIds, inLayersShapes, outLayersShapes);
 }
 
@@ -294,6 +341,7 @@ void Net::getLayerShapes(const ShapesVec& netInputShapes,
         ShapesVec& outLayerShapes) const
 {
     CV_Assert(impl);
+    impl->finishAsyncRequests();
     LayerShapes shapes;
     impl->getLayerShapes(netInputShapes, layerId, shapes);
     inLayerShapes = shapes.in;
@@ -304,6 +352,7 @@ int64 Net::getFLOPS(const std::vector<MatShape>& netInputShapes) const
 {
     CV_TRACE_FUNCTION();
     CV_Assert(impl);
+    impl->finishAsyncRequests();
     return impl->getFLOPS(netInputShapes);
 }
 
@@ -317,6 +366,7 @@ int64 Net::getFLOPS(const int layerId,
 {
     CV_TRACE_FUNCTION();
     CV_Assert(impl);
+    impl->finishAsyncRequests();
     return impl->getFLOPS(layerId, netInputShapes);
 }
 
@@ -330,6 +380,7 @@ void Net::getLayerTypes(std::vector<String>& layersTypes) const
 {
     CV_TRACE_FUNCTION();
     CV_Assert(impl);
+    impl->finishAsyncRequests();
     return impl->getLayerTypes(layersTypes);
 }
 
@@ -337,6 +388,7 @@ int Net::getLayersCount(const String& layerType) const
 {
     CV_TRACE_FUNCTION();
     CV_Assert(impl);
+    impl->finishAsyncRequests();
     return impl->getLayersCount(layerType);
 }
 
@@ -346,6 +398,7 @@ void Net::getMemoryConsumption(const int layerId,
 {
     CV_TRACE_FUNCTION();
     CV_Assert(impl);
+    impl->finishAsyncRequests();
     return impl->getMemoryConsumption(layerId, netInputShapes, weights, blobs);
 }
 
@@ -354,9 +407,19 @@ void Net::getMemoryConsumption(const std::vector<MatShape>& netInputShapes,
 {
     CV_TRACE_FUNCTION();
     CV_Assert(impl);
+    impl->finishAsyncRequests();
     return impl->getMemoryConsumption(netInputShapes, weights, blobs);
 }
 
+void Net::getMemoryConsumption(const std::vector<MatShape>& netInputShapes,
+        size_t& weights, size_t& blobs, size_t& plannedBlobs) const
+{
+    CV_TRACE_FUNCTION();
+    CV_Assert(impl);
+    impl->finishAsyncRequests();
+    return impl->getMemoryConsumption(netInputShapes, weights, blobs, plannedBlobs);
+}
+
 void Net::getMemoryConsumption(const int layerId,
         const MatShape& netInputShape,
         size_t& weights, size_t& blobs) const
@@ -378,6 +441,7 @@ void Net::getMemoryConsumption(const std::vector<MatShape>& netInputShapes,
 {
     CV_TRACE_FUNCTION();
     CV_Assert(impl);
+    impl->finishAsyncRequests();
     return impl->getMemoryConsumption(netInputShapes, layerIds, weights, blobs);
 }
 
@@ -393,6 +457,7 @@ void Net::enableFusion(bool fusion)
 {
     CV_TRACE_FUNCTION();
     CV_Assert(impl);
+    impl->resetAsyncQueue();
     return impl->enableFusion(fusion);
 }
 
@@ -400,14 +465,73 @@ void Net::enableWinograd(bool useWinograd)
 {
     CV_TRACE_FUNCTION();
     CV_Assert(impl);
+    impl->resetAsyncQueue();
     return impl->enableWinograd(useWinograd);
 }
 
+void Net::setShapeCacheSize(int maxEntries)
+{
+    CV_TRACE_FUNCTION();
+    CV_Assert(impl);
+    CV_CheckGE(maxEntries, 0, "");
+    impl->resetAsyncQueue();
+    return impl->setShapeCacheSize((size_t)maxEntries);
+}
+
+void Net::setInputDynamicAxes(const String& inputName, const std::vector<int>& axes)
+{
+    CV_TRACE_FUNCTION();
+    CV_Assert(impl);
+    impl->resetAsyncQueue();
+    return impl->setInputDynamicAxes(inputName, axes);
+}
+
+void Net::enableKVCache(bool enable)
+{
+    CV_TRACE_FUNCTION();
+    CV_Assert(impl);
+    impl->resetAsyncQueue();
+    return impl->enableKVCache(enable);
+}
+
+void Net::resetState()
+{
+    CV_TRACE_FUNCTION();
+    CV_Assert(impl);
+    impl->resetAsyncQueue();
+    return impl->resetState();
+}
+
+void Net::enableProfiling(bool enable)
+{
+    CV_TRACE_FUNCTION();
+    CV_Assert(impl);
+    impl->resetAsyncQueue();
+    return impl->enableProfiling(enable);
+}
+
+void Net::getLayersProfile(std::vector<LayerProfile>& records) const
+{
+    CV_TRACE_FUNCTION();
+    CV_Assert(impl);
+    impl->finishAsyncRequests();
+    return impl->getLayersProfile(records);
+}
+
+void Net::dumpProfile(const String& path) const
+{
+    CV_TRACE_FUNCTION();
+    CV_Assert(impl);
+    impl->finishAsyncRequests();
+    return impl->dumpProfile(path);
+}
+
 void Net::setHalideScheduler(const String& scheduler)
 {
     CV_TRACE_FUNCTION();
     CV_TRACE_ARG_VALUE(scheduler, "scheduler", scheduler.c_str());
     CV_Assert(impl);
+    impl->resetAsyncQueue();
     return impl->setHalideScheduler(scheduler);
 }
 
@@ -415,6 +539,7 @@ int64 Net::getPerfProfile(std::vector<double>& timings)
 {
     CV_TRACE_FUNCTION();
     CV_Assert(impl);
+    impl->finishAsyncRequests();
     return impl->getPerfProfile(timings);
 }
 
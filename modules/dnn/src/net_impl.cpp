@@ -32,6 +32,7 @@ std::string detail::NetImplBase::getDumpFileNameBase() const
 
 Net::Impl::~Impl()
 {
+    stopAsyncQueue();
 #ifdef HAVE_VULKAN
     if (context)
         context->reset();
@@ -59,6 +60,10 @@ Net::Impl::Impl()
     preferableTarget = DNN_TARGET_CPU;
     hasDynamicShapes = false;
     useWinograd = true;
+    shapeCacheSize = getParam_DNN_SHAPE_CACHE_SIZE();
+    kvCacheEnabled = false;
+    layerBlobsModified = false;
+    profileForwardIndex = 0;
 }
 
 
@@ -82,6 +87,7 @@ void Net::Impl::clear()
             it->second.internals.clear();
         }
         it->second.skip = false;
+        it->second.elementwiseChain.release();
         // it->second.consumers.clear();
         Ptr<Layer> currLayer = it->second.layerInstance;
 
@@ -95,6 +101,47 @@ void Net::Impl::clear()
 }
 
 
+void Net::Impl::cloneTo(Net& dst) const
+{
+    CV_TRACE_FUNCTION();
+    Impl* dstImpl = dst.getImpl();
+    CV_Assert(dstImpl && dstImpl->empty());
+
+    for (MapIdToLayerData::const_iterator it = layers.begin(); it != layers.end(); ++it)
+    {
+        const LayerData& ld = it->second;
+        if (ld.id != 0)
+        {
+            LayerParams params = ld.params;  // blobs are not copied
+            dstImpl->layers.insert(std::make_pair(ld.id, LayerData(ld.id, ld.name, ld.type, ld.dtype, params)));
+        }
+        LayerData& dstLd = dstImpl->getLayerData(ld.id);
+        dstLd.inputBlobsId = ld.inputBlobsId;
+        dstLd.inputLayersId = ld.inputLayersId;
+        dstLd.requiredOutputs = ld.requiredOutputs;
+        dstLd.consumers = ld.consumers;
+    }
+    dstImpl->layerNameToId = layerNameToId;
+    dstImpl->outputNameToId = outputNameToId;
+    dstImpl->lastLayerId = lastLayerId;
+    dstImpl->hasDynamicShapes = hasDynamicShapes;
+    dstImpl->netWasQuantized = netWasQuantized;
+    dstImpl->fusion = fusion;
+    dstImpl->useWinograd = useWinograd;
+    dstImpl->halideConfigFile = halideConfigFile;
+
+    dstImpl->netInputLayer->setNames(netInputLayer->outNames);
+    for (size_t i = 0; i < netInputLayer->outNames.size(); i++)
+    {
+        if (!netInputLayer->shapes[i].empty())
+            dstImpl->netInputLayer->setInputShape(netInputLayer->outNames[i], netInputLayer->shapes[i]);
+    }
+
+    dst.setPreferableBackend(preferableBackend);
+    dst.setPreferableTarget(preferableTarget);
+}
+
+
 void Net::Impl::validateBackendAndTarget()
 {
     CV_TRACE_FUNCTION();
@@ -137,6 +184,8 @@ void Net::Impl::setUpNet(const std::vector<LayerPin>& blobsToKeep_)
 
     if (!netWasAllocated || this->blobsToKeep != blobsToKeep_)
     {
+        SharedWeightsCollector packedWeightsCollector(packedWeights, preloadedWeights);
+
         if (preferableBackend == DNN_BACKEND_OPENCV && IS_DNN_OPENCL_TARGET(preferableTarget))
 #ifndef HAVE_OPENCL
         {
@@ -215,6 +264,7 @@ void Net::Impl::setUpNet(const std::vector<LayerPin>& blobsToKeep_)
         }
 
         netWasAllocated = true;
+        releasePreloadedWeights(false);
 
         if (dumpLevel)
         {
@@ -381,6 +431,7 @@ int Net::Impl::addLayer(const String& name, const String& type, const int& dtype
         }
     }
 
+    clearShapeCache();
     id = ++lastLayerId;
     layerNameToId.insert(std::make_pair(name, id));
     layers.insert(std::make_pair(id, LayerData(id, name, type, dtype, params)));
@@ -408,6 +459,7 @@ void Net::Impl::connect(int outLayerId, int outNum, int inLayerId, int inNum)
     CV_Assert(outLayerId < inLayerId);
     LayerData& ldOut = getLayerData(outLayerId);
     LayerData& ldInp = getLayerData(inLayerId);
+    clearShapeCache();
 
     addLayerInput(ldInp, inNum, LayerPin(outLayerId, outNum));
     ldOut.requiredOutputs.insert(outNum);
@@ -419,6 +471,7 @@ void Net::Impl::connect(int outLayerId, int outNum, int inLayerId, int inNum)
 
 int Net::Impl::registerOutput(const std::string& outputName, int layerId, int outputPort)
 {
+    clearShapeCache();
     int checkLayerId = getLayerId(outputName);
     if (checkLayerId >= 0)
     {
@@ -590,19 +643,15 @@ void Net::Impl::allocateLayers(const std::vector<LayerPin>& blobsToKeep_)
         ld.internalBlobsWrappers.clear();
     }
 
-    // Fake references to input blobs.
-    for (int i = 0; i < layers[0].outputBlobs.size(); ++i)
-        blobManager.addReference(LayerPin(0, i));
-    for (MapIdToLayerData::const_iterator it = layers.begin(); it != layers.end(); ++it)
+    const int numInputs = (int)layers[0].outputBlobs.size();
+    if (isMemoryPlannerSupported())
     {
-        const LayerData& ld = it->second;
-        blobManager.addReferences(ld.inputBlobsId);
+        planMemory(blobManager, layersShapes, numInputs, blobsToKeep_);
+        blobManager.applyPlan();
+        CV_LOG_DEBUG(NULL, "DNN: planned memory for intermediate blobs: " << blobManager.getArenasSize() << " bytes");
     }
 
-    for (int i = 0; i < blobsToKeep_.size(); i++)
-    {
-        blobManager.addReference(blobsToKeep_[i]);
-    }
+    addBlobReferences(blobManager, numInputs, blobsToKeep_);
 
     for (MapIdToLayerData::const_iterator it = layers.begin(); it != layers.end(); it++)
     {
@@ -615,16 +664,84 @@ void Net::Impl::allocateLayers(const std::vector<LayerPin>& blobsToKeep_)
 }
 
 
+bool Net::Impl::isMemoryPlannerSupported() const
+{
+    return preferableBackend == DNN_BACKEND_OPENCV && IS_DNN_CPU_TARGET(preferableTarget) &&
+           getParam_DNN_MEMORY_PLANNER() && !getParam_DNN_DISABLE_MEMORY_OPTIMIZATIONS();
+}
+
+
+void Net::Impl::addBlobReferences(BlobManager& manager, int numInputs, const std::vector<LayerPin>& blobsToKeep_) const
+{
+    // Fake references to input blobs.
+    for (int i = 0; i < numInputs; ++i)
+        manager.addReference(LayerPin(0, i));
+    for (MapIdToLayerData::const_iterator it = layers.begin(); it != layers.end(); ++it)
+    {
+        const LayerData& ld = it->second;
+        manager.addReferences(ld.inputBlobsId);
+    }
+
+    for (int i = 0; i < blobsToKeep_.size(); i++)
+    {
+        manager.addReference(blobsToKeep_[i]);
+    }
+}
+
+
+// dry run of allocateLayer(): the same order of layers and the same references
+void Net::Impl::planLayerMemory(BlobManager& manager, int lid, const LayersShapesMap& layersShapes, std::set<int>& planned)
+{
+    if (planned.count(lid))
+        return;
+
+    const LayerData& ld = layers[lid];
+    std::set<int> inputLayersId;
+    for (size_t i = 0; i < ld.inputBlobsId.size(); i++)
+        inputLayersId.insert(ld.inputBlobsId[i].lid);
+    for (std::set<int>::const_iterator i = inputLayersId.begin(); i != inputLayersId.end(); i++)
+        planLayerMemory(manager, *i, layersShapes, planned);
+
+    LayersShapesMap::const_iterator layerShapesIt = layersShapes.find(lid);
+    CV_Assert(layerShapesIt != layersShapes.end());
+
+    std::vector<LayerPin> pinsForInternalBlobs;
+    manager.planBlobsForLayer(ld, layerShapesIt->second, pinsForInternalBlobs);
+    manager.releaseReferences(ld.inputBlobsId);
+    manager.releaseReferences(pinsForInternalBlobs);
+    manager.nextStep();
+
+    planned.insert(lid);
+}
+
+
+size_t Net::Impl::planMemory(BlobManager& manager, const LayersShapesMap& layersShapes, int numInputs,
+        const std::vector<LayerPin>& blobsToKeep_)
+{
+    CV_TRACE_FUNCTION();
+
+    manager.beginPlanning();
+    addBlobReferences(manager, numInputs, blobsToKeep_);
+    std::set<int> planned;
+    for (MapIdToLayerData::const_iterator it = layers.begin(); it != layers.end(); it++)
+        planLayerMemory(manager, it->first, layersShapes, planned);
+    return manager.computePlan();
+}
+
+
 void Net::Impl::forwardLayer(LayerData& ld)
 {
     CV_TRACE_FUNCTION();
 
-    Ptr<Layer> layer = ld.layerInstance;
+    Ptr<Layer> layer = ld.elementwiseChain.empty() ? ld.layerInstance : ld.elementwiseChain;
 
     if (!ld.skip)
     {
+        Profiler::LayerScope profileScope(profiler.get());
+        const double cpuTimeStart = profiler ? Profiler::getCPUTime() : 0.0;
         TickMeter tm;
         tm.start();
+        const int64 startTicks = profiler ? getTickCount() : 0;
 
 #ifndef HAVE_VULKAN
         std::map<int, Ptr<BackendNode>>::const_iterator it = ld.backendNodes.find(preferableBackend);
@@ -848,6 +965,12 @@ void Net::Impl::forwardLayer(LayerData& ld)
         tm.stop();
         int64 t = tm.getTimeTicks();
         layersTimings[ld.id] = (t > 0) ? t : t + 1;  // zero for skipped layers only
+        if (profiler)
+        {
+            const int64 endTicks = getTickCount();
+            const double cpuTimeEnd = Profiler::getCPUTime();
+            addLayerProfile(ld, startTicks, endTicks, cpuTimeStart, cpuTimeEnd, profileScope.end());
+        }
     }
     else
     {
@@ -866,12 +989,20 @@ void Net::Impl::forwardToLayer(LayerData& ld, bool clearFlags)
     {
         for (MapIdToLayerData::iterator it = layers.begin(); it != layers.end(); it++)
             it->second.flag = 0;
+        if (profiler)
+        {
+            AutoLock lock(profiler->mutex);
+            profileForwardIndex = profiler->numForwards++;
+        }
     }
 
     // already was forwarded
     if (ld.flag)
         return;
 
+    // some layers pack weights on the first forward
+    SharedWeightsCollector packedWeightsCollector(packedWeights, preloadedWeights);
+
     // forward parents
     for (MapIdToLayerData::iterator it = layers.begin(); it != layers.end() && (it->second.id < ld.id); ++it)
     {
@@ -884,6 +1015,9 @@ void Net::Impl::forwardToLayer(LayerData& ld, bool clearFlags)
     // forward itself
     forwardLayer(ld);
 
+    // all the layers have requested their packed weights after the first complete forward
+    releasePreloadedWeights(ld.id == layers.rbegin()->first);
+
 #ifdef HAVE_CUDA
     if (preferableBackend == DNN_BACKEND_CUDA)
         cudaInfo->context.stream.synchronize();
@@ -894,6 +1028,8 @@ void Net::Impl::forwardToLayer(LayerData& ld, bool clearFlags)
 Mat Net::Impl::forward(const String& outputName)
 {
     CV_Assert(!empty());
+    if (Impl* bucket = getShapeBucket())
+        return bucket->forward(outputName);
     FPDenormalsIgnoreHintScope fp_denormals_ignore_scope;
 
     String layerName = outputName;
@@ -916,6 +1052,9 @@ Mat Net::Impl::forward(const String& outputName)
 AsyncArray Net::Impl::forwardAsync(const String& outputName)
 {
     CV_Assert(!empty());
+    if (isAsyncQueueSupported())
+        return forwardAsyncCPU(outputName);
+
     FPDenormalsIgnoreHintScope fp_denormals_ignore_scope;
 
     String layerName = outputName;
@@ -931,7 +1070,7 @@ AsyncArray Net::Impl::forwardAsync(const String& outputName)
     setUpNet(pins);
 
     if (preferableBackend != DNN_BACKEND_INFERENCE_ENGINE_NGRAPH)
-        CV_Error(Error::StsNotImplemented, "DNN: Asynchronous forward is supported for Inference Engine backend only");
+        CV_Error(Error::StsNotImplemented, "DNN: Asynchronous forward is supported for OpenCV (CPU target) and Inference Engine backends only");
 
     isAsync = true;
     forwardToLayer(getLayerData(layerName));
@@ -944,6 +1083,8 @@ AsyncArray Net::Impl::forwardAsync(const String& outputName)
 void Net::Impl::forward(OutputArrayOfArrays outputBlobs, const String& outputName)
 {
     CV_Assert(!empty());
+    if (Impl* bucket = getShapeBucket())
+        return bucket->forward(outputBlobs, outputName);
     FPDenormalsIgnoreHintScope fp_denormals_ignore_scope;
 
     String layerName = outputName;
@@ -1027,6 +1168,8 @@ void Net::Impl::forward(OutputArrayOfArrays outputBlobs,
         const std::vector<String>& outBlobNames)
 {
     CV_Assert(!empty());
+    if (Impl* bucket = getShapeBucket())
+        return bucket->forward(outputBlobs, outBlobNames);
     FPDenormalsIgnoreHintScope fp_denormals_ignore_scope;
 
     std::vector<LayerPin> pins;
@@ -1056,6 +1199,8 @@ void Net::Impl::forward(std::vector<std::vector<Mat>>& outputBlobs,
         const std::vector<String>& outBlobNames)
 {
     CV_Assert(!empty());
+    if (Impl* bucket = getShapeBucket())
+        return bucket->forward(outputBlobs, outBlobNames);
     FPDenormalsIgnoreHintScope fp_denormals_ignore_scope;
 
     std::vector<LayerPin> pins;
@@ -1377,6 +1522,7 @@ void Net::Impl::setInputsNames(const std::vector<String>& inputBlobNames)
 {
     CV_Assert(netInputLayer);
     netInputLayer->setNames(inputBlobNames);
+    clearShapeCache();
 }
 
 
@@ -1384,6 +1530,7 @@ void Net::Impl::setInputShape(const String& inputName, const MatShape& shape)
 {
     CV_Assert(netInputLayer);
     netInputLayer->setInputShape(inputName, shape);
+    clearShapeCache();
 }
 
 
@@ -1444,9 +1591,12 @@ void Net::Impl::setInput(InputArray blob, const String& name, double scalefactor
     {
         ld.outputBlobsWrappers[pin.oid]->setHostDirty();
     }
+    // input layer is skipped if there is no preprocessing (see DataLayer::finalize)
+    bool oldIdentity = netInputLayer->scaleFactors[pin.oid] == 1.0 && netInputLayer->means[pin.oid] == Scalar();
+    bool newIdentity = scalefactor == 1.0 && mean == Scalar();
     netInputLayer->scaleFactors[pin.oid] = scalefactor;
     netInputLayer->means[pin.oid] = mean;
-    netWasAllocated = netWasAllocated && oldShape;
+    netWasAllocated = netWasAllocated && oldShape && oldIdentity == newIdentity;
 }
 
 
@@ -1467,6 +1617,47 @@ void Net::Impl::setParam(int layer, int numParam, const Mat& blob)
     CV_Assert(numParam < (int)layerBlobs.size());
     // we don't make strong checks, use this function carefully
     layerBlobs[numParam] = blob;
+    layerBlobsModified = true;
+
+    if (shapeCacheSize > 0)
+    {
+        // cached instances are created from the original layer parameters
+        CV_LOG_INFO(NULL, "DNN: shape cache is disabled after setParam()");
+        shapeCacheSize = 0;
+        clearShapeCache();
+    }
+}
+
+
+void Net::Impl::enableKVCache(bool enable)
+{
+    kvCacheEnabled = enable;
+    if (enable && shapeCacheSize > 0)
+    {
+        // cached tokens are kept by layer instances, they must be the same for all the input shapes
+        CV_LOG_INFO(NULL, "DNN: shape cache is disabled by key/value cache");
+        shapeCacheSize = 0;
+        clearShapeCache();
+    }
+    for (MapIdToLayerData::iterator it = layers.begin(); it != layers.end(); it++)
+    {
+        LayerData& ld = it->second;
+        if (ld.id == 0 || (ld.type != "Attention" && ld.type != "AttentionInt8"))
+            continue;
+        Ptr<AttentionLayer> layer = getLayerInstance(ld).dynamicCast<AttentionLayer>();
+        if (layer)
+            layer->setKVCacheEnabled(enable);
+    }
+}
+
+void Net::Impl::resetState()
+{
+    for (MapIdToLayerData::iterator it = layers.begin(); it != layers.end(); it++)
+    {
+        Ptr<AttentionLayer> layer = it->second.layerInstance.dynamicCast<AttentionLayer>();
+        if (layer)
+            layer->resetKVCache();
+    }
 }
 
 
@@ -2006,8 +2197,23 @@ void Net::Impl::getMemoryConsumption(
 }
 
 
+void Net::Impl::getMemoryConsumption(
+        const std::vector<MatShape>& netInputShapes,
+        size_t& weights, size_t& blobs, size_t& plannedBlobs) /*const*/
+{
+    getMemoryConsumption(netInputShapes, weights, blobs);
+
+    LayersShapesMap layersShapes;
+    getLayersShapes(netInputShapes, layersShapes);
+    BlobManager manager;
+    plannedBlobs = planMemory(manager, layersShapes, (int)netInputShapes.size(), std::vector<LayerPin>());
+}
+
+
 int64 Net::Impl::getPerfProfile(std::vector<double>& timings) const
 {
+    if (shapeCacheSize > 0 && !shapeBuckets.empty())
+        return shapeBuckets.front().net.getImpl()->getPerfProfile(timings);
     timings = std::vector<double>(layersTimings.begin() + 1, layersTimings.end());
     int64 total = (int64)std::accumulate(timings.begin(), timings.end(), 0.0);
     return total;
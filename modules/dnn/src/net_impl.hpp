@@ -22,9 +22,13 @@
 
 #include <opencv2/core/utils/logger.hpp>
 
+#include <list>
+#include <atomic>
+
 #include "layer_internals.hpp"  // LayerPin LayerData DataLayer
 
 #include "legacy_backend.hpp"  // wrapMat BlobManager OpenCLBackendWrapper
+#include "layers/cpu_kernels/shared_weights.hpp"  // SharedWeightsMap
 
 namespace cv {
 namespace dnn {
@@ -68,8 +72,114 @@ struct Net::Impl : public detail::NetImplBase
     bool useWinograd;
     std::vector<int64> layersTimings;
 
+    // Asynchronous forward of OpenCV CPU backend (net_impl_async.cpp)
+    struct StagedInput
+    {
+        Mat blob;
+        String name;
+        double scalefactor;
+        Scalar mean;
+    };
+    class AsyncForwardQueue;
+    Ptr<AsyncForwardQueue> asyncQueue;  // created by the first forwardAsync() call
+
+    // Network instances prepared for recently used input shapes (net_impl_shape_cache.cpp)
+    struct ShapeBucket
+    {
+        std::vector<MatShape> key;  // dynamic axes are masked
+        Net net;  // clone of this network
+    };
+    std::list<ShapeBucket> shapeBuckets;  // most recently used first
+    std::vector<int> shapeBucketsConfig;  // configuration of cached instances
+    size_t shapeCacheSize;  // 0 - disabled
+    std::map<String, std::vector<int> > inputDynamicAxes;
+
+    void setShapeCacheSize(size_t size);
+    void setInputDynamicAxes(const String& inputName, const std::vector<int>& axes);
+    /// returns network instance for current input shapes with bound inputs, NULL if cache is not used
+    Impl* getShapeBucket();
+    void clearShapeCache();
+    /// instance which has run the last forward(): the most recently used shape cache entry or this one
+    const Impl& getActiveInstance() const;
+
+    bool kvCacheEnabled;
+    bool layerBlobsModified;  // setParam() was called, layer instances differ from the layer parameters
+    void enableKVCache(bool enable);
+    void resetState();
+
+    // Per-layer profiling (net_impl_profiler.cpp)
+    struct Profiler
+    {
+        Profiler();
+        // records and numForwards are guarded by the mutex: forward() calls of the network instances
+        // which share the profiler (asynchronous requests) run concurrently
+        Mutex mutex;
+        std::vector<LayerProfile> records;  // ring buffer of at most maxRecords records
+        size_t maxRecords;
+        size_t firstRecord;  // index of the oldest record if the buffer is full
+        int numForwards;
+        int64 startTicks;
+        std::atomic<int> activeLayers;
+        std::atomic<int64> layerStarts;
+
+        /// CPU time of the process in seconds
+        static double getCPUTime();
+        void addRecord(const LayerProfile& r);
+
+        /// Tracks layers which run concurrently in the instances sharing the profiler
+        class LayerScope
+        {
+        public:
+            explicit LayerScope(Profiler* profiler);
+            ~LayerScope();
+            /// returns true if no other layer ran since the scope was created
+            bool end();
+        private:
+            Profiler* profiler;
+            int64 token;  // number of started layers including this one, -1 if another layer was running
+        };
+    };
+    Ptr<Profiler> profiler;  // shared with the shape cache and async queue instances, empty if profiling is disabled
+    int profileForwardIndex;  // index of the current forward() call of this instance
+
+    void enableProfiling(bool enable);
+    void getLayersProfile(std::vector<LayerProfile>& records) const;
+    void dumpProfile(const String& path) const;
+    /// adds record of the layer forward, CPU times are in seconds. The CPU time is dropped if the layer was not
+    /// the only one running in the instances sharing the profiler (exclusive is false)
+    void addLayerProfile(const LayerData& ld, int64 startTicks, int64 endTicks, double cpuTimeStart, double cpuTimeEnd, bool exclusive);
+
+    bool isAsyncQueueSupported() const;
+    AsyncArray forwardAsyncCPU(const String& outputName);
+    bool setInputAsync(InputArray blob, const String& name, double scalefactor, const Scalar& mean);
+    void applyStagedInputs(const std::vector<StagedInput>& inputs);
+    /// waits for submitted asynchronous requests, required before any synchronous call
+    void finishAsyncRequests();
+    /// waits for submitted requests and drops the queue, required before modification of the network
+    void resetAsyncQueue();
+    /// drops the queue, pending requests are cancelled
+    void stopAsyncQueue();
+
 
     virtual bool empty() const;
+    /// copies network graph and settings into the empty network, weights are shared
+    void cloneTo(Net& dst) const;
+    /// writes network graph and weights for readNetFromCache() (net_serialization.cpp)
+    void writeCache(const String& path) const;
+    /// prepacked weights which are still used by the layers of this network and its shape cache instances
+    void collectPackedWeights(std::map<std::string, Ptr<void> >& packed) const;
+
+    // Prepacked weights requested by the layers during setup and forward, stored by writeCache()
+    SharedWeightsMap packedWeights;
+    // Prepacked weights of the cache file (readNetFromCache()), found by the layers of this network only
+    // (see SharedWeightsCollector), they are not registered in the process-wide registry.
+    // Kept until the layers request them: consumed entries are dropped after setup and forward, the rest
+    // (e.g. packed for another target) after the first complete forward.
+    std::map<std::string, Ptr<void> > preloadedWeights;
+    /// drops preloaded weights which are already used by the layers, or all of them
+    void releasePreloadedWeights(bool all);
+    /// hands preloaded weights over to an instance created by cloneTo() (shape cache, async queue)
+    void sharePreloadedWeights(Impl& dst) const;
     virtual void setPreferableBackend(Net& net, int backendId);
     virtual void setPreferableTarget(int targetId);
 
@@ -214,10 +324,18 @@ struct Net::Impl : public detail::NetImplBase
     void enableFusion(bool fusion_);
 
     virtual void fuseLayers(const std::vector<LayerPin>& blobsToKeep_);
+    void fuseElementwiseChains(const std::set<LayerPin>& pinsToKeep);
     void enableWinograd(bool useWinograd_);
 
     void allocateLayers(const std::vector<LayerPin>& blobsToKeep_);
 
+    // Memory planner (see BlobManager::beginPlanning())
+    bool isMemoryPlannerSupported() const;
+    void addBlobReferences(BlobManager& manager, int numInputs, const std::vector<LayerPin>& blobsToKeep_) const;
+    void planLayerMemory(BlobManager& manager, int lid, const LayersShapesMap& layersShapes, std::set<int>& planned);
+    size_t planMemory(BlobManager& manager, const LayersShapesMap& layersShapes, int numInputs,
+            const std::vector<LayerPin>& blobsToKeep_);
+
     virtual void forwardLayer(LayerData& ld);
 
     void forwardToLayer(LayerData& ld, bool clearFlags = true);
@@ -260,6 +378,9 @@ struct Net::Impl : public detail::NetImplBase
     void getMemoryConsumption(
             const std::vector<MatShape>& netInputShapes,
             size_t& weights, size_t& blobs) /*const*/;
+    void getMemoryConsumption(
+            const std::vector<MatShape>& netInputShapes,
+            size_t& weights, size_t& blobs, size_t& plannedBlobs) /*const*/;
     void getMemoryConsumption(
             const std::vector<MatShape>& netInputShapes,
             std::vector<int>& layerIds, std::vector<size_t>& weights,
@@ -0,0 +1,296 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "precomp.hpp"
+
+#include "net_impl.hpp"
+
+#include <opencv2/core/detail/async_promise.hpp>
+
+#ifndef OPENCV_DISABLE_THREAD_SUPPORT
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <thread>
+#endif
+
+namespace cv {
+namespace dnn {
+CV__DNN_INLINE_NS_BEGIN
+
+
+#ifndef OPENCV_DISABLE_THREAD_SUPPORT
+
+// Requests are taken in submission order by a pool of worker threads. Every worker runs its
+// requests on its own network instance: a weight-sharing clone (see cloneTo()) with its own
+// blob set, so several requests are computed at the same time on one Net.
+// Networks with a state (key/value cache) have a single worker which uses the network itself,
+// so the requests see the state of the previous ones. The same is done after setParam(),
+// clones are created from the original layer parameters.
+// Inputs are staged by the caller (setInput) and handed over with each request,
+// so the caller may prepare the next frame while the current ones are processed.
+// The instances are created from the current network: methods which modify it drop the queue
+// (resetAsyncQueue()), the next forwardAsync() call creates it again.
+class Net::Impl::AsyncForwardQueue
+{
+public:
+    explicit AsyncForwardQueue(Net::Impl& net_)
+        : stopping(false), active(0)
+    {
+        const bool singleInstance = net_.kvCacheEnabled || net_.layerBlobsModified;
+        const int numWorkers = singleInstance ? 1 : std::max((int)getParam_DNN_ASYNC_MAX_REQUESTS(), 1);
+
+        inputNames = net_.netInputLayer->outNames;
+        const DataLayer& inputLayer = *net_.netInputLayer;
+        for (size_t i = 0; i < inputLayer.inputsData.size(); i++)
+        {
+            if (inputLayer.inputsData[i].empty() || (i > 0 && i >= inputNames.size()))
+                continue;
+            StagedInput input;
+            input.blob = inputLayer.inputsData[i];
+            input.name = i < inputNames.size() ? inputNames[i] : String();
+            input.scalefactor = inputLayer.scaleFactors[i];
+            input.mean = inputLayer.means[i];
+            currentInputs.push_back(input);
+        }
+
+        instances.resize(numWorkers);
+        for (int i = 0; i < numWorkers; i++)
+        {
+            if (singleInstance)
+            {
+                instances[i] = &net_;
+                continue;
+            }
+            clones.push_back(Net());
+            net_.cloneTo(clones.back());
+            Impl* clone = clones.back().getImpl();
+            clone->shapeCacheSize = net_.shapeCacheSize;
+            clone->inputDynamicAxes = net_.inputDynamicAxes;
+            clone->profiler = net_.profiler;
+            net_.sharePreloadedWeights(*clone);
+            instances[i] = clone;
+        }
+        if (!clones.empty())
+            net_.preloadedWeights.clear();  // the clones keep them until their first forward
+        for (int i = 0; i < numWorkers; i++)
+            workers.push_back(std::thread(&AsyncForwardQueue::workerLoop, this, instances[i]));
+    }
+
+    ~AsyncForwardQueue()
+    {
+        std::deque< Ptr<Request> > cancelled;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            stopping = true;
+            cancelled.swap(queue);
+            cond.notify_all();
+        }
+        for (size_t i = 0; i < workers.size(); i++)
+            workers[i].join();
+        for (size_t i = 0; i < cancelled.size(); i++)
+        {
+            try
+            {
+                CV_Error(Error::StsError, "DNN: asynchronous request has been cancelled (Net is destroyed)");
+            }
+            catch (...)
+            {
+                setException(*cancelled[i]);
+            }
+        }
+    }
+
+    void setInput(InputArray blob, const String& name, double scalefactor, const Scalar& mean)
+    {
+        StagedInput input;
+        input.blob = blob.getMat().clone();  // caller may reuse its buffer for the next frame
+        input.name = name.empty() && !inputNames.empty() ? inputNames[0] : name;
+        input.scalefactor = scalefactor;
+        input.mean = mean;
+        std::unique_lock<std::mutex> lock(mutex);
+        for (size_t i = 0; i < currentInputs.size(); i++)
+        {
+            if (currentInputs[i].name == input.name)
+            {
+                currentInputs[i] = input;
+                return;
+            }
+        }
+        currentInputs.push_back(input);
+    }
+
+    AsyncArray submit(const String& outputName)
+    {
+        Ptr<Request> request = makePtr<Request>();
+        request->outputName = outputName;
+        AsyncArray result = request->promise.getArrayResult();
+        std::unique_lock<std::mutex> lock(mutex);
+        request->inputs = currentInputs;  // blobs are not modified, they are shared by requests
+        queue.push_back(request);
+        cond.notify_one();
+        return result;
+    }
+
+    // Waits for completion of submitted requests. The last inputs are returned to the caller.
+    void finish(std::vector<StagedInput>& inputs)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (active > 0 || !queue.empty())
+            idleCond.wait(lock);
+        inputs = currentInputs;
+    }
+
+protected:
+    struct Request
+    {
+        std::vector<StagedInput> inputs;
+        String outputName;
+        AsyncPromise promise;
+    };
+
+    void workerLoop(Net::Impl* instance)
+    {
+        for (;;)
+        {
+            Ptr<Request> request;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                while (!stopping && queue.empty())
+                    cond.wait(lock);
+                if (stopping)
+                    break;
+                request = queue.front();
+                queue.pop_front();
+                active++;
+            }
+            execute(*instance, *request);
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                active--;
+                if (active == 0 && queue.empty())
+                    idleCond.notify_all();
+            }
+        }
+    }
+
+    static void execute(Net::Impl& instance, Request& request)
+    {
+        CV_TRACE_FUNCTION();
+        try
+        {
+            instance.applyStagedInputs(request.inputs);
+            Mat out = instance.forward(request.outputName);
+            request.promise.setValue(out);  // makes a copy, output blobs are reused by the next request
+        }
+        catch (...)
+        {
+            setException(request);
+        }
+    }
+
+    static void setException(Request& request)
+    {
+        try
+        {
+            request.promise.setException(std::current_exception());
+        }
+        catch (...)
+        {
+            // result is not awaited (AsyncArray has been destroyed)
+        }
+    }
+
+    std::mutex mutex;
+    std::condition_variable cond;      // new requests or stop
+    std::condition_variable idleCond;  // queue is drained
+    std::deque< Ptr<Request> > queue;
+    std::vector<String> inputNames;         // names of the network inputs, resolve the default one
+    std::vector<StagedInput> currentInputs;  // inputs of the next request
+    bool stopping;
+    int active;  // number of requests in progress
+    std::list<Net> clones;
+    std::vector<Net::Impl*> instances;  // network of every worker
+    std::vector<std::thread> workers;
+};
+
+
+bool Net::Impl::isAsyncQueueSupported() const
+{
+    return preferableBackend == DNN_BACKEND_OPENCV && IS_DNN_CPU_TARGET(preferableTarget);
+}
+
+
+AsyncArray Net::Impl::forwardAsyncCPU(const String& outputName)
+{
+    if (!asyncQueue)
+    {
+        asyncQueue = Ptr<AsyncForwardQueue>(new AsyncForwardQueue(*this));
+        CV_LOG_DEBUG(NULL, "DNN: started asynchronous forward queue");
+    }
+    return asyncQueue->submit(outputName);
+}
+
+
+bool Net::Impl::setInputAsync(InputArray blob, const String& name, double scalefactor, const Scalar& mean)
+{
+    if (!asyncQueue)
+        return false;
+    asyncQueue->setInput(blob, name, scalefactor, mean);
+    return true;
+}
+
+
+void Net::Impl::finishAsyncRequests()
+{
+    if (!asyncQueue)
+        return;
+    std::vector<StagedInput> inputs;
+    asyncQueue->finish(inputs);
+    applyStagedInputs(inputs);
+}
+
+
+void Net::Impl::resetAsyncQueue()
+{
+    finishAsyncRequests();
+    asyncQueue.release();
+}
+
+
+void Net::Impl::stopAsyncQueue()
+{
+    asyncQueue.release();
+}
+
+#else  // OPENCV_DISABLE_THREAD_SUPPORT
+
+class Net::Impl::AsyncForwardQueue {};
+
+bool Net::Impl::isAsyncQueueSupported() const { return false; }
+AsyncArray Net::Impl::forwardAsyncCPU(const String&)
+{
+    CV_Error(Error::StsNotImplemented, "DNN: Asynchronous forward requires threads support");
+}
+bool Net::Impl::setInputAsync(InputArray, const String&, double, const Scalar&) { return false; }
+void Net::Impl::finishAsyncRequests() {}
+void Net::Impl::resetAsyncQueue() {}
+void Net::Impl::stopAsyncQueue() {}
+
+#endif  // OPENCV_DISABLE_THREAD_SUPPORT
+
+
+void Net::Impl::applyStagedInputs(const std::vector<StagedInput>& inputs)
+{
+    for (size_t i = 0; i < inputs.size(); i++)
+    {
+        const StagedInput& input = inputs[i];
+        setInput(input.blob, input.name, input.scalefactor, input.mean);
+    }
+}
+
+
+CV__DNN_INLINE_NS_END
+}}  // namespace cv::dnn
@@ -6,6 +6,7 @@
 
 #include "net_impl.hpp"
 #include "legacy_backend.hpp"
+#include "layers/cpu_kernels/reduced_precision.hpp"  // haveReducedPrecisionWeights
 
 #include "backend.hpp"
 #include "factory.hpp"
@@ -164,6 +165,8 @@ void Net::Impl::initBackend(const std::vector<LayerPin>& blobsToKeep_)
 
 void Net::Impl::setPreferableBackend(Net& net, int backendId)
 {
+    resetAsyncQueue();  // instances of the queue are created for the previous backend and target
+
     if (backendId == DNN_BACKEND_DEFAULT)
         backendId = (Backend)getParam_DNN_BACKEND_DEFAULT();
 
@@ -215,6 +218,8 @@ void Net::Impl::setPreferableBackend(Net& net, int backendId)
 
 void Net::Impl::setPreferableTarget(int targetId)
 {
+    resetAsyncQueue();  // instances of the queue are created for the previous backend and target
+
     if (netWasQuantized && targetId != DNN_TARGET_CPU &&
         targetId != DNN_TARGET_OPENCL && targetId != DNN_TARGET_OPENCL_FP16 && targetId != DNN_TARGET_NPU)
     {
@@ -243,9 +248,9 @@ void Net::Impl::setPreferableTarget(int targetId)
         }
 
 #if !defined(__arm64__) || !__arm64__
-        if (targetId == DNN_TARGET_CPU_FP16)
+        if (targetId == DNN_TARGET_CPU_FP16 && !haveReducedPrecisionWeights())
         {
-            CV_LOG_WARNING(NULL, "DNN: fall back to DNN_TARGET_CPU. Only ARM v8 CPU is supported by DNN_TARGET_CPU_FP16.");
+            CV_LOG_WARNING(NULL, "DNN: fall back to DNN_TARGET_CPU. DNN_TARGET_CPU_FP16 requires ARM v8 CPU or CPU with FP16 conversion instructions and OPENCV_DNN_CPU_FP16_WEIGHTS=FP16|BF16.");
             targetId = DNN_TARGET_CPU;
         }
 #endif
@@ -833,6 +833,210 @@ void Net::Impl::fuseLayers(const std::vector<LayerPin>& blobsToKeep_)
             }
         }
     }
+
+    // the optimization #3. chains of element-wise layers which were not fused
+    // with the producer are computed by a single layer tile by tile.
+    if (preferableBackend == DNN_BACKEND_OPENCV && IS_DNN_CPU_TARGET(preferableTarget))
+        fuseElementwiseChains(pinsToKeep);
+}
+
+
+// [N, C] prefix of the shape as it is used by per-channel element-wise operations
+static std::pair<int, int> elementwiseChannelsLayout(const Mat& m)
+{
+    if (m.dims > 1)
+        return std::make_pair(m.size[0], m.size[1]);
+    return std::make_pair(1, m.dims == 1 ? m.size[0] : 1);
+}
+
+// Returns 1 if operand is a scalar, 2 if it has one value per channel (axis 1 of data),
+// 3 if it has the same shape as data and 0 if it can't be used by ElementwiseChainLayer.
+static int elementwiseOperandKind(const MatShape& data, const MatShape& operand)
+{
+    if (total(operand) == 1)
+        return 1;
+    if (operand == data)
+        return 3;
+    if (operand.size() > data.size() || data.size() < 2)
+        return 0;
+    // numpy-style broadcasting to [1, C, 1, ..., 1]
+    const int shift = (int)(data.size() - operand.size());
+    for (int i = 0; i < (int)operand.size(); i++)
+    {
+        const int axis = i + shift;
+        if (operand[i] != 1 && (axis != 1 || operand[i] != data[1]))
+            return 0;
+    }
+    return 2;
+}
+
+// Appends layer 'ld' to the chain, the chain data is 'dataIdx' input of the layer.
+// Layers with per-channel parameters are allowed if the data has the same [N, C] layout as the chain input.
+static bool addElementwiseChainStage(Net::Impl::MapIdToLayerData& layers, LayerData& ld, int dataIdx, int headId,
+                                     const std::pair<int, int>& layout, ElementwiseChainLayer& chain, bool& compute)
+{
+    if (ld.outputBlobs.size() != 1 || dataIdx >= (int)ld.inputBlobs.size())
+        return false;
+    // the layer which was fused with the next one writes to the output blob of that layer
+    for (size_t i = 0; i < ld.consumers.size(); i++)
+    {
+        if (layers[ld.consumers[i].lid].skip)
+            return false;
+    }
+    const Mat& inp = *ld.inputBlobs[dataIdx];
+    const Mat& out = ld.outputBlobs[0];
+    if (inp.type() != CV_32F || out.type() != CV_32F || inp.total() != out.total() ||
+        !inp.isContinuous() || !out.isContinuous())
+        return false;
+    const bool sameLayout = elementwiseChannelsLayout(inp) == layout;
+
+    compute = true;
+    const size_t ninputs = ld.inputBlobsId.size();
+    if (ld.type == "Reshape" || ld.type == "Flatten" || ld.type == "Identity")
+    {
+        compute = false;
+        return ninputs == 1;
+    }
+
+    Ptr<ActivationLayer> activ = ld.layerInstance.dynamicCast<ActivationLayer>();
+    if (activ)
+    {
+        const bool perChannel = !activ.dynamicCast<ChannelsPReLULayer>().empty() ||
+                                !activ.dynamicCast<BatchNormLayer>().empty();
+        if (ninputs != 1 || (perChannel && !sameLayout))
+            return false;
+        chain.addActivation(activ);
+        return true;
+    }
+
+    Ptr<ScaleLayer> scaleLayer = ld.layerInstance.dynamicCast<ScaleLayer>();
+    if (scaleLayer)
+    {
+        if (ninputs != 1 || scaleLayer->mode != "scale" || inp.dims < 2 || normalize_axis(scaleLayer->axis, inp.dims) != 1)
+            return false;
+        Mat scale, shift;
+        scaleLayer->getScaleShift(scale, shift);
+        if (scale.empty() && shift.empty())
+            return false;
+        for (const Mat* m : { &scale, &shift })
+        {
+            if (!m->empty() && (m->type() != CV_32F || (m->total() != 1 && (m->total() != (size_t)inp.size[1] || !sameLayout))))
+                return false;
+        }
+        chain.addScaleShift(scale, shift);
+        return true;
+    }
+
+    if (ld.type == "NaryEltwise" && ninputs == 2)
+    {
+        static const struct { const char* name; ElementwiseChainLayer::BinaryOp op; } ops[] = {
+            {"sum", ElementwiseChainLayer::OP_ADD}, {"add", ElementwiseChainLayer::OP_ADD},
+            {"sub", ElementwiseChainLayer::OP_SUB}, {"mul", ElementwiseChainLayer::OP_MUL},
+            {"div", ElementwiseChainLayer::OP_DIV}, {"max", ElementwiseChainLayer::OP_MAX},
+            {"min", ElementwiseChainLayer::OP_MIN}
+        };
+        const String operation = toLowerCase(ld.params.get<String>("operation", "sum"));
+        int opIdx = -1;
+        for (int i = 0; i < (int)(sizeof(ops) / sizeof(ops[0])); i++)
+        {
+            if (operation == ops[i].name)
+                opIdx = i;
+        }
+        if (opIdx < 0)
+            return false;
+
+        const LayerPin operandPin = ld.inputBlobsId[1 - dataIdx];
+        LayerData& operandLd = layers[operandPin.lid];
+        const Mat& operandBlob = *ld.inputBlobs[1 - dataIdx];
+        Mat value;
+        if (operandLd.type == "Const" && !operandLd.layerInstance->blobs.empty())
+            value = operandLd.layerInstance->blobs[0];
+        const Mat& operand = value.empty() ? operandBlob : value;
+        const int kind = elementwiseOperandKind(shape(inp), shape(operand));
+        if (operand.type() != CV_32F || kind == 0 || (kind == 2 && !sameLayout))
+            return false;
+        if (!value.empty())
+            chain.addBinaryConst(ops[opIdx].op, value, dataIdx == 1);
+        else if (operandPin.lid < headId && operandBlob.isContinuous())  // computed before the chain
+            chain.addBinaryBlob(ops[opIdx].op, &operandLd.outputBlobs[operandPin.oid], dataIdx == 1);
+        else
+            return false;
+        return true;
+    }
+    return false;
+}
+
+void Net::Impl::fuseElementwiseChains(const std::set<LayerPin>& pinsToKeep)
+{
+    CV_TRACE_FUNCTION();
+
+    for (MapIdToLayerData::iterator it = layers.begin(); it != layers.end(); it++)
+    {
+        LayerData& ld = it->second;
+        if (ld.id == 0 || ld.skip || ld.inputBlobs.empty())
+            continue;
+
+        // the chain data is the input of the same shape as the output (the other one is an operand of binary operation)
+        int dataIdx = 0;
+        if (ld.inputBlobs.size() == 2 && !ld.outputBlobs.empty() && ld.inputBlobs[0]->size != ld.outputBlobs[0].size)
+            dataIdx = 1;
+        const std::pair<int, int> layout = elementwiseChannelsLayout(*ld.inputBlobs[dataIdx]);
+        Ptr<ElementwiseChainLayer> chain = ElementwiseChainLayer::create(ld.name, dataIdx);
+        bool compute = false;
+        if (!addElementwiseChainStage(layers, ld, dataIdx, ld.id, layout, *chain, compute) || !compute)
+            continue;
+
+        std::vector<LayerData*> members(1, &ld);
+        bool inplace = true;
+        for (;;)
+        {
+            LayerData& last = *members.back();
+            if (last.consumers.size() != 1 || pinsToKeep.count(LayerPin(last.id, 0)) != 0)
+                break;
+            LayerData& next = layers[last.consumers[0].lid];
+            if (next.skip)
+                break;
+            int nextDataIdx = -1;
+            for (int i = 0; i < (int)next.inputBlobsId.size(); i++)
+            {
+                if (next.inputBlobsId[i].lid == last.id)
+                    nextDataIdx = nextDataIdx < 0 ? i : (int)next.inputBlobsId.size();
+            }
+            if (nextDataIdx < 0 || nextDataIdx >= (int)next.inputBlobsId.size() || next.inputBlobsId[nextDataIdx].oid != 0)
+                break;
+            if (!addElementwiseChainStage(layers, next, nextDataIdx, ld.id, layout, *chain, compute))
+                break;
+            inplace = inplace && next.outputBlobs[0].data == next.inputBlobs[nextDataIdx]->data;
+            members.push_back(&next);
+        }
+        if (chain->getNumStages() < 2)
+            continue;
+
+        LayerData& last = *members.back();
+        CV_LOG_DEBUG(NULL, "DNN: fused " << members.size() << " element-wise layers: " << ld.name << " ... " << last.name);
+        for (size_t i = 1; i < members.size(); i++)
+            members[i]->skip = true;
+        ld.elementwiseChain = chain;
+        if (!inplace)
+        {
+            // The output blob of the last layer may share memory with blobs which are computed
+            // between the first and the last layers of the chain, so the chain writes to the new blob.
+            const Mat& out = last.outputBlobs[0];
+            last.outputBlobs[0] = Mat(out.dims, out.size.p, out.type());
+            last.outputBlobsWrappers[0] = wrap(last.outputBlobs[0]);
+            for (size_t i = 0; i < last.consumers.size(); i++)
+            {
+                LayerData& consumer = layers[last.consumers[i].lid];
+                for (size_t j = 0; j < consumer.inputBlobsId.size(); j++)
+                {
+                    if (consumer.inputBlobsId[j].lid == last.id)
+                        consumer.inputBlobsWrappers[j] = last.outputBlobsWrappers[0];
+                }
+            }
+        }
+        ld.outputBlobs[0] = last.outputBlobs[0];
+        ld.outputBlobsWrappers[0] = last.outputBlobsWrappers[0];
+    }
 }
 
 
@@ -0,0 +1,239 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "precomp.hpp"
+
+#include "net_impl.hpp"
+
+#include <ctime>
+
+namespace cv {
+namespace dnn {
+CV__DNN_INLINE_NS_BEGIN
+
+/*
+ * Per-layer profiling: every forwardLayer() call of a network with enabled profiling adds a record with
+ * measured times and the work estimated from the actual shapes, so compute-bound layers (high GFLOP/s)
+ * are told from memory-bound ones (high GB/s, low GFLOP/s).
+ * The records are shared with the shape cache instances of the network (see getShapeBucket()) and with
+ * the instances of the asynchronous queue, which run forward() concurrently.
+ * The CPU time is measured by the process clock, so it includes the parallel_for_() workers of the layer.
+ * It is dropped for layers which overlapped with layers of other concurrent forward() calls.
+ * Only the last getParam_DNN_PROFILE_MAX_RECORDS() records are kept.
+ */
+
+LayerProfile::LayerProfile()
+    : layerId(-1), forwardIndex(0), startTime(0), wallTime(0), cpuTime(0), flops(0), bytes(0),
+      gflops(0), gbps(0), numThreads(1), threadUtilization(0)
+{
+}
+
+Net::Impl::Profiler::Profiler()
+    : maxRecords(std::max(getParam_DNN_PROFILE_MAX_RECORDS(), (size_t)1)), firstRecord(0), numForwards(0),
+      startTicks(getTickCount()), activeLayers(0), layerStarts(0)
+{
+}
+
+Net::Impl::Profiler::LayerScope::LayerScope(Profiler* profiler_)
+    : profiler(profiler_), token(0)
+{
+    if (profiler)
+    {
+        const int active = ++profiler->activeLayers;
+        const int64 started = ++profiler->layerStarts;
+        token = active == 1 ? started : -1;
+    }
+}
+
+Net::Impl::Profiler::LayerScope::~LayerScope()
+{
+    if (profiler)
+        --profiler->activeLayers;
+}
+
+bool Net::Impl::Profiler::LayerScope::end()
+{
+    CV_Assert(profiler);
+    // no layer was running at the start, and none was started or is running since then
+    const bool exclusive = token >= 0 && profiler->layerStarts.load() == token && profiler->activeLayers.load() == 1;
+    --profiler->activeLayers;
+    profiler = NULL;
+    return exclusive;
+}
+
+void Net::Impl::Profiler::addRecord(const LayerProfile& r)
+{
+    AutoLock lock(mutex);
+    if (records.size() < maxRecords)
+        records.push_back(r);
+    else
+    {
+        records[firstRecord] = r;
+        firstRecord = (firstRecord + 1) % records.size();
+    }
+}
+
+double Net::Impl::Profiler::getCPUTime()
+{
+#if defined(CLOCK_PROCESS_CPUTIME_ID)
+    timespec ts;
+    if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts) == 0)
+        return ts.tv_sec + ts.tv_nsec * 1e-9;
+#endif
+    return (double)std::clock() / CLOCKS_PER_SEC;
+}
+
+void Net::Impl::enableProfiling(bool enable)
+{
+    profiler = enable ? makePtr<Profiler>() : Ptr<Profiler>();
+    for (std::list<ShapeBucket>::iterator it = shapeBuckets.begin(); it != shapeBuckets.end(); ++it)
+        it->net.getImpl()->profiler = profiler;
+}
+
+void Net::Impl::getLayersProfile(std::vector<LayerProfile>& records) const
+{
+    if (profiler)
+    {
+        AutoLock lock(profiler->mutex);
+        const std::vector<LayerProfile>& ring = profiler->records;
+        records.assign(ring.begin() + profiler->firstRecord, ring.end());
+        records.insert(records.end(), ring.begin(), ring.begin() + profiler->firstRecord);
+    }
+    else
+        records.clear();
+}
+
+static int64 getBlobsSize(const std::vector<Mat>& blobs)
+{
+    int64 size = 0;
+    for (size_t i = 0; i < blobs.size(); i++)
+        size += (int64)(blobs[i].total() * blobs[i].elemSize());
+    return size;
+}
+
+void Net::Impl::addLayerProfile(const LayerData& ld, int64 startTicks, int64 endTicks, double cpuTimeStart, double cpuTimeEnd, bool exclusive)
+{
+    CV_Assert(profiler);
+    const double usPerTick = 1e6 / getTickFrequency();
+
+    LayerProfile r;
+    r.layerId = ld.id;
+    r.name = ld.name;
+    r.type = ld.type;
+    r.forwardIndex = profileForwardIndex;
+    r.startTime = (startTicks - profiler->startTicks) * usPerTick;
+    r.wallTime = (endTicks - startTicks) * usPerTick;
+    r.cpuTime = exclusive ? std::max(cpuTimeEnd - cpuTimeStart, 0.0) * 1e6 : -1;
+    r.numThreads = std::max(getNumThreads(), 1);
+
+    Ptr<Layer> layer = ld.elementwiseChain.empty() ? ld.layerInstance : ld.elementwiseChain;
+    if (const KernelInfo* info = dynamic_cast<const KernelInfo*>(layer.get()))
+        r.kernel = info->getKernelInfo();
+
+    std::vector<MatShape> inputShapes, outputShapes;
+    for (size_t i = 0; i < ld.inputBlobs.size(); i++)
+    {
+        if (!ld.inputBlobs[i])
+            continue;
+        inputShapes.push_back(shape(*ld.inputBlobs[i]));
+        r.bytes += (int64)(ld.inputBlobs[i]->total() * ld.inputBlobs[i]->elemSize());
+    }
+    for (size_t i = 0; i < ld.outputBlobs.size(); i++)
+        outputShapes.push_back(shape(ld.outputBlobs[i]));
+    r.bytes += getBlobsSize(ld.outputBlobs);
+    if (ld.layerInstance)
+    {
+        r.bytes += getBlobsSize(ld.layerInstance->blobs);
+        r.flops = ld.layerInstance->getFLOPS(inputShapes, outputShapes);
+    }
+
+    if (r.wallTime > 0)
+    {
+        r.gflops = r.flops * 1e-3 / r.wallTime;
+        r.gbps = r.bytes * 1e-3 / r.wallTime;
+        r.threadUtilization = exclusive ? r.cpuTime / (r.wallTime * r.numThreads) : -1;
+    }
+    else if (!exclusive)
+        r.threadUtilization = -1;
+    profiler->addRecord(r);
+}
+
+static bool lessForwardIndex(const LayerProfile& a, const LayerProfile& b)
+{
+    return a.forwardIndex < b.forwardIndex;
+}
+
+static std::string escapeJSON(const String& s)
+{
+    std::string res;
+    for (size_t i = 0; i < s.size(); i++)
+    {
+        const char c = s[i];
+        if (c == '"' || c == '\\')
+        {
+            res += '\\';
+            res += c;
+        }
+        else if ((unsigned char)c < 0x20)
+            res += cv::format("\\u%04x", c);
+        else
+            res += c;
+    }
+    return res;
+}
+
+void Net::Impl::dumpProfile(const String& path) const
+{
+    CV_Assert(profiler && "DNN: profiling is not enabled, see Net::enableProfiling()");
+    std::vector<LayerProfile> records;
+    getLayersProfile(records);
+    // records of concurrent forward() calls (asynchronous requests) are interleaved
+    std::stable_sort(records.begin(), records.end(), lessForwardIndex);
+    std::vector<double> laneEnd;  // concurrent forward() calls are placed on different timeline rows
+
+    std::ofstream out(path.c_str());
+    if (!out.is_open())
+        CV_Error(Error::StsError, "DNN: can't open file for writing: " + path);
+    out.precision(15);
+
+    // complete events ("ph": "X"), time in microseconds. Every forward() call encloses its layers.
+    out << "{\"traceEvents\": [";
+    const char* sep = "\n";
+    for (size_t i = 0; i < records.size();)
+    {
+        const int forwardIndex = records[i].forwardIndex;
+        size_t j = i;
+        double end = records[i].startTime;
+        for (; j < records.size() && records[j].forwardIndex == forwardIndex; j++)
+            end = std::max(end, records[j].startTime + records[j].wallTime);
+        size_t lane = 0;
+        while (lane < laneEnd.size() && laneEnd[lane] > records[i].startTime)
+            lane++;
+        if (lane == laneEnd.size())
+            laneEnd.push_back(end);
+        else
+            laneEnd[lane] = end;
+        out << sep << "{\"name\": \"forward #" << forwardIndex << "\", \"cat\": \"forward\", \"ph\": \"X\", \"pid\": 0, \"tid\": " << lane
+            << ", \"ts\": " << records[i].startTime << ", \"dur\": " << end - records[i].startTime << "}";
+        sep = ",\n";
+        for (; i < j; i++)
+        {
+            const LayerProfile& r = records[i];
+            out << sep << "{\"name\": \"" << escapeJSON(r.name) << "\", \"cat\": \"" << escapeJSON(r.type)
+                << "\", \"ph\": \"X\", \"pid\": 0, \"tid\": " << lane << ", \"ts\": " << r.startTime << ", \"dur\": " << r.wallTime
+                << ", \"args\": {\"id\": " << r.layerId << ", \"kernel\": \"" << escapeJSON(r.kernel) << "\""
+                << ", \"process_cpu_time_us\": " << r.cpuTime << ", \"flops\": " << r.flops << ", \"bytes\": " << r.bytes
+                << ", \"gflops\": " << r.gflops << ", \"gbps\": " << r.gbps << ", \"threads\": " << r.numThreads
+                << ", \"thread_utilization\": " << r.threadUtilization << "}}";
+        }
+    }
+    out << "\n], \"displayTimeUnit\": \"ms\", \"otherData\": {\"opencv_version\": \"" << CV_VERSION
+        << "\", \"cpu_features\": \"" << escapeJSON(getCPUFeaturesKey()) << "\"}}\n";
+    if (!out.good())
+        CV_Error(Error::StsError, "DNN: can't write file: " + path);
+}
+
+
+CV__DNN_INLINE_NS_END
+}}  // namespace cv::dnn
@@ -0,0 +1,143 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "precomp.hpp"
+
+#include "net_impl.hpp"
+
+namespace cv {
+namespace dnn {
+CV__DNN_INLINE_NS_BEGIN
+
+
+// Networks with variable input resolution (batch size, sequence length, image size) spend most of
+// the time in setUpNet() if the input shape changes between calls: layers are re-initialized,
+// fused and memory is re-allocated. The cache keeps prepared instances (weight-sharing clones,
+// see cloneTo()) for recently used input shapes, so switching between them costs nothing.
+// Shapes which differ along declared dynamic axes share one instance: its memory arenas only
+// grow (BlobManager::setKeepArenas()), so smaller inputs reuse buffers of the largest one.
+
+void Net::Impl::setShapeCacheSize(size_t size)
+{
+    shapeCacheSize = size;
+    if (shapeBuckets.size() > size)
+        shapeBuckets.resize(size);
+}
+
+
+void Net::Impl::setInputDynamicAxes(const String& inputName, const std::vector<int>& axes)
+{
+    CV_Assert(netInputLayer);
+    const std::vector<String>& names = netInputLayer->outNames;
+    if (!names.empty() && std::find(names.begin(), names.end(), inputName) == names.end())
+        CV_Error(Error::StsObjectNotFound, "DNN: unknown network input \"" + inputName + "\"");
+    for (size_t i = 0; i < axes.size(); i++)
+        CV_CheckGE(axes[i], 0, "DNN: invalid dynamic axis");
+    if (axes.empty())
+        inputDynamicAxes.erase(inputName);
+    else
+        inputDynamicAxes[inputName] = axes;
+    clearShapeCache();
+}
+
+
+// called by the methods which change the graph, cached instances are clones of the previous one
+void Net::Impl::clearShapeCache()
+{
+    shapeBuckets.clear();
+}
+
+
+const Net::Impl& Net::Impl::getActiveInstance() const
+{
+    if (shapeCacheSize > 0 && !shapeBuckets.empty())
+        return *shapeBuckets.front().net.getImpl();
+    return *this;
+}
+
+
+Net::Impl* Net::Impl::getShapeBucket()
+{
+    if (shapeCacheSize == 0)
+        return NULL;
+
+    CV_Assert(netInputLayer);
+    const DataLayer& inputLayer = *netInputLayer;
+    const size_t numInputs = inputLayer.inputsData.size();
+    if (numInputs == 0 || (numInputs > 1 && inputLayer.outNames.size() < numInputs))
+        return NULL;  // inputs can't be bound by name
+
+    std::vector<MatShape> key(numInputs);
+    for (size_t i = 0; i < numInputs; i++)
+    {
+        const Mat& blob = inputLayer.inputsData[i];
+        if (blob.empty())
+            return NULL;
+        key[i] = MatShape(blob.size.p, blob.size.p + blob.dims);
+        key[i].push_back(blob.type());
+        if (i < inputLayer.outNames.size())
+        {
+            std::map<String, std::vector<int> >::const_iterator axes = inputDynamicAxes.find(inputLayer.outNames[i]);
+            if (axes != inputDynamicAxes.end())
+            {
+                for (size_t j = 0; j < axes->second.size(); j++)
+                {
+                    if (axes->second[j] < blob.dims)
+                        key[i][axes->second[j]] = -1;
+                }
+            }
+        }
+    }
+
+    std::vector<int> config(5);
+    config[0] = preferableBackend;
+    config[1] = preferableTarget;
+    config[2] = fusion;
+    config[3] = useWinograd;
+    config[4] = lastLayerId;
+    if (config != shapeBucketsConfig)
+    {
+        shapeBuckets.clear();
+        shapeBucketsConfig = config;
+    }
+
+    std::list<ShapeBucket>::iterator it = shapeBuckets.begin();
+    for (; it != shapeBuckets.end(); ++it)
+    {
+        if (it->key == key)
+            break;
+    }
+    if (it != shapeBuckets.end())
+    {
+        shapeBuckets.splice(shapeBuckets.begin(), shapeBuckets, it);
+    }
+    else
+    {
+        if (shapeBuckets.size() >= shapeCacheSize)
+            shapeBuckets.pop_back();
+        shapeBuckets.push_front(ShapeBucket());
+        ShapeBucket& bucket = shapeBuckets.front();
+        bucket.key = key;
+        cloneTo(bucket.net);
+        Impl* bucketImpl = bucket.net.getImpl();
+        bucketImpl->shapeCacheSize = 0;
+        bucketImpl->profiler = profiler;
+        bucketImpl->blobManager.setKeepArenas(!inputDynamicAxes.empty());
+        sharePreloadedWeights(*bucketImpl);
+        preloadedWeights.clear();  // the layers of this instance are not used while the cache is enabled
+        CV_LOG_DEBUG(NULL, "DNN: new shape cache entry (" << shapeBuckets.size() << "/" << shapeCacheSize << ")");
+    }
+
+    Impl* bucket = shapeBuckets.front().net.getImpl();
+    for (size_t i = 0; i < numInputs; i++)
+    {
+        bucket->setInput(inputLayer.inputsData[i], i < inputLayer.outNames.size() ? inputLayer.outNames[i] : String(),
+                         inputLayer.scaleFactors[i], inputLayer.means[i]);
+    }
+    return bucket;
+}
+
+
+CV__DNN_INLINE_NS_END
+}}  // namespace cv::dnn
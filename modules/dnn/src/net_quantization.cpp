@@ -169,9 +169,31 @@ Net Net::Impl::quantize(Net& net, InputArrayOfArrays calibData, int inputsDtype,
     dstNet.setPreferableTarget(prefTarget);
     dstNet.enableFusion(originalFusion);
 
+    // Weights of some layers (Attention, Einsum) are inputs produced by Const layers.
+    // They are passed to tryQuantize() as trailing blobs listed by "const_inputs" parameter and folded into
+    // the quantized layer. Const layers consumed by such layers only are added to the new Net lazily,
+    // when some consumer stays in floating point.
+    std::set<int> foldedConsts;
+    for (Impl::MapIdToLayerData::iterator it = layers.begin(); it != layers.end(); it++)
+    {
+        const LayerData& ld = it->second;
+        if (ld.type != "Const" || ld.consumers.empty())
+            continue;
+        bool fold = true;
+        for (size_t i = 0; i < ld.consumers.size(); i++)
+        {
+            const String& type = layers[ld.consumers[i].lid].type;
+            fold &= type == "Attention" || type == "Einsum";
+        }
+        if (fold)
+            foldedConsts.insert(ld.id);
+    }
+
     for (Impl::MapIdToLayerData::iterator it = layers.begin(); it != layers.end(); it++)
     {
         LayerData ld = it->second;
+        if (foldedConsts.count(ld.id))
+            continue;
         if (ld.id == 0)
         {
             LayerData &quantInpLd = dstNet.layers[0];
@@ -198,13 +220,52 @@ Net Net::Impl::quantize(Net& net, InputArrayOfArrays calibData, int inputsDtype,
         // Especially for Convolution layer and Fully connection layer.
         ld.params.set("per_channel", perChannel);
 
+        std::vector<int> constInputs;
+        const size_t numBlobs = ld.params.blobs.size();
+        for (int i = 0; i < inpPins.size(); i++)
+        {
+            if (foldedConsts.count(inpPins[i].lid))
+            {
+                constInputs.push_back(i);
+                ld.params.blobs.push_back(layers[inpPins[i].lid].layerInstance->blobs[0]);
+            }
+        }
+        if (!constInputs.empty())
+            ld.params.set("const_inputs", DictValue::arrayInt(constInputs.data(), constInputs.size()));
+
         // Quantize layer
         Ptr<Layer> layer = ld.layerInstance;
-        if (layer->tryQuantize(inp_out_sc, inp_out_zp, ld.params))
+        bool quantized = layer->tryQuantize(inp_out_sc, inp_out_zp, ld.params);
+        if (quantized)
         {
             ld.type += "Int8";
             ld.dtype = CV_8S;
         }
+        if (!constInputs.empty())
+        {
+            ld.params.erase("const_inputs");
+            for (int i = (int)constInputs.size() - 1; i >= 0; i--)
+            {
+                if (quantized)
+                {
+                    // folded into the quantized layer
+                    inpPins.erase(inpPins.begin() + constInputs[i]);
+                    inp_out_sc[0].erase(inp_out_sc[0].begin() + constInputs[i]);
+                    inp_out_zp[0].erase(inp_out_zp[0].begin() + constInputs[i]);
+                }
+                else
+                {
+                    const LayerData& constLd = layers[inpPins[constInputs[i]].lid];
+                    if (dstNet.getLayerId(constLd.name) < 0)
+                    {
+                        LayerParams lp = constLd.params;
+                        dstNet.addLayer(constLd.name, constLd.type, constLd.dtype, lp);
+                    }
+                }
+            }
+            if (!quantized)
+                ld.params.blobs.resize(numBlobs);
+        }
         ld.params.set("scales", DictValue::arrayReal(inp_out_sc[1].data(), inp_out_sc[1].size()));
         ld.params.set("zeropoints", DictValue::arrayInt(inp_out_zp[1].data(), inp_out_zp[1].size()));
 
@@ -0,0 +1,617 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "precomp.hpp"
+
+#include "net_impl.hpp"
+#include "layers/cpu_kernels/shared_weights.hpp"
+
+#include <opencv2/core/utils/logger.hpp>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define OPENCV_DNN_CACHE_MMAP 1
+#endif
+
+namespace cv {
+namespace dnn {
+CV__DNN_INLINE_NS_BEGIN
+
+/* Network cache file layout (native byte order):
+ *   header: magic, format version, byte order marker, OpenCV version, CPU features,
+ *           size of the graph section, offset and size of the data section
+ *   graph:  layers with parameters and connections, inputs and outputs of the network,
+ *           prepacked weights of the layers (keys, parameters and references to their buffers)
+ *   data:   contents of the weights, every blob is aligned to CACHE_ALIGNMENT bytes
+ * The data section is mapped into memory by readNetFromCache(), blobs of the layers refer to it.
+ * Prepacked weights depend on the CPU, they are used only if CPU features match. They are copied
+ * into the buffers of the packing kernels, which are validated against the parameters of the layers.
+ */
+static const char CACHE_MAGIC[8] = {'O', 'C', 'V', 'D', 'N', 'N', 'C', 'F'};
+static const uint32_t CACHE_FORMAT_VERSION = 2;
+static const uint32_t CACHE_BYTE_ORDER = 0x01020304;
+enum { CACHE_ALIGNMENT = 64 };
+
+std::string getCPUFeaturesKey()
+{
+    std::string key;
+    for (int i = 1; i < CV_HARDWARE_MAX_FEATURE; i++)
+    {
+        if (!checkHardwareSupport(i))
+            continue;
+        String name = getHardwareFeatureName(i);
+        if (name.empty())
+            continue;
+        if (!key.empty())
+            key += ' ';
+        key += name;
+    }
+    return key;
+}
+
+class CacheWriter
+{
+public:
+    template<typename T> void put(const T& v)
+    {
+        const uchar* p = (const uchar*)&v;
+        buf.insert(buf.end(), p, p + sizeof(T));
+    }
+    void putString(const std::string& s)
+    {
+        put((int32_t)s.size());
+        buf.insert(buf.end(), s.begin(), s.end());
+    }
+    void putInts(const std::vector<int>& v)
+    {
+        put((int32_t)v.size());
+        for (size_t i = 0; i < v.size(); i++)
+            put((int32_t)v[i]);
+    }
+    void putDict(const Dict& dict)
+    {
+        put((int32_t)std::distance(dict.begin(), dict.end()));
+        for (std::map<String, DictValue>::const_iterator it = dict.begin(); it != dict.end(); ++it)
+        {
+            const DictValue& v = it->second;
+            const int n = v.size();
+            putString(it->first);
+            put((int32_t)(v.isInt() ? Param::INT : v.isReal() ? Param::REAL : Param::STRING));
+            put((int32_t)n);
+            for (int i = 0; i < n; i++)
+            {
+                if (v.isInt())
+                    put(v.get<int64>(i));
+                else if (v.isReal())
+                    put(v.get<double>(i));
+                else
+                    putString(v.get<String>(i));
+            }
+        }
+    }
+
+    std::vector<uchar> buf;
+};
+
+class CacheReader
+{
+public:
+    CacheReader(const uchar* data, size_t size) : ptr(data), end(data + size) {}
+
+    template<typename T> T get()
+    {
+        check(sizeof(T));
+        T v;
+        memcpy(&v, ptr, sizeof(T));
+        ptr += sizeof(T);
+        return v;
+    }
+    int getCount()
+    {
+        int32_t n = get<int32_t>();
+        if (n < 0)
+            CV_Error(Error::StsParseError, "DNN/cache: invalid file");
+        return n;
+    }
+    std::string getString()
+    {
+        int n = getCount();
+        check(n);
+        std::string s((const char*)ptr, n);
+        ptr += n;
+        return s;
+    }
+    const uchar* position() const { return ptr; }
+    std::vector<int> getInts()
+    {
+        std::vector<int> v(getCount());
+        for (size_t i = 0; i < v.size(); i++)
+            v[i] = get<int32_t>();
+        return v;
+    }
+    void getDict(Dict& dict)
+    {
+        int count = getCount();
+        for (int k = 0; k < count; k++)
+        {
+            String key = getString();
+            int32_t type = get<int32_t>();
+            int n = getCount();
+            if (type == (int32_t)Param::INT)
+            {
+                std::vector<int64> v(n);
+                for (int i = 0; i < n; i++)
+                    v[i] = get<int64>();
+                dict.set(key, DictValue::arrayInt(v.begin(), n));
+            }
+            else if (type == (int32_t)Param::REAL)
+            {
+                std::vector<double> v(n);
+                for (int i = 0; i < n; i++)
+                    v[i] = get<double>();
+                dict.set(key, DictValue::arrayReal(v.begin(), n));
+            }
+            else if (type == (int32_t)Param::STRING)
+            {
+                std::vector<String> v(n);
+                for (int i = 0; i < n; i++)
+                    v[i] = getString();
+                dict.set(key, DictValue::arrayString(v.begin(), n));
+            }
+            else
+                CV_Error(Error::StsParseError, "DNN/cache: invalid type of parameter " + key);
+        }
+    }
+
+private:
+    void check(size_t n) const
+    {
+        if ((size_t)(end - ptr) < n)
+            CV_Error(Error::StsParseError, "DNN/cache: unexpected end of file");
+    }
+
+    const uchar* ptr;
+    const uchar* end;
+};
+
+// Contents of the weights written after the graph, the same buffer is stored once
+class CacheBlobsWriter
+{
+public:
+    CacheBlobsWriter() : size(0) {}
+
+    void putMat(CacheWriter& w, const Mat& m)
+    {
+        if (m.empty())
+        {
+            w.put((int32_t)-1);
+            return;
+        }
+        Mat blob = m.isContinuous() ? m : m.clone();
+        const size_t nbytes = blob.total() * blob.elemSize();
+        std::map<const uchar*, std::pair<size_t, size_t> >::const_iterator it = offsets.find(blob.data);
+        size_t offset;
+        if (it != offsets.end() && it->second.second == nbytes)
+            offset = it->second.first;
+        else
+        {
+            offset = alignSize(size, CACHE_ALIGNMENT);
+            size = offset + nbytes;
+            offsets[blob.data] = std::make_pair(offset, nbytes);
+            blobs.push_back(std::make_pair(offset, blob));
+        }
+        w.put((int32_t)blob.type());
+        w.putInts(shape(blob));
+        w.put((uint64_t)offset);
+    }
+
+    void write(std::ostream& os) const
+    {
+        static const char zeros[CACHE_ALIGNMENT] = {};
+        size_t pos = 0;
+        for (size_t i = 0; i < blobs.size(); i++)
+        {
+            const Mat& blob = blobs[i].second;
+            os.write(zeros, blobs[i].first - pos);
+            os.write((const char*)blob.data, blob.total() * blob.elemSize());
+            pos = blobs[i].first + blob.total() * blob.elemSize();
+        }
+    }
+
+    size_t size;
+
+private:
+    std::vector<std::pair<size_t, Mat> > blobs;
+    std::map<const uchar*, std::pair<size_t, size_t> > offsets;
+};
+
+void Net::Impl::collectPackedWeights(std::map<std::string, Ptr<void> >& packed) const
+{
+    for (SharedWeightsMap::const_iterator it = packedWeights.begin(); it != packedWeights.end(); ++it)
+    {
+        if (Ptr<void> value = it->second.lock())
+            packed[it->first] = value;
+    }
+    for (std::list<ShapeBucket>::const_iterator it = shapeBuckets.begin(); it != shapeBuckets.end(); ++it)
+        it->net.getImpl()->collectPackedWeights(packed);
+}
+
+void Net::Impl::releasePreloadedWeights(bool all)
+{
+    if (all)
+    {
+        preloadedWeights.clear();
+        return;
+    }
+    for (std::map<std::string, Ptr<void> >::iterator it = preloadedWeights.begin(); it != preloadedWeights.end();)
+    {
+        if (packedWeights.count(it->first))
+            it = preloadedWeights.erase(it);  // held by the layers
+        else
+            ++it;
+    }
+}
+
+void Net::Impl::sharePreloadedWeights(Impl& dst) const
+{
+    dst.preloadedWeights.insert(preloadedWeights.begin(), preloadedWeights.end());
+}
+
+void Net::Impl::writeCache(const String& path) const
+{
+    CV_TRACE_FUNCTION();
+    CV_Assert(!empty());
+
+    CacheWriter graph;
+    CacheBlobsWriter data;
+    graph.put((uint8_t)hasDynamicShapes);
+    graph.put((uint8_t)netWasQuantized);
+    graph.put((uint8_t)fusion);
+    graph.put((uint8_t)useWinograd);
+    graph.put((int32_t)lastLayerId);
+
+    graph.put((int32_t)netInputLayer->outNames.size());
+    for (size_t i = 0; i < netInputLayer->outNames.size(); i++)
+    {
+        graph.putString(netInputLayer->outNames[i]);
+        graph.putInts(i < netInputLayer->shapes.size() ? netInputLayer->shapes[i] : MatShape());
+    }
+    graph.put((int32_t)outputNameToId.size());
+    for (std::map<std::string, int>::const_iterator it = outputNameToId.begin(); it != outputNameToId.end(); ++it)
+    {
+        graph.putString(it->first);
+        graph.put((int32_t)it->second);
+    }
+
+    graph.put((int32_t)layers.size());
+    for (MapIdToLayerData::const_iterator it = layers.begin(); it != layers.end(); ++it)
+    {
+        const LayerData& ld = it->second;
+        graph.put((int32_t)ld.id);
+        if (ld.id != 0)
+        {
+            graph.putString(ld.name);
+            graph.putString(ld.type);
+            graph.put((int32_t)ld.dtype);
+            graph.putDict(ld.params);
+            // setParam() modifies the blobs of the layer instance only
+            const std::vector<Mat>& blobs = layerBlobsModified && ld.layerInstance ? ld.layerInstance->blobs : ld.params.blobs;
+            graph.put((int32_t)blobs.size());
+            for (size_t i = 0; i < blobs.size(); i++)
+                data.putMat(graph, blobs[i]);
+        }
+        graph.put((int32_t)ld.inputBlobsId.size());
+        for (size_t i = 0; i < ld.inputBlobsId.size(); i++)
+        {
+            graph.put((int32_t)ld.inputBlobsId[i].lid);
+            graph.put((int32_t)ld.inputBlobsId[i].oid);
+        }
+        graph.putInts(std::vector<int>(ld.inputLayersId.begin(), ld.inputLayersId.end()));
+        graph.putInts(std::vector<int>(ld.requiredOutputs.begin(), ld.requiredOutputs.end()));
+        graph.put((int32_t)ld.consumers.size());
+        for (size_t i = 0; i < ld.consumers.size(); i++)
+        {
+            graph.put((int32_t)ld.consumers[i].lid);
+            graph.put((int32_t)ld.consumers[i].oid);
+        }
+    }
+
+    // Prepacked weights (GEMM, Winograd, FP16 layouts, including weights of fused layers) are stored
+    // with their keys. The keys include digests of the source weights, so after loading the layers
+    // find them by the keys computed from their own weights instead of packing again.
+    std::map<std::string, Ptr<void> > packed;
+    collectPackedWeights(packed);
+    std::vector<std::pair<std::string, std::pair<std::vector<int>, std::vector<Mat> > > > packedEntries;
+    for (std::map<std::string, Ptr<void> >::const_iterator it = packed.begin(); it != packed.end(); ++it)
+    {
+        std::vector<int> params;
+        std::vector<Mat> buffers;
+        if (serializeSharedWeights(it->first, it->second, params, buffers))
+            packedEntries.push_back(std::make_pair(it->first, std::make_pair(params, buffers)));
+    }
+    graph.put((int32_t)packedEntries.size());
+    for (size_t i = 0; i < packedEntries.size(); i++)
+    {
+        graph.putString(packedEntries[i].first);
+        graph.putInts(packedEntries[i].second.first);
+        const std::vector<Mat>& buffers = packedEntries[i].second.second;
+        graph.put((int32_t)buffers.size());
+        for (size_t j = 0; j < buffers.size(); j++)
+            data.putMat(graph, buffers[j]);
+    }
+
+    // the header size doesn't depend on the offset value
+    CacheWriter header;
+    for (int pass = 0; pass < 2; pass++)
+    {
+        const size_t dataOffset = alignSize(header.buf.size() + graph.buf.size(), CACHE_ALIGNMENT);
+        header.buf.clear();
+        header.put(CACHE_MAGIC);
+        header.put(CACHE_FORMAT_VERSION);
+        header.put(CACHE_BYTE_ORDER);
+        header.putString(CV_VERSION);
+        header.putString(getCPUFeaturesKey());
+        header.put((uint64_t)graph.buf.size());
+        header.put((uint64_t)dataOffset);
+        header.put((uint64_t)data.size);
+    }
+    const size_t graphEnd = header.buf.size() + graph.buf.size();
+
+    std::ofstream os(path.c_str(), std::ios::binary);
+    if (!os.is_open())
+        CV_Error(Error::StsError, "DNN/cache: can't open file for writing: " + path);
+    os.write((const char*)header.buf.data(), header.buf.size());
+    os.write((const char*)graph.buf.data(), graph.buf.size());
+    std::vector<char> padding(alignSize(graphEnd, CACHE_ALIGNMENT) - graphEnd, 0);
+    os.write(padding.data(), padding.size());
+    data.write(os);
+    if (!os.good())
+        CV_Error(Error::StsError, "DNN/cache: can't write file: " + path);
+}
+
+// Owner of the file contents, keeps them while any of the weights is referenced
+class CacheFileAllocator CV_FINAL : public MatAllocator
+{
+public:
+    UMatData* allocate(int dims, const int* sizes, int type, void* data, size_t* step,
+                       AccessFlag flags, UMatUsageFlags usageFlags) const CV_OVERRIDE
+    {
+        return Mat::getStdAllocator()->allocate(dims, sizes, type, data, step, flags, usageFlags);
+    }
+    bool allocate(UMatData*, AccessFlag, UMatUsageFlags) const CV_OVERRIDE
+    {
+        return false;
+    }
+    void deallocate(UMatData* u) const CV_OVERRIDE
+    {
+        if (!u)
+            return;
+        CV_Assert(u->urefcount == 0 && u->refcount == 0);
+#ifdef OPENCV_DNN_CACHE_MMAP
+        if (u->handle)
+            munmap(u->origdata, u->size);
+        else
+#endif
+            fastFree(u->origdata);
+        delete u;
+    }
+
+    static MatAllocator* getInstance()
+    {
+        static MatAllocator* instance = new CacheFileAllocator();
+        return instance;
+    }
+};
+
+class CacheFile
+{
+public:
+    explicit CacheFile(const String& path) : u(NULL)
+    {
+#ifdef OPENCV_DNN_CACHE_MMAP
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            CV_Error(Error::StsError, "DNN/cache: can't open file: " + path);
+        struct stat st;
+        void* p = MAP_FAILED;
+        if (fstat(fd, &st) == 0 && st.st_size > 0)
+        {
+            // private mapping: layers are allowed to modify weights in place, pages are copied on write
+            p = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        }
+        close(fd);
+        if (p != MAP_FAILED)
+        {
+            init((uchar*)p, (size_t)st.st_size);
+            u->handle = p;
+            return;
+        }
+        CV_LOG_DEBUG(NULL, "DNN/cache: can't map file, reading: " + path);
+#endif
+        std::ifstream is(path.c_str(), std::ios::binary | std::ios::ate);
+        if (!is.is_open())
+            CV_Error(Error::StsError, "DNN/cache: can't open file: " + path);
+        const size_t size = (size_t)is.tellg();
+        init((uchar*)fastMalloc(std::max(size, (size_t)1)), size);
+        is.seekg(0);
+        is.read((char*)u->origdata, size);
+        if (!is.good())
+            CV_Error(Error::StsError, "DNN/cache: can't read file: " + path);
+    }
+
+    ~CacheFile()
+    {
+        if (u && CV_XADD(&u->refcount, -1) == 1)
+            u->currAllocator->unmap(u);
+    }
+
+    const uchar* data() const { return u->origdata; }
+    size_t size() const { return u->size; }
+
+    // the returned header shares the file contents
+    Mat getMat(int type, const MatShape& shape, size_t offset) const
+    {
+        CV_CheckEQ(type, CV_MAT_TYPE(type), "DNN/cache: invalid file, unknown blob type");
+        CV_CheckFalse(shape.empty(), "DNN/cache: invalid file");
+        size_t size = CV_ELEM_SIZE(type);
+        for (size_t i = 0; i < shape.size(); i++)
+        {
+            CV_CheckGE(shape[i], 0, "DNN/cache: invalid file");
+            if (shape[i] > 0)
+                CV_CheckLE(size, u->size / shape[i], "DNN/cache: invalid file");  // no overflow
+            size *= shape[i];
+        }
+        CV_CheckLE(size, u->size, "DNN/cache: invalid file");
+        CV_CheckLE(offset, u->size - size, "DNN/cache: invalid file");
+        Mat m((int)shape.size(), shape.data(), type, u->origdata + offset);
+        m.u = u;
+        CV_XADD(&u->refcount, 1);
+        return m;
+    }
+
+private:
+    void init(uchar* p, size_t size)
+    {
+        u = new UMatData(CacheFileAllocator::getInstance());
+        u->data = u->origdata = p;
+        u->size = size;
+        u->refcount = 1;
+    }
+
+    UMatData* u;
+};
+
+Net readNetFromCache(const String& path)
+{
+    CV_TRACE_FUNCTION();
+    CacheFile file(path);
+
+    CacheReader header(file.data(), file.size());
+    char magic[sizeof(CACHE_MAGIC)];
+    for (size_t i = 0; i < sizeof(magic); i++)
+        magic[i] = header.get<char>();
+    if (memcmp(magic, CACHE_MAGIC, sizeof(magic)) != 0)
+        CV_Error(Error::StsParseError, "DNN/cache: not a network cache file: " + path);
+    const uint32_t version = header.get<uint32_t>();
+    if (version != CACHE_FORMAT_VERSION || header.get<uint32_t>() != CACHE_BYTE_ORDER)
+        CV_Error(Error::StsNotImplemented, cv::format("DNN/cache: unsupported format (version %u) of file ", version) + path);
+    const std::string cvVersion = header.getString();
+    if (cvVersion != CV_VERSION)
+        CV_Error(Error::StsNotImplemented, "DNN/cache: file is created by OpenCV " + cvVersion + ", re-create it: " + path);
+    const std::string features = header.getString();
+    const uint64_t graphSize = header.get<uint64_t>();
+    const uint64_t dataOffset = header.get<uint64_t>();
+    const uint64_t dataSize = header.get<uint64_t>();
+    const size_t graphOffset = header.position() - file.data();
+    if (graphSize > file.size() - graphOffset || dataOffset < graphOffset + graphSize ||
+        dataOffset > file.size() || dataSize > file.size() - dataOffset)
+        CV_Error(Error::StsParseError, "DNN/cache: invalid file: " + path);
+
+    Net net;
+    Net::Impl& impl = net.getImplRef();
+    CacheReader graph(file.data() + graphOffset, (size_t)graphSize);
+    impl.hasDynamicShapes = graph.get<uint8_t>() != 0;
+    impl.netWasQuantized = graph.get<uint8_t>() != 0;
+    impl.fusion = graph.get<uint8_t>() != 0;
+    impl.useWinograd = graph.get<uint8_t>() != 0;
+    impl.lastLayerId = graph.get<int32_t>();
+
+    std::vector<String> inputNames(graph.getCount());
+    std::vector<MatShape> inputShapes(inputNames.size());
+    for (size_t i = 0; i < inputNames.size(); i++)
+    {
+        inputNames[i] = graph.getString();
+        inputShapes[i] = graph.getInts();
+    }
+    impl.netInputLayer->setNames(inputNames);
+    for (size_t i = 0; i < inputNames.size(); i++)
+    {
+        if (!inputShapes[i].empty())
+            impl.netInputLayer->setInputShape(inputNames[i], inputShapes[i]);
+    }
+    int numOutputs = graph.getCount();
+    for (int i = 0; i < numOutputs; i++)
+    {
+        std::string name = graph.getString();
+        impl.outputNameToId[name] = graph.get<int32_t>();
+    }
+
+    auto readBlob = [&]() -> Mat
+    {
+        const int32_t blobType = graph.get<int32_t>();
+        if (blobType < 0)
+            return Mat();
+        MatShape blobShape = graph.getInts();
+        const uint64_t offset = graph.get<uint64_t>();
+        CV_CheckLE(offset, dataSize, "DNN/cache: invalid file");
+        return file.getMat(blobType, blobShape, (size_t)(dataOffset + offset));
+    };
+
+    int numLayers = graph.getCount();
+    for (int k = 0; k < numLayers; k++)
+    {
+        const int id = graph.get<int32_t>();
+        if (id != 0)
+        {
+            LayerParams params;
+            String name = graph.getString();
+            String type = graph.getString();
+            const int dtype = graph.get<int32_t>();
+            graph.getDict(params);
+            params.blobs.resize(graph.getCount());
+            for (size_t i = 0; i < params.blobs.size(); i++)
+                params.blobs[i] = readBlob();
+            CV_Assert(impl.layers.find(id) == impl.layers.end());
+            impl.layers.insert(std::make_pair(id, LayerData(id, name, type, dtype, params)));
+            impl.layerNameToId.insert(std::make_pair(name, id));
+        }
+        LayerData& ld = impl.getLayerData(id);
+        ld.inputBlobsId.resize(graph.getCount());
+        for (size_t i = 0; i < ld.inputBlobsId.size(); i++)
+        {
+            ld.inputBlobsId[i].lid = graph.get<int32_t>();
+            ld.inputBlobsId[i].oid = graph.get<int32_t>();
+        }
+        std::vector<int> ids = graph.getInts();
+        ld.inputLayersId.insert(ids.begin(), ids.end());
+        ids = graph.getInts();
+        ld.requiredOutputs.insert(ids.begin(), ids.end());
+        ld.consumers.resize(graph.getCount());
+        for (size_t i = 0; i < ld.consumers.size(); i++)
+        {
+            ld.consumers[i].lid = graph.get<int32_t>();
+            ld.consumers[i].oid = graph.get<int32_t>();
+        }
+    }
+
+    const int numPacked = graph.getCount();
+    if (numPacked > 0 && features != getCPUFeaturesKey())
+    {
+        CV_LOG_WARNING(NULL, "DNN/cache: file is created on CPU with other features (" << features << "), "
+                             "prepacked weights are ignored and will be packed again: " << path);
+        return net;
+    }
+    if (numPacked > 0 && !isPackedWeightsSharingEnabled())
+    {
+        CV_LOG_WARNING(NULL, "DNN/cache: prepacked weights are ignored, OPENCV_DNN_SHARE_PACKED_WEIGHTS is disabled: " << path);
+        return net;
+    }
+    for (int k = 0; k < numPacked; k++)
+    {
+        std::string key = graph.getString();
+        std::vector<int> params = graph.getInts();
+        std::vector<Mat> buffers(graph.getCount());
+        for (size_t i = 0; i < buffers.size(); i++)
+            buffers[i] = readBlob();
+        // kept by the network until its layers request them, other networks don't see them
+        impl.preloadedWeights[key] = deserializeSharedWeights(key, params, buffers);
+    }
+    return net;
+}
+
+CV__DNN_INLINE_NS_END
+}}  // namespace cv::dnn
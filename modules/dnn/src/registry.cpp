@@ -14,6 +14,7 @@
 #include "op_cann.hpp"
 
 #include "halide_scheduler.hpp"
+#include "layers/cpu_kernels/reduced_precision.hpp"  // haveReducedPrecisionWeights
 
 #include "backend.hpp"
 #include "factory.hpp"
@@ -64,6 +65,8 @@ private:
         bool haveBackendCPU_FP16 = false;
 #if defined(__arm64__) && __arm64__
         haveBackendCPU_FP16 = true;
+#else
+        haveBackendCPU_FP16 = haveReducedPrecisionWeights();
 #endif
 
         if (haveBackendOpenVINO && openvino::checkTarget(DNN_TARGET_CPU))
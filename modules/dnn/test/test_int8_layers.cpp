@@ -397,6 +397,223 @@ TEST_P(Test_Int8_layers, InnerProduct)
     }
 }
 
+static void testInt8MatMulNet(Net& net, const std::vector<Mat>& inputs, const std::string& layerName,
+                              const std::string& int8Type, double l1, double lInf)
+{
+    net.setPreferableBackend(DNN_BACKEND_OPENCV);
+    net.setPreferableTarget(DNN_TARGET_CPU);
+    std::vector<String> inpNames(inputs.size());
+    for (size_t i = 0; i < inputs.size(); i++)
+    {
+        inpNames[i] = format("input%d", (int)i);
+    }
+    net.setInputsNames(inpNames);
+    for (size_t i = 0; i < inputs.size(); i++)
+        net.setInput(inputs[i], inpNames[i]);
+    Mat ref = net.forward().clone();
+
+    Net qnet = net.quantize(inputs, CV_32F, CV_32F);
+    qnet.setPreferableBackend(DNN_BACKEND_OPENCV);
+    qnet.setPreferableTarget(DNN_TARGET_CPU);
+    EXPECT_EQ(int8Type, qnet.getLayer(layerName)->type);
+    for (size_t i = 0; i < inputs.size(); i++)
+        qnet.setInput(inputs[i], inpNames[i]);
+    Mat out = qnet.forward();
+    normAssert(ref, out, "", l1, lInf);
+}
+
+TEST(Test_Int8_layers_MatMul, const_weights)
+{
+    Mat A({2, 5, 24}, CV_32F), B(24, 10, CV_32F);
+    randu(A, -1.f, 1.f);
+    randu(B, -1.f, 1.f);
+
+    LayerParams lp;
+    lp.type = "MatMul";
+    lp.name = "matmul";
+    lp.blobs.push_back(B);
+    Net net;
+    net.addLayerToPrev(lp.name, lp.type, lp);
+    testInt8MatMulNet(net, std::vector<Mat>(1, A), lp.name, "MatMulInt8", 0.03, 0.1);
+}
+
+TEST(Test_Int8_layers_MatMul, two_inputs_broadcast)
+{
+    Mat A({2, 3, 8, 16}, CV_32F), B({3, 16, 10}, CV_32F);
+    randu(A, -1.f, 1.f);
+    randu(B, -1.f, 1.f);
+
+    LayerParams lp;
+    lp.type = "MatMul";
+    lp.name = "matmul";
+    Net net;
+    int id = net.addLayer(lp.name, lp.type, lp);
+    net.connect(0, 0, id, 0);
+    net.connect(0, 1, id, 1);
+    std::vector<Mat> inputs;
+    inputs.push_back(A);
+    inputs.push_back(B);
+    testInt8MatMulNet(net, inputs, lp.name, "MatMulInt8", 0.03, 0.15);
+}
+
+TEST(Test_Int8_layers_MatMul, gemm_bias)
+{
+    Mat A(7, 32, CV_32F), B(12, 32, CV_32F), C(1, 12, CV_32F);
+    randu(A, -1.f, 1.f);
+    randu(B, -1.f, 1.f);
+    randu(C, -1.f, 1.f);
+
+    LayerParams lp;
+    lp.type = "Gemm";
+    lp.name = "gemm";
+    lp.set("transB", true);
+    lp.set("constB", true);
+    lp.set("have_bias", true);
+    lp.set("constC", true);
+    lp.set("real_ndims_C", 2);
+    lp.blobs.push_back(B);
+    lp.blobs.push_back(C);
+    Net net;
+    net.addLayerToPrev(lp.name, lp.type, lp);
+    testInt8MatMulNet(net, std::vector<Mat>(1, A), lp.name, "GemmInt8", 0.03, 0.1);
+}
+
+TEST(Test_Int8_layers_MatMul, attention_const_weights)
+{
+    const int batch = 2, seq_len = 6, hidden = 16, num_heads = 2;
+    const int bias_size = 3 * hidden;
+    Mat X({batch, seq_len, hidden}, CV_32F), W(hidden, bias_size, CV_32F), bias(1, &bias_size, CV_32F);
+    randu(X, -1.f, 1.f);
+    randu(W, -0.5f, 0.5f);
+    randu(bias, -0.1f, 0.1f);
+
+    Net net;
+    LayerParams wp, bp;
+    wp.blobs.push_back(W);
+    bp.blobs.push_back(bias);
+    int wid = net.addLayer("weight", "Const", wp);
+    int bid = net.addLayer("bias", "Const", bp);
+
+    LayerParams lp;
+    lp.type = "Attention";
+    lp.name = "attention";
+    lp.set("num_heads", num_heads);
+    int qkv[] = {hidden, hidden, hidden};
+    lp.set("qkv_hidden_sizes", DictValue::arrayInt(qkv, 3));
+    int id = net.addLayer(lp.name, lp.type, lp);
+    net.connect(0, 0, id, 0);
+    net.connect(wid, 0, id, 1);
+    net.connect(bid, 0, id, 2);
+    testInt8MatMulNet(net, std::vector<Mat>(1, X), lp.name, "AttentionInt8", 0.03, 0.15);
+}
+
+TEST(Test_Int8_layers_MatMul, attention_kv_cache)
+{
+    const int batch = 1, seq_len = 12, prefix = 9, hidden = 16, num_heads = 2;
+    const int bias_size = 3 * hidden;
+    Mat X({batch, seq_len, hidden}, CV_32F), W(hidden, bias_size, CV_32F), bias(1, &bias_size, CV_32F);
+    randu(X, -1.f, 1.f);
+    randu(W, -0.5f, 0.5f);
+    randu(bias, -0.1f, 0.1f);
+
+    Net net;
+    LayerParams wp, bp;
+    wp.blobs.push_back(W);
+    bp.blobs.push_back(bias);
+    int wid = net.addLayer("weight", "Const", wp);
+    int bid = net.addLayer("bias", "Const", bp);
+
+    LayerParams lp;
+    lp.type = "Attention";
+    lp.name = "attention";
+    lp.set("num_heads", num_heads);
+    lp.set("unidirectional", 1);
+    int qkv[] = {hidden, hidden, hidden};
+    lp.set("qkv_hidden_sizes", DictValue::arrayInt(qkv, 3));
+    int id = net.addLayer(lp.name, lp.type, lp);
+    net.connect(0, 0, id, 0);
+    net.connect(wid, 0, id, 1);
+    net.connect(bid, 0, id, 2);
+    net.setPreferableBackend(DNN_BACKEND_OPENCV);
+    net.setPreferableTarget(DNN_TARGET_CPU);
+
+    Net qnet = net.quantize(X, CV_32F, CV_32F);
+    qnet.setPreferableBackend(DNN_BACKEND_OPENCV);
+    qnet.setPreferableTarget(DNN_TARGET_CPU);
+    ASSERT_EQ("AttentionInt8", qnet.getLayer(lp.name)->type);
+    qnet.setInput(X);
+    Mat ref = qnet.forward().clone();
+
+    qnet.enableKVCache(true);
+    Ptr<AttentionLayer> layer = qnet.getLayer(lp.name).dynamicCast<AttentionLayer>();
+    ASSERT_TRUE(layer);
+    for (int iter = 0; iter < 2; iter++)
+    {
+        // prefix at once, then token by token. Causal tokens don't depend on the next ones.
+        for (int start = 0; start < seq_len; )
+        {
+            int len = start == 0 ? prefix : 1;
+            Range ranges[] = {Range::all(), Range(start, start + len), Range::all()};
+            qnet.setInput(X(ranges).clone());
+            Mat out = qnet.forward();
+            ASSERT_EQ(len, out.size[1]);
+            normAssert(ref(ranges), out, cv::format("tokens %d..%d", start, start + len).c_str(), 1e-5, 1e-4);
+            start += len;
+            EXPECT_EQ(start, layer->getKVCacheLength());
+        }
+        qnet.resetState();
+        EXPECT_EQ(0, layer->getKVCacheLength());
+    }
+}
+
+static LayerParams einsumParams(const std::string& equation, const std::vector<MatShape>& inputShapes)
+{
+    LayerParams lp;
+    lp.type = "Einsum";
+    lp.name = "einsum";
+    lp.set("equation", equation);
+    lp.set("inputSize", (int)inputShapes.size());
+    lp.set("outputSize", 1);
+    for (size_t i = 0; i < inputShapes.size(); i++)
+        lp.set(format("inputShapes%d", (int)i), DictValue::arrayInt(inputShapes[i].data(), inputShapes[i].size()));
+    return lp;
+}
+
+TEST(Test_Int8_layers_MatMul, einsum_two_inputs)
+{
+    Mat A({3, 8, 16}, CV_32F), B({3, 16, 10}, CV_32F);
+    randu(A, -1.f, 1.f);
+    randu(B, -1.f, 1.f);
+
+    LayerParams lp = einsumParams("bmk,bkn->bmn", {shape(A), shape(B)});
+    Net net;
+    int id = net.addLayer(lp.name, lp.type, lp);
+    net.connect(0, 0, id, 0);
+    net.connect(0, 1, id, 1);
+    std::vector<Mat> inputs;
+    inputs.push_back(A);
+    inputs.push_back(B);
+    testInt8MatMulNet(net, inputs, lp.name, "EinsumInt8", 0.03, 0.15);
+}
+
+TEST(Test_Int8_layers_MatMul, einsum_const_weights)
+{
+    Mat A(7, 24, CV_32F), B(12, 24, CV_32F);
+    randu(A, -1.f, 1.f);
+    randu(B, -1.f, 1.f);
+
+    Net net;
+    LayerParams wp;
+    wp.blobs.push_back(B);
+    int wid = net.addLayer("weight", "Const", wp);
+
+    LayerParams lp = einsumParams("mk,nk->mn", {shape(A), shape(B)});
+    int id = net.addLayer(lp.name, lp.type, lp);
+    net.connect(0, 0, id, 0);
+    net.connect(wid, 0, id, 1);
+    testInt8MatMulNet(net, std::vector<Mat>(1, A), lp.name, "EinsumInt8", 0.03, 0.1);
+}
+
 TEST_P(Test_Int8_layers, Reshape)
 {
     testLayer("reshape_layer", "TensorFlow", 0.0032, 0.0082);
@@ -1871,6 +1871,122 @@ TEST(Layer_Test_Convolution, relu_fusion)
     normAssert(input, output);
 }
 
+static Net createAttentionNet(const Mat& W, const Mat& bias, int num_heads, bool unidirectional)
+{
+    Net net;
+    LayerParams wp, bp;
+    wp.blobs.push_back(W);
+    bp.blobs.push_back(bias);
+    int wid = net.addLayer("weight", "Const", wp);
+    int bid = net.addLayer("bias", "Const", bp);
+
+    LayerParams lp;
+    lp.set("num_heads", num_heads);
+    lp.set("unidirectional", unidirectional ? 1 : 0);
+    int hidden = W.cols / 3;
+    int qkv[] = {hidden, hidden, hidden};
+    lp.set("qkv_hidden_sizes", DictValue::arrayInt(qkv, 3));
+    int id = net.addLayer("attention", "Attention", lp);
+    net.connect(0, 0, id, 0);
+    net.connect(wid, 0, id, 1);
+    net.connect(bid, 0, id, 2);
+    net.setPreferableBackend(DNN_BACKEND_OPENCV);
+    net.setPreferableTarget(DNN_TARGET_CPU);
+    return net;
+}
+
+// X: [B, S, E], W: [E, 3E], bias: [3E]
+static Mat attentionReference(const Mat& X, const Mat& W, const Mat& bias, int num_heads, bool unidirectional)
+{
+    const int batch = X.size[0], seq_len = X.size[1], hidden = X.size[2];
+    const int head_size = hidden / num_heads;
+    Mat out(3, X.size.p, CV_32F);
+    for (int b = 0; b < batch; b++)
+    {
+        Mat x(seq_len, hidden, CV_32F, (void*)X.ptr<float>(b));
+        Mat qkv = x * W + repeat(bias.reshape(1, 1), seq_len, 1);
+        Mat o(seq_len, hidden, CV_32F, out.ptr<float>(b));
+        for (int h = 0; h < num_heads; h++)
+        {
+            Mat q = qkv.colRange(h * head_size, (h + 1) * head_size);
+            Mat k = qkv.colRange(hidden + h * head_size, hidden + (h + 1) * head_size);
+            Mat v = qkv.colRange(2 * hidden + h * head_size, 2 * hidden + (h + 1) * head_size);
+            Mat scores = q * k.t() / std::sqrt((double)head_size);
+            for (int i = 0; i < seq_len; i++)
+            {
+                Mat row = scores.row(i);
+                if (unidirectional)
+                    row.colRange(i + 1, seq_len).setTo(-FLT_MAX);
+                double maxVal;
+                minMaxLoc(row, 0, &maxVal);
+                exp(row - maxVal, row);
+                row /= sum(row)[0];
+            }
+            Mat(scores * v).copyTo(o.colRange(h * head_size, (h + 1) * head_size));
+        }
+    }
+    return out;
+}
+
+typedef testing::TestWithParam<bool> Layer_Test_Attention;
+TEST_P(Layer_Test_Attention, fused_accuracy)
+{
+    const bool unidirectional = GetParam();
+    // several query and key tiles, partial last tile
+    const int batch = 2, seq_len = 70, hidden = 24, num_heads = 3;
+    Mat X({batch, seq_len, hidden}, CV_32F), W(hidden, 3 * hidden, CV_32F), bias(1, 3 * hidden, CV_32F);
+    randu(X, -1.f, 1.f);
+    randu(W, -0.5f, 0.5f);
+    randu(bias, -0.1f, 0.1f);
+
+    Net net = createAttentionNet(W, bias.reshape(1, std::vector<int>(1, 3 * hidden)), num_heads, unidirectional);
+    net.setInput(X);
+    Mat out = net.forward();
+    normAssert(attentionReference(X, W, bias, num_heads, unidirectional), out, "", 1e-5, 1e-4);
+}
+
+TEST_P(Layer_Test_Attention, kv_cache)
+{
+    const bool unidirectional = GetParam();
+    const int batch = 1, seq_len = 40, prefix = 33, hidden = 16, num_heads = 2;
+    Mat X({batch, seq_len, hidden}, CV_32F), W(hidden, 3 * hidden, CV_32F), bias(1, 3 * hidden, CV_32F);
+    randu(X, -1.f, 1.f);
+    randu(W, -0.5f, 0.5f);
+    randu(bias, -0.1f, 0.1f);
+    Mat bias1d = bias.reshape(1, std::vector<int>(1, 3 * hidden));
+
+    Net net = createAttentionNet(W, bias1d, num_heads, unidirectional);
+    net.setInput(X);
+    Mat ref = net.forward().clone();
+
+    net.enableKVCache(true);
+    for (int iter = 0; iter < 2; iter++)
+    {
+        // prefix at once, then token by token
+        for (int start = 0; start < seq_len; )
+        {
+            int len = start == 0 ? prefix : 1;
+            Range ranges[] = {Range::all(), Range(start, start + len), Range::all()};
+            net.setInput(X(ranges).clone());
+            Mat out = net.forward();
+            ASSERT_EQ(len, out.size[1]);
+            if (unidirectional)
+            {
+                // the tokens don't depend on the next ones
+                normAssert(ref(ranges), out, cv::format("tokens %d..%d", start, start + len).c_str(), 1e-5, 1e-4);
+            }
+            else if (start + len == seq_len)
+            {
+                // the last token attends to all the sequence
+                normAssert(ref(ranges), out, "last token", 1e-5, 1e-4);
+            }
+            start += len;
+        }
+        net.resetState();
+    }
+}
+INSTANTIATE_TEST_CASE_P(/**/, Layer_Test_Attention, testing::Bool());
+
 typedef testing::TestWithParam<tuple<bool, tuple<Backend, Target> > > Layer_Test_Eltwise_unequal;
 TEST_P(Layer_Test_Eltwise_unequal, accuracy_input_0_truncate)
 {
@@ -2783,4 +2899,72 @@ INSTANTIATE_TEST_CASE_P(TestLayerFusion, ConvolutionActivationEltwiseFusion, Com
                         TestLayerFusion::dnnBackendsAndTargetsForFusionTests()
 ));
 
+TEST(ElementwiseChainFusion, Accuracy)
+{
+    //  input ---------------------------+
+    //    |                              |
+    //  sigmoid -> scale -> mul(const) -> add -> reshape -> prelu -> flatten -> tanh -> sub(const)
+    const int inpShape[] = {2, 3, 40, 60};  // planes are larger than a tile
+    Mat input(4, inpShape, CV_32F);
+    randu(input, -1.0f, 1.0f);
+
+    Net net;
+    LayerParams lp;
+    Mat channelsValues(1, 3, CV_32F);
+    randu(channelsValues, 0.5f, 1.5f);
+    lp.blobs.push_back(channelsValues.reshape(1, std::vector<int>{1, 3, 1, 1}));
+    int mulConstId = net.addLayer("mul_const", "Const", lp);
+    lp.blobs.assign(1, Mat(1, 1, CV_32F, Scalar(0.25f)));
+    int subConstId = net.addLayer("sub_const", "Const", lp);
+
+    lp = LayerParams();
+    int sigmoidId = net.addLayer("sigmoid", "Sigmoid", lp);
+    net.connect(0, 0, sigmoidId, 0);
+
+    lp = LayerParams();
+    lp.set("bias_term", true);
+    Mat weights(1, 3, CV_32F), bias(1, 3, CV_32F);
+    randu(weights, -1.0f, 1.0f);
+    randu(bias, -1.0f, 1.0f);
+    lp.blobs.push_back(weights);
+    lp.blobs.push_back(bias);
+    int scaleId = net.addLayerToPrev("scale", "Scale", lp);
+
+    lp = LayerParams();
+    lp.set("operation", "mul");
+    int mulId = net.addLayerToPrev("mul", "NaryEltwise", lp);
+    net.connect(mulConstId, 0, mulId, 1);
+
+    lp.set("operation", "add");
+    int addId = net.addLayerToPrev("add", "NaryEltwise", lp);
+    net.connect(0, 0, addId, 1);
+
+    lp = LayerParams();
+    const int reshapeDims[] = {2, 3, 2400};
+    lp.set("dim", DictValue::arrayInt(reshapeDims, 3));
+    int reshapeId = net.addLayerToPrev("reshape", "Reshape", lp);
+
+    lp = LayerParams();
+    Mat slopes(1, 3, CV_32F);
+    randu(slopes, -1.0f, 1.0f);
+    lp.blobs.push_back(slopes);
+    int preluId = net.addLayerToPrev("prelu", "ChannelsPReLU", lp);
+
+    lp = LayerParams();
+    int flattenId = net.addLayerToPrev("flatten", "Flatten", lp);
+    int tanhId = net.addLayerToPrev("tanh", "TanH", lp);
+
+    lp.set("operation", "sub");
+    int subId = net.addLayer("sub", "NaryEltwise", lp);
+    net.connect(subConstId, 0, subId, 0);
+    net.connect(tanhId, 0, subId, 1);
+
+    std::vector<int> expectedFusedLayers = {scaleId, mulId, addId, reshapeId, preluId, flattenId, tanhId, subId};
+    TestLayerFusion::test(input, net, DNN_BACKEND_OPENCV, DNN_TARGET_CPU, expectedFusedLayers);
+
+    Mat out = net.forward();
+    std::vector<int> expectedShape = {2, 7200};
+    EXPECT_EQ(shape(out), expectedShape);
+}
+
 }} // namespace
@@ -10,6 +10,10 @@
 #include <opencv2/core/ocl.hpp>
 #include <opencv2/core/opencl/ocl_defs.hpp>
 #include <opencv2/dnn/layer.details.hpp>  // CV_DNN_REGISTER_LAYER_CLASS
+#include <opencv2/dnn/utils/debug_utils.hpp>  // getPackedWeightsAddresses
+
+#include <atomic>
+#include <thread>
 
 namespace opencv_test { namespace {
 
@@ -242,6 +246,61 @@ TEST(blobFromImagesWithParams_4ch, multi_image)
     EXPECT_EQ(0, cvtest::norm(2 * blob0, blob1, NORM_INF));
 }
 
+typedef testing::TestWithParam<tuple<bool, DataLayout> > blobFromImageWithWarp_;
+TEST_P(blobFromImageWithWarp_, accuracy)
+{
+    const bool perspective = get<0>(GetParam());
+    const DataLayout layout = get<1>(GetParam());
+
+    Mat img(300, 400, CV_8UC3);
+    randu(img, 0, 256);
+    Size size(160, 120);
+
+    Mat M = getRotationMatrix2D(Point2f(200, 150), 15, 0.4);
+    M.at<double>(0, 2) -= 120;
+    M.at<double>(1, 2) -= 90;
+    if (perspective)
+    {
+        M.push_back(Mat(Matx13d(1e-5, -2e-5, 1.0)));
+    }
+
+    Image2BlobParams param(Scalar(0.5, 0.25, 0.125), size, Scalar(10, 20, 30), true, CV_32F, layout);
+    param.borderValue = Scalar(1, 2, 3);
+
+    Mat warped;
+    if (perspective)
+        warpPerspective(img, warped, M, size, INTER_LINEAR, BORDER_CONSTANT, param.borderValue);
+    else
+        warpAffine(img, warped, M, size, INTER_LINEAR, BORDER_CONSTANT, param.borderValue);
+    cvtColor(warped, warped, COLOR_BGR2YCrCb);
+    Mat ref = blobFromImageWithParams(warped, param);
+
+    Mat blob = blobFromImageWithWarp(img, M, param, INTER_LINEAR, COLOR_BGR2YCrCb);
+    ASSERT_EQ(ref.size, blob.size);
+    // Stripes are warped with shifted matrices, so fixed-point rounding may differ by one level
+    EXPECT_LE(cvtest::norm(ref, blob, NORM_INF), 0.5 + 1e-5);
+    EXPECT_LE(cvtest::norm(ref, blob, NORM_L1) / ref.total(), 0.01);
+}
+INSTANTIATE_TEST_CASE_P(/**/, blobFromImageWithWarp_, Combine(
+    testing::Bool(), Values(DNN_LAYOUT_NCHW, DNN_LAYOUT_NHWC)
+));
+
+TEST(blobFromImageWithWarp, resize_gray_8u)
+{
+    Mat img(64, 48, CV_8UC3);
+    randu(img, 0, 256);
+
+    Matx23d M(0.5, 0, 0, 0, 0.5, 0);
+    Image2BlobParams param(Scalar::all(1.0), Size(24, 32), Scalar(), false, CV_8U);
+    Mat blob = blobFromImageWithWarp(img, M, param, INTER_NEAREST, COLOR_BGR2GRAY);
+
+    Mat resized, gray;
+    warpAffine(img, resized, M, param.size, INTER_NEAREST);
+    cvtColor(resized, gray, COLOR_BGR2GRAY);
+    Mat ref = blobFromImage(gray, 1.0, Size(), Scalar(), false, false, CV_8U);
+    EXPECT_EQ(0, cvtest::norm(ref, blob, NORM_INF));
+}
+
 TEST(readNet, Regression)
 {
     Net net = readNet(findDataFile("dnn/squeezenet_v1.1.prototxt"),
@@ -615,6 +674,1006 @@ TEST(Net, forwardAndRetrieve)
     normAssert(outBlobs[0][1], inp.rowRange(2, 4), "second part");
 }
 
+TEST(Net, memory_planner_branches)
+{
+    Net net;
+    int prevId = 0;
+    std::vector<int> convIds;
+    for (int i = 0; i < 5; ++i)
+    {
+        int inpCn = i == 0 ? 3 : 8;
+        int sz[] = {8, inpCn, 3, 3};
+        Mat weights(4, &sz[0], CV_32F);
+        randu(weights, -0.5f, 0.5f);
+
+        LayerParams lp;
+        lp.set("kernel_size", 3);
+        lp.set("pad", 1);
+        lp.set("num_output", 8);
+        lp.set("bias_term", false);
+        lp.type = "Convolution";
+        lp.name = cv::format("conv%d", i);
+        lp.blobs.push_back(weights);
+        int id = net.addLayer(lp.name, lp.type, lp);
+        net.connect(prevId, 0, id, 0);
+        convIds.push_back(id);
+        prevId = id;
+
+        if (i >= 2)
+        {
+            // skip connection
+            LayerParams lpSum;
+            lpSum.type = "Eltwise";
+            lpSum.name = cv::format("sum%d", i);
+            int sumId = net.addLayer(lpSum.name, lpSum.type, lpSum);
+            net.connect(prevId, 0, sumId, 0);
+            net.connect(convIds[i - 2], 0, sumId, 1);
+            prevId = sumId;
+        }
+    }
+    net.setPreferableBackend(DNN_BACKEND_OPENCV);
+    net.setPreferableTarget(DNN_TARGET_CPU);
+
+    int sz[] = {1, 3, 32, 32};
+    Mat input(4, &sz[0], CV_32F);
+    randu(input, -1.0f, 1.0f);
+
+    size_t weights = 0, blobs = 0, plannedBlobs = 0;
+    net.getMemoryConsumption(std::vector<MatShape>(1, MatShape(sz, sz + 4)), weights, blobs, plannedBlobs);
+    EXPECT_GT(plannedBlobs, (size_t)0);
+    EXPECT_LT(plannedBlobs, blobs);
+
+    net.setInput(input);
+    Mat out = net.forward().clone();
+
+    // reference: all intermediate blobs are kept, so memory is not reused
+    std::vector<String> names = net.getLayerNames();
+    std::vector<Mat> outs;
+    net.setInput(input);
+    net.forward(outs, names);
+    ASSERT_EQ(outs.size(), names.size());
+    normAssert(outs.back(), out);
+}
+
+TEST(Net, clone_shares_weights)
+{
+    Net net;
+    {
+        int sz[] = {8, 3, 3, 3};
+        Mat weights(4, &sz[0], CV_32F);
+        randu(weights, -1.0f, 1.0f);
+
+        LayerParams lp;
+        lp.set("kernel_size", 3);
+        lp.set("num_output", 8);
+        lp.set("bias_term", false);
+        lp.type = "Convolution";
+        lp.name = "conv";
+        lp.blobs.push_back(weights);
+        net.addLayerToPrev(lp.name, lp.type, lp);
+
+        Mat fcWeights(10, 8 * 14 * 14, CV_32F);
+        randu(fcWeights, -0.1f, 0.1f);
+        LayerParams lpFC;
+        lpFC.set("num_output", 10);
+        lpFC.set("bias_term", false);
+        lpFC.type = "InnerProduct";
+        lpFC.name = "fc";
+        lpFC.blobs.push_back(fcWeights);
+        net.addLayerToPrev(lpFC.name, lpFC.type, lpFC);
+    }
+    net.setPreferableBackend(DNN_BACKEND_OPENCV);
+    net.setPreferableTarget(DNN_TARGET_CPU);
+
+    int sz[] = {1, 3, 16, 16};
+    Mat input(4, &sz[0], CV_32F);
+    randu(input, -1.0f, 1.0f);
+    net.setInput(input);
+    Mat ref = net.forward().clone();
+
+    const int numClones = 3;
+    std::vector<Net> clones(numClones);
+    for (int i = 0; i < numClones; ++i)
+    {
+        clones[i] = net.clone();
+        ASSERT_FALSE(clones[i].empty());
+        EXPECT_EQ(net.getLayerNames(), clones[i].getLayerNames());
+    }
+
+    std::vector<Mat> outs(numClones);
+    parallel_for_(Range(0, numClones), [&](const Range& r)
+    {
+        for (int i = r.start; i < r.end; ++i)
+        {
+            clones[i].setInput(input);
+            outs[i] = clones[i].forward().clone();
+        }
+    });
+    for (int i = 0; i < numClones; ++i)
+    {
+        normAssert(ref, outs[i], cv::format("clone %d", i).c_str());
+        EXPECT_EQ(net.getParam("conv", 0).data, clones[i].getParam("conv", 0).data);
+        EXPECT_EQ(net.getParam("fc", 0).data, clones[i].getParam("fc", 0).data);
+    }
+
+    // activations are not shared
+    Mat input2 = input * 0.5;
+    clones[0].setInput(input2);
+    Mat out2 = clones[0].forward();
+    net.setInput(input);
+    normAssert(ref, net.forward(), "original");
+    EXPECT_GT(cvtest::norm(ref, out2, NORM_INF), 0.0);
+}
+
+// prepacked weights (FastConv) are shared by clones
+TEST(Net, clone_shares_packed_weights)
+{
+    const int channels = 64;
+    int wsz[] = {channels, channels, 3, 3};
+    Mat weights(4, &wsz[0], CV_32F);
+    randu(weights, -0.1f, 0.1f);
+
+    Net net;
+    LayerParams lp;
+    lp.set("kernel_size", 3);
+    lp.set("pad", 1);
+    lp.set("num_output", channels);
+    lp.set("bias_term", false);
+    lp.type = "Convolution";
+    lp.name = "conv";
+    lp.blobs.push_back(weights);
+    net.addLayerToPrev(lp.name, lp.type, lp);
+    net.setPreferableBackend(DNN_BACKEND_OPENCV);
+    net.setPreferableTarget(DNN_TARGET_CPU);
+
+    int sz[] = {1, channels, 4, 4};
+    Mat input(4, &sz[0], CV_32F);
+    randu(input, -1.0f, 1.0f);
+    net.setInput(input);
+    Mat ref = net.forward().clone();  // weights are packed on the first forward
+    std::map<std::string, const void*> packed;
+    getPackedWeightsAddresses(net, packed);
+    ASSERT_EQ((size_t)1, packed.size());
+
+    const int numClones = 4;
+    std::vector<Net> clones(numClones);
+    for (int i = 0; i < numClones; ++i)
+    {
+        clones[i] = net.clone();
+        clones[i].setInput(input);
+        normAssert(ref, clones[i].forward(), cv::format("clone %d", i).c_str());
+        std::map<std::string, const void*> packedClone;
+        getPackedWeightsAddresses(clones[i], packedClone);
+        EXPECT_EQ(packed, packedClone) << "clone " << i;
+    }
+
+    // other weights are packed separately
+    Net other;
+    lp.blobs[0] = weights * 0.5;
+    other.addLayerToPrev(lp.name, lp.type, lp);
+    other.setPreferableBackend(DNN_BACKEND_OPENCV);
+    other.setPreferableTarget(DNN_TARGET_CPU);
+    other.setInput(input);
+    other.forward();
+    std::map<std::string, const void*> packedOther;
+    getPackedWeightsAddresses(other, packedOther);
+    ASSERT_EQ((size_t)1, packedOther.size());
+    EXPECT_NE(packed.begin()->second, packedOther.begin()->second);
+}
+
+TEST(Net, forwardAsync_CPU_pipeline)
+{
+    Net net;
+    {
+        int sz[] = {6, 3, 3, 3};
+        Mat weights(4, &sz[0], CV_32F);
+        randu(weights, -1.0f, 1.0f);
+
+        LayerParams lp;
+        lp.set("kernel_size", 3);
+        lp.set("pad", 1);
+        lp.set("num_output", 6);
+        lp.set("bias_term", false);
+        lp.type = "Convolution";
+        lp.name = "conv";
+        lp.blobs.push_back(weights);
+        net.addLayerToPrev(lp.name, lp.type, lp);
+
+        LayerParams lpReLU;
+        lpReLU.type = "ReLU";
+        lpReLU.name = "relu";
+        net.addLayerToPrev(lpReLU.name, lpReLU.type, lpReLU);
+    }
+    net.setPreferableBackend(DNN_BACKEND_OPENCV);
+    net.setPreferableTarget(DNN_TARGET_CPU);
+
+    const int numRequests = 5;
+    std::vector<Mat> inputs(numRequests), refs(numRequests);
+    for (int i = 0; i < numRequests; ++i)
+    {
+        int sz[] = {1, 3, 17, 23};
+        inputs[i].create(4, &sz[0], CV_32F);
+        randu(inputs[i], -1.0f, 1.0f);
+        net.setInput(inputs[i]);
+        refs[i] = net.forward().clone();
+    }
+
+    std::vector<AsyncArray> results(numRequests);
+    Mat buffer;
+    for (int i = 0; i < numRequests; ++i)
+    {
+        inputs[i].copyTo(buffer);  // input buffer is reused by the caller
+        net.setInput(buffer, "", 2.0);
+        results[i] = net.forwardAsync();
+        buffer.setTo(0);
+    }
+    for (int i = 0; i < numRequests; ++i)
+    {
+        Mat out;
+        ASSERT_TRUE(results[i].get(out, 10 * 1e9));
+        Mat ref;
+        net.setInput(inputs[i], "", 2.0);  // waits for pending requests
+        net.forward().copyTo(ref);
+        normAssert(ref, out, cv::format("request %d", i).c_str());
+        normAssert(refs[i] * 2, out, cv::format("request %d (unscaled reference)", i).c_str(), 1e-5, 1e-4);
+    }
+
+    // synchronous API after asynchronous requests
+    net.setInput(inputs[0]);
+    AsyncArray pending = net.forwardAsync();
+    Mat out = net.forward();
+    normAssert(refs[0], out, "sync");
+    Mat asyncOut;
+    pending.get(asyncOut);
+    normAssert(refs[0], asyncOut, "async");
+
+    // introspection and modification of the net wait for pending requests too
+    const int convId = net.getLayerId("conv");
+    Mat weights = net.getParam(convId, 0).clone();
+    net.setInput(inputs[1]);
+    pending = net.forwardAsync();
+    EXPECT_GT(net.getFLOPS(MatShape(inputs[1].size.p, inputs[1].size.p + inputs[1].dims)), 0);
+    net.setParam(convId, 0, Mat::zeros(weights.dims, weights.size.p, CV_32F));
+    ASSERT_TRUE(pending.get(asyncOut, 10 * 1e9));
+    normAssert(refs[1], asyncOut, "before setParam");
+    // requests after modification are computed as forward()
+    ASSERT_TRUE(net.forwardAsync().get(asyncOut, 10 * 1e9));
+    normAssert(net.forward(), asyncOut, "after setParam");
+    net.setParam(convId, 0, weights);
+
+    // errors are reported through AsyncArray
+    AsyncArray failed = net.forwardAsync("unknown_layer");
+    Mat dummy;
+    EXPECT_ANY_THROW(failed.get(dummy));
+
+#ifdef HAVE_OPENCL
+    // the queue is dropped with the CPU target
+    net.setPreferableTarget(DNN_TARGET_OPENCL);
+    net.setInput(inputs[0]);
+    EXPECT_THROW(net.forwardAsync(), cv::Exception);
+#endif
+}
+
+// copies the input and keeps the maximal number of concurrent forward() calls
+class ConcurrencyProbeLayer CV_FINAL : public Layer
+{
+public:
+    ConcurrencyProbeLayer(const LayerParams &params) : Layer(params) {}
+
+    static Ptr<Layer> create(LayerParams& params)
+    {
+        return Ptr<Layer>(new ConcurrencyProbeLayer(params));
+    }
+
+    void forward(InputArrayOfArrays inputs_arr, OutputArrayOfArrays outputs_arr, OutputArrayOfArrays) CV_OVERRIDE
+    {
+        const int active = ++numActive;
+        int prevMax = maxActive.load();
+        while (active > prevMax && !maxActive.compare_exchange_weak(prevMax, active)) {}
+
+        std::vector<Mat> inputs, outputs;
+        inputs_arr.getMatVector(inputs);
+        outputs_arr.getMatVector(outputs);
+        inputs[0].copyTo(outputs[0]);
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        --numActive;
+    }
+
+    static std::atomic<int> numActive, maxActive;
+};
+std::atomic<int> ConcurrencyProbeLayer::numActive(0);
+std::atomic<int> ConcurrencyProbeLayer::maxActive(0);
+
+TEST(Net, forwardAsync_CPU_concurrent_requests)
+{
+    CV_DNN_REGISTER_LAYER_CLASS(ConcurrencyProbe, ConcurrencyProbeLayer);
+    Net net;
+    {
+        int sz[] = {4, 3, 3, 3};
+        Mat weights(4, &sz[0], CV_32F);
+        randu(weights, -1.0f, 1.0f);
+
+        LayerParams lp;
+        lp.set("kernel_size", 3);
+        lp.set("num_output", 4);
+        lp.set("bias_term", false);
+        lp.type = "Convolution";
+        lp.name = "conv";
+        lp.blobs.push_back(weights);
+        net.addLayerToPrev(lp.name, lp.type, lp);
+
+        LayerParams lpProbe;
+        lpProbe.type = "ConcurrencyProbe";
+        lpProbe.name = "probe";
+        net.addLayerToPrev(lpProbe.name, lpProbe.type, lpProbe);
+    }
+    net.setPreferableBackend(DNN_BACKEND_OPENCV);
+    net.setPreferableTarget(DNN_TARGET_CPU);
+
+    const int numRequests = 4;
+    std::vector<Mat> inputs(numRequests), refs(numRequests);
+    for (int i = 0; i < numRequests; ++i)
+    {
+        int sz[] = {1, 3, 10, 12};
+        inputs[i].create(4, &sz[0], CV_32F);
+        randu(inputs[i], -1.0f, 1.0f);
+        net.setInput(inputs[i]);
+        refs[i] = net.forward().clone();
+    }
+
+    ConcurrencyProbeLayer::maxActive = 0;
+    std::vector<AsyncArray> results(numRequests);
+    for (int i = 0; i < numRequests; ++i)
+    {
+        net.setInput(inputs[i]);
+        results[i] = net.forwardAsync();
+    }
+    for (int i = 0; i < numRequests; ++i)
+    {
+        Mat out;
+        ASSERT_TRUE(results[i].get(out, 10 * 1e9));
+        normAssert(refs[i], out, cv::format("request %d", i).c_str());
+    }
+    LayerFactory::unregisterLayer("ConcurrencyProbe");
+
+    // requests are computed on separate blob sets at the same time
+    EXPECT_GE(ConcurrencyProbeLayer::maxActive.load(), 2);
+}
+
+TEST(Net, forwardAsync_CPU_profiling)
+{
+    CV_DNN_REGISTER_LAYER_CLASS(ConcurrencyProbe, ConcurrencyProbeLayer);
+    Net net;
+    {
+        LayerParams lpProbe;
+        lpProbe.type = "ConcurrencyProbe";
+        lpProbe.name = "probe";
+        net.addLayerToPrev(lpProbe.name, lpProbe.type, lpProbe);
+
+        LayerParams lpReLU;
+        lpReLU.type = "ReLU";
+        lpReLU.name = "relu";
+        net.addLayerToPrev(lpReLU.name, lpReLU.type, lpReLU);
+    }
+    net.setPreferableBackend(DNN_BACKEND_OPENCV);
+    net.setPreferableTarget(DNN_TARGET_CPU);
+    net.enableProfiling();
+
+    int sz[] = {1, 3, 8, 8};
+    Mat input(4, &sz[0], CV_32F);
+    randu(input, -1.0f, 1.0f);
+
+    const int numRequests = 6;
+    ConcurrencyProbeLayer::maxActive = 0;
+    std::vector<AsyncArray> results(numRequests);
+    for (int i = 0; i < numRequests; ++i)
+    {
+        net.setInput(input);
+        results[i] = net.forwardAsync();
+    }
+    for (int i = 0; i < numRequests; ++i)
+    {
+        Mat out;
+        ASSERT_TRUE(results[i].get(out, 10 * 1e9));
+    }
+    LayerFactory::unregisterLayer("ConcurrencyProbe");
+    EXPECT_GE(ConcurrencyProbeLayer::maxActive.load(), 2);
+
+    // every request has its own forward index and a record of every layer
+    std::vector<LayerProfile> records;
+    net.getLayersProfile(records);
+    std::map<int, std::set<String> > forwards;
+    int numOverlapped = 0;
+    for (size_t i = 0; i < records.size(); i++)
+    {
+        EXPECT_TRUE(forwards[records[i].forwardIndex].insert(records[i].name).second) << records[i].name;
+        // the process CPU time of overlapped layers is not attributed to any of them
+        if (records[i].cpuTime < 0)
+        {
+            numOverlapped++;
+            EXPECT_EQ(records[i].cpuTime, -1);
+            EXPECT_EQ(records[i].threadUtilization, -1);
+        }
+    }
+    EXPECT_GE(numOverlapped, 2);
+    ASSERT_EQ((int)forwards.size(), numRequests);
+    for (int i = 0; i < numRequests; ++i)
+    {
+        ASSERT_EQ(forwards.count(i), (size_t)1) << i;
+        EXPECT_EQ(forwards[i].size(), (size_t)2) << i;
+    }
+
+    const std::string path = cv::tempfile(".json");
+    net.dumpProfile(path);
+    {
+        std::ifstream is(path.c_str());
+        std::string trace((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+        EXPECT_NE(trace.find("\"name\": \"forward #5\""), std::string::npos);
+        EXPECT_NE(trace.find("\"tid\": 1"), std::string::npos);  // overlapped requests are on separate rows
+    }
+    remove(path.c_str());
+}
+
+class SetupCounterLayer CV_FINAL : public Layer
+{
+public:
+    SetupCounterLayer(const LayerParams &params) : Layer(params) {}
+
+    static Ptr<Layer> create(LayerParams& params)
+    {
+        return Ptr<Layer>(new SetupCounterLayer(params));
+    }
+
+    bool getMemoryShapes(const std::vector<MatShape> &inputs, const int,
+                         std::vector<MatShape> &outputs, std::vector<MatShape> &) const CV_OVERRIDE
+    {
+        outputs = inputs;
+        return false;
+    }
+
+    void finalize(InputArrayOfArrays, OutputArrayOfArrays) CV_OVERRIDE
+    {
+        ++numSetups;
+    }
+
+    void forward(InputArrayOfArrays inputs_arr, OutputArrayOfArrays outputs_arr, OutputArrayOfArrays) CV_OVERRIDE
+    {
+        std::vector<Mat> inputs, outputs;
+        inputs_arr.getMatVector(inputs);
+        outputs_arr.getMatVector(outputs);
+        inputs[0].copyTo(outputs[0]);
+    }
+
+    static int numSetups;
+};
+int SetupCounterLayer::numSetups = 0;
+
+TEST(Net, shape_cache)
+{
+    Net net;
+    {
+        int sz[] = {4, 3, 3, 3};
+        Mat weights(4, &sz[0], CV_32F);
+        randu(weights, -1.0f, 1.0f);
+
+        LayerParams lp;
+        lp.set("kernel_size", 3);
+        lp.set("pad", 1);
+        lp.set("num_output", 4);
+        lp.set("bias_term", false);
+        lp.type = "Convolution";
+        lp.name = "conv";
+        lp.blobs.push_back(weights);
+        net.addLayerToPrev(lp.name, lp.type, lp);
+
+        LayerParams lpReLU;
+        lpReLU.type = "ReLU";
+        lpReLU.name = "relu";
+        net.addLayerToPrev(lpReLU.name, lpReLU.type, lpReLU);
+    }
+    net.setInputsNames(std::vector<String>(1, "data"));
+    net.setPreferableBackend(DNN_BACKEND_OPENCV);
+    net.setPreferableTarget(DNN_TARGET_CPU);
+    Net ref = net.clone();
+
+    const int sizes[] = {16, 24, 16, 20, 24, 16};
+    std::vector<Mat> inputs;
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+    {
+        int sz[] = {1, 3, sizes[i], sizes[i] + 3};
+        Mat input(4, &sz[0], CV_32F);
+        randu(input, -1.0f, 1.0f);
+        inputs.push_back(input);
+    }
+
+    net.setShapeCacheSize(2);
+    for (size_t i = 0; i < inputs.size(); ++i)
+    {
+        ref.setInput(inputs[i], "data");
+        Mat expected = ref.forward().clone();
+        net.setInput(inputs[i], "data");
+        normAssert(expected, net.forward(), cv::format("cached, input %d", (int)i).c_str());
+    }
+
+    // spatial axes are dynamic: one entry for all sizes
+    net.setInputDynamicAxes("data", std::vector<int>{2, 3});
+    for (size_t i = 0; i < inputs.size(); ++i)
+    {
+        ref.setInput(inputs[i], "data");
+        Mat expected = ref.forward().clone();
+        net.setInput(inputs[i], "data");
+        std::vector<Mat> outs;
+        net.forward(outs, std::vector<String>(1, "relu"));
+        ASSERT_EQ(outs.size(), (size_t)1);
+        normAssert(expected, outs[0], cv::format("dynamic axes, input %d", (int)i).c_str());
+    }
+    EXPECT_THROW(net.setInputDynamicAxes("unknown", std::vector<int>{0}), cv::Exception);
+
+    net.setShapeCacheSize(0);
+    net.setInput(inputs[0], "data");
+    ref.setInput(inputs[0], "data");
+    normAssert(ref.forward(), net.forward(), "without cache");
+}
+
+TEST(Net, shape_cache_hits_and_invalidation)
+{
+    CV_DNN_REGISTER_LAYER_CLASS(SetupCounter, SetupCounterLayer);
+    Net net;
+    LayerParams lp;
+    lp.type = "SetupCounter";
+    lp.name = "counter";
+    net.addLayerToPrev(lp.name, lp.type, lp);
+    net.setInputsNames(std::vector<String>(1, "data"));
+    net.setPreferableBackend(DNN_BACKEND_OPENCV);
+    net.setPreferableTarget(DNN_TARGET_CPU);
+    net.setShapeCacheSize(2);
+
+    Mat small({1, 2, 4, 4}, CV_32F), large({1, 2, 8, 8}, CV_32F);
+    randu(small, -1.0f, 1.0f);
+    randu(large, -1.0f, 1.0f);
+    SetupCounterLayer::numSetups = 0;
+    for (int i = 0; i < 3; ++i)
+    {
+        net.setInput(small, "data");
+        normAssert(small, net.forward(), "small");
+        net.setInput(large, "data");
+        normAssert(large, net.forward(), "large");
+    }
+    // one setup per shape, the cache hits don't set up the network again
+    EXPECT_EQ(SetupCounterLayer::numSetups, 2);
+
+    // getLayer() returns the layer which computed the last forward()
+    Ptr<Layer> layerLarge = net.getLayer("counter");
+    net.setInput(small, "data");
+    net.forward();
+    Ptr<Layer> layerSmall = net.getLayer("counter");
+    EXPECT_NE(layerLarge.get(), layerSmall.get());
+    net.setInput(large, "data");
+    net.forward();
+    EXPECT_EQ(layerLarge.get(), net.getLayer("counter").get());
+    EXPECT_EQ(SetupCounterLayer::numSetups, 2);
+
+    // changes of the graph drop the cached entries
+    LayerParams lpOut;
+    lpOut.type = "Identity";
+    lpOut.name = "out";
+    net.addLayerToPrev(lpOut.name, lpOut.type, lpOut);
+    net.setInput(large, "data");
+    normAssert(large, net.forward("out"), "new layer");
+    EXPECT_EQ(SetupCounterLayer::numSetups, 3);
+    net.setInputShape("data", MatShape({1, 2, 8, 8}));
+    net.setInput(large, "data");
+    net.forward("out");
+    EXPECT_EQ(SetupCounterLayer::numSetups, 4);
+
+    LayerFactory::unregisterLayer("SetupCounter");
+}
+
+// 16-bit weights of DNN_TARGET_CPU_FP16 are opt-in on x86, enabled by OPENCV_DNN_CPU_FP16_WEIGHTS
+static void testCPUReducedPrecisionWeights(const std::string& format, double l1, double lInf)
+{
+#if defined(__arm64__) && __arm64__
+    throw SkipTestException("ARM v8 uses FP16 arithmetic for DNN_TARGET_CPU_FP16");
+#endif
+    if (!checkHardwareSupport(CPU_FP16))
+        throw SkipTestException("CPU doesn't support FP16 conversions");
+
+    struct ScopedWeightsFormat
+    {
+        explicit ScopedWeightsFormat(const std::string& value)
+        {
+            const char* old = getenv("OPENCV_DNN_CPU_FP16_WEIGHTS");
+            hasOld = old != NULL;
+            oldValue = old ? old : "";
+            set(value.c_str());
+        }
+        ~ScopedWeightsFormat()
+        {
+            if (hasOld)
+                set(oldValue.c_str());
+            else
+            {
+#ifdef _WIN32
+                _putenv_s("OPENCV_DNN_CPU_FP16_WEIGHTS", "");
+#else
+                unsetenv("OPENCV_DNN_CPU_FP16_WEIGHTS");
+#endif
+            }
+        }
+        static void set(const char* value)
+        {
+#ifdef _WIN32
+            _putenv_s("OPENCV_DNN_CPU_FP16_WEIGHTS", value);
+#else
+            setenv("OPENCV_DNN_CPU_FP16_WEIGHTS", value, 1);
+#endif
+        }
+        bool hasOld;
+        std::string oldValue;
+    } weightsFormat(format);
+
+    Mat weights({16, 8, 3, 3}, CV_32F);
+    randu(weights, -1.0f, 1.0f);
+    Mat B(16 * 8 * 8, 40, CV_32F);
+    randu(B, -0.1f, 0.1f);
+    Mat input({2, 8, 16, 16}, CV_32F);
+    randu(input, -1.0f, 1.0f);
+
+    // weights are packed once per layer instance, so each target gets its own network
+    auto run = [&](int target)
+    {
+        Net net;
+        LayerParams lp;
+        lp.set("kernel_size", 3);
+        lp.set("stride", 2);  // not Winograd
+        lp.set("pad", 1);
+        lp.set("num_output", 16);
+        lp.set("bias_term", false);
+        lp.type = "Convolution";
+        lp.name = "conv";
+        lp.blobs.push_back(weights);
+        net.addLayerToPrev(lp.name, lp.type, lp);
+
+        LayerParams lpFlatten;
+        lpFlatten.type = "Flatten";
+        lpFlatten.name = "flatten";
+        net.addLayerToPrev(lpFlatten.name, lpFlatten.type, lpFlatten);
+
+        LayerParams lpGemm;
+        lpGemm.set("constB", true);
+        lpGemm.type = "Gemm";
+        lpGemm.name = "gemm";
+        lpGemm.blobs.push_back(B);
+        net.addLayerToPrev(lpGemm.name, lpGemm.type, lpGemm);
+
+        net.setPreferableBackend(DNN_BACKEND_OPENCV);
+        net.setPreferableTarget(target);
+        net.setInput(input);
+        std::vector<Mat> outs;
+        net.forward(outs, std::vector<String>{"conv", "gemm"});
+        for (size_t i = 0; i < outs.size(); i++)
+            outs[i] = outs[i].clone();
+        return outs;
+    };
+
+    std::vector<Mat> ref = run(DNN_TARGET_CPU);
+    std::vector<Mat> outs = run(DNN_TARGET_CPU_FP16);
+    ASSERT_EQ(outs.size(), (size_t)2);
+    // 16-bit weights are used indeed
+    EXPECT_GT(cvtest::norm(ref[0], outs[0], NORM_INF), 0);
+    EXPECT_GT(cvtest::norm(ref[1], outs[1], NORM_INF), 0);
+    normAssert(ref[0], outs[0], "conv", l1, lInf);
+    normAssert(ref[1], outs[1], "gemm", l1, lInf);
+}
+
+TEST(Net, cpu_fp16_weights)
+{
+    testCPUReducedPrecisionWeights("FP16", 2e-3, 1e-2);
+}
+
+TEST(Net, cpu_bf16_weights)
+{
+    testCPUReducedPrecisionWeights("BF16", 2e-2, 6e-2);
+}
+
+TEST(Net, cache_file)
+{
+    Net net;
+    {
+        int sz[] = {6, 3, 3, 3};
+        Mat weights(4, &sz[0], CV_32F);
+        randu(weights, -1.0f, 1.0f);
+
+        LayerParams lp;
+        lp.set("kernel_size", 3);
+        lp.set("pad", 1);
+        lp.set("num_output", 6);
+        lp.set("bias_term", false);
+        lp.type = "Convolution";
+        lp.name = "conv";
+        lp.blobs.push_back(weights);
+        net.addLayerToPrev(lp.name, lp.type, lp);
+
+        LayerParams lpReLU;
+        lpReLU.set("negative_slope", 0.1);
+        lpReLU.type = "ReLU";
+        lpReLU.name = "relu";
+        net.addLayerToPrev(lpReLU.name, lpReLU.type, lpReLU);
+
+        LayerParams lpPool;
+        lpPool.set("pool", "max");
+        lpPool.set("global_pooling", true);
+        lpPool.type = "Pooling";
+        lpPool.name = "pool";
+        net.addLayerToPrev(lpPool.name, lpPool.type, lpPool);
+    }
+    net.setInputsNames(std::vector<String>(1, "data"));
+    net.setPreferableBackend(DNN_BACKEND_OPENCV);
+    net.setPreferableTarget(DNN_TARGET_CPU);
+
+    int sz[] = {2, 3, 12, 16};
+    Mat input(4, &sz[0], CV_32F);
+    randu(input, -1.0f, 1.0f);
+    net.setInput(input, "data");
+    Mat ref = net.forward().clone();
+
+    const std::string path = cv::tempfile(".dnncache");
+    net.writeCache(path);
+    {
+        Net cached = readNetFromCache(path);
+        ASSERT_FALSE(cached.empty());
+        EXPECT_EQ(net.getLayerNames(), cached.getLayerNames());
+        normAssert(net.getParam("conv", 0), cached.getParam("conv", 0), "weights");
+        cached.setPreferableBackend(DNN_BACKEND_OPENCV);
+        cached.setPreferableTarget(DNN_TARGET_CPU);
+        cached.setInput(input, "data");
+        normAssert(ref, cached.forward(), "output");
+
+        // weights stay valid after the network is released
+        Mat w = cached.getParam("conv", 0);
+        cached = Net();
+        normAssert(net.getParam("conv", 0), w, "weights after release");
+    }
+
+    // weights modified by setParam()
+    {
+        Mat weights = net.getParam("conv", 0) * 0.5;
+        net.setParam(net.getLayerId("conv"), 0, weights);
+        net.writeCache(path);
+        Net cached = readNetFromCache(path);
+        normAssert(weights, cached.getParam("conv", 0), "modified weights");
+    }
+
+    // truncated file
+    {
+        std::vector<char> contents;
+        {
+            std::ifstream is(path.c_str(), std::ios::binary);
+            contents.assign(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>());
+        }
+        ASSERT_GT(contents.size(), (size_t)100);
+        std::ofstream os(path.c_str(), std::ios::binary);
+        os.write(contents.data(), 100);
+    }
+    EXPECT_THROW(readNetFromCache(path), cv::Exception);
+    remove(path.c_str());
+}
+
+TEST(Net, cache_file_prepacked_weights)
+{
+    int wsz[] = {16, 16, 3, 3};
+    Mat weights(4, &wsz[0], CV_32F);
+    randu(weights, -1.0f, 1.0f);
+    auto createNet = [&]() -> Net
+    {
+        Net net;
+        LayerParams lp;
+        lp.set("kernel_size", 3);
+        lp.set("pad", 1);
+        lp.set("num_output", 16);
+        lp.set("bias_term", false);
+        lp.type = "Convolution";
+        lp.name = "conv";
+        lp.blobs.push_back(weights);
+        net.addLayerToPrev(lp.name, lp.type, lp);
+        net.setInputsNames(std::vector<String>(1, "data"));
+        net.setPreferableBackend(DNN_BACKEND_OPENCV);
+        net.setPreferableTarget(DNN_TARGET_CPU);
+        return net;
+    };
+    auto fileSize = [](const std::string& path) -> std::streamoff
+    {
+        std::ifstream is(path.c_str(), std::ios::binary | std::ios::ate);
+        return is.tellg();
+    };
+
+    int sz[] = {1, 16, 24, 32};
+    Mat input(4, &sz[0], CV_32F);
+    randu(input, -1.0f, 1.0f);
+
+    // weights are packed on the first forward, so they are stored only after it
+    const std::string pathGraph = cv::tempfile(".dnncache");
+    createNet().writeCache(pathGraph);
+
+    Net net = createNet();
+    net.setInput(input, "data");
+    Mat ref = net.forward().clone();
+    const std::string path = cv::tempfile(".dnncache");
+    net.writeCache(path);
+    EXPECT_GT(fileSize(path), fileSize(pathGraph) + (std::streamoff)weights.total() * (std::streamoff)sizeof(float));
+
+    net = Net();
+    {
+        Net cached = readNetFromCache(path);
+        cached.setPreferableBackend(DNN_BACKEND_OPENCV);
+        cached.setPreferableTarget(DNN_TARGET_CPU);
+        cached.setInput(input, "data");
+        normAssert(ref, cached.forward(), "output");
+    }
+    remove(path.c_str());
+    remove(pathGraph.c_str());
+}
+
+// prepacked weights of a cache file are used by the network which has loaded it only
+TEST(Net, cache_file_prepacked_weights_are_private)
+{
+    int wsz[] = {16, 16, 3, 3};
+    Mat weights(4, &wsz[0], CV_32F);
+    randu(weights, -1.0f, 1.0f);
+    auto createNet = [&]() -> Net
+    {
+        Net net;
+        LayerParams lp;
+        lp.set("kernel_size", 3);
+        lp.set("pad", 1);
+        lp.set("num_output", 16);
+        lp.set("bias_term", false);
+        lp.type = "Convolution";
+        lp.name = "conv";
+        lp.blobs.push_back(weights);
+        net.addLayerToPrev(lp.name, lp.type, lp);
+        net.setInputsNames(std::vector<String>(1, "data"));
+        net.setPreferableBackend(DNN_BACKEND_OPENCV);
+        net.setPreferableTarget(DNN_TARGET_CPU);
+        return net;
+    };
+
+    int sz[] = {1, 16, 24, 32};
+    Mat input(4, &sz[0], CV_32F);
+    randu(input, -1.0f, 1.0f);
+
+    Net net = createNet();
+    net.setInput(input, "data");
+    Mat ref = net.forward().clone();
+    const std::string path = cv::tempfile(".dnncache");
+    net.writeCache(path);
+    net = Net();  // the packed weights are released
+
+    // the packed bias is the last buffer of the file: 16 zeros and padding
+    {
+        std::fstream fs(path.c_str(), std::ios::in | std::ios::out | std::ios::binary);
+        const int nbias = 16 + 32;
+        std::vector<float> bias(nbias);
+        fs.seekg(-(std::streamoff)(nbias * sizeof(float)), std::ios::end);
+        fs.read((char*)bias.data(), nbias * sizeof(float));
+        ASSERT_TRUE(fs.good());
+        ASSERT_EQ(0, countNonZero(Mat(bias)));
+        std::fill(bias.begin(), bias.end(), 1.0f);
+        fs.seekp(-(std::streamoff)(nbias * sizeof(float)), std::ios::end);
+        fs.write((const char*)bias.data(), nbias * sizeof(float));
+        ASSERT_TRUE(fs.good());
+    }
+
+    Net cached = readNetFromCache(path);
+    cached.setPreferableBackend(DNN_BACKEND_OPENCV);
+    cached.setPreferableTarget(DNN_TARGET_CPU);
+
+    // the weights of the file are not registered for other networks with the same layer weights
+    Net other = createNet();
+    other.setInput(input, "data");
+    normAssert(ref, other.forward(), "other network");
+
+    cached.setInput(input, "data");
+    Mat expected = ref + 1.0f;
+    normAssert(expected, cached.forward(), "network of the file");
+    remove(path.c_str());
+}
+
+TEST(Net, profiling)
+{
+    Net net;
+    {
+        int sz[] = {8, 3, 3, 3};
+        Mat weights(4, &sz[0], CV_32F);
+        randu(weights, -1.0f, 1.0f);
+
+        LayerParams lp;
+        lp.set("kernel_size", 3);
+        lp.set("num_output", 8);
+        lp.set("bias_term", false);
+        lp.type = "Convolution";
+        lp.name = "conv";
+        lp.blobs.push_back(weights);
+        net.addLayerToPrev(lp.name, lp.type, lp);
+
+        LayerParams lpFlatten;
+        lpFlatten.type = "Flatten";
+        lpFlatten.name = "flatten";
+        net.addLayerToPrev(lpFlatten.name, lpFlatten.type, lpFlatten);
+
+        Mat B(8 * 14 * 14, 10, CV_32F);
+        randu(B, -0.1f, 0.1f);
+        LayerParams lpGemm;
+        lpGemm.set("constB", true);
+        lpGemm.type = "Gemm";
+        lpGemm.name = "gemm";
+        lpGemm.blobs.push_back(B);
+        net.addLayerToPrev(lpGemm.name, lpGemm.type, lpGemm);
+    }
+    net.setPreferableBackend(DNN_BACKEND_OPENCV);
+    net.setPreferableTarget(DNN_TARGET_CPU);
+
+    int sz[] = {1, 3, 16, 16};
+    Mat input(4, &sz[0], CV_32F);
+    randu(input, -1.0f, 1.0f);
+
+    net.enableProfiling();
+    for (int i = 0; i < 2; i++)
+    {
+        net.setInput(input);
+        net.forward();
+    }
+
+    std::vector<LayerProfile> records;
+    net.getLayersProfile(records);
+    ASSERT_FALSE(records.empty());
+    EXPECT_EQ(records.front().forwardIndex, 0);
+    EXPECT_EQ(records.back().forwardIndex, 1);
+    int numConv = 0;
+    for (size_t i = 0; i < records.size(); i++)
+    {
+        const LayerProfile& r = records[i];
+        EXPECT_EQ(r.name, net.getLayerNames()[r.layerId - 1]);
+        EXPECT_GE(r.wallTime, 0.0);
+        EXPECT_GE(r.cpuTime, 0.0);  // no concurrent forward() calls
+        EXPECT_GT(r.bytes, 0);
+        if (i > 0)
+        {
+            EXPECT_GE(r.startTime, records[i - 1].startTime);
+        }
+        if (r.name == "conv")
+        {
+            numConv++;
+            EXPECT_EQ(r.flops, net.getFLOPS(r.layerId, MatShape(sz, sz + 4)));
+            EXPECT_EQ(r.bytes, (int64)(3 * 16 * 16 + 8 * 14 * 14 + 8 * 3 * 3 * 3) * 4);
+            EXPECT_FALSE(r.kernel.empty());
+        }
+        if (r.name == "gemm")
+        {
+            EXPECT_EQ(r.kernel.find("fast_gemm_packed"), (size_t)0) << r.kernel;
+        }
+    }
+    EXPECT_EQ(numConv, 2);
+
+    const std::string path = cv::tempfile(".json");
+    net.dumpProfile(path);
+    {
+        std::ifstream is(path.c_str());
+        std::string trace((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+        EXPECT_EQ(trace.find("{\"traceEvents\": ["), (size_t)0);
+        EXPECT_NE(trace.find("\"name\": \"forward #1\""), std::string::npos);
+        EXPECT_NE(trace.find("\"name\": \"conv\""), std::string::npos);
+    }
+    remove(path.c_str());
+
+    net.enableProfiling(false);
+    net.setInput(input);
+    net.forward();
+    net.getLayersProfile(records);
+    EXPECT_TRUE(records.empty());
+    EXPECT_ANY_THROW(net.dumpProfile(path));
+}
+
 #ifdef HAVE_INF_ENGINE
 static const std::chrono::milliseconds async_timeout(10000);
 
@@ -81,6 +81,15 @@ enum ImreadModes {
        IMREAD_IGNORE_ORIENTATION   = 128 //!< If set, do not rotate the image according to EXIF's orientation flag.
      };
 
+//! Imread parameters, see the cv::imread and cv::imdecode overloads with `params`
+enum ImreadParams {
+       IMREAD_PARAM_SCALE_DENOM    = 1,  //!< Image size reduction factor: 1 (default), 2, 4 or 8. Overrides the reduction of IMREAD_REDUCED_* flags. JPEG skips the unneeded DCT coefficients, other formats are resized after decoding.
+       IMREAD_PARAM_ROI_X          = 2,  //!< Left edge of the region to decode, in coordinates of the reduced image. Default is 0.
+       IMREAD_PARAM_ROI_Y          = 3,  //!< Top edge of the region to decode, in coordinates of the reduced image. Default is 0.
+       IMREAD_PARAM_ROI_WIDTH      = 4,  //!< Width of the region to decode. Default is 0 - decode the whole image, the region position must be 0 then.
+       IMREAD_PARAM_ROI_HEIGHT     = 5   //!< Height of the region to decode. Default is 0 - decode the whole image, the region position must be 0 then.
+     };
+
 //! Imwrite flags
 enum ImwriteFlags {
        IMWRITE_JPEG_QUALITY        = 1,  //!< For JPEG, it can be a quality from 0 to 100 (the higher is the better). Default value is 95.
@@ -226,9 +235,25 @@ Currently, the following file formats are supported:
 */
 CV_EXPORTS_W Mat imread( const String& filename, int flags = IMREAD_COLOR );
 
+/** @overload
+@param filename Name of file to be loaded.
+@param flags Flag that can take values of cv::ImreadModes
+@param params Format-specific parameters encoded as pairs (paramId_1, paramValue_1, paramId_2, paramValue_2, ... .)
+see cv::ImreadParams
+
+The region of interest (if any) is clipped to the image; if nothing is left, an empty matrix is returned.
+JPEG (with libjpeg-turbo), PNG (non-interlaced), WebP and TIFF decode only the requested rows,
+MCUs, tiles or strips, other formats crop the fully decoded image. EXIF orientation is not applied
+when a region of interest is requested.
+*/
+CV_EXPORTS_W Mat imread( const String& filename, int flags, const std::vector<int>& params );
+
 /** @brief Loads a multi-page image from a file.
 
 The function imreadmulti loads a multi-page image from the specified file into a vector of Mat objects.
+
+@note Formats with random access to their pages (TIFF) are decoded by up to cv::getNumThreads() threads,
+each with its own decoder working on a contiguous range of pages.
 @param filename Name of file to be loaded.
 @param mats A vector of Mat objects holding each page.
 @param flags Flag that can take values of cv::ImreadModes, default with cv::IMREAD_ANYCOLOR.
@@ -317,6 +342,13 @@ See cv::imread for the list of supported formats and flags description.
 */
 CV_EXPORTS_W Mat imdecode( InputArray buf, int flags );
 
+/** @overload
+@param buf Input array or vector of bytes.
+@param flags The same flags as in cv::imread, see cv::ImreadModes.
+@param params The same parameters as in cv::imread, see cv::ImreadParams.
+*/
+CV_EXPORTS_W Mat imdecode( InputArray buf, int flags, const std::vector<int>& params );
+
 /** @overload
 @param buf Input array or vector of bytes.
 @param flags The same flags as in cv::imread, see cv::ImreadModes.
@@ -326,6 +358,26 @@ failure the function returns empty cv::Mat object, but does not release user-pro
 */
 CV_EXPORTS Mat imdecode( InputArray buf, int flags, Mat* dst);
 
+/** @brief Reads an image from a buffer in memory into the caller-provided storage.
+
+Unlike cv::imdecode, the function never reallocates a non-empty @p dst: the image is decoded straight
+into its data (it may be a ROI, a mapped cv::UMat or a matrix created with a custom cv::MatAllocator).
+If size or type of the decoded image (after applying @p flags) does not match @p dst, the function
+returns false and leaves @p dst untouched. An empty @p dst is allocated as by cv::imdecode, using its
+own allocator if one is set. EXIF orientation is not applied when decoding into non-empty @p dst, as it
+might change the image size.
+
+The decoder instance of each image format is kept per calling thread and reused by the following calls,
+so repeated decoding of same-format images into preallocated @p dst doesn't create a new decoder per call.
+The underlying codec libraries may still allocate their own per-image state.
+
+@param buf Input array or vector of bytes.
+@param flags The same flags as in cv::imread, see cv::ImreadModes.
+@param dst Destination image.
+@return true if the image has been decoded into @p dst.
+*/
+CV_EXPORTS_W bool imdecodeTo( InputArray buf, int flags, InputOutputArray dst );
+
 /** @brief Reads a multi-page image from a buffer in memory.
 
 The function imdecodemulti reads a multi-page image from the specified buffer in the memory. If the buffer is too short or
@@ -341,6 +393,51 @@ See cv::imreadmulti for the list of supported formats and flags description.
 */
 CV_EXPORTS_W bool imdecodemulti(InputArray buf, int flags, CV_OUT std::vector<Mat>& mats, const cv::Range& range = Range::all());
 
+/** @brief Decodes batches of images from memory buffers in parallel.
+
+The buffers of a batch are decoded by up to cv::getNumThreads() threads. Unlike repeated cv::imdecode calls,
+the object keeps its decoder instances alive between the images and the batches, so per-image setup like
+the creation of the libjpeg decompress object is done once per thread and format instead of once per image.
+Malformed or unsupported buffers don't make decode() throw, they are reported per item instead.
+
+@note An instance must not be used from several threads at the same time, use one instance per calling thread.
+*/
+class CV_EXPORTS_W ImageBatchDecoder
+{
+public:
+    /** @param flags The same flags as in cv::imread, see cv::ImreadModes.
+    */
+    CV_WRAP explicit ImageBatchDecoder(int flags = IMREAD_COLOR);
+
+    /** @brief Decodes a batch of images.
+
+    @param bufs Input buffers, e.g. a vector of vectors of bytes.
+    @param mats Decoded images in the order of bufs, an empty Mat for each item that can't be decoded.
+    @param errors Error message for each item, an empty string for the decoded ones.
+    @return The number of successfully decoded images.
+    */
+    CV_WRAP int decode(InputArrayOfArrays bufs, CV_OUT std::vector<Mat>& mats, CV_OUT std::vector<String>& errors);
+
+    /** @overload */
+    int decode(InputArrayOfArrays bufs, CV_OUT std::vector<Mat>& mats);
+
+    class Impl;
+protected:
+    Ptr<Impl> pImpl;
+};
+
+/** @brief Decodes a batch of images from memory buffers in parallel.
+
+Shortcut for ImageBatchDecoder(flags).decode(bufs, mats), see cv::ImageBatchDecoder. Keep an ImageBatchDecoder
+object to reuse the decoders between the calls.
+
+@param bufs Input buffers, e.g. a vector of vectors of bytes.
+@param flags The same flags as in cv::imread, see cv::ImreadModes.
+@param mats Decoded images in the order of bufs, an empty Mat for each item that can't be decoded.
+@return The number of successfully decoded images.
+*/
+CV_EXPORTS_W int imdecodeBatch(InputArrayOfArrays bufs, int flags, CV_OUT std::vector<Mat>& mats);
+
 /** @brief Encodes an image into a memory buffer.
 
 The function imencode compresses the image and stores it in the memory buffer that is resized to fit the
@@ -355,6 +452,75 @@ CV_EXPORTS_W bool imencode( const String& ext, InputArray img,
                             CV_OUT std::vector<uchar>& buf,
                             const std::vector<int>& params = std::vector<int>());
 
+/** @brief Encodes an image passed by strips of rows, emitting the encoded data as it is produced.
+
+Unlike cv::imencode, the encoded image is never stored as a whole: every chunk of output is passed to a
+callback as soon as the encoder produces it, so e.g. encoding can be pipelined with network writes, and the
+peak memory usage is proportional to a strip rather than to the whole image.
+
+PNG and JPEG are encoded incrementally. Other formats are encoded by cv::imencode when the last strip is
+written, so for them the whole image is kept until then.
+
+@code
+    ImageStreamEncoder encoder;
+    encoder.open(".png", Size(width, height), CV_8UC3,
+                 [&](const uchar* data, size_t size) { return socket.send(data, size); });
+    for (int y = 0; y < height; y += 64)
+        encoder.write(produceRows(y, std::min(64, height - y)));
+    encoder.finish();
+@endcode
+*/
+class CV_EXPORTS ImageStreamEncoder
+{
+public:
+    /** @brief Receives a chunk of the encoded data, returns false to abort encoding.
+
+    The data is valid only during the call. An exception thrown by the sink aborts encoding as well.
+    */
+    typedef std::function<bool(const uchar* data, size_t size)> Sink;
+
+    ImageStreamEncoder();
+    /** @brief Aborts encoding, if it was not finished.
+    */
+    ~ImageStreamEncoder();
+
+    /** @brief Starts encoding of an image.
+
+    @param ext File extension that defines the output format. Must include a leading period.
+    @param size Size of the whole image.
+    @param type Type of the image, the same as for cv::imencode.
+    @param sink Callback receiving the encoded data.
+    @param params Format-specific parameters. See cv::imwrite and cv::ImwriteFlags.
+    @return true when encoding has started. Like cv::imencode, throws if there is no encoder for ext.
+    */
+    bool open(const String& ext, Size size, int type, const Sink& sink,
+              const std::vector<int>& params = std::vector<int>());
+
+    /** @brief Returns true after a successful open() until finish().
+    */
+    bool isOpened() const;
+
+    /** @brief Encodes the next strip of rows of the image.
+
+    @param strip Rows of the image, starting right after the rows written before. It must have the width and
+    type of the image passed to open().
+    @return false if encoding fails or the sink aborts it. Then the encoder is closed.
+    */
+    bool write(InputArray strip);
+
+    /** @brief Completes encoding and flushes the remaining data to the sink.
+
+    All rows of the image must have been written, otherwise encoding fails. The encoder is closed afterwards
+    and can be opened for the next image.
+    @return true if the image has been encoded and passed to the sink completely.
+    */
+    bool finish();
+
+    class Impl;
+protected:
+    Ptr<Impl> pImpl;
+};
+
 /** @brief Returns true if the specified image can be decoded by OpenCV
 
 @param filename File name of the image
@@ -378,6 +544,8 @@ However, the intermediate pages are not decoded during the process, so typically
 This is required because multipage codecs does not support going backwards.
 After decoding the one page, it is stored inside the collection cache. Hence, trying to get Mat object from already decoded page is O(1).
 If you need memory, you can use .releaseCache() method to release cached index.
+For formats with random access to their pages (TIFF), a missing page is decoded together with up to
+cv::getNumThreads() - 1 following pages in parallel, so sequential iteration yields the pages batch by batch.
 The space complexity is O(n) if all pages are decoded into memory. The user is able to decode and release images on demand.
 */
 class CV_EXPORTS ImageCollection {
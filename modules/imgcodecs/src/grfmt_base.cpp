@@ -64,6 +64,8 @@ bool BaseImageDecoder::setSource( const String& filename )
 {
     m_filename = filename;
     m_buf.release();
+    m_roi = Rect();
+    m_exif = ExifReader(); // the decoder may be reused for another image
     return true;
 }
 
@@ -73,6 +75,8 @@ bool BaseImageDecoder::setSource( const Mat& buf )
         return false;
     m_filename = String();
     m_buf = buf;
+    m_roi = Rect();
+    m_exif = ExifReader(); // the decoder may be reused for another image
     return true;
 }
 
@@ -94,6 +98,11 @@ int BaseImageDecoder::setScale( const int& scale_denom )
     return temp;
 }
 
+bool BaseImageDecoder::setROI( const Rect& )
+{
+    return false;
+}
+
 ImageDecoder BaseImageDecoder::newDecoder() const
 {
     return ImageDecoder();
@@ -137,6 +146,21 @@ bool BaseImageEncoder::writemulti(const std::vector<Mat>&, const std::vector<int
     return false;
 }
 
+bool BaseImageEncoder::writeBegin( Size, int, const std::vector<int>&, const ImageStreamEncoder::Sink& )
+{
+    return false;
+}
+
+bool BaseImageEncoder::writeRows( const Mat& )
+{
+    return false;
+}
+
+bool BaseImageEncoder::writeEnd()
+{
+    return false;
+}
+
 ImageEncoder BaseImageEncoder::newEncoder() const
 {
     return ImageEncoder();
@@ -71,11 +71,19 @@ public:
     virtual bool setSource( const Mat& buf );
     virtual int setScale( const int& scale_denom );
     virtual bool readHeader() = 0;
+
+    /// Called after readHeader to decode only a part of the image into readData's img of roi.size().
+    /// Returns false if the decoder can't do that, then readData expects the whole image.
+    virtual bool setROI( const Rect& roi );
     virtual bool readData( Mat& img ) = 0;
 
     /// Called after readData to advance to the next page, if any.
     virtual bool nextPage() { return false; }
 
+    /// Called after readHeader to jump to the page with the given (0-based) index.
+    /// Returns false if the decoder has no random access to its pages, or there is no such page.
+    virtual bool gotoPage( int index ) { CV_UNUSED(index); return false; }
+
     virtual size_t signatureLength() const;
     virtual bool checkSignature( const String& signature ) const;
     virtual ImageDecoder newDecoder() const;
@@ -85,6 +93,7 @@ protected:
     int  m_height; // height of the image ( filled by readHeader )
     int  m_type;
     int  m_scale_denom;
+    Rect m_roi;    // region to decode, empty for the whole image ( see setROI )
     String m_filename;
     String m_signature;
     Mat m_buf;
@@ -106,6 +115,13 @@ public:
     virtual bool write( const Mat& img, const std::vector<int>& params ) = 0;
     virtual bool writemulti(const std::vector<Mat>& img_vec, const std::vector<int>& params);
 
+    /// Incremental encoding, see ImageStreamEncoder: writeBegin is called with the size and type of the whole
+    /// image, then writeRows with consecutive strips of rows and writeEnd after the last one. The encoded data
+    /// goes to sink as it is produced. writeBegin returns false if the encoder doesn't support that.
+    virtual bool writeBegin( Size size, int type, const std::vector<int>& params, const ImageStreamEncoder::Sink& sink );
+    virtual bool writeRows( const Mat& rows );
+    virtual bool writeEnd();
+
     virtual String getDescription() const;
     virtual ImageEncoder newEncoder() const;
 
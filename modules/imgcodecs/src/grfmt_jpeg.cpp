@@ -77,6 +77,10 @@ extern "C" {
 #include "jpeglib.h"
 }
 
+#if defined(LIBJPEG_TURBO_VERSION_NUMBER) && LIBJPEG_TURBO_VERSION_NUMBER >= 1005000
+  #define CV_JPEG_HAVE_CROP_SCANLINE 1  // jpeg_crop_scanline() and jpeg_skip_scanlines()
+#endif
+
 #ifndef CV_MANUAL_JPEG_STD_HUFF_TABLES
   #if defined(LIBJPEG_TURBO_VERSION_NUMBER) && LIBJPEG_TURBO_VERSION_NUMBER >= 1003090
     #define CV_MANUAL_JPEG_STD_HUFF_TABLES 0  // libjpeg-turbo handles standard huffman tables itself (jstdhuff.c)
@@ -220,16 +224,32 @@ ImageDecoder JpegDecoder::newDecoder() const
 bool  JpegDecoder::readHeader()
 {
     volatile bool result = false;
-    close();
 
-    JpegState* state = new JpegState;
+    // A decoder reused for another memory buffer keeps its decompress object,
+    // jpeg_abort_decompress() resets it but retains the permanent memory pool.
+    const bool reuse = m_state && !m_f && !m_buf.empty();
+    if( !reuse )
+        close();
+    else
+    {
+        m_width = m_height = 0;
+        m_type = -1;
+    }
+
+    JpegState* state = reuse ? (JpegState*)m_state : new JpegState;
     m_state = state;
-    state->cinfo.err = jpeg_std_error(&state->jerr.pub);
-    state->jerr.pub.error_exit = error_exit;
+    if( !reuse )
+    {
+        state->cinfo.err = jpeg_std_error(&state->jerr.pub);
+        state->jerr.pub.error_exit = error_exit;
+    }
 
     if( setjmp( state->jerr.setjmp_buffer ) == 0 )
     {
-        jpeg_create_decompress( &state->cinfo );
+        if( reuse )
+            jpeg_abort_decompress( &state->cinfo );
+        else
+            jpeg_create_decompress( &state->cinfo );
 
         if( !m_buf.empty() )
         {
@@ -263,6 +283,19 @@ bool  JpegDecoder::readHeader()
     return result;
 }
 
+bool  JpegDecoder::setROI( const Rect& roi )
+{
+#ifdef CV_JPEG_HAVE_CROP_SCANLINE
+    // rows above the region are skipped without color conversion and upsampling,
+    // columns are cropped to the iMCU boundary, so only the needed blocks are dequantized
+    m_roi = roi;
+    return true;
+#else
+    CV_UNUSED(roi);
+    return false;
+#endif
+}
+
 #ifdef CV_MANUAL_JPEG_STD_HUFF_TABLES
 /***************************************************************************
  * following code is for supporting MJPEG image files
@@ -496,37 +529,66 @@ bool  JpegDecoder::readData( Mat& img )
 
             jpeg_start_decompress( cinfo );
 
-#ifndef JCS_EXTENSIONS
+            // decoded rows start at xofs pixels to the left of the region
+            const Rect roi = m_roi.empty() ? Rect(0, 0, m_width, m_height) : m_roi;
+            int xofs = 0;
+#ifdef CV_JPEG_HAVE_CROP_SCANLINE
+            if( !m_roi.empty() )
+            {
+                JDIMENSION crop_x = roi.x, crop_width = roi.width;
+                jpeg_crop_scanline( cinfo, &crop_x, &crop_width );
+                xofs = roi.x - (int)crop_x;
+                if( roi.y > 0 )
+                    jpeg_skip_scanlines( cinfo, roi.y );
+            }
+#endif
+            const int ncomp = cinfo->out_color_components;
+
+#ifdef JCS_EXTENSIONS
+            const bool cropped = (int)cinfo->output_width != roi.width;
+            JSAMPARRAY buffer = cropped ? (*cinfo->mem->alloc_sarray)((j_common_ptr)cinfo,
+                                              JPOOL_IMAGE, cinfo->output_width*ncomp, 1 ) : 0;
+#else
             buffer = (*cinfo->mem->alloc_sarray)((j_common_ptr)cinfo,
                                               JPOOL_IMAGE, m_width*4, 1 );
 #endif
 
             uchar* data = img.ptr();
-            for( ; m_height--; data += step )
+            for( int y = 0; y < roi.height; y++, data += step )
             {
 #ifdef JCS_EXTENSIONS
-                jpeg_read_scanlines( cinfo, &data, 1 );
+                if( !cropped )
+                {
+                    jpeg_read_scanlines( cinfo, &data, 1 );
+                    continue;
+                }
+                jpeg_read_scanlines( cinfo, buffer, 1 );
+                memcpy( data, buffer[0] + xofs*ncomp, roi.width*ncomp );
 #else
                 jpeg_read_scanlines( cinfo, buffer, 1 );
+                const uchar* src = buffer[0] + xofs*ncomp;
                 if( color )
                 {
-                    if( cinfo->out_color_components == 3 )
-                        icvCvt_RGB2BGR_8u_C3R( buffer[0], 0, data, 0, Size(m_width,1) );
+                    if( ncomp == 3 )
+                        icvCvt_RGB2BGR_8u_C3R( src, 0, data, 0, Size(roi.width,1) );
                     else
-                        icvCvt_CMYK2BGR_8u_C4C3R( buffer[0], 0, data, 0, Size(m_width,1) );
+                        icvCvt_CMYK2BGR_8u_C4C3R( src, 0, data, 0, Size(roi.width,1) );
                 }
                 else
                 {
-                    if( cinfo->out_color_components == 1 )
-                        memcpy( data, buffer[0], m_width );
+                    if( ncomp == 1 )
+                        memcpy( data, src, roi.width );
                     else
-                        icvCvt_CMYK2Gray_8u_C4C1R( buffer[0], 0, data, 0, Size(m_width,1) );
+                        icvCvt_CMYK2Gray_8u_C4C1R( src, 0, data, 0, Size(roi.width,1) );
                 }
 #endif
             }
 
             result = true;
-            jpeg_finish_decompress( cinfo );
+            if( cinfo->output_scanline < cinfo->output_height )
+                jpeg_abort_decompress( cinfo ); // rows below the region are not needed
+            else
+                jpeg_finish_decompress( cinfo );
         }
     }
 
@@ -581,16 +643,244 @@ static void jpeg_buffer_dest(j_compress_ptr cinfo, JpegDestination* destination)
     destination->pub.term_destination = term_destination;
 }
 
+// emulating output stream passing the data to ImageStreamEncoder::Sink
+
+struct JpegSinkDestination
+{
+    struct jpeg_destination_mgr pub;
+    std::vector<uchar> buf;
+    ImageStreamEncoder::Sink sink;
+    bool aborted;
+};
+
+static void flush_to_sink(j_compress_ptr cinfo, size_t size)
+{
+    JpegSinkDestination* dest = (JpegSinkDestination*)cinfo->dest;
+    bool ok = false;
+    try
+    {
+        ok = size == 0 || dest->sink(&dest->buf[0], size);
+    }
+    catch (...)
+    {
+        // don't let exceptions propagate through libjpeg
+    }
+    if( !ok )
+    {
+        dest->aborted = true;
+        cinfo->err->error_exit((j_common_ptr)cinfo);
+    }
+    dest->pub.next_output_byte = &dest->buf[0];
+    dest->pub.free_in_buffer = dest->buf.size();
+}
+
+METHODDEF(boolean)
+empty_output_buffer_to_sink(j_compress_ptr cinfo)
+{
+    JpegSinkDestination* dest = (JpegSinkDestination*)cinfo->dest;
+    flush_to_sink(cinfo, dest->buf.size());
+    return TRUE;
+}
+
+METHODDEF(void)
+term_destination_to_sink(j_compress_ptr cinfo)
+{
+    JpegSinkDestination* dest = (JpegSinkDestination*)cinfo->dest;
+    flush_to_sink(cinfo, dest->buf.size() - dest->pub.free_in_buffer);
+}
+
+static void jpeg_sink_dest(j_compress_ptr cinfo, JpegSinkDestination* destination, const ImageStreamEncoder::Sink& sink)
+{
+    cinfo->dest = &destination->pub;
+
+    destination->pub.init_destination = stub;
+    destination->pub.empty_output_buffer = empty_output_buffer_to_sink;
+    destination->pub.term_destination = term_destination_to_sink;
+
+    destination->buf.resize(1 << 16);
+    destination->sink = sink;
+    destination->aborted = false;
+    destination->pub.next_output_byte = &destination->buf[0];
+    destination->pub.free_in_buffer = destination->buf.size();
+}
+
+struct JpegEncoderState
+{
+    jpeg_compress_struct cinfo; // IJG JPEG codec structure
+    JpegErrorMgr jerr; // error processing manager state
+    JpegSinkDestination dest; // output sink
+    AutoBuffer<uchar> buffer; // row conversion buffer
+};
+
+
+/// Sets the image geometry and the compression parameters of cinfo, libjpeg errors longjmp to the caller
+static void setupCompress( jpeg_compress_struct* cinfo, int width, int height, int _channels, const std::vector<int>& params )
+{
+    cinfo->image_width = width;
+    cinfo->image_height = height;
+
+    int channels = _channels > 1 ? 3 : 1;
+
+#ifdef JCS_EXTENSIONS
+    cinfo->input_components = _channels;
+    cinfo->in_color_space = _channels == 3 ? JCS_EXT_BGR
+        : _channels == 4 ? JCS_EXT_BGRX : JCS_GRAYSCALE;
+#else
+    cinfo->input_components = channels;
+    cinfo->in_color_space = channels > 1 ? JCS_RGB : JCS_GRAYSCALE;
+#endif
+
+    int quality = 95;
+    int progressive = 0;
+    int optimize = 0;
+    int rst_interval = 0;
+    int luma_quality = -1;
+    int chroma_quality = -1;
+    uint32_t sampling_factor = 0; // same as 0x221111
+
+    for( size_t i = 0; i < params.size(); i += 2 )
+    {
+        if( params[i] == IMWRITE_JPEG_QUALITY )
+        {
+            quality = params[i+1];
+            quality = MIN(MAX(quality, 0), 100);
+        }
+
+        if( params[i] == IMWRITE_JPEG_PROGRESSIVE )
+        {
+            progressive = params[i+1];
+        }
+
+        if( params[i] == IMWRITE_JPEG_OPTIMIZE )
+        {
+            optimize = params[i+1];
+        }
+
+        if( params[i] == IMWRITE_JPEG_LUMA_QUALITY )
+        {
+            if (params[i+1] >= 0)
+            {
+                luma_quality = MIN(MAX(params[i+1], 0), 100);
+
+                quality = luma_quality;
+
+                if (chroma_quality < 0)
+                {
+                    chroma_quality = luma_quality;
+                }
+            }
+        }
+
+        if( params[i] == IMWRITE_JPEG_CHROMA_QUALITY )
+        {
+            if (params[i+1] >= 0)
+            {
+                chroma_quality = MIN(MAX(params[i+1], 0), 100);
+            }
+        }
+
+        if( params[i] == IMWRITE_JPEG_RST_INTERVAL )
+        {
+            rst_interval = params[i+1];
+            rst_interval = MIN(MAX(rst_interval, 0), 65535L);
+        }
+
+        if( params[i] == IMWRITE_JPEG_SAMPLING_FACTOR )
+        {
+            sampling_factor = static_cast<uint32_t>(params[i+1]);
+
+            switch ( sampling_factor )
+            {
+                case IMWRITE_JPEG_SAMPLING_FACTOR_411:
+                case IMWRITE_JPEG_SAMPLING_FACTOR_420:
+                case IMWRITE_JPEG_SAMPLING_FACTOR_422:
+                case IMWRITE_JPEG_SAMPLING_FACTOR_440:
+                case IMWRITE_JPEG_SAMPLING_FACTOR_444:
+                // OK.
+                break;
+
+                default:
+                CV_LOG_WARNING(NULL, cv::format("Unknown value for IMWRITE_JPEG_SAMPLING_FACTOR: 0x%06x", sampling_factor ) );
+                sampling_factor = 0;
+                break;
+            }
+        }
+    }
+
+    jpeg_set_defaults( cinfo );
+    cinfo->restart_interval = rst_interval;
+
+    jpeg_set_quality( cinfo, quality,
+                      TRUE /* limit to baseline-JPEG values */ );
+    if( progressive )
+        jpeg_simple_progression( cinfo );
+    if( optimize )
+        cinfo->optimize_coding = TRUE;
+
+    if( (channels > 1) && ( sampling_factor != 0 ) )
+    {
+        cinfo->comp_info[0].v_samp_factor = (sampling_factor >> 16 ) & 0xF;
+        cinfo->comp_info[0].h_samp_factor = (sampling_factor >> 20 ) & 0xF;
+        cinfo->comp_info[1].v_samp_factor = 1;
+        cinfo->comp_info[1].h_samp_factor = 1;
+    }
+
+#if JPEG_LIB_VERSION >= 70
+    if (luma_quality >= 0 && chroma_quality >= 0)
+    {
+        cinfo->q_scale_factor[0] = jpeg_quality_scaling(luma_quality);
+        cinfo->q_scale_factor[1] = jpeg_quality_scaling(chroma_quality);
+        if ( luma_quality != chroma_quality )
+        {
+            /* disable subsampling - ref. Libjpeg.txt */
+            cinfo->comp_info[0].v_samp_factor = 1;
+            cinfo->comp_info[0].h_samp_factor = 1;
+            cinfo->comp_info[1].v_samp_factor = 1;
+            cinfo->comp_info[1].h_samp_factor = 1;
+        }
+        jpeg_default_qtables( cinfo, TRUE );
+    }
+#endif // #if JPEG_LIB_VERSION >= 70
+}
+
+/// Writes the rows of img, buffer must fit a row of RGB pixels if libjpeg has no BGR input
+static void writeScanlines( jpeg_compress_struct* cinfo, const Mat& img, uchar* buffer )
+{
+    int _channels = img.channels(), width = img.cols;
+    for( int y = 0; y < img.rows; y++ )
+    {
+        uchar *data = const_cast<uchar*>(img.ptr(y)), *ptr = data;
+
+#ifndef JCS_EXTENSIONS
+        if( _channels == 3 )
+        {
+            icvCvt_BGR2RGB_8u_C3R( data, 0, buffer, 0, Size(width,1) );
+            ptr = buffer;
+        }
+        else if( _channels == 4 )
+        {
+            icvCvt_BGRA2BGR_8u_C4C3R( data, 0, buffer, 0, Size(width,1), 2 );
+            ptr = buffer;
+        }
+#else
+        CV_UNUSED(_channels); CV_UNUSED(width); CV_UNUSED(buffer);
+#endif
+
+        jpeg_write_scanlines( cinfo, &ptr, 1 );
+    }
+}
 
 JpegEncoder::JpegEncoder()
 {
     m_description = "JPEG files (*.jpeg;*.jpg;*.jpe)";
     m_buf_supported = true;
+    m_state = 0;
 }
 
 
 JpegEncoder::~JpegEncoder()
 {
+    closeStream(false);
 }
 
 ImageEncoder JpegEncoder::newEncoder() const
@@ -615,10 +905,8 @@ bool JpegEncoder::write( const Mat& img, const std::vector<int>& params )
 
     std::vector<uchar> out_buf(1 << 12);
 
-#ifndef JCS_EXTENSIONS
     AutoBuffer<uchar> _buffer;
-    uchar* buffer;
-#endif
+    uchar* buffer = 0;
 
     struct jpeg_compress_struct cinfo;
     JpegErrorMgr jerr;
@@ -648,177 +936,118 @@ bool JpegEncoder::write( const Mat& img, const std::vector<int>& params )
 
     if( setjmp( jerr.setjmp_buffer ) == 0 )
     {
-        cinfo.image_width = width;
-        cinfo.image_height = height;
-
         int _channels = img.channels();
-        int channels = _channels > 1 ? 3 : 1;
-
-#ifdef JCS_EXTENSIONS
-        cinfo.input_components = _channels;
-        cinfo.in_color_space = _channels == 3 ? JCS_EXT_BGR
-            : _channels == 4 ? JCS_EXT_BGRX : JCS_GRAYSCALE;
-#else
-        cinfo.input_components = channels;
-        cinfo.in_color_space = channels > 1 ? JCS_RGB : JCS_GRAYSCALE;
-#endif
-
-        int quality = 95;
-        int progressive = 0;
-        int optimize = 0;
-        int rst_interval = 0;
-        int luma_quality = -1;
-        int chroma_quality = -1;
-        uint32_t sampling_factor = 0; // same as 0x221111
-
-        for( size_t i = 0; i < params.size(); i += 2 )
-        {
-            if( params[i] == IMWRITE_JPEG_QUALITY )
-            {
-                quality = params[i+1];
-                quality = MIN(MAX(quality, 0), 100);
-            }
-
-            if( params[i] == IMWRITE_JPEG_PROGRESSIVE )
-            {
-                progressive = params[i+1];
-            }
-
-            if( params[i] == IMWRITE_JPEG_OPTIMIZE )
-            {
-                optimize = params[i+1];
-            }
+        setupCompress( &cinfo, width, height, _channels, params );
 
-            if( params[i] == IMWRITE_JPEG_LUMA_QUALITY )
-            {
-                if (params[i+1] >= 0)
-                {
-                    luma_quality = MIN(MAX(params[i+1], 0), 100);
+        jpeg_start_compress( &cinfo, TRUE );
 
-                    quality = luma_quality;
+#ifndef JCS_EXTENSIONS
+        if( _channels > 1 )
+            _buffer.allocate(width*3);
+        buffer = _buffer.data();
+#endif
 
-                    if (chroma_quality < 0)
-                    {
-                        chroma_quality = luma_quality;
-                    }
-                }
-            }
+        writeScanlines( &cinfo, img, buffer );
 
-            if( params[i] == IMWRITE_JPEG_CHROMA_QUALITY )
-            {
-                if (params[i+1] >= 0)
-                {
-                    chroma_quality = MIN(MAX(params[i+1], 0), 100);
-                }
-            }
-
-            if( params[i] == IMWRITE_JPEG_RST_INTERVAL )
-            {
-                rst_interval = params[i+1];
-                rst_interval = MIN(MAX(rst_interval, 0), 65535L);
-            }
+        jpeg_finish_compress( &cinfo );
+        result = true;
+    }
 
-            if( params[i] == IMWRITE_JPEG_SAMPLING_FACTOR )
-            {
-                sampling_factor = static_cast<uint32_t>(params[i+1]);
+_exit_:
 
-                switch ( sampling_factor )
-                {
-                    case IMWRITE_JPEG_SAMPLING_FACTOR_411:
-                    case IMWRITE_JPEG_SAMPLING_FACTOR_420:
-                    case IMWRITE_JPEG_SAMPLING_FACTOR_422:
-                    case IMWRITE_JPEG_SAMPLING_FACTOR_440:
-                    case IMWRITE_JPEG_SAMPLING_FACTOR_444:
-                    // OK.
-                    break;
-
-                    default:
-                    CV_LOG_WARNING(NULL, cv::format("Unknown value for IMWRITE_JPEG_SAMPLING_FACTOR: 0x%06x", sampling_factor ) );
-                    sampling_factor = 0;
-                    break;
-                }
-            }
-        }
+    if(!result)
+    {
+        char jmsg_buf[JMSG_LENGTH_MAX];
+        jerr.pub.format_message((j_common_ptr)&cinfo, jmsg_buf);
+        m_last_error = jmsg_buf;
+    }
 
-        jpeg_set_defaults( &cinfo );
-        cinfo.restart_interval = rst_interval;
+    jpeg_destroy_compress( &cinfo );
 
-        jpeg_set_quality( &cinfo, quality,
-                          TRUE /* limit to baseline-JPEG values */ );
-        if( progressive )
-            jpeg_simple_progression( &cinfo );
-        if( optimize )
-            cinfo.optimize_coding = TRUE;
+    return result;
+}
 
-        if( (channels > 1) && ( sampling_factor != 0 ) )
-        {
-            cinfo.comp_info[0].v_samp_factor = (sampling_factor >> 16 ) & 0xF;
-            cinfo.comp_info[0].h_samp_factor = (sampling_factor >> 20 ) & 0xF;
-            cinfo.comp_info[1].v_samp_factor = 1;
-            cinfo.comp_info[1].h_samp_factor = 1;
-        }
+void JpegEncoder::closeStream( bool failed )
+{
+    JpegEncoderState* state = (JpegEncoderState*)m_state;
+    if( !state )
+        return;
 
-#if JPEG_LIB_VERSION >= 70
-        if (luma_quality >= 0 && chroma_quality >= 0)
+    if( failed )
+    {
+        if( state->dest.aborted )
+            m_last_error = "encoding is aborted by the output sink";
+        else
         {
-            cinfo.q_scale_factor[0] = jpeg_quality_scaling(luma_quality);
-            cinfo.q_scale_factor[1] = jpeg_quality_scaling(chroma_quality);
-            if ( luma_quality != chroma_quality )
-            {
-                /* disable subsampling - ref. Libjpeg.txt */
-                cinfo.comp_info[0].v_samp_factor = 1;
-                cinfo.comp_info[0].h_samp_factor = 1;
-                cinfo.comp_info[1].v_samp_factor = 1;
-                cinfo.comp_info[1].h_samp_factor = 1;
-            }
-            jpeg_default_qtables( &cinfo, TRUE );
+            char jmsg_buf[JMSG_LENGTH_MAX];
+            state->jerr.pub.format_message((j_common_ptr)&state->cinfo, jmsg_buf);
+            m_last_error = jmsg_buf;
         }
-#endif // #if JPEG_LIB_VERSION >= 70
+    }
+    jpeg_destroy_compress( &state->cinfo );
+    delete state;
+    m_state = 0;
+}
 
-        jpeg_start_compress( &cinfo, TRUE );
+bool JpegEncoder::writeBegin( Size size, int type, const std::vector<int>& params, const ImageStreamEncoder::Sink& sink )
+{
+    closeStream(false);
+    m_last_error.clear();
 
-#ifndef JCS_EXTENSIONS
-        if( channels > 1 )
-            _buffer.allocate(width*channels);
-        buffer = _buffer.data();
-#endif
+    if( CV_MAT_DEPTH(type) != CV_8U )
+        return false;
+    int _channels = CV_MAT_CN(type);
 
-        for( int y = 0; y < height; y++ )
-        {
-            uchar *data = img.data + img.step*y, *ptr = data;
+    JpegEncoderState* state = new JpegEncoderState;
+    m_state = state;
+    state->cinfo.err = jpeg_std_error(&state->jerr.pub);
+    state->jerr.pub.error_exit = error_exit;
+    jpeg_create_compress( &state->cinfo );
+    jpeg_sink_dest( &state->cinfo, &state->dest, sink );
 
+    if( setjmp( state->jerr.setjmp_buffer ) == 0 )
+    {
+        setupCompress( &state->cinfo, size.width, size.height, _channels, params );
+        jpeg_start_compress( &state->cinfo, TRUE );
 #ifndef JCS_EXTENSIONS
-            if( _channels == 3 )
-            {
-                icvCvt_BGR2RGB_8u_C3R( data, 0, buffer, 0, Size(width,1) );
-                ptr = buffer;
-            }
-            else if( _channels == 4 )
-            {
-                icvCvt_BGRA2BGR_8u_C4C3R( data, 0, buffer, 0, Size(width,1), 2 );
-                ptr = buffer;
-            }
+        if( _channels > 1 )
+            state->buffer.allocate(size.width*3);
 #endif
-
-            jpeg_write_scanlines( &cinfo, &ptr, 1 );
-        }
-
-        jpeg_finish_compress( &cinfo );
-        result = true;
+        return true;
     }
+    closeStream(true);
+    return false;
+}
 
-_exit_:
+bool JpegEncoder::writeRows( const Mat& rows )
+{
+    JpegEncoderState* state = (JpegEncoderState*)m_state;
+    if( !state )
+        return false;
 
-    if(!result)
+    if( setjmp( state->jerr.setjmp_buffer ) == 0 )
     {
-        char jmsg_buf[JMSG_LENGTH_MAX];
-        jerr.pub.format_message((j_common_ptr)&cinfo, jmsg_buf);
-        m_last_error = jmsg_buf;
+        writeScanlines( &state->cinfo, rows, state->buffer.data() );
+        return true;
     }
+    closeStream(true);
+    return false;
+}
 
-    jpeg_destroy_compress( &cinfo );
+bool JpegEncoder::writeEnd()
+{
+    JpegEncoderState* state = (JpegEncoderState*)m_state;
+    if( !state )
+        return false;
 
-    return result;
+    if( setjmp( state->jerr.setjmp_buffer ) == 0 )
+    {
+        jpeg_finish_compress( &state->cinfo );
+        closeStream(false);
+        return true;
+    }
+    closeStream(true);
+    return false;
 }
 
 }
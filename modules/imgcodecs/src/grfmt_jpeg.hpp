@@ -81,6 +81,7 @@ public:
 
     bool  readData( Mat& img ) CV_OVERRIDE;
     bool  readHeader() CV_OVERRIDE;
+    bool  setROI( const Rect& roi ) CV_OVERRIDE;
     void  close();
 
     ImageDecoder newDecoder() const CV_OVERRIDE;
@@ -103,7 +104,15 @@ public:
     virtual ~JpegEncoder();
 
     bool  write( const Mat& img, const std::vector<int>& params ) CV_OVERRIDE;
+    bool  writeBegin( Size size, int type, const std::vector<int>& params, const ImageStreamEncoder::Sink& sink ) CV_OVERRIDE;
+    bool  writeRows( const Mat& rows ) CV_OVERRIDE;
+    bool  writeEnd() CV_OVERRIDE;
     ImageEncoder newEncoder() const CV_OVERRIDE;
+
+protected:
+    void  closeStream( bool failed );
+
+    void* m_state; // state of incremental encoding
 };
 
 }
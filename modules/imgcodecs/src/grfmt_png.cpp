@@ -214,12 +214,21 @@ bool  PngDecoder::readHeader()
 }
 
 
+bool  PngDecoder::setROI( const Rect& roi )
+{
+    m_roi = roi;
+    return true;
+}
+
 bool  PngDecoder::readData( Mat& img )
 {
     volatile bool result = false;
     AutoBuffer<uchar*> _buffer(m_height);
     uchar** buffer = _buffer.data();
     bool color = img.channels() > 1;
+    // buffers for partial decoding are owned outside of setjmp() scope to be released on errors
+    AutoBuffer<uchar> _row(m_roi.empty() ? 1 : (size_t)m_width * 8); // up to 4 channels of 16 bits
+    Mat full;
 
     png_structp png_ptr = (png_structp)m_png_ptr;
     png_infop info_ptr = (png_infop)m_info_ptr;
@@ -268,14 +277,43 @@ bool  PngDecoder::readData( Mat& img )
             else
                 png_set_rgb_to_gray( png_ptr, 1, 0.299, 0.587 ); // RGB->Gray
 
-            png_set_interlace_handling( png_ptr );
+            const int passes = png_set_interlace_handling( png_ptr );
             png_read_update_info( png_ptr, info_ptr );
 
-            for( y = 0; y < m_height; y++ )
-                buffer[y] = img.data + y*img.step;
+            if( m_roi.empty() )
+            {
+                for( y = 0; y < m_height; y++ )
+                    buffer[y] = img.data + y*img.step;
 
-            png_read_image( png_ptr, buffer );
-            png_read_end( png_ptr, end_info );
+                png_read_image( png_ptr, buffer );
+                png_read_end( png_ptr, end_info );
+            }
+            else if( passes == 1 )
+            {
+                // rows are decoded one by one, the ones below the region are not decoded at all
+                const size_t esz = img.elemSize();
+                CV_Assert( png_get_rowbytes( png_ptr, info_ptr ) <= _row.size() );
+                uchar* row = _row.data();
+                for( y = 0; y < m_roi.y + m_roi.height; y++ )
+                {
+                    png_read_row( png_ptr, row, NULL );
+                    if( y >= m_roi.y )
+                        memcpy( img.ptr(y - m_roi.y), row + m_roi.x*esz, m_roi.width*esz );
+                }
+                if( y == m_height )
+                    png_read_end( png_ptr, end_info );
+            }
+            else
+            {
+                // interlaced image can't be decoded partially
+                full.create( m_height, m_width, img.type() );
+                for( y = 0; y < m_height; y++ )
+                    buffer[y] = full.data + y*full.step;
+
+                png_read_image( png_ptr, buffer );
+                png_read_end( png_ptr, end_info );
+                full( m_roi ).copyTo( img );
+            }
 
 #ifdef PNG_eXIf_SUPPORTED
             png_uint_32 num_exif = 0;
@@ -304,15 +342,76 @@ bool  PngDecoder::readData( Mat& img )
 /////////////////////// PngEncoder ///////////////////
 
 
+/// Sets up the compression and the transformations, and writes the header.
+/// The output of png_ptr must be set already, libpng errors longjmp to the setjmp of the caller.
+static void writeHeader( png_structp png_ptr, png_infop info_ptr, int width, int height,
+                         int depth, int channels, const std::vector<int>& params )
+{
+    int compression_level = -1; // Invalid value to allow setting 0-9 as valid
+    int compression_strategy = IMWRITE_PNG_STRATEGY_RLE; // Default strategy
+    bool isBilevel = false;
+
+    for( size_t i = 0; i < params.size(); i += 2 )
+    {
+        if( params[i] == IMWRITE_PNG_COMPRESSION )
+        {
+            compression_strategy = IMWRITE_PNG_STRATEGY_DEFAULT; // Default strategy
+            compression_level = params[i+1];
+            compression_level = MIN(MAX(compression_level, 0), Z_BEST_COMPRESSION);
+        }
+        if( params[i] == IMWRITE_PNG_STRATEGY )
+        {
+            compression_strategy = params[i+1];
+            compression_strategy = MIN(MAX(compression_strategy, 0), Z_FIXED);
+        }
+        if( params[i] == IMWRITE_PNG_BILEVEL )
+        {
+            isBilevel = params[i+1] != 0;
+        }
+    }
+
+    if( compression_level >= 0 )
+    {
+        png_set_compression_level( png_ptr, compression_level );
+    }
+    else
+    {
+        // tune parameters for speed
+        // (see http://wiki.linuxquestions.org/wiki/Libpng)
+        png_set_filter(png_ptr, PNG_FILTER_TYPE_BASE, PNG_FILTER_SUB);
+        png_set_compression_level(png_ptr, Z_BEST_SPEED);
+    }
+    png_set_compression_strategy(png_ptr, compression_strategy);
+
+    png_set_IHDR( png_ptr, info_ptr, width, height, depth == CV_8U ? isBilevel?1:8 : 16,
+        channels == 1 ? PNG_COLOR_TYPE_GRAY :
+        channels == 3 ? PNG_COLOR_TYPE_RGB : PNG_COLOR_TYPE_RGBA,
+        PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT,
+        PNG_FILTER_TYPE_DEFAULT );
+
+    png_write_info( png_ptr, info_ptr );
+
+    if (isBilevel)
+        png_set_packing(png_ptr);
+
+    png_set_bgr( png_ptr );
+    if( !isBigEndian() )
+        png_set_swap( png_ptr );
+}
+
+
 PngEncoder::PngEncoder()
 {
     m_description = "Portable Network Graphics files (*.png)";
     m_buf_supported = true;
+    m_png_ptr = 0;
+    m_info_ptr = 0;
 }
 
 
 PngEncoder::~PngEncoder()
 {
+    closeStream();
 }
 
 
@@ -344,6 +443,25 @@ void PngEncoder::flushBuf(void*)
 {
 }
 
+void PngEncoder::writeDataToSink(void* _png_ptr, uchar* src, size_t size)
+{
+    if( size == 0 )
+        return;
+    png_structp png_ptr = (png_structp)_png_ptr;
+    PngEncoder* encoder = (PngEncoder*)(png_get_io_ptr(png_ptr));
+    bool ok = false;
+    try
+    {
+        ok = encoder->m_sink(src, size);
+    }
+    catch (...)
+    {
+        // don't let exceptions propagate through libpng
+    }
+    if( !ok )
+        png_error( png_ptr, "PNG encoder: encoding is aborted by the output sink" );
+}
+
 bool  PngEncoder::write( const Mat& img, const std::vector<int>& params )
 {
     png_structp png_ptr = png_create_write_struct( PNG_LIBPNG_VER_STRING, 0, 0, 0 );
@@ -377,58 +495,9 @@ bool  PngEncoder::write( const Mat& img, const std::vector<int>& params )
                         png_init_io( png_ptr, (png_FILE_p)f );
                 }
 
-                int compression_level = -1; // Invalid value to allow setting 0-9 as valid
-                int compression_strategy = IMWRITE_PNG_STRATEGY_RLE; // Default strategy
-                bool isBilevel = false;
-
-                for( size_t i = 0; i < params.size(); i += 2 )
-                {
-                    if( params[i] == IMWRITE_PNG_COMPRESSION )
-                    {
-                        compression_strategy = IMWRITE_PNG_STRATEGY_DEFAULT; // Default strategy
-                        compression_level = params[i+1];
-                        compression_level = MIN(MAX(compression_level, 0), Z_BEST_COMPRESSION);
-                    }
-                    if( params[i] == IMWRITE_PNG_STRATEGY )
-                    {
-                        compression_strategy = params[i+1];
-                        compression_strategy = MIN(MAX(compression_strategy, 0), Z_FIXED);
-                    }
-                    if( params[i] == IMWRITE_PNG_BILEVEL )
-                    {
-                        isBilevel = params[i+1] != 0;
-                    }
-                }
-
                 if( m_buf || f )
                 {
-                    if( compression_level >= 0 )
-                    {
-                        png_set_compression_level( png_ptr, compression_level );
-                    }
-                    else
-                    {
-                        // tune parameters for speed
-                        // (see http://wiki.linuxquestions.org/wiki/Libpng)
-                        png_set_filter(png_ptr, PNG_FILTER_TYPE_BASE, PNG_FILTER_SUB);
-                        png_set_compression_level(png_ptr, Z_BEST_SPEED);
-                    }
-                    png_set_compression_strategy(png_ptr, compression_strategy);
-
-                    png_set_IHDR( png_ptr, info_ptr, width, height, depth == CV_8U ? isBilevel?1:8 : 16,
-                        channels == 1 ? PNG_COLOR_TYPE_GRAY :
-                        channels == 3 ? PNG_COLOR_TYPE_RGB : PNG_COLOR_TYPE_RGBA,
-                        PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT,
-                        PNG_FILTER_TYPE_DEFAULT );
-
-                    png_write_info( png_ptr, info_ptr );
-
-                    if (isBilevel)
-                        png_set_packing(png_ptr);
-
-                    png_set_bgr( png_ptr );
-                    if( !isBigEndian() )
-                        png_set_swap( png_ptr );
+                    writeHeader( png_ptr, info_ptr, width, height, depth, channels, params );
 
                     buffer.allocate(height);
                     for( y = 0; y < height; y++ )
@@ -449,6 +518,83 @@ bool  PngEncoder::write( const Mat& img, const std::vector<int>& params )
     return result;
 }
 
+void PngEncoder::closeStream()
+{
+    if( m_png_ptr )
+    {
+        png_structp png_ptr = (png_structp)m_png_ptr;
+        png_infop info_ptr = (png_infop)m_info_ptr;
+        png_destroy_write_struct( &png_ptr, info_ptr ? &info_ptr : 0 );
+    }
+    m_png_ptr = 0;
+    m_info_ptr = 0;
+    m_sink = ImageStreamEncoder::Sink();
+}
+
+bool PngEncoder::writeBegin( Size size, int type, const std::vector<int>& params, const ImageStreamEncoder::Sink& sink )
+{
+    closeStream();
+
+    int depth = CV_MAT_DEPTH(type), channels = CV_MAT_CN(type);
+    if( depth != CV_8U && depth != CV_16U )
+        return false;
+
+    png_structp png_ptr = png_create_write_struct( PNG_LIBPNG_VER_STRING, 0, 0, 0 );
+    if( !png_ptr )
+        return false;
+    m_png_ptr = png_ptr;
+    png_infop info_ptr = png_create_info_struct( png_ptr );
+    if( !info_ptr )
+    {
+        closeStream();
+        return false;
+    }
+    m_info_ptr = info_ptr;
+    m_sink = sink;
+
+    if( setjmp( png_jmpbuf ( png_ptr ) ) == 0 )
+    {
+        png_set_write_fn(png_ptr, this,
+            (png_rw_ptr)writeDataToSink, (png_flush_ptr)flushBuf);
+        writeHeader( png_ptr, info_ptr, size.width, size.height, depth, channels, params );
+        return true;
+    }
+    closeStream();
+    return false;
+}
+
+bool PngEncoder::writeRows( const Mat& rows )
+{
+    png_structp png_ptr = (png_structp)m_png_ptr;
+    if( !png_ptr )
+        return false;
+
+    if( setjmp( png_jmpbuf ( png_ptr ) ) == 0 )
+    {
+        for( int y = 0; y < rows.rows; y++ )
+            png_write_row( png_ptr, rows.ptr(y) );
+        return true;
+    }
+    closeStream();
+    return false;
+}
+
+bool PngEncoder::writeEnd()
+{
+    png_structp png_ptr = (png_structp)m_png_ptr;
+    if( !png_ptr )
+        return false;
+
+    volatile bool result = false;
+    if( setjmp( png_jmpbuf ( png_ptr ) ) == 0 )
+    {
+        png_write_end( png_ptr, (png_infop)m_info_ptr );
+        result = true;
+    }
+    closeStream();
+    return result;
+}
+
 }
 
 #endif
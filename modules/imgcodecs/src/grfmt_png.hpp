@@ -60,6 +60,7 @@ public:
 
     bool  readData( Mat& img ) CV_OVERRIDE;
     bool  readHeader() CV_OVERRIDE;
+    bool  setROI( const Rect& roi ) CV_OVERRIDE;
     void  close();
 
     ImageDecoder newDecoder() const CV_OVERRIDE;
@@ -87,11 +88,22 @@ public:
     bool  isFormatSupported( int depth ) const CV_OVERRIDE;
     bool  write( const Mat& img, const std::vector<int>& params ) CV_OVERRIDE;
 
+    bool  writeBegin( Size size, int type, const std::vector<int>& params, const ImageStreamEncoder::Sink& sink ) CV_OVERRIDE;
+    bool  writeRows( const Mat& rows ) CV_OVERRIDE;
+    bool  writeEnd() CV_OVERRIDE;
+
     ImageEncoder newEncoder() const CV_OVERRIDE;
 
 protected:
     static void writeDataToBuf(void* png_ptr, uchar* src, size_t size);
+    static void writeDataToSink(void* png_ptr, uchar* src, size_t size);
     static void flushBuf(void* png_ptr);
+    void closeStream();
+
+    // state of incremental encoding
+    void* m_png_ptr;
+    void* m_info_ptr;
+    ImageStreamEncoder::Sink m_sink;
 };
 
 }
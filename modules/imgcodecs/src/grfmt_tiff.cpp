@@ -378,6 +378,15 @@ bool TiffDecoder::nextPage()
            readHeader();
 }
 
+bool TiffDecoder::gotoPage(int index)
+{
+    TIFF* tif = static_cast<TIFF*>(m_tif.get());
+    return tif && index >= 0 &&
+           index < (int)TIFFNumberOfDirectories(tif) &&
+           TIFFSetDirectory(tif, (tdir_t)index) &&
+           readHeader();
+}
+
 static void fixOrientationPartial(Mat &img, uint16 orientation)
 {
     switch(orientation) {
@@ -587,6 +596,18 @@ static void _unpack14To16(const uchar* src, const uchar* srcEnd, ushort* dst, us
 }
 //end _unpack14To16()
 
+bool TiffDecoder::setROI( const Rect& roi )
+{
+    CV_Assert(!m_tif.empty());
+    TIFF* tif = (TIFF*)m_tif.get();
+    uint16 img_orientation = ORIENTATION_TOPLEFT;
+    CV_TIFF_CHECK_CALL_DEBUG(TIFFGetField(tif, TIFFTAG_ORIENTATION, &img_orientation));
+    if (img_orientation != ORIENTATION_TOPLEFT || m_hdr)
+        return false;
+    m_roi = roi;
+    return true;
+}
+
 bool  TiffDecoder::readData( Mat& img )
 {
     int type = img.type();
@@ -770,6 +791,21 @@ bool  TiffDecoder::readData( Mat& img )
                 tile_height0 = 1;
             }
 
+            // With region of interest only the tiles (strips) intersecting it are decoded into the canvas
+            // aligned to the tile grid. Scanlines of a single compressed strip can't be skipped.
+            Rect canvas_rect(0, 0, m_width, m_height);
+            if (!m_roi.empty() && !doReadScanline)
+            {
+                const int x0 = m_roi.x / (int)tile_width0 * (int)tile_width0;
+                const int y0 = m_roi.y / (int)tile_height0 * (int)tile_height0;
+                const int x1 = std::min(m_width, (int)(divUp((size_t)m_roi.br().x, (size_t)tile_width0) * tile_width0));
+                const int y1 = std::min(m_height, (int)(divUp((size_t)m_roi.br().y, (size_t)tile_height0) * tile_height0));
+                canvas_rect = Rect(x0, y0, x1 - x0, y1 - y0);
+            }
+            Mat canvas = m_roi.empty() ? img : Mat(canvas_rect.size(), type);
+            const int cx0 = canvas_rect.x, cy0 = canvas_rect.y;
+            const int tiles_per_row = (int)divUp((size_t)m_width, (size_t)tile_width0);
+
             const size_t src_buffer_bytes_per_row = divUp(static_cast<size_t>(ncn * tile_width0 * bpp), static_cast<size_t>(bitsPerByte));
             const size_t src_buffer_size = tile_height0 * src_buffer_bytes_per_row;
             CV_CheckLT(src_buffer_size, MAX_TILE_SIZE, "buffer_size is too large: >= 1Gb");
@@ -788,21 +824,20 @@ bool  TiffDecoder::readData( Mat& img )
                            "src_buffer_size is smaller than TIFFScanlineSize().");
             }
 
-            int tileidx = 0;
-
             #define MAKE_FLAG(a,b) ( (a << 8) | b )
             const int  convert_flag = MAKE_FLAG( ncn, wanted_channels );
             const bool isNeedConvert16to8 = ( doReadScanline ) && ( bpp == 16 ) && ( dst_bpp == 8);
 
-            for (int y = 0; y < m_height; y += (int)tile_height0)
+            for (int y = canvas_rect.y; y < canvas_rect.br().y; y += (int)tile_height0)
             {
                 int tile_height = std::min((int)tile_height0, m_height - y);
 
                 const int img_y = vert_flip ? m_height - y - tile_height : y;
 
-                for(int x = 0; x < m_width; x += (int)tile_width0, tileidx++)
+                for(int x = canvas_rect.x; x < canvas_rect.br().x; x += (int)tile_width0)
                 {
                     int tile_width = std::min((int)tile_width0, m_width - x);
+                    const int tileidx = y / (int)tile_height0 * tiles_per_row + x / (int)tile_width0;
 
                     switch (dst_bpp)
                     {
@@ -842,7 +877,7 @@ bool  TiffDecoder::readData( Mat& img )
                                 bstart += (tile_height0 - tile_height) * tile_width0 * 4;
                             }
 
-                            uchar* img_line_buffer = (uchar*) img.ptr(y, 0);
+                            uchar* img_line_buffer = (uchar*) canvas.ptr(y - cy0, 0);
 
                             for (int i = 0; i < tile_height; i++)
                             {
@@ -905,14 +940,14 @@ bool  TiffDecoder::readData( Mat& img )
                                     if (wanted_channels == 4)
                                     {
                                         icvCvt_BGRA2RGBA_8u_C4R(bstart + i*tile_width0*4, 0,
-                                                img.ptr(img_y + tile_height - i - 1, x), 0,
+                                                canvas.ptr(img_y + tile_height - i - 1 - cy0, x - cx0), 0,
                                                 Size(tile_width, 1) );
                                     }
                                     else
                                     {
                                         CV_CheckEQ(wanted_channels, 3, "TIFF-8bpp: BGR/BGRA images are supported only");
                                         icvCvt_BGRA2BGR_8u_C4C3R(bstart + i*tile_width0*4, 0,
-                                                img.ptr(img_y + tile_height - i - 1, x), 0,
+                                                canvas.ptr(img_y + tile_height - i - 1 - cy0, x - cx0), 0,
                                                 Size(tile_width, 1), 2);
                                     }
                                 }
@@ -920,7 +955,7 @@ bool  TiffDecoder::readData( Mat& img )
                                 {
                                     CV_CheckEQ(wanted_channels, 1, "");
                                     icvCvt_BGRA2Gray_8u_C4C1R( bstart + i*tile_width0*4, 0,
-                                            img.ptr(img_y + tile_height - i - 1, x), 0,
+                                            canvas.ptr(img_y + tile_height - i - 1 - cy0, x - cx0), 0,
                                             Size(tile_width, 1), 2);
                                 }
                             }
@@ -970,14 +1005,14 @@ bool  TiffDecoder::readData( Mat& img )
                                     {
                                         CV_CheckEQ(wanted_channels, 3, "");
                                         icvCvt_Gray2BGR_16u_C1C3R(buffer16, 0,
-                                                img.ptr<ushort>(img_y + i, x), 0,
+                                                canvas.ptr<ushort>(img_y + i - cy0, x - cx0), 0,
                                                 Size(tile_width, 1));
                                     }
                                     else if (ncn == 3)
                                     {
                                         CV_CheckEQ(wanted_channels, 3, "");
                                         icvCvt_RGB2BGR_16u_C3R(buffer16, 0,
-                                                img.ptr<ushort>(img_y + i, x), 0,
+                                                canvas.ptr<ushort>(img_y + i - cy0, x - cx0), 0,
                                                 Size(tile_width, 1));
                                     }
                                     else if (ncn == 4)
@@ -985,14 +1020,14 @@ bool  TiffDecoder::readData( Mat& img )
                                         if (wanted_channels == 4)
                                         {
                                             icvCvt_BGRA2RGBA_16u_C4R(buffer16, 0,
-                                                img.ptr<ushort>(img_y + i, x), 0,
+                                                canvas.ptr<ushort>(img_y + i - cy0, x - cx0), 0,
                                                 Size(tile_width, 1));
                                         }
                                         else
                                         {
                                             CV_CheckEQ(wanted_channels, 3, "TIFF-16bpp: BGR/BGRA images are supported only");
                                             icvCvt_BGRA2BGR_16u_C4C3R(buffer16, 0,
-                                                img.ptr<ushort>(img_y + i, x), 0,
+                                                canvas.ptr<ushort>(img_y + i - cy0, x - cx0), 0,
                                                 Size(tile_width, 1), 2);
                                         }
                                     }
@@ -1006,14 +1041,14 @@ bool  TiffDecoder::readData( Mat& img )
                                     CV_CheckEQ(wanted_channels, 1, "");
                                     if( ncn == 1 )
                                     {
-                                        memcpy(img.ptr<ushort>(img_y + i, x),
+                                        memcpy(canvas.ptr<ushort>(img_y + i - cy0, x - cx0),
                                                buffer16,
                                                tile_width*sizeof(ushort));
                                     }
                                     else
                                     {
                                         icvCvt_BGRA2Gray_16u_CnC1R(buffer16, 0,
-                                                img.ptr<ushort>(img_y + i, x), 0,
+                                                canvas.ptr<ushort>(img_y + i - cy0, x - cx0), 0,
                                                 Size(tile_width, 1), ncn, 2);
                                     }
                                 }
@@ -1035,13 +1070,13 @@ bool  TiffDecoder::readData( Mat& img )
 
                             Mat m_tile(Size(tile_width0, tile_height0), CV_MAKETYPE((dst_bpp == 32) ? (depth == CV_32S ? CV_32S : CV_32F) : CV_64F, ncn), src_buffer);
                             Rect roi_tile(0, 0, tile_width, tile_height);
-                            Rect roi_img(x, img_y, tile_width, tile_height);
+                            Rect roi_img(x - cx0, img_y - cy0, tile_width, tile_height);
                             if (!m_hdr && ncn == 3)
-                                extend_cvtColor(m_tile(roi_tile), img(roi_img), COLOR_RGB2BGR);
+                                extend_cvtColor(m_tile(roi_tile), canvas(roi_img), COLOR_RGB2BGR);
                             else if (!m_hdr && ncn == 4)
-                                extend_cvtColor(m_tile(roi_tile), img(roi_img), COLOR_RGBA2BGRA);
+                                extend_cvtColor(m_tile(roi_tile), canvas(roi_img), COLOR_RGBA2BGRA);
                             else
-                                m_tile(roi_tile).copyTo(img(roi_img));
+                                m_tile(roi_tile).copyTo(canvas(roi_img));
                             break;
                         }
                         default:
@@ -1051,14 +1086,20 @@ bool  TiffDecoder::readData( Mat& img )
                     }  // switch (dst_bpp)
                 }  // for x
             }  // for y
-        }
-        if (bpp < dst_bpp)
-          img *= (1<<(dst_bpp-bpp));
 
-        // If TIFFReadRGBA* function is used -> fixOrientationPartial().
-        // Otherwise                         -> fixOrientationFull().
-        fixOrientation(img, img_orientation,
-                       ( ( dst_bpp != 8 ) && ( !doReadScanline ) ) );
+            if (bpp < dst_bpp)
+              canvas *= (1<<(dst_bpp-bpp));
+
+            // If TIFFReadRGBA* function is used -> fixOrientationPartial().
+            // Otherwise                         -> fixOrientationFull().
+            fixOrientation(canvas, img_orientation,
+                           ( ( dst_bpp != 8 ) && ( !doReadScanline ) ) );
+
+            if (m_roi.empty())
+                img = canvas;  // orientation fix may reallocate it
+            else
+                canvas(Rect(m_roi.tl() - canvas_rect.tl(), m_roi.size())).copyTo(img);
+        }
     }
 
     if (m_hdr && depth >= CV_32F)
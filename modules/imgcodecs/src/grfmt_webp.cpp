@@ -148,12 +148,19 @@ bool WebPDecoder::readHeader()
     return false;
 }
 
+bool WebPDecoder::setROI(const Rect& roi)
+{
+    m_roi = roi;
+    return true;
+}
+
 bool WebPDecoder::readData(Mat &img)
 {
     CV_CheckGE(m_width, 0, ""); CV_CheckGE(m_height, 0, "");
 
-    CV_CheckEQ(img.cols, m_width, "");
-    CV_CheckEQ(img.rows, m_height, "");
+    const Rect roi = m_roi.empty() ? Rect(0, 0, m_width, m_height) : m_roi;
+    CV_CheckEQ(img.cols, roi.width, "");
+    CV_CheckEQ(img.rows, roi.height, "");
 
     if (m_buf.empty())
     {
@@ -166,11 +173,14 @@ bool WebPDecoder::readData(Mat &img)
     CV_Assert(data.type() == CV_8UC1); CV_Assert(data.rows == 1);
 
     {
+        // libwebp crops from even coordinates only
+        const Rect region(roi.x & ~1, roi.y & ~1, roi.width + (roi.x & 1), roi.height + (roi.y & 1));
+
         Mat read_img;
         CV_CheckType(img.type(), img.type() == CV_8UC1 || img.type() == CV_8UC3 || img.type() == CV_8UC4, "");
-        if (img.type() != m_type)
+        if (img.type() != m_type || region != roi)
         {
-            read_img.create(m_height, m_width, m_type);
+            read_img.create(region.height, region.width, m_type);
         }
         else
         {
@@ -180,16 +190,33 @@ bool WebPDecoder::readData(Mat &img)
         uchar* out_data = read_img.ptr();
         size_t out_data_size = read_img.dataend - out_data;
 
+        CV_CheckTypeEQ(read_img.type(), channels == 3 ? CV_8UC3 : CV_8UC4, "");
         uchar *res_ptr = NULL;
-        if (channels == 3)
+        if (!m_roi.empty())
+        {
+            WebPDecoderConfig config;
+            CV_Assert(WebPInitDecoderConfig(&config));
+            config.options.use_cropping = 1;
+            config.options.crop_left = region.x;
+            config.options.crop_top = region.y;
+            config.options.crop_width = region.width;
+            config.options.crop_height = region.height;
+            config.output.colorspace = channels == 3 ? MODE_BGR : MODE_BGRA;
+            config.output.is_external_memory = 1;
+            config.output.u.RGBA.rgba = out_data;
+            config.output.u.RGBA.stride = (int)read_img.step;
+            config.output.u.RGBA.size = out_data_size;
+            if (WebPDecode(data.ptr(), data.total(), &config) == VP8_STATUS_OK)
+                res_ptr = out_data;
+            WebPFreeDecBuffer(&config.output);
+        }
+        else if (channels == 3)
         {
-            CV_CheckTypeEQ(read_img.type(), CV_8UC3, "");
             res_ptr = WebPDecodeBGRInto(data.ptr(), data.total(), out_data,
                                         (int)out_data_size, (int)read_img.step);
         }
         else if (channels == 4)
         {
-            CV_CheckTypeEQ(read_img.type(), CV_8UC4, "");
             res_ptr = WebPDecodeBGRAInto(data.ptr(), data.total(), out_data,
                                          (int)out_data_size, (int)read_img.step);
         }
@@ -197,10 +224,17 @@ bool WebPDecoder::readData(Mat &img)
         if (res_ptr != out_data)
             return false;
 
+        if (read_img.data != img.data)
+            read_img = read_img(Rect(roi.tl() - region.tl(), roi.size()));
+
         if (read_img.data == img.data && img.type() == m_type)
         {
             // nothing
         }
+        else if (img.type() == m_type)
+        {
+            read_img.copyTo(img);
+        }
         else if (img.type() == CV_8UC1)
         {
             cvtColor(read_img, img, COLOR_BGR2GRAY);
@@ -52,6 +52,9 @@
 #include <iostream>
 #include <fstream>
 #include <cerrno>
+#include <atomic>
+#include <exception>
+#include <opencv2/core/utils/tls.hpp>
 #include <opencv2/core/utils/logger.hpp>
 #include <opencv2/core/utils/configuration.private.hpp>
 #include <opencv2/imgcodecs.hpp>
@@ -80,6 +83,33 @@ static Size validateInputImageSize(const Size& size)
     return size;
 }
 
+static void parseImreadParams(const std::vector<int>& params, int& scale_denom, Rect& roi)
+{
+    CV_Check(params.size(), (params.size() & 1) == 0, "Encoding 'params' must be key-value pairs");
+    CV_CheckLE(params.size(), (size_t)(CV_IO_MAX_IMAGE_PARAMS*2), "");
+    for (size_t i = 0; i < params.size(); i += 2)
+    {
+        const int value = params[i + 1];
+        switch (params[i])
+        {
+        case IMREAD_PARAM_SCALE_DENOM:
+            CV_Check(value, value == 1 || value == 2 || value == 4 || value == 8, "Scale denominator must be 1, 2, 4 or 8");
+            scale_denom = value;
+            break;
+        case IMREAD_PARAM_ROI_X: roi.x = value; break;
+        case IMREAD_PARAM_ROI_Y: roi.y = value; break;
+        case IMREAD_PARAM_ROI_WIDTH: roi.width = value; break;
+        case IMREAD_PARAM_ROI_HEIGHT: roi.height = value; break;
+        default:
+            CV_Error(Error::StsBadArg, cv::format("Unknown imread parameter: %d", params[i]));
+        }
+    }
+    CV_CheckGE(roi.width, 0, ""); CV_CheckGE(roi.height, 0, "");
+    CV_CheckEQ(roi.width == 0, roi.height == 0, "Both ROI width and height must be specified");
+    if (roi.width == 0 && (roi.x != 0 || roi.y != 0))
+        CV_Error(Error::StsBadArg, "ROI width and height must be specified along with ROI position");
+}
+
 
 namespace {
 
@@ -259,13 +289,11 @@ static ImageDecoder findDecoder( const String& filename ) {
     return ImageDecoder();
 }
 
-static ImageDecoder findDecoder( const Mat& buf )
+/// Returns the leading bytes of buf to be matched against the signatures of all decoders
+static String getSignature( const Mat& buf )
 {
     size_t i, maxlen = 0;
 
-    if( buf.rows*buf.cols < 1 || !buf.isContinuous() )
-        return ImageDecoder();
-
     ImageCodecInitializer& codecs = getCodecs();
     for( i = 0; i < codecs.decoders.size(); i++ )
     {
@@ -277,6 +305,18 @@ static ImageDecoder findDecoder( const Mat& buf )
     size_t bufSize = buf.rows*buf.cols*buf.elemSize();
     maxlen = std::min(maxlen, bufSize);
     memcpy( (void*)signature.c_str(), buf.data, maxlen );
+    return signature;
+}
+
+static ImageDecoder findDecoder( const Mat& buf )
+{
+    size_t i;
+
+    if( buf.rows*buf.cols < 1 || !buf.isContinuous() )
+        return ImageDecoder();
+
+    ImageCodecInitializer& codecs = getCodecs();
+    String signature = getSignature(buf);
 
     for( i = 0; i < codecs.decoders.size(); i++ )
     {
@@ -287,6 +327,29 @@ static ImageDecoder findDecoder( const Mat& buf )
     return ImageDecoder();
 }
 
+/**
+ * Same lookup as findDecoder(), but the decoder instance of the codec is taken from @p decoders
+ * (created there on the first use), so it is reused by the following calls.
+ * Returns NULL for unknown formats.
+ */
+static ImageDecoder* findCachedDecoder( std::vector<ImageDecoder>& decoders, const Mat& buf_row )
+{
+    ImageCodecInitializer& codecs = getCodecs();
+    String signature = getSignature(buf_row);
+    size_t idx = 0;
+    while( idx < codecs.decoders.size() && !codecs.decoders[idx]->checkSignature(signature) )
+        idx++;
+    if( idx == codecs.decoders.size() )
+        return NULL;
+
+    if( decoders.size() < codecs.decoders.size() )
+        decoders.resize(codecs.decoders.size());
+    ImageDecoder* slot = &decoders[idx];
+    if( !*slot )
+        *slot = codecs.decoders[idx]->newDecoder();
+    return slot;
+}
+
 static ImageEncoder findEncoder( const String& _ext )
 {
     if( _ext.size() <= 1 )
@@ -385,7 +448,7 @@ static void ApplyExifOrientation(ExifEntry_t orientationTag, Mat& img)
  *
 */
 static bool
-imread_( const String& filename, int flags, Mat& mat )
+imread_( const String& filename, int flags, Mat& mat, const std::vector<int>& params = std::vector<int>() )
 {
     /// Search for the relevant decoder to handle the imagery
     ImageDecoder decoder;
@@ -415,6 +478,8 @@ imread_( const String& filename, int flags, Mat& mat )
         else if( flags & IMREAD_REDUCED_GRAYSCALE_8 )
             scale_denom = 8;
     }
+    Rect roi;
+    parseImreadParams(params, scale_denom, roi);
 
     /// set the scale_denom in the driver
     decoder->setScale( scale_denom );
@@ -457,13 +522,35 @@ imread_( const String& filename, int flags, Mat& mat )
             type = CV_MAKETYPE(CV_MAT_DEPTH(type), 1);
     }
 
-    mat.create( size.height, size.width, type );
+    // if decoder is JpegDecoder then decoder->setScale always returns 1
+    const bool needResize = decoder->setScale( scale_denom ) > 1;
+    const Size dsize = needResize ? Size( size.width / scale_denom, size.height / scale_denom ) : size;
+
+    const bool hasROI = !roi.empty();
+    roi &= Rect(Point(), dsize);
+    if( hasROI && roi.empty() )
+    {
+        CV_LOG_WARNING(NULL, "imread_('" << filename << "'): region of interest is outside of the image " << dsize);
+        return false;
+    }
+    const bool nativeROI = !roi.empty() && !needResize && decoder->setROI( roi );
+    const bool direct = !needResize && (roi.empty() || nativeROI);
+
+    // decode straight into the result unless it is resized or cropped afterwards
+    Mat decoded;
+    if( direct )
+    {
+        mat.create( nativeROI ? roi.size() : size, type );
+        decoded = mat;
+    }
+    else
+        decoded.create( size.height, size.width, type );
 
     // read the image data
     bool success = false;
     try
     {
-        if (decoder->readData(mat))
+        if (decoder->readData(decoded))
             success = true;
     }
     catch (const cv::Exception& e)
@@ -480,13 +567,19 @@ imread_( const String& filename, int flags, Mat& mat )
         return false;
     }
 
-    if( decoder->setScale( scale_denom ) > 1 ) // if decoder is JpegDecoder then decoder->setScale always returns 1
+    if( !direct )
     {
-        resize( mat, mat, Size( size.width / scale_denom, size.height / scale_denom ), 0, 0, INTER_LINEAR_EXACT);
+        Mat full = decoded;
+        if( needResize )
+            resize( decoded, full, dsize, 0, 0, INTER_LINEAR_EXACT );
+        if( roi.empty() )
+            mat = full;
+        else
+            full( roi ).copyTo( mat );
     }
 
     /// optionally rotate the data if EXIF orientation flag says so
-    if (!mat.empty() && (flags & IMREAD_IGNORE_ORIENTATION) == 0 && flags != IMREAD_UNCHANGED )
+    if (!mat.empty() && roi.empty() && (flags & IMREAD_IGNORE_ORIENTATION) == 0 && flags != IMREAD_UNCHANGED )
     {
         ApplyExifOrientation(decoder->getExifTag(ORIENTATION), mat);
     }
@@ -495,6 +588,126 @@ imread_( const String& filename, int flags, Mat& mat )
 }
 
 
+/// Decodes one page of a multi-page image at the current position of the decoder
+static bool readPage_(const ImageDecoder& decoder, int flags, Mat& mat)
+{
+    int type = decoder->type();
+    if ((flags & IMREAD_LOAD_GDAL) != IMREAD_LOAD_GDAL && flags != IMREAD_UNCHANGED)
+    {
+        if ((flags & IMREAD_ANYDEPTH) == 0)
+            type = CV_MAKETYPE(CV_8U, CV_MAT_CN(type));
+
+        if ((flags & IMREAD_COLOR) != 0 ||
+            ((flags & IMREAD_ANYCOLOR) != 0 && CV_MAT_CN(type) > 1))
+            type = CV_MAKETYPE(CV_MAT_DEPTH(type), 3);
+        else
+            type = CV_MAKETYPE(CV_MAT_DEPTH(type), 1);
+    }
+
+    Size size = validateInputImageSize(Size(decoder->width(), decoder->height()));
+    mat.create(size.height, size.width, type);
+    bool success = false;
+    try
+    {
+        if (decoder->readData(mat))
+            success = true;
+    }
+    catch (const cv::Exception& e)
+    {
+        CV_LOG_ERROR(NULL, "readPage_(): can't read data: " << e.what());
+    }
+    catch (...)
+    {
+        CV_LOG_ERROR(NULL, "readPage_(): can't read data: unknown exception");
+    }
+    if (!success)
+        return false;
+
+    if ((flags & IMREAD_IGNORE_ORIENTATION) == 0 && flags != IMREAD_UNCHANGED)
+    {
+        ApplyExifOrientation(decoder->getExifTag(ORIENTATION), mat);
+    }
+    return true;
+}
+
+/**
+ * Decodes pages [start, start + pages.size()) of a multi-page image in parallel.
+ *
+ * The range is split into at most getNumThreads() contiguous chunks. Every chunk gets its own
+ * decoder instance, which jumps to the first page of the chunk with gotoPage() and then decodes
+ * the chunk sequentially, so no more than one decoder per thread is alive at a time.
+ * Pages that can't be decoded are left empty. Exceptions other than decoding errors (e.g. from
+ * validateInputImageSize()) are rethrown after all chunks finish, if the sequential loop would
+ * have reached the failing page, i.e. all pages before it were decoded.
+ *
+ * @param[in] proto decoder used to create the per-thread decoders
+ * @param[in] filename source file, used when buf is empty
+ * @param[in] buf source buffer
+*/
+static void decodePagesParallel_(const ImageDecoder& proto, const String& filename, const Mat& buf,
+                                 int flags, int start, std::vector<Mat>& pages)
+{
+    const int npages = (int)pages.size();
+    const int nchunks = std::min(npages, std::max(getNumThreads(), 1));
+    Mutex errorMutex;
+    std::exception_ptr error;
+    int errorPage = npages;
+    parallel_for_(Range(0, nchunks), [&](const Range& r)
+    {
+        for (int chunk = r.start; chunk < r.end; chunk++)
+        {
+            const int first = (int)((int64)npages * chunk / nchunks);
+            const int last = (int)((int64)npages * (chunk + 1) / nchunks);
+            int i = first;
+            try
+            {
+                ImageDecoder decoder = proto->newDecoder();
+                if (buf.empty() ? !decoder->setSource(filename) : !decoder->setSource(buf))
+                    continue;
+                if (!decoder->readHeader() || !decoder->gotoPage(start + first))
+                    continue;
+                for (; i < last; i++)
+                {
+                    if (!readPage_(decoder, flags, pages[i]))
+                    {
+                        pages[i].release();
+                        break;
+                    }
+                    if (i + 1 < last && !decoder->nextPage())
+                        break;
+                }
+            }
+            catch (...)
+            {
+                pages[i].release();
+                AutoLock lock(errorMutex);
+                if (i < errorPage)
+                {
+                    errorPage = i;
+                    error = std::current_exception();
+                }
+            }
+        }
+    }, nchunks);
+
+    if (error)
+    {
+        for (int i = 0; i < errorPage; i++)
+            if (pages[i].empty())
+                return;
+        std::rethrow_exception(error);
+    }
+}
+
+/// Counts up to count pages starting from the current one, leaves the decoder on the last of them
+static int countPages_(const ImageDecoder& decoder, int count)
+{
+    int npages = 1;
+    while (npages < count && decoder->nextPage())
+        ++npages;
+    return npages;
+}
+
 static bool
 imreadmulti_(const String& filename, int flags, std::vector<Mat>& mats, int start, int count)
 {
@@ -544,6 +757,16 @@ imreadmulti_(const String& filename, int flags, std::vector<Mat>& mats, int star
         return 0;
     }
 
+    // decoders with random page access decode the pages concurrently
+    if (count > 1 && getNumThreads() > 1 && decoder->gotoPage(start))
+    {
+        std::vector<Mat> pages(countPages_(decoder, count));
+        decodePagesParallel_(decoder, filename, Mat(), flags, start, pages);
+        for (size_t i = 0; i < pages.size() && !pages[i].empty(); i++)
+            mats.push_back(pages[i]);
+        return !mats.empty();
+    }
+
     int current = start;
 
     while (current > 0)
@@ -632,6 +855,15 @@ Mat imread( const String& filename, int flags )
     return img;
 }
 
+Mat imread( const String& filename, int flags, const std::vector<int>& params )
+{
+    CV_TRACE_FUNCTION();
+
+    Mat img;
+    imread_( filename, flags, img, params );
+    return img;
+}
+
 /**
 * Read a multi-page image
 *
@@ -788,8 +1020,19 @@ bool imwrite( const String& filename, InputArray _img,
     return imwrite_(filename, img_vec, params, false);
 }
 
+/**
+ * Decode an image from memory
+ *
+ * @param[in] buf Encoded image data
+ * @param[in] flags Flags
+ * @param[in,out] mat Destination matrix
+ * @param[in] inplace If true, @p mat must already have the decoded size and type and is never reallocated
+ * @param[in] params Decoding parameters ( see ImreadParams )
+ *
+*/
 static bool
-imdecode_( const Mat& buf, int flags, Mat& mat )
+imdecode_( const Mat& buf, int flags, Mat& mat, bool inplace = false, const std::vector<int>& params = std::vector<int>(),
+           ImageDecoder decoder = ImageDecoder() )
 {
     CV_Assert(!buf.empty());
     CV_Assert(buf.isContinuous());
@@ -798,7 +1041,8 @@ imdecode_( const Mat& buf, int flags, Mat& mat )
 
     String filename;
 
-    ImageDecoder decoder = findDecoder(buf_row);
+    if( !decoder )
+        decoder = findDecoder(buf_row);
     if( !decoder )
         return false;
 
@@ -812,6 +1056,8 @@ imdecode_( const Mat& buf, int flags, Mat& mat )
         else if( flags & IMREAD_REDUCED_GRAYSCALE_8 )
             scale_denom = 8;
     }
+    Rect roi;
+    parseImreadParams(params, scale_denom, roi);
 
     /// set the scale_denom in the driver
     decoder->setScale( scale_denom );
@@ -878,12 +1124,53 @@ imdecode_( const Mat& buf, int flags, Mat& mat )
             type = CV_MAKETYPE(CV_MAT_DEPTH(type), 1);
     }
 
-    mat.create( size.height, size.width, type );
+    // if decoder is JpegDecoder then decoder->setScale always returns 1
+    const bool needResize = decoder->setScale( scale_denom ) > 1;
+    const Size dsize = needResize ? Size( size.width / scale_denom, size.height / scale_denom ) : size;
+
+    const bool hasROI = !roi.empty();
+    roi &= Rect(Point(), dsize);
+    const Size outSize = roi.empty() ? dsize : roi.size();
+
+    if( (hasROI && roi.empty()) || (inplace && (mat.size() != outSize || mat.type() != type)) )
+    {
+        if( hasROI && roi.empty() )
+        {
+            CV_LOG_WARNING(NULL, "imdecode_('" << filename << "'): region of interest is outside of the image " << dsize);
+        }
+        else
+        {
+            CV_LOG_ERROR(NULL, "imdecode_('" << filename << "'): destination " << mat.size() << " of type " << typeToString(mat.type())
+                         << " does not match decoded image " << outSize << " of type " << typeToString(type));
+        }
+        if (!filename.empty())
+        {
+            if (0 != remove(filename.c_str()))
+            {
+                CV_LOG_WARNING(NULL, "unable to remove temporary file: " << filename);
+            }
+        }
+        return false;
+    }
+
+    const bool nativeROI = !roi.empty() && !needResize && decoder->setROI( roi );
+    const bool direct = !needResize && (roi.empty() || nativeROI);
+
+    // decode straight into the destination unless it is resized or cropped afterwards
+    Mat decoded;
+    if( direct )
+    {
+        if( !inplace )
+            mat.create( outSize, type );
+        decoded = mat;
+    }
+    else
+        decoded.create( size.height, size.width, type );
 
     success = false;
     try
     {
-        if (decoder->readData(mat))
+        if (decoder->readData(decoded))
             success = true;
     }
     catch (const cv::Exception& e)
@@ -908,13 +1195,22 @@ imdecode_( const Mat& buf, int flags, Mat& mat )
         return false;
     }
 
-    if( decoder->setScale( scale_denom ) > 1 ) // if decoder is JpegDecoder then decoder->setScale always returns 1
+    if( !direct )
     {
-        resize(mat, mat, Size( size.width / scale_denom, size.height / scale_denom ), 0, 0, INTER_LINEAR_EXACT);
+        // when decoding in place mat already has outSize, so it is filled without reallocation
+        if( roi.empty() )
+            resize(decoded, mat, dsize, 0, 0, INTER_LINEAR_EXACT);
+        else
+        {
+            Mat full = decoded;
+            if( needResize )
+                resize(decoded, full, dsize, 0, 0, INTER_LINEAR_EXACT);
+            full(roi).copyTo(mat);
+        }
     }
 
     /// optionally rotate the data if EXIF' orientation flag says so
-    if (!mat.empty() && (flags & IMREAD_IGNORE_ORIENTATION) == 0 && flags != IMREAD_UNCHANGED)
+    if (!inplace && roi.empty() && !mat.empty() && (flags & IMREAD_IGNORE_ORIENTATION) == 0 && flags != IMREAD_UNCHANGED)
     {
         ApplyExifOrientation(decoder->getExifTag(ORIENTATION), mat);
     }
@@ -934,6 +1230,17 @@ Mat imdecode( InputArray _buf, int flags )
     return img;
 }
 
+Mat imdecode( InputArray _buf, int flags, const std::vector<int>& params )
+{
+    CV_TRACE_FUNCTION();
+
+    Mat buf = _buf.getMat(), img;
+    if (!imdecode_(buf, flags, img, false, params))
+        img.release();
+
+    return img;
+}
+
 Mat imdecode( InputArray _buf, int flags, Mat* dst )
 {
     CV_TRACE_FUNCTION();
@@ -946,6 +1253,63 @@ Mat imdecode( InputArray _buf, int flags, Mat* dst )
         return cv::Mat();
 }
 
+// decoders kept between the imdecodeTo() calls, per thread and codec
+static TLSData<std::vector<ImageDecoder> >& getImdecodeToDecoders()
+{
+    static TLSData<std::vector<ImageDecoder> >* decoders = new TLSData<std::vector<ImageDecoder> >();
+    return *decoders;
+}
+
+bool imdecodeTo( InputArray _buf, int flags, InputOutputArray _dst )
+{
+    CV_TRACE_FUNCTION();
+
+    Mat buf = _buf.getMat();
+    CV_Assert(!buf.empty());
+    CV_Assert(buf.isContinuous());
+    CV_Assert(buf.checkVector(1, CV_8U) > 0);
+
+    ImageDecoder* slot = findCachedDecoder(getImdecodeToDecoders().getRef(), buf.reshape(1, 1));
+    if (!slot)
+        return false;
+
+    bool success = false;
+    try
+    {
+        if (_dst.empty())
+        {
+            if (_dst.kind() == _InputArray::MAT)
+            {
+                // allocated by the destination's own allocator (if any)
+                success = imdecode_(buf, flags, _dst.getMatRef(), false, std::vector<int>(), *slot);
+            }
+            else
+            {
+                Mat img;
+                success = imdecode_(buf, flags, img, false, std::vector<int>(), *slot);
+                if (success)
+                    img.copyTo(_dst);
+            }
+        }
+        else
+        {
+            CV_Assert(_dst.dims() <= 2);
+            Mat dst = _dst.getMat();
+            success = imdecode_(buf, flags, dst, true, std::vector<int>(), *slot);
+        }
+    }
+    catch (...)
+    {
+        slot->release();
+        throw;
+    }
+
+    // don't reuse a decoder which has failed in the middle of an image
+    if (!success)
+        slot->release();
+    return success;
+}
+
 static bool
 imdecodemulti_(const Mat& buf, int flags, std::vector<Mat>& mats, int start, int count)
 {
@@ -1000,6 +1364,31 @@ imdecodemulti_(const Mat& buf, int flags, std::vector<Mat>& mats, int start, int
         CV_LOG_ERROR(NULL, "imreadmulti_('" << filename << "'): can't read header: unknown exception");
     }
 
+    // decoders with random page access decode the pages concurrently
+    if (success && count > 1 && getNumThreads() > 1 && decoder->gotoPage(start))
+    {
+        std::vector<Mat> pages(countPages_(decoder, count));
+        decodePagesParallel_(decoder, filename, filename.empty() ? buf_row : Mat(), flags, start, pages);
+        for (size_t i = 0; i < pages.size(); i++)
+        {
+            if (pages[i].empty())
+            {
+                mats.clear();
+                break;
+            }
+            mats.push_back(pages[i]);
+        }
+
+        if (!filename.empty())
+        {
+            if (0 != remove(filename.c_str()))
+            {
+                CV_LOG_WARNING(NULL, "unable to remove temporary file: " << filename);
+            }
+        }
+        return !mats.empty();
+    }
+
     int current = start;
     while (success && current > 0)
     {
@@ -1106,6 +1495,133 @@ bool imdecodemulti(InputArray _buf, int flags, CV_OUT std::vector<Mat>& mats, co
     }
 }
 
+/* ImageBatchDecoder */
+
+class ImageBatchDecoder::Impl
+{
+public:
+    explicit Impl(int flags) : m_flags(flags) {}
+    int decode(InputArrayOfArrays bufs, std::vector<Mat>& mats, std::vector<String>* errors);
+
+private:
+    bool decodeItem(std::vector<ImageDecoder>& decoders, const Mat& buf, Mat& mat, String& error) const;
+
+    int m_flags;
+    // decoders kept alive between the items and the batches, per parallel chunk and codec
+    std::vector<std::vector<ImageDecoder> > m_decoders;
+};
+
+bool ImageBatchDecoder::Impl::decodeItem(std::vector<ImageDecoder>& decoders, const Mat& buf, Mat& mat, String& error) const
+{
+    mat.release();
+    if (buf.empty())
+    {
+        error = "empty buffer";
+        return false;
+    }
+    ImageDecoder* slot = NULL;
+    try
+    {
+        if (!buf.isContinuous() || buf.depth() != CV_8U)
+        {
+            error = "buffer must be a continuous array of bytes";
+            return false;
+        }
+        Mat buf_row = buf.reshape(1, 1);
+
+        // the decoder instance of this chunk is reused
+        slot = findCachedDecoder(decoders, buf_row);
+        if (!slot)
+        {
+            error = "unknown image format";
+            return false;
+        }
+
+        if (!imdecode_(buf_row, m_flags, mat, false, std::vector<int>(), *slot) || mat.empty())
+        {
+            slot->release(); // don't reuse a decoder which has failed in the middle of an image
+            mat.release();
+            error = "can't decode image";
+            return false;
+        }
+    }
+    catch (const cv::Exception& e)
+    {
+        if (slot)
+            slot->release();
+        mat.release();
+        error = e.what();
+        return false;
+    }
+    catch (...)
+    {
+        if (slot)
+            slot->release();
+        mat.release();
+        error = "unknown exception";
+        return false;
+    }
+    error.clear();
+    return true;
+}
+
+int ImageBatchDecoder::Impl::decode(InputArrayOfArrays bufs, std::vector<Mat>& mats, std::vector<String>* errors)
+{
+    const int n = (int)bufs.total();
+    std::vector<Mat> inputs(n);
+    for (int i = 0; i < n; i++)
+        inputs[i] = bufs.getMat(i);
+
+    mats.resize(n);
+    std::vector<String> messages(n);
+    std::vector<uchar> status(n, 0);
+    if (n == 0)
+    {
+        if (errors)
+            errors->clear();
+        return 0;
+    }
+
+    const int nchunks = std::min(n, std::max(getNumThreads(), 1));
+    if ((int)m_decoders.size() < nchunks)
+        m_decoders.resize(nchunks);
+
+    // chunks pick the items one by one, so that a few large images don't stall a whole chunk
+    std::atomic<int> next(0);
+    parallel_for_(Range(0, nchunks), [&](const Range& r)
+    {
+        for (int chunk = r.start; chunk < r.end; chunk++)
+        {
+            for (int i = next++; i < n; i = next++)
+                status[i] = decodeItem(m_decoders[chunk], inputs[i], mats[i], messages[i]) ? 1 : 0;
+        }
+    }, nchunks);
+
+    if (errors)
+        errors->swap(messages);
+    return (int)std::count(status.begin(), status.end(), (uchar)1);
+}
+
+ImageBatchDecoder::ImageBatchDecoder(int flags) : pImpl(makePtr<Impl>(flags)) {}
+
+int ImageBatchDecoder::decode(InputArrayOfArrays bufs, std::vector<Mat>& mats, std::vector<String>& errors)
+{
+    CV_TRACE_FUNCTION();
+    return pImpl->decode(bufs, mats, &errors);
+}
+
+int ImageBatchDecoder::decode(InputArrayOfArrays bufs, std::vector<Mat>& mats)
+{
+    CV_TRACE_FUNCTION();
+    return pImpl->decode(bufs, mats, NULL);
+}
+
+int imdecodeBatch(InputArrayOfArrays bufs, int flags, std::vector<Mat>& mats)
+{
+    CV_TRACE_FUNCTION();
+    return ImageBatchDecoder(flags).decode(bufs, mats);
+}
+
 bool imencode( const String& ext, InputArray _image,
                std::vector<uchar>& buf, const std::vector<int>& params_ )
 {
@@ -1181,6 +1697,162 @@ bool imencode( const String& ext, InputArray _image,
     return code;
 }
 
+/* ImageStreamEncoder */
+
+class ImageStreamEncoder::Impl
+{
+public:
+    Impl() : m_type(-1), m_rows(0), m_opened(false) {}
+    bool open(const String& ext, Size size, int type, const Sink& sink, const std::vector<int>& params);
+    bool isOpened() const { return m_opened; }
+    bool write(InputArray strip);
+    bool finish();
+    void close();
+
+private:
+    ImageEncoder m_encoder; // incremental encoder, empty if the image is collected for imencode()
+    String m_ext;
+    Size m_size;
+    int m_type;
+    int m_rows;             // rows written so far
+    bool m_convert;         // strips are converted to CV_8U for the encoder
+    std::vector<int> m_params;
+    Sink m_sink;
+    Mat m_image;            // the whole image for the encoders without incremental encoding
+    bool m_opened;
+};
+
+void ImageStreamEncoder::Impl::close()
+{
+    m_encoder.release();
+    m_image.release();
+    m_sink = Sink();
+    m_rows = 0;
+    m_opened = false;
+}
+
+bool ImageStreamEncoder::Impl::open(const String& ext, Size size, int type, const Sink& sink, const std::vector<int>& params)
+{
+    close();
+
+    CV_Assert(!size.empty());
+    CV_Assert(sink);
+    int channels = CV_MAT_CN(type);
+    CV_Assert( channels == 1 || channels == 3 || channels == 4 );
+    CV_Check(params.size(), (params.size() & 1) == 0, "Encoding 'params' must be key-value pairs");
+    CV_CheckLE(params.size(), (size_t)(CV_IO_MAX_IMAGE_PARAMS*2), "");
+
+    ImageEncoder encoder = findEncoder( ext );
+    if( !encoder )
+        CV_Error( Error::StsError, "could not find encoder for the specified extension" );
+
+    m_convert = !encoder->isFormatSupported(CV_MAT_DEPTH(type));
+    if( m_convert )
+        CV_Assert( encoder->isFormatSupported(CV_8U) );
+
+    m_ext = ext;
+    m_size = size;
+    m_type = type;
+    m_params = params;
+    m_sink = sink;
+    if( encoder->writeBegin(size, m_convert ? CV_MAKETYPE(CV_8U, channels) : type, params, sink) )
+        m_encoder = encoder;
+    else
+        m_image.create(size, type);
+    m_opened = true;
+    return true;
+}
+
+bool ImageStreamEncoder::Impl::write(InputArray _strip)
+{
+    if( !m_opened )
+        return false;
+
+    Mat strip = _strip.getMat();
+    CV_CheckEQ(strip.cols, m_size.width, "Strip must have the width of the image");
+    CV_CheckTypeEQ(strip.type(), m_type, "Strip must have the type of the image");
+    CV_CheckLE(m_rows + strip.rows, m_size.height, "Too many rows are written");
+
+    if( m_encoder )
+    {
+        if( m_convert )
+        {
+            Mat temp;
+            strip.convertTo(temp, CV_8U);
+            strip = temp;
+        }
+        if( !m_encoder->writeRows(strip) )
+        {
+            CV_LOG_ERROR(NULL, "ImageStreamEncoder('" << m_ext << "'): can't encode rows " << m_rows << ".." << m_rows + strip.rows);
+            close();
+            return false;
+        }
+    }
+    else
+        strip.copyTo(m_image.rowRange(m_rows, m_rows + strip.rows));
+    m_rows += strip.rows;
+    return true;
+}
+
+bool ImageStreamEncoder::Impl::finish()
+{
+    if( !m_opened )
+        return false;
+
+    bool result = false;
+    if( m_rows != m_size.height )
+    {
+        CV_LOG_ERROR(NULL, "ImageStreamEncoder('" << m_ext << "'): only " << m_rows << " of " << m_size.height << " rows are written");
+    }
+    else if( m_encoder )
+    {
+        result = m_encoder->writeEnd();
+    }
+    else
+    {
+        std::vector<uchar> buf;
+        result = imencode(m_ext, m_image, buf, m_params);
+        m_image.release();
+        if( result )
+        {
+            try
+            {
+                result = m_sink(buf.data(), buf.size());
+            }
+            catch (...)
+            {
+                result = false; // same as for the incremental encoders, which can't pass exceptions through
+            }
+        }
+    }
+    close();
+    return result;
+}
+
+ImageStreamEncoder::ImageStreamEncoder() : pImpl(makePtr<Impl>()) {}
+
+ImageStreamEncoder::~ImageStreamEncoder() {}
+
+bool ImageStreamEncoder::open(const String& ext, Size size, int type, const Sink& sink, const std::vector<int>& params)
+{
+    CV_TRACE_FUNCTION();
+    return pImpl->open(ext, size, type, sink, params);
+}
+
+bool ImageStreamEncoder::isOpened() const { return pImpl->isOpened(); }
+
+bool ImageStreamEncoder::write(InputArray strip)
+{
+    CV_TRACE_FUNCTION();
+    return pImpl->write(strip);
+}
+
+bool ImageStreamEncoder::finish()
+{
+    CV_TRACE_FUNCTION();
+    return pImpl->finish();
+}
+
 bool haveImageReader( const String& filename )
 {
     ImageDecoder decoder = cv::findDecoder(filename);
@@ -1220,6 +1892,7 @@ private:
     int m_width{};
     int m_height{};
     int m_current{};
+    bool m_randomAccess{};
     std::vector<cv::Mat> m_pages;
     ImageDecoder m_decoder;
 };
@@ -1268,6 +1941,9 @@ void ImageCollection::Impl::init(String const& filename, int flags) {
 
     m_decoder->setSource(m_filename);
     m_decoder->readHeader();
+    m_current = 0;
+    // the decoder is already on the first page, this only probes for random page access
+    m_randomAccess = m_size > 1 && m_decoder->gotoPage(0);
 }
 
 size_t ImageCollection::Impl::size() const { return m_size; }
@@ -1365,6 +2041,17 @@ Mat& ImageCollection::Impl::at(int index) {
 }
 
 Mat& ImageCollection::Impl::operator[](int index) {
+    if(m_pages.at(index).empty() && m_randomAccess && getNumThreads() > 1) {
+        // Read ahead: decode the missing pages from index on in parallel, one batch of at most
+        // getNumThreads() pages at a time, so the cache grows no faster than it is consumed.
+        int batch = 0;
+        while (batch < getNumThreads() && size_t(index + batch) < m_size && m_pages[index + batch].empty())
+            ++batch;
+        std::vector<Mat> pages(batch);
+        decodePagesParallel_(m_decoder, m_filename, Mat(), m_flags, index, pages);
+        for (int i = 0; i < batch; i++)
+            m_pages[index + i] = pages[i];
+    }
     if(m_pages.at(index).empty()) {
         // We can't go backward in multi images. If the page is not in vector yet,
         // go back to first page and advance until the desired page and read it into memory
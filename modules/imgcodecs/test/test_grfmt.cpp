@@ -495,6 +495,218 @@ TEST(Imgcodecs, imdecode_user_buffer)
     EXPECT_TRUE(result.empty());
 }
 
+TEST(Imgcodecs, imdecodeTo_preallocated)
+{
+    cv::Mat src(48, 64, CV_8UC3);
+    cv::randu(src, 0, 256);
+    std::vector<uchar> encoded;
+    ASSERT_TRUE(cv::imencode(".png", src, encoded));
+
+    // decode into ROI of a bigger buffer without reallocation
+    cv::Mat storage(100, 100, CV_8UC3, cv::Scalar::all(7));
+    cv::Mat roi = storage(cv::Rect(10, 20, 64, 48));
+    const uchar* data = roi.data;
+    ASSERT_TRUE(cv::imdecodeTo(encoded, IMREAD_COLOR, roi));
+    EXPECT_EQ(data, roi.data);
+    EXPECT_EQ(0, cvtest::norm(src, roi, NORM_INF));
+    EXPECT_EQ(7, storage.at<cv::Vec3b>(0, 0)[0]);
+
+    // mismatched size or type is rejected and the buffer is kept intact
+    cv::Mat wrongSize(48, 63, CV_8UC3, cv::Scalar::all(1));
+    EXPECT_FALSE(cv::imdecodeTo(encoded, IMREAD_COLOR, wrongSize));
+    EXPECT_EQ(cv::Size(63, 48), wrongSize.size());
+    EXPECT_EQ(0, cvtest::norm(wrongSize, cv::Mat(48, 63, CV_8UC3, cv::Scalar::all(1)), NORM_INF));
+    cv::Mat wrongType(48, 64, CV_8UC1);
+    EXPECT_FALSE(cv::imdecodeTo(encoded, IMREAD_COLOR, wrongType));
+    EXPECT_EQ(CV_8UC1, wrongType.type());
+
+    // flags are taken into account
+    cv::Mat gray(48, 64, CV_8UC1);
+    ASSERT_TRUE(cv::imdecodeTo(encoded, IMREAD_GRAYSCALE, gray));
+    EXPECT_EQ(0, cvtest::norm(cv::imdecode(encoded, IMREAD_GRAYSCALE), gray, NORM_INF));
+    cv::Mat reduced(24, 32, CV_8UC3);
+    ASSERT_TRUE(cv::imdecodeTo(encoded, IMREAD_REDUCED_COLOR_2, reduced));
+    EXPECT_EQ(0, cvtest::norm(cv::imdecode(encoded, IMREAD_REDUCED_COLOR_2), reduced, NORM_INF));
+
+    // empty destination is allocated
+    cv::Mat empty;
+    ASSERT_TRUE(cv::imdecodeTo(encoded, IMREAD_COLOR, empty));
+    EXPECT_EQ(0, cvtest::norm(src, empty, NORM_INF));
+
+    cv::UMat u(48, 64, CV_8UC3);
+    ASSERT_TRUE(cv::imdecodeTo(encoded, IMREAD_COLOR, u));
+    EXPECT_EQ(0, cvtest::norm(src, u.getMat(ACCESS_READ), NORM_INF));
+}
+
+TEST(Imgcodecs, imdecodeTo_reused_decoders)
+{
+    std::vector<std::string> exts;
+    exts.push_back(".png");
+    exts.push_back(".bmp");
+#ifdef HAVE_JPEG
+    exts.push_back(".jpg");
+#endif
+
+    // decoders are kept between the calls, mix formats, sizes and broken buffers
+    for (int i = 0; i < 12; i++)
+    {
+        SCOPED_TRACE(cv::format("i=%d", i));
+        cv::Mat src(20 + i, 30 - i, CV_8UC3);
+        cv::randu(src, 0, 256);
+        std::vector<uchar> encoded;
+        ASSERT_TRUE(cv::imencode(exts[i % exts.size()], src, encoded));
+
+        cv::Mat dst(src.size(), CV_8UC3);
+        if (i % 4 == 3)
+        {
+            std::vector<uchar> truncated(encoded.begin(), encoded.begin() + encoded.size() / 2);
+            // libjpeg pads truncated streams, so compare with imdecode() instead of expecting a failure
+            EXPECT_EQ(!cv::imdecode(truncated, IMREAD_COLOR).empty(), cv::imdecodeTo(truncated, IMREAD_COLOR, dst));
+        }
+        ASSERT_TRUE(cv::imdecodeTo(encoded, IMREAD_COLOR, dst));
+        EXPECT_EQ(0, cvtest::norm(cv::imdecode(encoded, IMREAD_COLOR), dst, NORM_INF));
+    }
+}
+
+TEST(Imgcodecs, ImageBatchDecoder)
+{
+    std::vector<std::string> exts;
+    exts.push_back(".png");
+    exts.push_back(".bmp");
+#ifdef HAVE_JPEG
+    exts.push_back(".jpg");
+#endif
+
+    std::vector<std::vector<uchar> > bufs;
+    for (int i = 0; i < 24; i++)
+    {
+        cv::Mat src(16 + i, 40 - i, (i % 3) ? CV_8UC3 : CV_8UC1);
+        cv::randu(src, 0, 256);
+        std::vector<uchar> encoded;
+        ASSERT_TRUE(cv::imencode(exts[i % exts.size()], src, encoded));
+        bufs.push_back(encoded);
+    }
+    bufs[5] = std::vector<uchar>();                       // empty
+    bufs[9].assign(100, (uchar)17);                       // unknown format
+    bufs[13].resize(bufs[13].size() / 2);                 // truncated
+
+    const int nthreads = cv::getNumThreads();
+    cv::ImageBatchDecoder decoder(IMREAD_COLOR);
+    for (int threads = 1; threads <= 4; threads += 3)
+    {
+        SCOPED_TRACE(cv::format("threads=%d", threads));
+        cv::setNumThreads(threads);
+        for (int iter = 0; iter < 2; iter++)  // the second batch reuses the decoders
+        {
+            std::vector<cv::Mat> mats;
+            std::vector<cv::String> errors;
+            int decoded = 0;
+            EXPECT_NO_THROW(decoded = decoder.decode(bufs, mats, errors));
+            ASSERT_EQ(bufs.size(), mats.size());
+            ASSERT_EQ(bufs.size(), errors.size());
+            int expected = 0;
+            for (size_t i = 0; i < bufs.size(); i++)
+            {
+                SCOPED_TRACE(cv::format("item=%d", (int)i));
+                cv::Mat ref;
+                if (!bufs[i].empty())
+                    ref = cv::imdecode(bufs[i], IMREAD_COLOR);
+                if (ref.empty())
+                {
+                    EXPECT_TRUE(mats[i].empty());
+                    EXPECT_FALSE(errors[i].empty());
+                }
+                else
+                {
+                    expected++;
+                    EXPECT_TRUE(errors[i].empty()) << errors[i];
+                    EXPECT_EQ(0, cvtest::norm(ref, mats[i], NORM_INF));
+                }
+            }
+            EXPECT_EQ(expected, decoded);
+            EXPECT_LE(expected, (int)bufs.size() - 2);
+        }
+    }
+    cv::setNumThreads(nthreads);
+
+    std::vector<cv::Mat> gray;
+    cv::imdecodeBatch(bufs, IMREAD_GRAYSCALE, gray);
+    ASSERT_EQ(bufs.size(), gray.size());
+    EXPECT_EQ(0, cvtest::norm(cv::imdecode(bufs[0], IMREAD_GRAYSCALE), gray[0], NORM_INF));
+}
+
+typedef testing::TestWithParam<std::string> Imgcodecs_StreamEncoder;
+
+TEST_P(Imgcodecs_StreamEncoder, strips_match_imencode)
+{
+    const std::string ext = GetParam();
+    const int types[] = { CV_8UC1, CV_8UC3, CV_8UC4, CV_16UC3 };
+    for (size_t t = 0; t < sizeof(types)/sizeof(types[0]); t++)
+    {
+        SCOPED_TRACE(cv::typeToString(types[t]));
+        cv::Mat img(133, 71, types[t]);
+        cv::randu(img, 0, 256);
+
+        std::vector<uchar> expected;
+        ASSERT_TRUE(cv::imencode(ext, img, expected));
+
+        std::vector<uchar> streamed;
+        int chunks = 0;
+        cv::ImageStreamEncoder encoder;
+        ASSERT_TRUE(encoder.open(ext, img.size(), img.type(), [&](const uchar* data, size_t size) {
+            streamed.insert(streamed.end(), data, data + size);
+            chunks++;
+            return true;
+        }));
+        EXPECT_TRUE(encoder.isOpened());
+        for (int y = 0; y < img.rows; y += 16)
+            ASSERT_TRUE(encoder.write(img.rowRange(y, std::min(y + 16, img.rows))));
+        ASSERT_TRUE(encoder.finish());
+        EXPECT_FALSE(encoder.isOpened());
+        EXPECT_GT(chunks, 0);
+        EXPECT_TRUE(expected == streamed);
+    }
+}
+
+TEST_P(Imgcodecs_StreamEncoder, abort)
+{
+    const std::string ext = GetParam();
+    cv::Mat img(64, 64, CV_8UC3);
+    cv::randu(img, 0, 256);
+
+    cv::ImageStreamEncoder encoder;
+    ASSERT_TRUE(encoder.open(ext, img.size(), img.type(), [](const uchar*, size_t) { return false; }));
+    bool ok = true;
+    for (int y = 0; y < img.rows && ok; y += 8)
+        ok = encoder.write(img.rowRange(y, y + 8));
+    if (ok)
+        ok = encoder.finish();
+    EXPECT_FALSE(ok);
+    EXPECT_FALSE(encoder.isOpened());
+
+    // wrong strip, incomplete image
+    ASSERT_TRUE(encoder.open(ext, img.size(), img.type(), [](const uchar*, size_t) { return true; }));
+    EXPECT_THROW(encoder.write(img.colRange(0, 8)), cv::Exception);
+    ASSERT_TRUE(encoder.write(img.rowRange(0, 8)));
+    EXPECT_FALSE(encoder.finish());
+    EXPECT_FALSE(encoder.write(img.rowRange(8, 16)));
+}
+
+static const std::string stream_exts[] = {
+#if defined(HAVE_PNG) || defined(HAVE_SPNG)
+    ".png",
+#endif
+    ".bmp",
+#ifdef HAVE_JPEG
+    ".jpg",
+#endif
+#ifdef HAVE_TIFF
+    ".tiff",
+#endif
+};
+
+INSTANTIATE_TEST_CASE_P(/**/, Imgcodecs_StreamEncoder, testing::ValuesIn(stream_exts));
+
 }} // namespace
 
 #if defined(HAVE_OPENEXR) && defined(OPENCV_IMGCODECS_ENABLE_OPENEXR_TESTS)
@@ -96,6 +96,85 @@ INSTANTIATE_TEST_CASE_P(/*nothing*/, Imgcodecs_Resize,
 
 //==================================================================================================
 
+/* < file extension, max difference with cropped full image > */
+typedef testing::TestWithParam< tuple<string, int> > Imgcodecs_ROI;
+
+static std::vector<int> roiParams(const Rect& roi, int scale_denom = 1)
+{
+    std::vector<int> params;
+    params.push_back(IMREAD_PARAM_SCALE_DENOM); params.push_back(scale_denom);
+    params.push_back(IMREAD_PARAM_ROI_X); params.push_back(roi.x);
+    params.push_back(IMREAD_PARAM_ROI_Y); params.push_back(roi.y);
+    params.push_back(IMREAD_PARAM_ROI_WIDTH); params.push_back(roi.width);
+    params.push_back(IMREAD_PARAM_ROI_HEIGHT); params.push_back(roi.height);
+    return params;
+}
+
+TEST_P(Imgcodecs_ROI, imdecode_roi)
+{
+    const string ext = get<0>(GetParam());
+    const int maxDiff = get<1>(GetParam());
+
+    Mat src(301, 403, CV_8UC3);
+    for (int y = 0; y < src.rows; y++)
+        for (int x = 0; x < src.cols; x++)
+            src.at<Vec3b>(y, x) = Vec3b((uchar)(x / 2), (uchar)(y / 2), (uchar)((x + y) / 3));
+    std::vector<uchar> buf;
+    ASSERT_TRUE(imencode(ext, src, buf));
+
+    const Rect rois[] = { Rect(0, 0, 403, 301), Rect(17, 33, 101, 67), Rect(300, 250, 103, 51), Rect(1, 1, 1, 1) };
+    for (int flags = IMREAD_GRAYSCALE; flags <= IMREAD_COLOR; flags++)
+    {
+        Mat full = imdecode(buf, flags);
+        ASSERT_FALSE(full.empty());
+        for (size_t i = 0; i < sizeof(rois) / sizeof(rois[0]); i++)
+        {
+            Mat part = imdecode(buf, flags, roiParams(rois[i]));
+            ASSERT_EQ(rois[i].size(), part.size()) << rois[i];
+            EXPECT_LE(cvtest::norm(full(rois[i]), part, NORM_INF), maxDiff) << rois[i] << " flags=" << flags;
+        }
+    }
+
+    // region is specified in coordinates of the reduced image
+    Mat reduced = imdecode(buf, IMREAD_REDUCED_COLOR_2);
+    ASSERT_FALSE(reduced.empty());
+    Rect roi(10, 20, 51, 31);
+    Mat part = imdecode(buf, IMREAD_COLOR, roiParams(roi, 2));
+    ASSERT_EQ(roi.size(), part.size());
+    EXPECT_LE(cvtest::norm(reduced(roi), part, NORM_INF), maxDiff);
+
+    // region is clipped by image
+    part = imdecode(buf, IMREAD_COLOR, roiParams(Rect(400, 290, 100, 100)));
+    EXPECT_EQ(Size(3, 11), part.size());
+    EXPECT_TRUE(imdecode(buf, IMREAD_COLOR, roiParams(Rect(500, 0, 10, 10))).empty());
+
+    // partially specified region
+    EXPECT_EQ(src.size(), imdecode(buf, IMREAD_COLOR, roiParams(Rect())).size());
+    EXPECT_THROW(imdecode(buf, IMREAD_COLOR, roiParams(Rect(10, 20, 0, 0))), cv::Exception);
+    EXPECT_THROW(imdecode(buf, IMREAD_COLOR, roiParams(Rect(0, 0, 10, 0))), cv::Exception);
+}
+
+const tuple<string, int> roi_exts[] =
+{
+#if defined(HAVE_PNG) || defined(HAVE_SPNG)
+    make_tuple<string, int>(".png", 0),
+#endif
+#ifdef HAVE_TIFF
+    make_tuple<string, int>(".tiff", 0),
+#endif
+#ifdef HAVE_JPEG
+    make_tuple<string, int>(".jpg", 2),
+#endif
+#ifdef HAVE_WEBP
+    make_tuple<string, int>(".webp", 0),
+#endif
+    make_tuple<string, int>(".bmp", 0),
+};
+
+INSTANTIATE_TEST_CASE_P(/*nothing*/, Imgcodecs_ROI, testing::ValuesIn(roi_exts));
+
+//==================================================================================================
+
 TEST(Imgcodecs_Image, read_write_bmp)
 {
     const size_t IMAGE_COUNT = 10;
@@ -1071,6 +1071,132 @@ TEST(Imgcodecs_Tiff_Modes, write_multipage)
     EXPECT_EQ(0, remove(tmp_filename.c_str()));
 }
 
+TEST(Imgcodecs_Tiff_Modes, read_multipage_parallel)
+{
+    const int page_count = 9;
+    vector<Mat> pages;
+    RNG& rng = theRNG();
+    for (int i = 0; i < page_count; i++)
+    {
+        Mat page(32 + 7 * i, 48 - 3 * i, CV_8UC3);
+        rng.fill(page, RNG::UNIFORM, 0, 256);
+        pages.push_back(page);
+    }
+
+    const string tmp_filename = cv::tempfile(".tiff");
+    ASSERT_TRUE(imwrite(tmp_filename, pages));
+    std::vector<uchar> buf;
+    {
+        std::ifstream f(tmp_filename.c_str(), std::ios::binary);
+        buf.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+    }
+    ASSERT_FALSE(buf.empty());
+
+    const int nthreads = getNumThreads();
+    for (int threads = 1; threads <= 4; threads += 3)
+    {
+        SCOPED_TRACE(cv::format("threads=%d", threads));
+        setNumThreads(threads);
+
+        vector<Mat> read_pages;
+        ASSERT_TRUE(imreadmulti(tmp_filename, read_pages));
+        ASSERT_EQ((size_t)page_count, read_pages.size());
+        for (int i = 0; i < page_count; i++)
+            EXPECT_PRED_FORMAT2(cvtest::MatComparator(0, 0), pages[i], read_pages[i]);
+
+        read_pages.clear();
+        ASSERT_TRUE(imreadmulti(tmp_filename, read_pages, 2, 5));
+        ASSERT_EQ((size_t)5, read_pages.size());
+        for (int i = 0; i < 5; i++)
+            EXPECT_PRED_FORMAT2(cvtest::MatComparator(0, 0), pages[2 + i], read_pages[i]);
+
+        read_pages.clear();
+        EXPECT_FALSE(imreadmulti(tmp_filename, read_pages, page_count, 2));
+        EXPECT_TRUE(read_pages.empty());
+
+        read_pages.clear();
+        ASSERT_TRUE(imdecodemulti(buf, IMREAD_UNCHANGED, read_pages, Range(3, page_count)));
+        ASSERT_EQ((size_t)page_count - 3, read_pages.size());
+        for (int i = 3; i < page_count; i++)
+            EXPECT_PRED_FORMAT2(cvtest::MatComparator(0, 0), pages[i], read_pages[i - 3]);
+
+        ImageCollection collection(tmp_filename, IMREAD_UNCHANGED);
+        ASSERT_EQ((size_t)page_count, collection.size());
+        int i = 0;
+        for (auto it = collection.begin(); it != collection.end(); ++it, ++i)
+        {
+            EXPECT_PRED_FORMAT2(cvtest::MatComparator(0, 0), pages[i], *it);
+            collection.releaseCache(i);
+        }
+        EXPECT_EQ(page_count, i);
+        EXPECT_PRED_FORMAT2(cvtest::MatComparator(0, 0), pages[1], collection.at(1));
+    }
+    setNumThreads(nthreads);
+    EXPECT_EQ(0, remove(tmp_filename.c_str()));
+}
+
+TEST(Imgcodecs_Tiff_Modes, read_multipage_parallel_oversized_page)
+{
+    const int page_count = 6, bad_page = 3;
+    vector<Mat> pages;
+    for (int i = 0; i < page_count; i++)
+        pages.push_back(Mat(16, 24, CV_8UC1, Scalar::all(i)));
+
+    const string tmp_filename = cv::tempfile(".tiff");
+    ASSERT_TRUE(imwrite(tmp_filename, pages));
+    std::vector<uchar> buf;
+    {
+        std::ifstream f(tmp_filename.c_str(), std::ios::binary);
+        buf.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+    }
+    EXPECT_EQ(0, remove(tmp_filename.c_str()));
+    ASSERT_GE(buf.size(), (size_t)8);
+    ASSERT_EQ('I', buf[0]);  // little-endian
+
+    // make ImageWidth of one page exceed CV_IO_MAX_IMAGE_WIDTH
+    uint32_t ifd = buf[4] | (buf[5] << 8) | (buf[6] << 16) | ((uint32_t)buf[7] << 24);
+    for (int i = 0; i < bad_page; i++)
+    {
+        ASSERT_LT((size_t)ifd + 2, buf.size());
+        const int entries = buf[ifd] | (buf[ifd + 1] << 8);
+        const size_t next = ifd + 2 + entries * 12;
+        ASSERT_LE(next + 4, buf.size());
+        ifd = buf[next] | (buf[next + 1] << 8) | (buf[next + 2] << 16) | ((uint32_t)buf[next + 3] << 24);
+    }
+    ASSERT_LT((size_t)ifd + 2, buf.size());
+    const int entries = buf[ifd] | (buf[ifd + 1] << 8);
+    bool patched = false;
+    for (int e = 0; e < entries && !patched; e++)
+    {
+        uchar* entry = &buf[ifd + 2 + e * 12];
+        if ((entry[0] | (entry[1] << 8)) != 256)  // TIFFTAG_IMAGEWIDTH
+            continue;
+        const uint32_t width = 1 << 21;
+        entry[2] = 4; entry[3] = 0;  // LONG
+        entry[4] = 1; entry[5] = entry[6] = entry[7] = 0;
+        for (int b = 0; b < 4; b++)
+            entry[8 + b] = (uchar)(width >> (8 * b));
+        patched = true;
+    }
+    ASSERT_TRUE(patched);
+
+    // both paths stop with the same exception, whatever the number of threads
+    const int nthreads = getNumThreads();
+    for (int threads = 1; threads <= 4; threads += 3)
+    {
+        SCOPED_TRACE(cv::format("threads=%d", threads));
+        setNumThreads(threads);
+        vector<Mat> read_pages;
+        EXPECT_THROW(imdecodemulti(buf, IMREAD_UNCHANGED, read_pages), cv::Exception);
+        read_pages.clear();
+        ASSERT_TRUE(imdecodemulti(buf, IMREAD_UNCHANGED, read_pages, Range(0, bad_page)));
+        ASSERT_EQ((size_t)bad_page, read_pages.size());
+        for (int i = 0; i < bad_page; i++)
+            EXPECT_PRED_FORMAT2(cvtest::MatComparator(0, 0), pages[i], read_pages[i]);
+    }
+    setNumThreads(nthreads);
+}
+
 //==================================================================================================
 
 TEST(Imgcodecs_Tiff, imdecode_no_exception_temporary_file_removed)
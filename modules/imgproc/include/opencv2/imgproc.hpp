@@ -2895,6 +2895,68 @@ CV_EXPORTS_W void integral( InputArray src, OutputArray sum, int sdepth = -1 );
 CV_EXPORTS_AS(integral2) void integral( InputArray src, OutputArray sum,
                                         OutputArray sqsum, int sdepth = -1, int sqdepth = -1 );
 
+/** @brief Integral images of a video frame updated in place and queried for many boxes at once.
+
+The object keeps the integral of the image and, optionally, the integral of squared pixel values
+(see #integral). When only a part of the next frame differs, update() recomputes the tables for the
+changed region: the rows of the region to the right of its left edge are integrated again, and the
+rows below it are shifted by the change of the last changed row.
+
+The tables can be queried for the sums, means and variances of many rectangles in one call.
+ */
+class CV_EXPORTS_W IntegralImage : public Algorithm
+{
+public:
+    /** @brief Computes the integral images of the whole image.
+
+    @param image Input image, see #integral.
+     */
+    CV_WRAP virtual void compute(InputArray image) = 0;
+
+    /** @brief Updates the integral images after the pixels inside roi have changed.
+
+    @param image The new image. It must have the same size and type as the image passed to compute(),
+    otherwise the tables are computed from scratch. The pixels outside roi must be unchanged.
+    @param roi The changed region of the image.
+     */
+    CV_WRAP virtual void update(InputArray image, const Rect& roi) = 0;
+
+    /** @brief Returns the integral image, \f$(W+1)\times (H+1)\f$.
+
+    The returned matrix shares the data with the object, so it reflects the subsequent updates.
+     */
+    CV_WRAP virtual void getSum(OutputArray sum) const = 0;
+
+    //! Returns the integral image of squared pixel values or an empty matrix if it is not computed.
+    CV_WRAP virtual void getSqSum(OutputArray sqsum) const = 0;
+
+    /** @brief Computes the sums of pixel values inside the boxes.
+
+    @param boxes Rectangles inside the image.
+    @param sums Output \f$N \times 1\f$ array of sums, CV_64F with the number of channels of the image.
+     */
+    CV_WRAP virtual void boxSums(const std::vector<Rect>& boxes, OutputArray sums) const = 0;
+
+    /** @brief Computes the means and the variances of pixel values inside the boxes.
+
+    The variances require the integral of squared pixel values.
+
+    @param boxes Rectangles inside the image.
+    @param means Output \f$N \times 1\f$ array of means, CV_64F with the number of channels of the image.
+    @param variances Optional output \f$N \times 1\f$ array of variances of the same type.
+     */
+    CV_WRAP virtual void boxStats(const std::vector<Rect>& boxes, OutputArray means,
+                                  OutputArray variances = noArray()) const = 0;
+};
+
+/** @brief Creates a smart pointer to a cv::IntegralImage class and initializes it.
+
+@param squares Whether to keep the integral of squared pixel values.
+@param sdepth Depth of the integral image, see #integral.
+@param sqdepth Depth of the integral image of squared pixel values, see #integral.
+ */
+CV_EXPORTS_W Ptr<IntegralImage> createIntegralImage(bool squares = true, int sdepth = -1, int sqdepth = -1);
+
 //! @} imgproc_misc
 
 //! @addtogroup imgproc_motion
@@ -3674,6 +3736,36 @@ CV_EXPORTS int floodFill( InputOutputArray image,
                           Scalar loDiff = Scalar(), Scalar upDiff = Scalar(),
                           int flags = 4 );
 
+/** @brief Fills the connected components containing the given seed points.
+
+The function gives the same result as calling #floodFill with the same mask for every seed point in
+turn, so the filled areas do not overlap: a seed point inside a component already filled from
+another seed, or on a non-zero mask pixel, fills nothing.
+
+In the floating range mode with equal loDiff and upDiff the neighbor pixels are connected both ways.
+In this case all the components are labelled in a single pass over the image, the image is processed in
+parallel stripes which are merged with union-find. This is much faster than separate calls when
+there are many seeds. Otherwise (#FLOODFILL_FIXED_RANGE or different loDiff and upDiff) the seeds
+are filled one by one.
+
+@param image Input/output 1- or 3-channel, 8-bit, or floating-point image, see #floodFill.
+@param mask Operation mask, see #floodFill. If it is not passed or empty, a zero mask is used.
+@param seedPoints Starting points.
+@param newVal New value of the repainted domain pixels.
+@param areas Optional output vector of the numbers of pixels filled from the seed points.
+@param rects Optional output vector of the bounding rectangles of the areas filled from the seed
+points (empty rectangles for the seed points which fill nothing).
+@param loDiff Maximal lower brightness/color difference, see #floodFill.
+@param upDiff Maximal upper brightness/color difference, see #floodFill.
+@param flags Operation flags, see #floodFill.
+@return The total number of filled pixels.
+ */
+CV_EXPORTS_W int floodFillMulti( InputOutputArray image, InputOutputArray mask,
+                                 const std::vector<Point>& seedPoints, Scalar newVal,
+                                 OutputArray areas = noArray(), OutputArray rects = noArray(),
+                                 Scalar loDiff = Scalar(), Scalar upDiff = Scalar(),
+                                 int flags = 4 );
+
 //! Performs linear blending of two images:
 //! \f[ \texttt{dst}(i,j) = \texttt{weights1}(i,j)*\texttt{src1}(i,j) + \texttt{weights2}(i,j)*\texttt{src2}(i,j) \f]
 //! @param src1 It has a type of CV_8UC(n) or CV_32FC(n), where n is a positive integer.
@@ -3911,6 +4003,61 @@ is \f$W \times H\f$ and templ is \f$w \times h\f$ , then result is \f$(W-w+1) \t
 CV_EXPORTS_W void matchTemplate( InputArray image, InputArray templ,
                                  OutputArray result, int method, InputArray mask = noArray() );
 
+/** @brief Template matching engine for a fixed set of templates.
+
+The engine computes the same maps as #matchTemplate without a mask, but keeps the data that does not
+depend on the image: the template statistics are computed once, and the template spectra are kept
+for the last image size, so matching the same templates against every frame of a video only
+transforms the frames. Templates of the same size are matched in a batch: the DFT of every image
+block is computed once and multiplied by each template spectrum.
+
+@sa matchTemplate, createTemplateMatcher
+ */
+class CV_EXPORTS_W TemplateMatcher : public Algorithm
+{
+public:
+    /** @brief Sets the templates to search for.
+
+    @param templs Vector of templates. All the templates must have the same type, 8-bit or 32-bit
+    floating-point with up to 4 channels. The sizes may differ.
+     */
+    CV_WRAP virtual void setTemplates(InputArrayOfArrays templs) = 0;
+
+    //! Returns the number of templates.
+    CV_WRAP virtual int getTemplatesCount() const = 0;
+
+    /** @brief Compares the templates against overlapped image regions.
+
+    @param image Image where the search is running. It must have the same type as the templates and
+    be not smaller than any of them.
+    @param results Vector of comparison maps, one per template, see #matchTemplate.
+     */
+    CV_WRAP virtual void match(InputArray image, OutputArrayOfArrays results) = 0;
+
+    //! Sets the comparison method, see #TemplateMatchModes.
+    CV_WRAP virtual void setMethod(int method) = 0;
+    CV_WRAP virtual int getMethod() const = 0;
+
+    /** @brief Sets whether templates of the same size share the image DFT.
+
+    If disabled, every template is matched separately, which needs less temporary memory.
+     */
+    CV_WRAP virtual void setShareImageDFT(bool share) = 0;
+    CV_WRAP virtual bool getShareImageDFT() const = 0;
+
+    //! Releases the cached template spectra.
+    CV_WRAP virtual void collectGarbage() = 0;
+};
+
+/** @brief Creates a smart pointer to a cv::TemplateMatcher class and initializes it.
+
+@param templs Vector of templates, see TemplateMatcher::setTemplates.
+@param method Comparison method, see #TemplateMatchModes.
+@param shareImageDFT Whether templates of the same size share the image DFT.
+ */
+CV_EXPORTS_W Ptr<TemplateMatcher> createTemplateMatcher(InputArrayOfArrays templs, int method,
+                                                        bool shareImageDFT = true);
+
 //! @}
 
 //! @addtogroup imgproc_shape
@@ -84,6 +84,40 @@ PERF_TEST_P(TestFindContoursFF, findContours,
     SANITY_CHECK_NOTHING();
 }
 
+typedef TestBaseWithParam< tuple<Size, RetrMode, int> > TestFindContoursParallel;
+
+// large masks: sequential scan (1 thread) vs labeling in parallel stripes
+PERF_TEST_P(TestFindContoursParallel, findContours,
+    Combine(
+        Values(sz1080p, Size(4096, 3072)), // image size
+        Values((int)RETR_EXTERNAL, (int)RETR_TREE), // retrieval mode
+        Values(1, 4) // threads
+    )
+)
+{
+    Size img_size = get<0>(GetParam());
+    int retr_mode = get<1>(GetParam());
+    int threads = get<2>(GetParam());
+
+    RNG rng;
+    Mat img = Mat::zeros(img_size, CV_8UC1);
+    int blob_count = img_size.area() / 2000;
+    for (int i = 0; i < blob_count; i++)
+    {
+        Point center((unsigned)rng % img.cols, (unsigned)rng % img.rows);
+        int radius = (unsigned)rng % 40 + 2;
+        circle(img, center, radius, Scalar(255), -1);
+        circle(img, center, radius / 2, Scalar(0), -1);
+    }
+    vector< vector<Point> > contours;
+    vector<Vec4i> hierarchy;
+
+    setNumThreads(threads);
+    TEST_CYCLE() findContours(img, contours, hierarchy, retr_mode, CHAIN_APPROX_SIMPLE);
+
+    SANITY_CHECK_NOTHING();
+}
+
 typedef TestBaseWithParam< tuple<MatDepth, int> > TestBoundingRect;
 
 PERF_TEST_P(TestBoundingRect, BoundingRect,
@@ -0,0 +1,67 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+#include "perf_precomp.hpp"
+
+namespace opencv_test {
+
+// Compares the 2D-tiled processing of large images (OPENCV_IMGPROC_FILTER_TILING_MIN_PIXELS, disabled by default)
+// with the untiled one of the same filters
+
+static void setFilterTilingMinPixels(const std::string& value)
+{
+#ifdef _WIN32
+    _putenv_s("OPENCV_IMGPROC_FILTER_TILING_MIN_PIXELS", value.c_str());
+#else
+    setenv("OPENCV_IMGPROC_FILTER_TILING_MIN_PIXELS", value.c_str(), 1);
+#endif
+}
+
+enum { TILED_FILTER2D, TILED_SEPFILTER2D, TILED_ERODE };
+CV_ENUM(TiledFilterOp, TILED_FILTER2D, TILED_SEPFILTER2D, TILED_ERODE)
+
+typedef TestBaseWithParam< tuple<Size, int, TiledFilterOp, bool> > FilterTiling;
+
+PERF_TEST_P(FilterTiling, filter,
+            Combine(
+                Values(sz1080p, sz2160p),
+                Values(3, 5, 9),
+                TiledFilterOp::all(),
+                testing::Bool()
+            )
+)
+{
+    const Size sz = get<0>(GetParam());
+    const int kSize = get<1>(GetParam());
+    const int op = get<2>(GetParam());
+    const bool tiled = get<3>(GetParam());
+
+    Mat src(sz, CV_8UC3), dst(sz, CV_8UC3);
+    Mat kernel2D(kSize, kSize, CV_32F);
+    randu(kernel2D, -1, 1);
+    kernel2D /= kSize*kSize;
+    Mat kernel1D = getGaussianKernel(kSize, -1, CV_32F);
+    Mat element = getStructuringElement(MORPH_ELLIPSE, Size(kSize, kSize));
+
+    const char* old = getenv("OPENCV_IMGPROC_FILTER_TILING_MIN_PIXELS");
+    const std::string oldValue = old ? old : "0";
+    setFilterTilingMinPixels(tiled ? "1" : "0");
+
+    declare.in(src, WARMUP_RNG).out(dst);
+
+    TEST_CYCLE()
+    {
+        switch (op)
+        {
+        case TILED_FILTER2D: cv::filter2D(src, dst, -1, kernel2D); break;
+        case TILED_SEPFILTER2D: cv::sepFilter2D(src, dst, -1, kernel1D, kernel1D); break;
+        default: cv::erode(src, dst, element); break;
+        }
+    }
+
+    setFilterTilingMinPixels(oldValue);
+
+    SANITY_CHECK_NOTHING();
+}
+
+} // namespace
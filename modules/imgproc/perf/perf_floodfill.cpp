@@ -67,4 +67,50 @@ PERF_TEST_P(Size_Source_Fl, floodFill1, Combine(
     SANITY_CHECK_NOTHING();
 }
 
+typedef tuple<Size, int, int, bool> Size_Seeds_Connectivity_Multi_t;
+typedef perf::TestBaseWithParam<Size_Seeds_Connectivity_Multi_t> Size_Seeds_Connectivity_Multi;
+
+PERF_TEST_P(Size_Seeds_Connectivity_Multi, floodFillMulti, Combine(
+            testing::Values(szVGA, sz1080p),
+            testing::Values(100, 1000), // seeds
+            testing::Values(4, 8), // connectivity
+            testing::Bool() // floodFillMulti or floodFill for every seed
+            ))
+{
+    Size sz = get<0>(GetParam());
+    int nseeds = get<1>(GetParam());
+    int connectivity = get<2>(GetParam());
+    bool multi = get<3>(GetParam());
+
+    // labels of a segmentation
+    Mat image0(sz, CV_8UC1, Scalar::all(0));
+    RNG& rng = theRNG();
+    for (int i = 0; i < 2000; i++)
+        circle(image0, Point(rng.uniform(0, sz.width), rng.uniform(0, sz.height)), rng.uniform(5, 40),
+               Scalar::all(rng.uniform(1, 250)), FILLED);
+
+    std::vector<Point> seeds;
+    for (int i = 0; i < nseeds; i++)
+        seeds.push_back(Point(rng.uniform(0, sz.width), rng.uniform(0, sz.height)));
+
+    const int flags = connectivity | FLOODFILL_MASK_ONLY | (255 << 8);
+    Mat mask;
+
+    for (; next(); )
+    {
+        mask = Mat::zeros(sz.height + 2, sz.width + 2, CV_8UC1);
+        startTimer();
+        if (multi)
+            floodFillMulti(image0, mask, seeds, Scalar::all(255), noArray(), noArray(), Scalar(), Scalar(), flags);
+        else
+        {
+            for (size_t i = 0; i < seeds.size(); i++)
+                floodFill(image0, mask, seeds[i], Scalar::all(255), NULL, Scalar(), Scalar(), flags);
+        }
+        stopTimer();
+    }
+
+    SANITY_CHECK_NOTHING();
+}
+
 } // namespace
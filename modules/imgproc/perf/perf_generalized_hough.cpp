@@ -0,0 +1,82 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+#include "perf_precomp.hpp"
+
+namespace opencv_test {
+
+static void drawStar(Mat& img, Point2d center, double scale, double angle)
+{
+    std::vector<Point> pts;
+    for (int i = 0; i < 10; i++)
+    {
+        const double r = (i % 2 ? 20 : 45) * scale, a = (i * 36 + angle) * CV_PI / 180;
+        pts.push_back(Point(cvRound(center.x + r * cos(a)), cvRound(center.y + r * sin(a))));
+    }
+    fillPoly(img, std::vector<std::vector<Point> >(1, pts), Scalar::all(255));
+}
+
+static void makeStarScene(Mat& templ, Mat& img)
+{
+    templ = Mat::zeros(110, 110, CV_8UC1);
+    drawStar(templ, Point2d(55, 55), 1.0, 0);
+
+    img = Mat::zeros(480, 640, CV_8UC1);
+    drawStar(img, Point2d(120, 140), 1.0, 0);
+    drawStar(img, Point2d(400, 120), 1.2, 30);
+    drawStar(img, Point2d(300, 350), 0.9, 100);
+}
+
+typedef TestBaseWithParam<int> GeneralizedHoughBallard_Dp;
+
+PERF_TEST_P(GeneralizedHoughBallard_Dp, GeneralizedHoughBallard, testing::Values(1, 2))
+{
+    Mat templ, img;
+    makeStarScene(templ, img);
+
+    Ptr<GeneralizedHoughBallard> alg = createGeneralizedHoughBallard();
+    alg->setDp(GetParam());
+    alg->setVotesThreshold(30);
+    alg->setTemplate(templ);
+
+    std::vector<Vec4f> positions;
+    std::vector<Vec3i> votes;
+    TEST_CYCLE() alg->detect(img, positions, votes);
+
+    SANITY_CHECK_NOTHING();
+}
+
+typedef tuple<double, double> AngleRange_ScaleRange_t;
+typedef TestBaseWithParam<AngleRange_ScaleRange_t> GeneralizedHoughGuil_Ranges;
+
+PERF_TEST_P(GeneralizedHoughGuil_Ranges, GeneralizedHoughGuil,
+            testing::Combine(
+                testing::Values(90.0, 360.0), // max angle
+                testing::Values(1.2, 1.5)     // max scale
+                )
+            )
+{
+    Mat templ, img;
+    makeStarScene(templ, img);
+
+    Ptr<GeneralizedHoughGuil> alg = createGeneralizedHoughGuil();
+    alg->setMinDist(20);
+    alg->setDp(2);
+    alg->setMinAngle(0);
+    alg->setMaxAngle(get<0>(GetParam()));
+    alg->setAngleThresh(300);
+    alg->setMinScale(0.8);
+    alg->setMaxScale(get<1>(GetParam()));
+    alg->setScaleStep(0.05);
+    alg->setScaleThresh(100);
+    alg->setPosThresh(20);
+    alg->setTemplate(templ);
+
+    std::vector<Vec4f> positions;
+    std::vector<Vec3i> votes;
+    TEST_CYCLE() alg->detect(img, positions, votes);
+
+    SANITY_CHECK_NOTHING();
+}
+
+} // namespace
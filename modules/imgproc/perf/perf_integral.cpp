@@ -136,4 +136,63 @@ PERF_TEST_P( Size_MatType_OutMatDepth, integral_sqsum_tilted,
     SANITY_CHECK(tilted, 1e-6, tilted.depth() > CV_32S ? ERROR_RELATIVE : ERROR_ABSOLUTE);
 }
 
+typedef tuple<Size, Size> Size_RoiSize_t;
+typedef perf::TestBaseWithParam<Size_RoiSize_t> Size_RoiSize;
+
+// full integral of the frame vs update of the changed region
+PERF_TEST_P(Size_RoiSize, IntegralImage_update,
+            testing::Combine(
+                testing::Values(szVGA, sz1080p),
+                testing::Values(Size(0, 0), Size(32, 32), Size(128, 128))
+                )
+            )
+{
+    Size sz = get<0>(GetParam());
+    Size roiSize = get<1>(GetParam());
+
+    Mat src(sz, CV_8UC1);
+    declare.in(src, WARMUP_RNG);
+    Ptr<IntegralImage> ii = createIntegralImage();
+    ii->compute(src);
+    Rect roi(Point(sz.width / 2, sz.height / 2), roiSize);
+
+    if (roi.empty())
+    {
+        TEST_CYCLE() ii->compute(src);
+    }
+    else
+    {
+        TEST_CYCLE() ii->update(src, roi);
+    }
+
+    SANITY_CHECK_NOTHING();
+}
+
+PERF_TEST_P(Size_MatType, IntegralImage_boxStats,
+            testing::Combine(
+                testing::Values(szVGA),
+                testing::Values(CV_8UC1, CV_8UC3)
+                )
+            )
+{
+    Size sz = get<0>(GetParam());
+    int matType = get<1>(GetParam());
+
+    Mat src(sz, matType);
+    declare.in(src, WARMUP_RNG);
+    Ptr<IntegralImage> ii = createIntegralImage();
+    ii->compute(src);
+
+    // sliding windows as in HOG/Haar-like scoring
+    std::vector<Rect> boxes;
+    for (int y = 0; y + 32 <= sz.height; y += 4)
+        for (int x = 0; x + 16 <= sz.width; x += 4)
+            boxes.push_back(Rect(x, y, 16, 32));
+    Mat means, variances;
+
+    TEST_CYCLE() ii->boxStats(boxes, means, variances);
+
+    SANITY_CHECK_NOTHING();
+}
+
 } // namespace
@@ -81,4 +81,46 @@ PERF_TEST_P(ImgSize_TmplSize_Method, matchTemplateBig,
     SANITY_CHECK(result, eps);
 }
 
+typedef tuple<MethodType, bool> Method_Matcher_t;
+typedef perf::TestBaseWithParam<Method_Matcher_t> Method_Matcher;
+
+// 30 templates of 3 sizes against a VGA frame: matchTemplate() calls vs TemplateMatcher with cached spectra
+PERF_TEST_P(Method_Matcher, matchTemplateBatch,
+            testing::Combine(
+                testing::Values(TM_CCORR, TM_SQDIFF_NORMED, TM_CCOEFF_NORMED),
+                testing::Bool()
+                )
+            )
+{
+    int method = get<0>(GetParam());
+    bool useMatcher = get<1>(GetParam());
+
+    Mat img(szVGA, CV_8UC1);
+    std::vector<Mat> templs(30);
+    for (size_t i = 0; i < templs.size(); i++)
+        templs[i].create(i % 3 == 0 ? Size(16, 16) : i % 3 == 1 ? Size(32, 24) : Size(48, 48), CV_8UC1);
+    declare.in(img, WARMUP_RNG);
+    for (size_t i = 0; i < templs.size(); i++)
+        declare.in(templs[i], WARMUP_RNG);
+
+    std::vector<Mat> results(templs.size());
+    Ptr<TemplateMatcher> matcher = createTemplateMatcher(templs, method);
+    matcher->match(img, results);
+
+    if (useMatcher)
+    {
+        TEST_CYCLE() matcher->match(img, results);
+    }
+    else
+    {
+        TEST_CYCLE()
+        {
+            for (size_t i = 0; i < templs.size(); i++)
+                matchTemplate(img, templs[i], results[i], method);
+        }
+    }
+
+    SANITY_CHECK_NOTHING();
+}
+
 } // namespace
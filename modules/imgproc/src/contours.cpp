@@ -1813,6 +1813,347 @@ cvFindContours( void*  img,  CvMemStorage*  storage,
     return cvFindContours_Impl(img, storage, firstContour, cntHeaderSize, mode, method, offset, 1);
 }
 
+namespace cv
+{
+
+/*
+    Parallel contour retrieval for large 8-bit images (CHAIN_APPROX_NONE and CHAIN_APPROX_SIMPLE).
+
+    The raster scan of Suzuki's algorithm meets every border at a fixed pixel:
+        - the outer border of an 8-connected component of non-zero pixels starts
+          at the top-left pixel of the component;
+        - the border of a hole (4-connected component of zero pixels not connected to the frame)
+          starts at the left neighbour of the top-left pixel of the hole.
+    The parent of an outer border is the border of the hole around the component,
+    the parent of a hole border is the outer border of the component around the hole.
+    So the components are labeled in horizontal stripes in parallel, the labels of neighbour
+    stripes are merged along the stripe bounds, and the borders are traced independently.
+    The output (order of contours, points and hierarchy) is the same as for the sequential scan.
+*/
+
+struct ContourRun
+{
+    int start, end, label;
+};
+
+struct ContourStripe
+{
+    int y0, y1;
+    std::vector<int> parent;    // union-find forest of the labels
+    std::vector<Point> origin;  // the first pixel of a label in raster order
+    std::vector<int> left;      // label of the left neighbour of the origin (-1 for none)
+    std::vector<ContourRun> firstRow, lastRow;
+};
+
+static inline int findContourLabel(std::vector<int>& parent, int i)
+{
+    while (parent[i] != i)
+    {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+    return i;
+}
+
+// the smaller label becomes the root, so every root is the first label of its component in raster order
+static inline void uniteContourLabels(std::vector<int>& parent, int a, int b)
+{
+    a = findContourLabel(parent, a);
+    b = findContourLabel(parent, b);
+    if (a < b)
+        parent[b] = a;
+    else if (b < a)
+        parent[a] = b;
+}
+
+static int findContourRunEnd(const uchar* row, int x, int width, bool fg)
+{
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+    const v_uint8 v_zero = vx_setzero_u8();
+    for (; x <= width - VTraits<v_uint8>::vlanes(); x += VTraits<v_uint8>::vlanes())
+    {
+        v_uint8 vmask = fg ? v_eq(vx_load(row + x), v_zero) : v_ne(vx_load(row + x), v_zero);
+        if (v_check_any(vmask))
+            return x + v_scan_forward(vmask);
+    }
+#endif
+    for (; x < width && (row[x] != 0) == fg; x++)
+        ;
+    return x;
+}
+
+/*
+    Connects the runs of a row to the runs of the previous row: non-zero pixels are 8-connected,
+    zero pixels are 4-connected. Every row starts with a zero run (the image has zero border),
+    so the odd runs are the non-zero ones.
+*/
+static inline int connectContourRun(std::vector<int>& parent, const std::vector<ContourRun>& prevRuns, size_t& k,
+                                    int start, int end, bool fg, int label)
+{
+    const int lo = fg ? start - 1 : start, hi = fg ? end + 1 : end;
+    while (k < prevRuns.size() && prevRuns[k].end <= lo)
+        k++;
+    for (size_t j = k; j < prevRuns.size() && prevRuns[j].start < hi; j++)
+    {
+        if (((j & 1) != 0) != fg)
+            continue;
+        if (label < 0)
+            label = prevRuns[j].label;
+        else
+            uniteContourLabels(parent, label, prevRuns[j].label);
+    }
+    return label;
+}
+
+static void labelContourStripe(const Mat& img, ContourStripe& stripe)
+{
+    const int width = img.cols;
+    std::vector<ContourRun> prevRuns, runs;
+
+    for (int y = stripe.y0; y < stripe.y1; y++)
+    {
+        const uchar* row = img.ptr<uchar>(y);
+        size_t k = 0;
+        runs.clear();
+        for (int x = 0; x < width; )
+        {
+            const bool fg = (runs.size() & 1) != 0;
+            const int end = findContourRunEnd(row, x, width, fg);
+            int label = connectContourRun(stripe.parent, prevRuns, k, x, end, fg, -1);
+            if (label < 0)
+            {
+                label = (int)stripe.parent.size();
+                stripe.parent.push_back(label);
+                stripe.origin.push_back(Point(x, y));
+                stripe.left.push_back(runs.empty() ? -1 : runs.back().label);
+            }
+            ContourRun run = { x, end, label };
+            runs.push_back(run);
+            x = end;
+        }
+        if (y == stripe.y0)
+            stripe.firstRow = runs;
+        std::swap(prevRuns, runs);
+    }
+    stripe.lastRow = prevRuns;
+}
+
+// the same border following as icvFetchContour(), but the image is not marked
+static void traceContourBorder(const uchar* ptr, int step, Point pt, bool isHole, bool simple, std::vector<Point>& points)
+{
+    int deltas[MAX_SIZE];
+    CV_INIT_3X3_DELTAS(deltas, step, 1);
+    memcpy(deltas + 8, deltas, 8 * sizeof(deltas[0]));
+
+    const uchar *i0 = ptr, *i1, *i3, *i4 = 0;
+    int s, s_end, prev_s;
+
+    s_end = s = isHole ? 0 : 4;
+    do
+    {
+        s = (s - 1) & 7;
+        i1 = i0 + deltas[s];
+    }
+    while (*i1 == 0 && s != s_end);
+
+    if (s == s_end)
+    {
+        points.push_back(pt);
+        return;
+    }
+
+    i3 = i0;
+    prev_s = s ^ 4;
+    for (;;)
+    {
+        s = std::min(s, MAX_SIZE - 1);
+        while (s < MAX_SIZE - 1)
+        {
+            i4 = i3 + deltas[++s];
+            if (*i4 != 0)
+                break;
+        }
+        s &= 7;
+
+        if (s != prev_s || !simple)
+        {
+            points.push_back(pt);
+            prev_s = s;
+        }
+        pt.x += icvCodeDeltas[s].x;
+        pt.y += icvCodeDeltas[s].y;
+
+        if (i4 == i0 && i3 == i1)
+            break;
+        i3 = i4;
+        s = (s + 4) & 7;
+    }
+}
+
+/*
+    image - 8-bit image with one pixel of zero border.
+    Returns false if the parallel path is not applicable.
+*/
+static bool findContoursParallel(const Mat& image, OutputArrayOfArrays _contours, OutputArray _hierarchy,
+                                 int mode, int method, Point offset)
+{
+    if (image.type() != CV_8UC1 || image.total() < ((size_t)1 << 18) ||
+        (method != CHAIN_APPROX_NONE && method != CHAIN_APPROX_SIMPLE) ||
+        (mode != RETR_EXTERNAL && mode != RETR_LIST && mode != RETR_CCOMP && mode != RETR_TREE))
+        return false;
+    const int nthreads = getNumThreads();
+    if (nthreads <= 1)
+        return false;
+
+    const int height = image.rows;
+    const int nstripes = std::min(nthreads * 4, std::max(height / 64, 1));
+    std::vector<ContourStripe> stripes(nstripes);
+    for (int i = 0; i < nstripes; i++)
+    {
+        stripes[i].y0 = (int)((int64)height * i / nstripes);
+        stripes[i].y1 = (int)((int64)height * (i + 1) / nstripes);
+    }
+    parallel_for_(Range(0, nstripes), [&](const Range& r)
+    {
+        for (int i = r.start; i < r.end; i++)
+            labelContourStripe(image, stripes[i]);
+    });
+
+    // global labels: labels of the stripe i are shifted by bases[i]
+    std::vector<int> bases(nstripes + 1, 0);
+    for (int i = 0; i < nstripes; i++)
+        bases[i + 1] = bases[i] + (int)stripes[i].parent.size();
+    const int nlabels = bases[nstripes];
+    std::vector<int> parent(nlabels), left(nlabels);
+    std::vector<Point> origin(nlabels);
+    for (int i = 0; i < nstripes; i++)
+    {
+        const ContourStripe& st = stripes[i];
+        const int base = bases[i];
+        for (size_t j = 0; j < st.parent.size(); j++)
+        {
+            parent[base + j] = st.parent[j] + base;
+            left[base + j] = st.left[j] >= 0 ? st.left[j] + base : -1;
+            origin[base + j] = st.origin[j];
+        }
+    }
+
+    for (int i = 1; i < nstripes; i++)
+    {
+        std::vector<ContourRun> above = stripes[i - 1].lastRow;
+        const std::vector<ContourRun>& below = stripes[i].firstRow;
+        for (size_t j = 0; j < above.size(); j++)
+            above[j].label += bases[i - 1];
+        size_t k = 0;
+        for (size_t j = 0; j < below.size(); j++)
+            connectContourRun(parent, above, k, below[j].start, below[j].end, (j & 1) != 0, below[j].label + bases[i]);
+    }
+
+    // walk the components in raster order of their first pixels, as the sequential scan meets the borders.
+    // Label 0 is the zero component touching the frame.
+    std::vector<int> borderOf(nlabels, -1);
+    std::vector<Point> starts;
+    std::vector<uchar> holes;
+    std::vector<int> parents;
+    for (int l = 0; l < nlabels; l++)
+    {
+        if (findContourLabel(parent, l) != l)
+            continue;
+        const Point pt = origin[l];
+        int outer = -1;
+        if (image.at<uchar>(pt) != 0)
+        {
+            const int hole = findContourLabel(parent, left[l]);
+            if (mode == RETR_EXTERNAL && hole != 0)
+                continue;
+            outer = mode == RETR_TREE && hole != 0 ? borderOf[hole] : -1;
+            starts.push_back(pt);
+        }
+        else
+        {
+            if (l == 0 || mode == RETR_EXTERNAL)
+                continue;
+            if (mode != RETR_LIST)
+                outer = borderOf[findContourLabel(parent, left[l])];
+            starts.push_back(Point(pt.x - 1, pt.y));
+        }
+        borderOf[l] = (int)parents.size();
+        holes.push_back(image.at<uchar>(pt) == 0);
+        parents.push_back(outer);
+    }
+
+    const int total = (int)parents.size();
+    std::vector<std::vector<Point> > points(total);
+    const bool simple = method == CHAIN_APPROX_SIMPLE;
+    parallel_for_(Range(0, total), [&](const Range& r)
+    {
+        for (int i = r.start; i < r.end; i++)
+        {
+            std::vector<Point>& c = points[i];
+            traceContourBorder(image.ptr<uchar>(starts[i].y, starts[i].x), (int)image.step, starts[i],
+                               holes[i] != 0, simple, c);
+            for (size_t j = 0; j < c.size(); j++)
+                c[j] += offset;
+        }
+    });
+
+    // the sequential scan prepends every new border to the children of its parent
+    // and returns the tree in depth-first order
+    std::vector<std::vector<int> > children(total + 1);
+    std::vector<int> siblingIdx(total);
+    for (int i = 0; i < total; i++)
+    {
+        siblingIdx[i] = (int)children[parents[i] + 1].size();
+        children[parents[i] + 1].push_back(i);
+    }
+    std::vector<int> order, index(total), stack(children[0]);
+    order.reserve(total);
+    while (!stack.empty())
+    {
+        const int i = stack.back();
+        stack.pop_back();
+        index[i] = (int)order.size();
+        order.push_back(i);
+        stack.insert(stack.end(), children[i + 1].begin(), children[i + 1].end());
+    }
+
+    if (_hierarchy.needed())
+        _hierarchy.clear();
+    if (total == 0)
+    {
+        _contours.clear();
+        return true;
+    }
+    _contours.create(total, 1, 0, -1, true);
+    for (int i = 0; i < total; i++)
+    {
+        const std::vector<Point>& c = points[order[i]];
+        _contours.create((int)c.size(), 1, CV_32SC2, i, true);
+        Mat ci = _contours.getMat(i);
+        CV_Assert(ci.isContinuous());
+        memcpy(ci.ptr(), &c[0], c.size() * sizeof(c[0]));
+    }
+
+    if (_hierarchy.needed())
+    {
+        _hierarchy.create(1, total, CV_32SC4, -1, true);
+        Vec4i* hierarchy = _hierarchy.getMat().ptr<Vec4i>();
+        for (int i = 0; i < total; i++)
+        {
+            const std::vector<int>& siblings = children[parents[i] + 1];
+            const std::vector<int>& kids = children[i + 1];
+            const size_t k = siblingIdx[i];
+            hierarchy[index[i]] = Vec4i(k > 0 ? index[siblings[k - 1]] : -1,
+                                        k + 1 < siblings.size() ? index[siblings[k + 1]] : -1,
+                                        kids.empty() ? -1 : index[kids.back()],
+                                        parents[i] >= 0 ? index[parents[i]] : -1);
+        }
+    }
+    return true;
+}
+
+}
+
 void cv::findContours( InputArray _image, OutputArrayOfArrays _contours,
                    OutputArray _hierarchy, int mode, int method, Point offset )
 {
@@ -1835,6 +2176,8 @@ void cv::findContours( InputArray _image, OutputArrayOfArrays _contours,
     {
         image = image0;
     }
+    if (method != CV_LINK_RUNS && findContoursParallel(image, _contours, _hierarchy, mode, method, offset0 + offset))
+        return;
     MemStorage storage(cvCreateMemStorage());
     CvMat _cimage = cvMat(image);
     CvSeq* _ccontours = 0;
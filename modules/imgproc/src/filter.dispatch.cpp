@@ -46,6 +46,7 @@
 #undef CV_LOG_STRIP_LEVEL
 #define CV_LOG_STRIP_LEVEL CV_LOG_LEVEL_DEBUG + 1
 #include <opencv2/core/utils/logger.hpp>
+#include <opencv2/core/utils/configuration.private.hpp>
 
 #include "opencv2/core/opencl/ocl_defs.hpp"
 #include "opencl_kernels_imgproc.hpp"
@@ -218,6 +219,50 @@ void FilterEngine::apply(const Mat& src, Mat& dst, const Size& wsz, const Point&
         CV_CPU_DISPATCH_MODES_ALL);
 }
 
+bool applyFilterTiled(const std::function<Ptr<FilterEngine>()>& createEngine,
+                      const Mat& src, Mat& dst, const Size& wsz, const Point& ofs, const Size& ksize)
+{
+    // opt-in: the gain depends on the cache sizes and the kernel, see perf_filter_tiling.cpp.
+    // Not cached, so it may be switched at runtime (the lookup is negligible next to creating an engine)
+    const size_t param_min_pixels = utils::getConfigurationParameterSizeT("OPENCV_IMGPROC_FILTER_TILING_MIN_PIXELS", 0);
+    if (param_min_pixels == 0 || src.total() < param_min_pixels)
+        return false;
+
+    // neighbouring tiles would overwrite the source rows of each other
+    const uchar* src0 = src.ptr();
+    const uchar* src1 = src.ptr(src.rows - 1) + src.cols*src.elemSize();
+    const uchar* dst0 = dst.ptr();
+    const uchar* dst1 = dst.ptr(dst.rows - 1) + dst.cols*dst.elemSize();
+    if (src0 < dst1 && dst0 < src1)
+        return false;
+
+    // the ring buffer of an engine holds ksize.height rows of a tile (of up to 32-bit elements), keep it in L2
+    const size_t bufPixelSize = src.channels()*std::max(src.elemSize1(), (size_t)4);
+    int tileWidth = (int)((1 << 17) / (bufPixelSize*(ksize.height + 2)));
+    tileWidth = std::max(tileWidth & ~63, 256);
+    const int ntilesX = divUp(src.cols, std::min(tileWidth, src.cols));
+    tileWidth = divUp(src.cols, ntilesX);
+
+    // every tile reads ksize.height - 1 extra rows, make tiles tall enough to amortize that
+    int tileHeight = std::max(16*ksize.height, 64);
+    const int ntilesY = divUp(src.rows, std::min(tileHeight, src.rows));
+    tileHeight = divUp(src.rows, ntilesY);
+
+    const int ntiles = ntilesX*ntilesY;
+    parallel_for_(Range(0, ntiles), [&](const Range& range)
+    {
+        Ptr<FilterEngine> f = createEngine();
+        for (int i = range.start; i < range.end; i++)
+        {
+            Rect tile(i % ntilesX*tileWidth, i / ntilesX*tileHeight, tileWidth, tileHeight);
+            tile &= Rect(0, 0, src.cols, src.rows);
+            Mat dstTile = dst(tile);
+            f->apply(src(tile), dstTile, wsz, ofs + tile.tl());
+        }
+    }, std::min(ntiles, getNumThreads()*4));
+    return true;
+}
+
 /****************************************************************************************\
 *                                 Separable linear filter                                *
 \****************************************************************************************/
@@ -1353,10 +1398,16 @@ static void ocvFilter2D(int stype, int dtype, int kernel_type,
 {
     int borderTypeValue = borderType & ~BORDER_ISOLATED;
     Mat kernel = Mat(Size(kernel_width, kernel_height), kernel_type, kernel_data, kernel_step);
-    Ptr<FilterEngine> f = createLinearFilter(stype, dtype, kernel, Point(anchor_x, anchor_y), delta,
-                                             borderTypeValue);
+    auto createEngine = [&]()
+    {
+        return createLinearFilter(stype, dtype, kernel, Point(anchor_x, anchor_y), delta,
+                                  borderTypeValue);
+    };
     Mat src(Size(width, height), stype, src_data, src_step);
     Mat dst(Size(width, height), dtype, dst_data, dst_step);
+    if (applyFilterTiled(createEngine, src, dst, Size(full_width, full_height), Point(offset_x, offset_y), kernel.size()))
+        return;
+    Ptr<FilterEngine> f = createEngine();
     f->apply(src, dst, Size(full_width, full_height), Point(offset_x, offset_y));
 }
 
@@ -1393,11 +1444,18 @@ static void ocvSepFilter(int stype, int dtype, int ktype,
 {
     Mat kernelX(Size(kernelx_len, 1), ktype, kernelx_data);
     Mat kernelY(Size(kernely_len, 1), ktype, kernely_data);
-    Ptr<FilterEngine> f = createSeparableLinearFilter(stype, dtype, kernelX, kernelY,
-                                                      Point(anchor_x, anchor_y),
-                                                      delta, borderType & ~BORDER_ISOLATED);
+    auto createEngine = [&]()
+    {
+        return createSeparableLinearFilter(stype, dtype, kernelX, kernelY,
+                                           Point(anchor_x, anchor_y),
+                                           delta, borderType & ~BORDER_ISOLATED);
+    };
     Mat src(Size(width, height), stype, src_data, src_step);
     Mat dst(Size(width, height), dtype, dst_data, dst_step);
+    if (applyFilterTiled(createEngine, src, dst, Size(full_width, full_height), Point(offset_x, offset_y),
+                         Size(kernelx_len, kernely_len)))
+        return;
+    Ptr<FilterEngine> f = createEngine();
     f->apply(src, dst, Size(full_width, full_height), Point(offset_x, offset_y));
 }
 
@@ -64,6 +64,17 @@ bool ocl_sepFilter2D_BitExact(
 
 void preprocess2DKernel(const Mat& kernel, std::vector<Point>& coords, std::vector<uchar>& coeffs);
 
+/** Applies filter engines to a large image by 2D tiles in parallel.
+
+Every parallel stripe gets its own engine from createEngine. A tile reads its neighbourhood from the image
+(within wsz, same as the ROI semantics of FilterEngine::apply), so the result is bitwise the same as of
+a single apply() call, while the row buffers of an engine cover a tile instead of the whole image width.
+Tiling is disabled by default, OPENCV_IMGPROC_FILTER_TILING_MIN_PIXELS=N enables it for images of at least N pixels.
+Returns false, doing nothing, if tiling is disabled, doesn't pay off (small image) or isn't possible (in-place processing).
+*/
+bool applyFilterTiled(const std::function<Ptr<FilterEngine>()>& createEngine,
+                      const Mat& src, Mat& dst, const Size& wsz, const Point& ofs, const Size& ksize);
+
 }  // namespace
 
 #endif
@@ -449,6 +449,247 @@ floodFillGrad_CnIR( Mat& image, Mat& msk,
     }
 }
 
+struct FFillDiffBuf
+{
+    Vec3b b;
+    Vec3i i;
+    Vec3f f;
+};
+
+static void convertFFillDiff( const Scalar& diff, int depth, int cn, FFillDiffBuf& buf )
+{
+    if( depth == CV_8U )
+        for( int i = 0; i < cn; i++ )
+        {
+#if defined(__GNUC__) && (__GNUC__ == 12)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wstringop-overflow"
+#endif
+            buf.b[i] = saturate_cast<uchar>(cvFloor(diff[i]));
+#if defined(__GNUC__) && (__GNUC__ == 12)
+#pragma GCC diagnostic pop
+#endif
+        }
+    else if( depth == CV_32S )
+        for( int i = 0; i < cn; i++ )
+            buf.i[i] = cvFloor(diff[i]);
+    else if( depth == CV_32F )
+        for( int i = 0; i < cn; i++ )
+            buf.f[i] = (float)diff[i];
+    else
+        CV_Error( cv::Error::StsUnsupportedFormat, "" );
+}
+
+/****************************************************************************************\
+*                                  Multi-seed Floodfill                                  *
+\****************************************************************************************/
+
+/*
+    In the floating range mode with loDiff == upDiff the neighbor pixels are connected both ways,
+    so the seeds sharing the mask fill the connected components of the non-masked pixels. They are
+    labelled in one pass: the image is split into horizontal stripes, every stripe is labelled in
+    parallel and the labels are merged across the stripe bounds with union-find.
+
+    labels[y*width + x] refers to a pixel with a smaller or the same index, the roots refer to themselves.
+    The root of a component filled from the seed s is set to -1 - s.
+*/
+
+static inline int findFFillLabel( int* labels, int i )
+{
+    while( labels[i] != i )
+    {
+        labels[i] = labels[labels[i]];
+        i = labels[i];
+    }
+    return i;
+}
+
+static inline void uniteFFillLabels( int* labels, int a, int b )
+{
+    a = findFFillLabel(labels, a);
+    b = findFFillLabel(labels, b);
+    if( a < b )
+        labels[b] = a;
+    else if( b < a )
+        labels[a] = b;
+}
+
+// returns the seed filling the component of the pixel i or -1, does not modify labels
+static inline int getFFillLabelSeed( const int* labels, int i )
+{
+    while( labels[i] >= 0 && labels[i] != i )
+        i = labels[i];
+    return labels[i] < 0 ? -1 - labels[i] : -1;
+}
+
+template<typename _Tp, class Diff>
+static void
+labelFFillRow( const Mat& image, const Mat& mask, int* labels, int y, const Diff& diff )
+{
+    const int width = image.cols;
+    const _Tp* img = image.ptr<_Tp>(y);
+    const uchar* m = mask.ptr(y + 1) + 1;
+    int* lab = labels + y*width;
+
+    // the mask border stops the runs at x == 0
+    for( int x = 0; x < width; x++ )
+        lab[x] = !m[x] && !m[x - 1] && diff( img + x, img + (x - 1) ) ? lab[x - 1] : y*width + x;
+}
+
+// unites the pixels of the row y with the connected pixels of the row y - 1
+template<typename _Tp, class Diff>
+static void
+uniteFFillRows( const Mat& image, const Mat& mask, int* labels, int y, const Diff& diff, int _8_connectivity )
+{
+    const int width = image.cols;
+    const _Tp* img = image.ptr<_Tp>(y);
+    const _Tp* img1 = image.ptr<_Tp>(y - 1);
+    const uchar* m = mask.ptr(y + 1) + 1;
+    const uchar* m1 = mask.ptr(y) + 1;
+    const int* lab = labels + y*width;
+    const int* lab1 = lab - width;
+    int lastA = -1, lastB = -1;
+
+    for( int x = 0; x < width; x++ )
+    {
+        if( m[x] )
+            continue;
+
+        const int a = lab[x];
+        for( int x1 = x - _8_connectivity; x1 <= x + _8_connectivity; x1++ )
+        {
+            if( m1[x1] )
+                continue;
+
+            // the neighbor pixels of the same runs are united once
+            const int b = lab1[x1];
+            if( (a != lastA || b != lastB) && diff( img + x, img1 + x1 ) )
+            {
+                uniteFFillLabels(labels, a, b);
+                lastA = a;
+                lastB = b;
+            }
+        }
+    }
+}
+
+template<typename _Tp, class Diff>
+static void
+floodFillMulti_CnIR( Mat& image, Mat& msk, const std::vector<Point>& seeds,
+                     _Tp newVal, uchar newMaskVal, Diff diff, int flags,
+                     std::vector<ConnectedComp>& comps )
+{
+    const Size size = image.size();
+    const int nseeds = (int)seeds.size();
+    const int _8_connectivity = (flags & 255) == 8;
+    const bool fillImage = (flags & FLOODFILL_MASK_ONLY) == 0;
+    const int nstripes = std::max(1, std::min(getNumThreads() * 4, size.height / 32));
+
+    CV_Assert( (int64)size.width * size.height < INT_MAX );
+    std::vector<int> _labels((size_t)size.width * size.height);
+    int* labels = &_labels[0];
+
+    parallel_for_(Range(0, nstripes), [&](const Range& range)
+    {
+        for( int s = range.start; s < range.end; s++ )
+        {
+            const int y0 = s * size.height / nstripes, y1 = (s + 1) * size.height / nstripes;
+            for( int y = y0; y < y1; y++ )
+            {
+                labelFFillRow<_Tp>(image, msk, labels, y, diff);
+                if( y > y0 )
+                    uniteFFillRows<_Tp>(image, msk, labels, y, diff, _8_connectivity);
+            }
+        }
+    }, nstripes);
+
+    for( int s = 1; s < nstripes; s++ )
+        uniteFFillRows<_Tp>(image, msk, labels, s * size.height / nstripes, diff, _8_connectivity);
+
+    // the first seed of every component fills it, the other ones fill nothing
+    for( int s = 0; s < nseeds; s++ )
+    {
+        const Point pt = seeds[s];
+        comps[s].pt = pt;
+        if( msk.at<uchar>(pt.y + 1, pt.x + 1) )
+            continue;
+
+        int root = pt.y*size.width + pt.x;
+        while( labels[root] >= 0 && labels[root] != root )
+            root = labels[root];
+        if( labels[root] >= 0 )
+        {
+            labels[root] = -1 - s;
+            comps[s].label = newMaskVal;
+        }
+    }
+
+    std::vector<int> areas((size_t)nstripes * nseeds, 0);
+    std::vector<Vec4i> bounds((size_t)nstripes * nseeds, Vec4i(INT_MAX, INT_MAX, -1, -1));
+
+    parallel_for_(Range(0, nstripes), [&](const Range& range)
+    {
+        for( int s = range.start; s < range.end; s++ )
+        {
+            const int y0 = s * size.height / nstripes, y1 = (s + 1) * size.height / nstripes;
+            int* area = &areas[(size_t)s * nseeds];
+            Vec4i* bound = &bounds[(size_t)s * nseeds];
+
+            for( int y = y0; y < y1; y++ )
+            {
+                _Tp* img = image.ptr<_Tp>(y);
+                uchar* m = msk.ptr(y + 1) + 1;
+                const int* lab = labels + y*size.width;
+
+                for( int x = 0; x < size.width; )
+                {
+                    if( m[x] )
+                    {
+                        x++;
+                        continue;
+                    }
+
+                    // x starts a run, the other pixels of the run refer to it
+                    const int start = y*size.width + x;
+                    int x1 = x + 1;
+                    while( x1 < size.width && lab[x1] == start )
+                        x1++;
+
+                    const int seed = getFFillLabelSeed(labels, start);
+                    if( seed >= 0 )
+                    {
+                        memset(m + x, newMaskVal, x1 - x);
+                        if( fillImage )
+                            for( int i = x; i < x1; i++ )
+                                img[i] = newVal;
+
+                        Vec4i& b = bound[seed];
+                        area[seed] += x1 - x;
+                        b[0] = std::min(b[0], x);
+                        b[1] = std::min(b[1], y);
+                        b[2] = std::max(b[2], x1 - 1);
+                        b[3] = std::max(b[3], y);
+                    }
+                    x = x1;
+                }
+            }
+        }
+    }, nstripes);
+
+    for( int s = 0; s < nseeds; s++ )
+    {
+        Vec4i b(INT_MAX, INT_MAX, -1, -1);
+        for( int k = 0; k < nstripes; k++ )
+        {
+            const Vec4i& bk = bounds[(size_t)k * nseeds + s];
+            comps[s].area += areas[(size_t)k * nseeds + s];
+            b = Vec4i(std::min(b[0], bk[0]), std::min(b[1], bk[1]), std::max(b[2], bk[2]), std::max(b[3], bk[3]));
+        }
+        if( comps[s].area > 0 )
+            comps[s].rect = Rect(b[0], b[1], b[2] - b[0] + 1, b[3] - b[1] + 1);
+    }
+}
+
 }
 
 /****************************************************************************************\
@@ -476,7 +717,7 @@ int cv::floodFill( InputOutputArray _image, InputOutputArray _mask,
     } nv_buf;
     nv_buf._[0] = nv_buf._[1] = nv_buf._[2] = nv_buf._[3] = 0;
 
-    struct { Vec3b b; Vec3i i; Vec3f f; } ld_buf, ud_buf;
+    FFillDiffBuf ld_buf, ud_buf;
 
     Mat img = _image.getMat(), mask;
 
@@ -557,33 +798,8 @@ int cv::floodFill( InputOutputArray _image, InputOutputArray _mask,
         }
     }
 
-    if( depth == CV_8U )
-        for( i = 0; i < cn; i++ )
-        {
-#if defined(__GNUC__) && (__GNUC__ == 12)
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wstringop-overflow"
-#endif
-            ld_buf.b[i] = saturate_cast<uchar>(cvFloor(loDiff[i]));
-            ud_buf.b[i] = saturate_cast<uchar>(cvFloor(upDiff[i]));
-#if defined(__GNUC__) && (__GNUC__ == 12)
-#pragma GCC diagnostic pop
-#endif
-        }
-    else if( depth == CV_32S )
-        for( i = 0; i < cn; i++ )
-        {
-            ld_buf.i[i] = cvFloor(loDiff[i]);
-            ud_buf.i[i] = cvFloor(upDiff[i]);
-        }
-    else if( depth == CV_32F )
-        for( i = 0; i < cn; i++ )
-        {
-            ld_buf.f[i] = (float)loDiff[i];
-            ud_buf.f[i] = (float)upDiff[i];
-        }
-    else
-        CV_Error( cv::Error::StsUnsupportedFormat, "" );
+    convertFFillDiff( loDiff, depth, cn, ld_buf );
+    convertFFillDiff( upDiff, depth, cn, ud_buf );
 
     uchar newMaskVal = (uchar)((flags & 0xff00) == 0 ? 1 : ((flags >> 8) & 255));
 
@@ -637,6 +853,154 @@ int cv::floodFill( InputOutputArray _image, Point seedPoint,
 }
 
 
+int cv::floodFillMulti( InputOutputArray _image, InputOutputArray _mask,
+                        const std::vector<Point>& seedPoints, Scalar newVal,
+                        OutputArray _areas, OutputArray _rects,
+                        Scalar loDiff, Scalar upDiff, int flags )
+{
+    CV_INSTRUMENT_REGION();
+
+    Mat img = _image.getMat(), mask;
+    Size size = img.size();
+    int type = img.type();
+    int depth = img.depth();
+    int cn = img.channels();
+    int i, nseeds = (int)seedPoints.size();
+
+    if ( (cn != 1) && (cn != 3) )
+    {
+        CV_Error( cv::Error::StsBadArg, "Number of channels in input image must be 1 or 3" );
+    }
+
+    const int connectivity = flags & 255;
+    if( connectivity != 0 && connectivity != 4 && connectivity != 8 )
+        CV_Error( cv::Error::StsBadFlag, "Connectivity must be 4, 0(=4) or 8" );
+
+    for( i = 0; i < cn; i++ )
+    {
+        if( loDiff[i] < 0 || upDiff[i] < 0 )
+            CV_Error( cv::Error::StsBadArg, "lo_diff and up_diff must be non-negative" );
+    }
+
+    for( i = 0; i < nseeds; i++ )
+    {
+        if( (unsigned)seedPoints[i].x >= (unsigned)size.width ||
+           (unsigned)seedPoints[i].y >= (unsigned)size.height )
+            CV_Error( cv::Error::StsOutOfRange, "Seed point is outside of image" );
+    }
+
+    // the seeds share the mask, so the filled areas don't overlap
+    if( _mask.needed() )
+    {
+        if( _mask.empty() )
+        {
+            _mask.create( size.height + 2, size.width + 2, CV_8UC1 );
+            _mask.setTo(0);
+        }
+        mask = _mask.getMat();
+    }
+    else
+        mask = Mat::zeros( size.height + 2, size.width + 2, CV_8UC1 );
+
+    CV_CheckTypeEQ( mask.type(), CV_8U, "" );
+    CV_CheckEQ( mask.rows, size.height + 2, "" );
+    CV_CheckEQ( mask.cols, size.width + 2, "" );
+
+    Mat mask_inner = mask( Rect(1, 1, mask.cols - 2, mask.rows - 2) );
+    copyMakeBorder( mask_inner, mask, 1, 1, 1, 1, BORDER_ISOLATED | BORDER_CONSTANT, Scalar(1) );
+
+    FFillDiffBuf ld_buf, ud_buf;
+    convertFFillDiff( loDiff, depth, cn, ld_buf );
+    convertFFillDiff( upDiff, depth, cn, ud_buf );
+
+    bool symmetric = true;
+    for( i = 0; i < cn; i++ )
+        symmetric = symmetric && (depth == CV_8U ? ld_buf.b[i] == ud_buf.b[i] :
+                                  depth == CV_32S ? ld_buf.i[i] == ud_buf.i[i] : ld_buf.f[i] == ud_buf.f[i]);
+
+    std::vector<ConnectedComp> comps(nseeds);
+
+    // a single seed or a one-way connectivity is filled seed by seed
+    if( nseeds < 2 || (flags & FLOODFILL_FIXED_RANGE) || !symmetric )
+    {
+        for( i = 0; i < nseeds; i++ )
+            comps[i].area = floodFill( img, mask, seedPoints[i], newVal, &comps[i].rect, loDiff, upDiff, flags );
+    }
+    else
+    {
+        union {
+            uchar b[4];
+            int i[4];
+            float f[4];
+            double _[4];
+        } nv_buf;
+        nv_buf._[0] = nv_buf._[1] = nv_buf._[2] = nv_buf._[3] = 0;
+        scalarToRawData( newVal, &nv_buf, type, 0);
+
+        uchar newMaskVal = (uchar)((flags & 0xff00) == 0 ? 1 : ((flags >> 8) & 255));
+
+        if( type == CV_8UC1 )
+            floodFillMulti_CnIR<uchar, Diff8uC1>(
+                    img, mask, seedPoints, nv_buf.b[0], newMaskVal,
+                    Diff8uC1(ld_buf.b[0], ud_buf.b[0]), flags, comps);
+        else if( type == CV_8UC3 )
+            floodFillMulti_CnIR<Vec3b, Diff8uC3>(
+                    img, mask, seedPoints, Vec3b(nv_buf.b), newMaskVal,
+                    Diff8uC3(ld_buf.b, ud_buf.b), flags, comps);
+        else if( type == CV_32SC1 )
+            floodFillMulti_CnIR<int, Diff32sC1>(
+                    img, mask, seedPoints, nv_buf.i[0], newMaskVal,
+                    Diff32sC1(ld_buf.i[0], ud_buf.i[0]), flags, comps);
+        else if( type == CV_32SC3 )
+            floodFillMulti_CnIR<Vec3i, Diff32sC3>(
+                    img, mask, seedPoints, Vec3i(nv_buf.i), newMaskVal,
+                    Diff32sC3(ld_buf.i, ud_buf.i), flags, comps);
+        else if( type == CV_32FC1 )
+            floodFillMulti_CnIR<float, Diff32fC1>(
+                    img, mask, seedPoints, nv_buf.f[0], newMaskVal,
+                    Diff32fC1(ld_buf.f[0], ud_buf.f[0]), flags, comps);
+        else if( type == CV_32FC3 )
+            floodFillMulti_CnIR<Vec3f, Diff32fC3>(
+                    img, mask, seedPoints, Vec3f(nv_buf.f), newMaskVal,
+                    Diff32fC3(ld_buf.f, ud_buf.f), flags, comps);
+        else
+            CV_Error(cv::Error::StsUnsupportedFormat, "");
+    }
+
+    int total = 0;
+    for( i = 0; i < nseeds; i++ )
+        total += comps[i].area;
+
+    if( _areas.needed() )
+    {
+        if( nseeds == 0 )
+            _areas.release();
+        else
+        {
+            _areas.create( nseeds, 1, CV_32S );
+            Mat areas = _areas.getMat();
+            for( i = 0; i < nseeds; i++ )
+                areas.at<int>(i) = comps[i].area;
+        }
+    }
+
+    if( _rects.needed() )
+    {
+        if( nseeds == 0 )
+            _rects.release();
+        else
+        {
+            _rects.create( nseeds, 1, CV_32SC4 );
+            Mat rects = _rects.getMat();
+            for( i = 0; i < nseeds; i++ )
+                rects.at<Rect>(i) = comps[i].rect;
+        }
+    }
+
+    return total;
+}
+
+
 CV_IMPL void
 cvFloodFill( CvArr* arr, CvPoint seed_point,
              CvScalar newVal, CvScalar lo_diff, CvScalar up_diff,
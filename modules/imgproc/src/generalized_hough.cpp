@@ -40,6 +40,7 @@
 //M*/
 
 #include "precomp.hpp"
+#include "opencv2/core/hal/intrin.hpp"
 #include <functional>
 #include <limits>
 
@@ -59,6 +60,38 @@ namespace
         return fabs(v) > std::numeric_limits<float>::epsilon();
     }
 
+    /*
+        Runs vote(range, hist) over the items of range in parallel. Every stripe votes into its own
+        histogram and the histograms are summed up, so the result does not depend on the scheduling.
+        hist must be zero-initialized.
+    */
+    template <typename VoteFunc>
+    void parallelVote(const Range& range, Mat& hist, double nstripes, const VoteFunc& vote)
+    {
+        if (nstripes <= 1 || getNumThreads() <= 1)
+        {
+            vote(range, hist);
+            return;
+        }
+
+        Mutex mutex;
+        parallel_for_(range, [&](const Range& r)
+        {
+            // nested call or a single stripe
+            if (r == range)
+            {
+                vote(r, hist);
+                return;
+            }
+
+            Mat local(hist.size(), hist.type(), Scalar::all(0));
+            vote(r, local);
+
+            AutoLock lock(mutex);
+            add(hist, local, hist);
+        }, nstripes);
+    }
+
     class GeneralizedHoughBase
     {
     protected:
@@ -326,6 +359,62 @@ namespace
 
 namespace
 {
+    /*
+        Votes of the image point p for the template centers p - r, r is the R-table row.
+        hist points to the histogram cell (0, 0) of rows x cols centers.
+    */
+    void voteRTable(const int* rx, const int* ry, int count, Point p, double idp, int rows, int cols, int* hist, int histStep)
+    {
+        int j = 0;
+
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+        const int vlanes = VTraits<v_int32>::vlanes();
+        int CV_DECL_ALIGNED(CV_SIMD_WIDTH) idx[VTraits<v_int32>::max_nlanes];
+
+        const v_int32 v_px = vx_setall_s32(p.x), v_py = vx_setall_s32(p.y);
+        const v_uint32 v_cols = vx_setall_u32((unsigned)cols), v_rows = vx_setall_u32((unsigned)rows);
+        const v_int32 v_step = vx_setall_s32(histStep), v_invalid = vx_setall_s32(-1);
+#if (CV_SIMD_64F || CV_SIMD_SCALABLE_64F)
+        const v_float64 v_idp = vx_setall_f64(idp);
+#else
+        if (idp == 1.0)
+#endif
+        for (; j <= count - vlanes; j += vlanes)
+        {
+            v_int32 cx = v_sub(v_px, vx_load(rx + j));
+            v_int32 cy = v_sub(v_py, vx_load(ry + j));
+#if (CV_SIMD_64F || CV_SIMD_SCALABLE_64F)
+            if (idp != 1.0)
+            {
+                cx = v_round(v_mul(v_cvt_f64(cx), v_idp), v_mul(v_cvt_f64_high(cx), v_idp));
+                cy = v_round(v_mul(v_cvt_f64(cy), v_idp), v_mul(v_cvt_f64_high(cy), v_idp));
+            }
+#endif
+            // the unsigned comparison rejects the negative coordinates as well
+            v_int32 inside = v_reinterpret_as_s32(v_and(v_lt(v_reinterpret_as_u32(cx), v_cols),
+                                                        v_lt(v_reinterpret_as_u32(cy), v_rows)));
+            v_store_aligned(idx, v_select(inside, v_add(v_mul(cy, v_step), cx), v_invalid));
+
+            for (int l = 0; l < vlanes; l++)
+            {
+                if (idx[l] >= 0)
+                    ++hist[idx[l]];
+            }
+        }
+#endif
+
+        for (; j < count; ++j)
+        {
+            Point c(p.x - rx[j], p.y - ry[j]);
+
+            c.x = cvRound(c.x * idp);
+            c.y = cvRound(c.y * idp);
+
+            if (c.x >= 0 && c.x < cols && c.y >= 0 && c.y < rows)
+                ++hist[c.y * histStep + c.x];
+        }
+    }
+
     class GeneralizedHoughBallardImpl CV_FINAL : public GeneralizedHoughBallard, private GeneralizedHoughBase
     {
     public:
@@ -368,7 +457,14 @@ namespace
         int levels_;
         int votesThreshold_;
 
-        std::vector< std::vector<Point> > r_table_;
+        // offsets of the template points from the center, stored by coordinates for the vectorized voting
+        struct RTableRow
+        {
+            std::vector<int> x;
+            std::vector<int> y;
+        };
+
+        std::vector<RTableRow> r_table_;
         Mat hist_;
     };
 
@@ -385,7 +481,7 @@ namespace
         const double thetaScale = levels_ / 360.0;
 
         r_table_.resize(levels_ + 1);
-        std::for_each(r_table_.begin(), r_table_.end(), [](std::vector<Point>& e)->void { e.clear(); });
+        std::for_each(r_table_.begin(), r_table_.end(), [](RTableRow& e)->void { e.x.clear(); e.y.clear(); });
 
         for (int y = 0; y < templSize_.height; ++y)
         {
@@ -401,7 +497,8 @@ namespace
                 {
                     const float theta = fastAtan2(dyRow[x], dxRow[x]);
                     const int n = cvRound(theta * thetaScale);
-                    r_table_[n].push_back(p - templCenter_);
+                    r_table_[n].x.push_back(p.x - templCenter_.x);
+                    r_table_[n].y.push_back(p.y - templCenter_.y);
                 }
             }
         }
@@ -432,36 +529,31 @@ namespace
         const int rows = hist_.rows - 2;
         const int cols = hist_.cols - 2;
 
-        for (int y = 0; y < imageSize_.height; ++y)
+        // the image rows vote in parallel
+        parallelVote(Range(0, imageSize_.height), hist_, getNumThreads(), [&](const Range& range, Mat& hist)
         {
-            const uchar* edgesRow = imageEdges_.ptr(y);
-            const float* dxRow = imageDx_.ptr<float>(y);
-            const float* dyRow = imageDy_.ptr<float>(y);
+            int* histData = hist.ptr<int>(1) + 1;
+            const int histStep = (int)hist.step1();
 
-            for (int x = 0; x < imageSize_.width; ++x)
+            for (int y = range.start; y < range.end; ++y)
             {
-                const Point p(x, y);
+                const uchar* edgesRow = imageEdges_.ptr(y);
+                const float* dxRow = imageDx_.ptr<float>(y);
+                const float* dyRow = imageDy_.ptr<float>(y);
 
-                if (edgesRow[x] && (notNull(dyRow[x]) || notNull(dxRow[x])))
+                for (int x = 0; x < imageSize_.width; ++x)
                 {
-                    const float theta = fastAtan2(dyRow[x], dxRow[x]);
-                    const int n = cvRound(theta * thetaScale);
-
-                    const std::vector<Point>& r_row = r_table_[n];
-
-                    for (size_t j = 0; j < r_row.size(); ++j)
+                    if (edgesRow[x] && (notNull(dyRow[x]) || notNull(dxRow[x])))
                     {
-                        Point c = p - r_row[j];
+                        const float theta = fastAtan2(dyRow[x], dxRow[x]);
+                        const int n = cvRound(theta * thetaScale);
 
-                        c.x = cvRound(c.x * idp);
-                        c.y = cvRound(c.y * idp);
-
-                        if (c.x >= 0 && c.x < cols && c.y >= 0 && c.y < rows)
-                            ++hist_.at<int>(c.y + 1, c.x + 1);
+                        const RTableRow& r_row = r_table_[n];
+                        voteRTable(r_row.x.data(), r_row.y.data(), (int)r_row.x.size(), Point(x, y), idp, rows, cols, histData, histStep);
                     }
                 }
             }
-        }
+        });
     }
 
     void GeneralizedHoughBallardImpl::findPosInHist()
@@ -604,15 +696,31 @@ namespace
         void buildFeatureList(const Mat& edges, const Mat& dx, const Mat& dy, std::vector< std::vector<Feature> >& features, Point2d center = Point2d());
         void getContourPoints(const Mat& edges, const Mat& dx, const Mat& dy, std::vector<ContourPoint>& points);
 
+        // image features of one level sorted by angle and stored by fields
+        struct FeatureTable
+        {
+            std::vector<double> theta;
+            std::vector<double> x1, y1;
+            std::vector<double> x2, y2;
+            std::vector<double> d12;
+        };
+
+        void buildFeatureTable();
+
+        // runs vote(level, hist) for all levels in getNumThreads() stripes of consecutive levels
+        template <typename LevelVoteFunc>
+        void voteLevels(Mat& hist, const LevelVoteFunc& vote) const;
+
         void calcOrientation();
-        void calcScale(double angle);
-        void calcPosition(double angle, int angleVotes, double scale, int scaleVotes);
+        void calcScale(double angle, std::vector< std::pair<double, int> >& scales);
+        void calcPosition(double angle, int angleVotes, double scale, int scaleVotes,
+                          std::vector<Vec4f>& positions, std::vector<Vec3i>& votes);
 
         std::vector< std::vector<Feature> > templFeatures_;
         std::vector< std::vector<Feature> > imageFeatures_;
+        std::vector<FeatureTable> imageTable_;
 
         std::vector< std::pair<double, int> > angles_;
-        std::vector< std::pair<double, int> > scales_;
     };
 
     double clampAngle(double a)
@@ -632,6 +740,163 @@ namespace
         return (fabs(clampAngle(a - b)) <= eps);
     }
 
+#if (CV_SIMD_64F || CV_SIMD_SCALABLE_64F)
+    // the same as clampAngle() for a in [-720, 720]
+    inline v_float64 v_clampAngle(const v_float64& a)
+    {
+        const v_float64 v_360 = vx_setall_f64(360.0), v_zero = vx_setzero_f64();
+        v_float64 res = a;
+        for (int i = 0; i < 2; ++i)
+            res = v_select(v_gt(res, v_360), v_sub(res, v_360), res);
+        for (int i = 0; i < 2; ++i)
+            res = v_select(v_lt(res, v_zero), v_add(res, v_360), res);
+        return res;
+    }
+#endif
+
+    /*
+        The voting kernels below match one template feature against the image features of a level.
+        The orientation votes are dense, their histogram bins are computed in vectors (-1 for no vote)
+        and incremented one by one. Only the image features with the same angle as the template feature
+        vote for the scale and the position, they are looked up with findAngleRanges().
+    */
+
+    void voteOrientation(const double* theta, int count, double templTheta,
+                         double minAngle, double maxAngle, double iAngleStep, int* hist)
+    {
+        int k = 0;
+
+#if (CV_SIMD_64F || CV_SIMD_SCALABLE_64F)
+        const int vlanes = VTraits<v_float64>::vlanes();
+        int CV_DECL_ALIGNED(CV_SIMD_WIDTH) idx[VTraits<v_int32>::max_nlanes];
+
+        const v_float64 v_templTheta = vx_setall_f64(templTheta), v_invalid = vx_setall_f64(-1.0);
+        const v_float64 v_minAngle = vx_setall_f64(minAngle), v_maxAngle = vx_setall_f64(maxAngle);
+        const v_float64 v_iAngleStep = vx_setall_f64(iAngleStep);
+
+        for (; k <= count - 2 * vlanes; k += 2 * vlanes)
+        {
+            v_float64 bin[2];
+            for (int h = 0; h < 2; ++h)
+            {
+                v_float64 angle = v_clampAngle(v_sub(vx_load(theta + k + h * vlanes), v_templTheta));
+                v_float64 mask = v_and(v_ge(angle, v_minAngle), v_le(angle, v_maxAngle));
+                bin[h] = v_select(mask, v_mul(v_sub(angle, v_minAngle), v_iAngleStep), v_invalid);
+            }
+            v_store_aligned(idx, v_round(bin[0], bin[1]));
+
+            for (int l = 0; l < 2 * vlanes; ++l)
+            {
+                if (idx[l] >= 0)
+                    ++hist[idx[l]];
+            }
+        }
+#endif
+
+        for (; k < count; ++k)
+        {
+            const double angle = clampAngle(theta[k] - templTheta);
+            if (angle >= minAngle && angle <= maxAngle)
+            {
+                const int n = cvRound((angle - minAngle) * iAngleStep);
+                ++hist[n];
+            }
+        }
+    }
+
+    /*
+        The image features of a level are sorted by angle, so the features with angleEq(theta, templTheta, eps)
+        lie in at most 3 ranges (templTheta is up to 720 degrees). The ranges are found with a small margin
+        for the rounding errors, the callers check the features exactly.
+    */
+    int findAngleRanges(const std::vector<double>& theta, double templTheta, double angleEpsilon, Range* ranges)
+    {
+        const double margin = 1e-6;
+
+        int count = 0, prevEnd = 0;
+        for (int m = -2; m <= 0; ++m)
+        {
+            const double low = templTheta + 360.0 * m - margin;
+            const double high = templTheta + 360.0 * m + angleEpsilon + margin;
+
+            const int start = std::max(prevEnd, (int)(std::lower_bound(theta.begin(), theta.end(), low) - theta.begin()));
+            const int end = (int)(std::upper_bound(theta.begin(), theta.end(), high) - theta.begin());
+
+            if (start < end)
+            {
+                ranges[count++] = Range(start, end);
+                prevEnd = end;
+            }
+        }
+
+        return count;
+    }
+
+    void voteScale(const double* theta, const double* d12, const Range& range, double templTheta, double templD12,
+                   double angleEpsilon, double minScale, double maxScale, double iScaleStep, int* hist)
+    {
+        for (int k = range.start; k < range.end; ++k)
+        {
+            if (angleEq(theta[k], templTheta, angleEpsilon))
+            {
+                const double scale = d12[k] / templD12;
+                if (scale >= minScale && scale <= maxScale)
+                {
+                    const int s = cvRound((scale - minScale) * iScaleStep);
+                    ++hist[s];
+                }
+            }
+        }
+    }
+
+    // hist points to the histogram cell (0, 0)
+    void votePosition(const double* theta, const double* x1, const double* y1, const double* x2, const double* y2, const Range& range,
+                      double templTheta, Point2d r1, Point2d r2, double angleEpsilon, double idp,
+                      int histRows, int histCols, int* hist, int histStep)
+    {
+        for (int k = range.start; k < range.end; ++k)
+        {
+            if (angleEq(theta[k], templTheta, angleEpsilon))
+            {
+                Point2d c1, c2;
+
+                c1 = Point2d(x1[k], y1[k]) - r1;
+                c1 *= idp;
+
+                c2 = Point2d(x2[k], y2[k]) - r2;
+                c2 *= idp;
+
+                if (fabs(c1.x - c2.x) > 1 || fabs(c1.y - c2.y) > 1)
+                    continue;
+
+                if (c1.y >= 0 && c1.y < histRows && c1.x >= 0 && c1.x < histCols)
+                    ++hist[cvRound(c1.y) * histStep + cvRound(c1.x)];
+            }
+        }
+    }
+
+    /*
+        Runs func(i) for every hypothesis. If there are enough hypotheses, they are processed in parallel
+        (the voting inside runs sequentially), otherwise every hypothesis votes in parallel.
+    */
+    template <typename Func>
+    void forEachHypothesis(int count, const Func& func)
+    {
+        if (count > 1 && count >= getNumThreads())
+        {
+            parallel_for_(Range(0, count), [&](const Range& range)
+            {
+                for (int i = range.start; i < range.end; ++i)
+                    func(i);
+            });
+        }
+        else
+        {
+            for (int i = 0; i < count; ++i)
+                func(i);
+        }
+    }
+
     GeneralizedHoughGuilImpl::GeneralizedHoughGuilImpl()
     {
         maxBufferSize_ = 1000;
@@ -660,23 +925,37 @@ namespace
     void GeneralizedHoughGuilImpl::processImage()
     {
         buildFeatureList(imageEdges_, imageDx_, imageDy_, imageFeatures_);
+        buildFeatureTable();
 
         calcOrientation();
 
+        std::vector< std::vector< std::pair<double, int> > > scales(angles_.size());
+        forEachHypothesis((int)angles_.size(), [&](int i)
+        {
+            calcScale(angles_[i].first, scales[i]);
+        });
+
+        std::vector<Vec2i> hypotheses;
         for (size_t i = 0; i < angles_.size(); ++i)
         {
-            const double angle = angles_[i].first;
-            const int angleVotes = angles_[i].second;
+            for (size_t j = 0; j < scales[i].size(); ++j)
+                hypotheses.push_back(Vec2i((int)i, (int)j));
+        }
 
-            calcScale(angle);
+        std::vector< std::vector<Vec4f> > positions(hypotheses.size());
+        std::vector< std::vector<Vec3i> > votes(hypotheses.size());
+        forEachHypothesis((int)hypotheses.size(), [&](int h)
+        {
+            const std::pair<double, int>& angle = angles_[hypotheses[h][0]];
+            const std::pair<double, int>& scale = scales[hypotheses[h][0]][hypotheses[h][1]];
 
-            for (size_t j = 0; j < scales_.size(); ++j)
-            {
-                const double scale = scales_[j].first;
-                const int scaleVotes = scales_[j].second;
+            calcPosition(angle.first, angle.second, scale.first, scale.second, positions[h], votes[h]);
+        });
 
-                calcPosition(angle, angleVotes, scale, scaleVotes);
-            }
+        for (size_t h = 0; h < hypotheses.size(); ++h)
+        {
+            posOutBuf_.insert(posOutBuf_.end(), positions[h].begin(), positions[h].end());
+            voteOutBuf_.insert(voteOutBuf_.end(), votes[h].begin(), votes[h].end());
         }
     }
 
@@ -759,6 +1038,71 @@ namespace
         }
     }
 
+    void GeneralizedHoughGuilImpl::buildFeatureTable()
+    {
+        imageTable_.resize(imageFeatures_.size());
+
+        for (size_t i = 0; i < imageFeatures_.size(); ++i)
+        {
+            const std::vector<Feature>& row = imageFeatures_[i];
+            FeatureTable& table = imageTable_[i];
+
+            std::vector<int> order(row.size());
+            for (size_t k = 0; k < row.size(); ++k)
+                order[k] = (int)k;
+            std::stable_sort(order.begin(), order.end(), [&row](int a, int b) { return row[a].p1.theta < row[b].p1.theta; });
+
+            table.theta.resize(row.size());
+            table.x1.resize(row.size());
+            table.y1.resize(row.size());
+            table.x2.resize(row.size());
+            table.y2.resize(row.size());
+            table.d12.resize(row.size());
+
+            for (size_t k = 0; k < row.size(); ++k)
+            {
+                const Feature& f = row[order[k]];
+
+                table.theta[k] = f.p1.theta;
+                table.x1[k] = f.p1.pos.x;
+                table.y1[k] = f.p1.pos.y;
+                table.x2[k] = f.p2.pos.x;
+                table.y2[k] = f.p2.pos.y;
+                table.d12[k] = f.d12;
+            }
+        }
+    }
+
+    template <typename LevelVoteFunc>
+    void GeneralizedHoughGuilImpl::voteLevels(Mat& hist, const LevelVoteFunc& vote) const
+    {
+        // Levels are cheap and their number is large (360 by default), so they are grouped into
+        // getNumThreads() stripes with about the same number of feature pairs each.
+        const int numLevels = levels_ + 1;
+        const int nstripes = std::max(std::min(getNumThreads(), numLevels), 1);
+
+        double total = 0.0;
+        for (int i = 0; i < numLevels; ++i)
+            total += (double)templFeatures_[i].size() * imageTable_[i].theta.size();
+
+        std::vector<int> bounds(1, 0);
+        double acc = 0.0;
+        for (int i = 0; i < numLevels - 1 && (int)bounds.size() < nstripes; ++i)
+        {
+            acc += (double)templFeatures_[i].size() * imageTable_[i].theta.size();
+            if (acc * nstripes >= total * bounds.size())
+                bounds.push_back(i + 1);
+        }
+        bounds.push_back(numLevels);
+
+        const int numStripes = (int)bounds.size() - 1;
+        parallelVote(Range(0, numStripes), hist, numStripes, [&](const Range& range, Mat& stripeHist)
+        {
+            for (int i = bounds[range.start]; i < bounds[range.end]; ++i)
+                vote(i, stripeHist);
+        });
+    }
+
     void GeneralizedHoughGuilImpl::calcOrientation()
     {
         CV_Assert( levels_ > 0 );
@@ -771,43 +1115,33 @@ namespace
         const double iAngleStep = 1.0 / angleStep_;
         const int angleRange = cvCeil((maxAngle_ - minAngle_) * iAngleStep);
 
-        std::vector<int> OHist(angleRange + 1, 0);
-        for (int i = 0; i <= levels_; ++i)
+        Mat OHist(1, angleRange + 1, CV_32SC1, Scalar::all(0));
+        voteLevels(OHist, [&](int i, Mat& hist)
         {
             const std::vector<Feature>& templRow = templFeatures_[i];
-            const std::vector<Feature>& imageRow = imageFeatures_[i];
+            const FeatureTable& imageRow = imageTable_[i];
 
             for (size_t j = 0; j < templRow.size(); ++j)
             {
-                Feature templF = templRow[j];
-
-                for (size_t k = 0; k < imageRow.size(); ++k)
-                {
-                    Feature imF = imageRow[k];
-
-                    const double angle = clampAngle(imF.p1.theta - templF.p1.theta);
-                    if (angle >= minAngle_ && angle <= maxAngle_)
-                    {
-                        const int n = cvRound((angle - minAngle_) * iAngleStep);
-                        ++OHist[n];
-                    }
-                }
+                voteOrientation(imageRow.theta.data(), (int)imageRow.theta.size(), templRow[j].p1.theta,
+                                minAngle_, maxAngle_, iAngleStep, hist.ptr<int>());
             }
-        }
+        });
 
         angles_.clear();
 
         for (int n = 0; n < angleRange; ++n)
         {
-            if (OHist[n] >= angleThresh_)
+            const int votes = OHist.at<int>(n);
+            if (votes >= angleThresh_)
             {
                 const double angle = minAngle_ + n * angleStep_;
-                angles_.push_back(std::make_pair(angle, OHist[n]));
+                angles_.push_back(std::make_pair(angle, votes));
             }
         }
     }
 
-    void GeneralizedHoughGuilImpl::calcScale(double angle)
+    void GeneralizedHoughGuilImpl::calcScale(double angle, std::vector< std::pair<double, int> >& scales)
     {
         CV_Assert( levels_ > 0 );
         CV_Assert( templFeatures_.size() == static_cast<size_t>(levels_ + 1) );
@@ -819,49 +1153,42 @@ namespace
         const double iScaleStep = 1.0 / scaleStep_;
         const int scaleRange = cvCeil((maxScale_ - minScale_) * iScaleStep);
 
-        std::vector<int> SHist(scaleRange + 1, 0);
-
-        for (int i = 0; i <= levels_; ++i)
+        Mat SHist(1, scaleRange + 1, CV_32SC1, Scalar::all(0));
+        voteLevels(SHist, [&](int i, Mat& hist)
         {
             const std::vector<Feature>& templRow = templFeatures_[i];
-            const std::vector<Feature>& imageRow = imageFeatures_[i];
+            const FeatureTable& imageRow = imageTable_[i];
 
             for (size_t j = 0; j < templRow.size(); ++j)
             {
-                Feature templF = templRow[j];
+                const Feature& templF = templRow[j];
+                const double templTheta = templF.p1.theta + angle;
 
-                templF.p1.theta += angle;
-
-                for (size_t k = 0; k < imageRow.size(); ++k)
+                Range ranges[3];
+                const int rangesCount = findAngleRanges(imageRow.theta, templTheta, angleEpsilon_, ranges);
+                for (int r = 0; r < rangesCount; ++r)
                 {
-                    Feature imF = imageRow[k];
-
-                    if (angleEq(imF.p1.theta, templF.p1.theta, angleEpsilon_))
-                    {
-                        const double scale = imF.d12 / templF.d12;
-                        if (scale >= minScale_ && scale <= maxScale_)
-                        {
-                            const int s = cvRound((scale - minScale_) * iScaleStep);
-                            ++SHist[s];
-                        }
-                    }
+                    voteScale(imageRow.theta.data(), imageRow.d12.data(), ranges[r], templTheta, templF.d12,
+                              angleEpsilon_, minScale_, maxScale_, iScaleStep, hist.ptr<int>());
                 }
             }
-        }
+        });
 
-        scales_.clear();
+        scales.clear();
 
         for (int s = 0; s < scaleRange; ++s)
         {
-            if (SHist[s] >= scaleThresh_)
+            const int votes = SHist.at<int>(s);
+            if (votes >= scaleThresh_)
             {
                 const double scale = minScale_ + s * scaleStep_;
-                scales_.push_back(std::make_pair(scale, SHist[s]));
+                scales.push_back(std::make_pair(scale, votes));
             }
         }
     }
 
-    void GeneralizedHoughGuilImpl::calcPosition(double angle, int angleVotes, double scale, int scaleVotes)
+    void GeneralizedHoughGuilImpl::calcPosition(double angle, int angleVotes, double scale, int scaleVotes,
+                                                std::vector<Vec4f>& positions, std::vector<Vec3i>& votesOut)
     {
         CV_Assert( levels_ > 0 );
         CV_Assert( templFeatures_.size() == static_cast<size_t>(levels_ + 1) );
@@ -878,10 +1205,10 @@ namespace
 
         Mat DHist(histRows + 2, histCols + 2, CV_32SC1, Scalar::all(0));
 
-        for (int i = 0; i <= levels_; ++i)
+        voteLevels(DHist, [&](int i, Mat& hist)
         {
             const std::vector<Feature>& templRow = templFeatures_[i];
-            const std::vector<Feature>& imageRow = imageFeatures_[i];
+            const FeatureTable& imageRow = imageTable_[i];
 
             for (size_t j = 0; j < templRow.size(); ++j)
             {
@@ -889,35 +1216,26 @@ namespace
 
                 templF.p1.theta += angle;
 
+                Range ranges[3];
+                const int rangesCount = findAngleRanges(imageRow.theta, templF.p1.theta, angleEpsilon_, ranges);
+                if (rangesCount == 0)
+                    continue;
+
                 templF.r1 *= scale;
                 templF.r2 *= scale;
 
                 templF.r1 = Point2d(cosVal * templF.r1.x - sinVal * templF.r1.y, sinVal * templF.r1.x + cosVal * templF.r1.y);
                 templF.r2 = Point2d(cosVal * templF.r2.x - sinVal * templF.r2.y, sinVal * templF.r2.x + cosVal * templF.r2.y);
 
-                for (size_t k = 0; k < imageRow.size(); ++k)
+                for (int r = 0; r < rangesCount; ++r)
                 {
-                    Feature imF = imageRow[k];
-
-                    if (angleEq(imF.p1.theta, templF.p1.theta, angleEpsilon_))
-                    {
-                        Point2d c1, c2;
-
-                        c1 = imF.p1.pos - templF.r1;
-                        c1 *= idp;
-
-                        c2 = imF.p2.pos - templF.r2;
-                        c2 *= idp;
-
-                        if (fabs(c1.x - c2.x) > 1 || fabs(c1.y - c2.y) > 1)
-                            continue;
-
-                        if (c1.y >= 0 && c1.y < histRows && c1.x >= 0 && c1.x < histCols)
-                            ++DHist.at<int>(cvRound(c1.y) + 1, cvRound(c1.x) + 1);
-                    }
+                    votePosition(imageRow.theta.data(), imageRow.x1.data(), imageRow.y1.data(),
+                                 imageRow.x2.data(), imageRow.y2.data(), ranges[r],
+                                 templF.p1.theta, templF.r1, templF.r2, angleEpsilon_, idp,
+                                 histRows, histCols, hist.ptr<int>(1) + 1, (int)hist.step1());
                 }
             }
-        }
+        });
 
         for(int y = 0; y < histRows; ++y)
         {
@@ -931,8 +1249,8 @@ namespace
 
                 if (votes > posThresh_ && votes > curRow[x] && votes >= curRow[x + 2] && votes > prevRow[x + 1] && votes >= nextRow[x + 1])
                 {
-                    posOutBuf_.push_back(Vec4f(static_cast<float>(x * dp_), static_cast<float>(y * dp_), static_cast<float>(scale), static_cast<float>(angle)));
-                    voteOutBuf_.push_back(Vec3i(votes, scaleVotes, angleVotes));
+                    positions.push_back(Vec4f(static_cast<float>(x * dp_), static_cast<float>(y * dp_), static_cast<float>(scale), static_cast<float>(angle)));
+                    votesOut.push_back(Vec3i(votes, scaleVotes, angleVotes));
                 }
             }
         }
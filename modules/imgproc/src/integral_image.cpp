@@ -0,0 +1,227 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "precomp.hpp"
+
+namespace cv
+{
+
+static Scalar getIntegralValue(const Mat& table, int y, int x)
+{
+    Scalar v;
+    const int cn = table.channels();
+    const uchar* p = table.ptr(y) + x*table.elemSize();
+    for( int c = 0; c < cn; c++ )
+    {
+        switch( table.depth() )
+        {
+        case CV_32S: v[c] = ((const int*)p)[c]; break;
+        case CV_32F: v[c] = ((const float*)p)[c]; break;
+        case CV_64F: v[c] = ((const double*)p)[c]; break;
+        default: CV_Error(Error::StsUnsupportedFormat, "");
+        }
+    }
+    return v;
+}
+
+/*
+    band is the integral of the image rows [origin.y, origin.y + height) from the column origin.x
+    to the right edge. The table entries right of origin.x are
+        table(y0 + i, x0 + j) = band(i, j) + table(y0 + i, x0) + table(y0, x0 + j) - table(y0, x0),
+    where the left column and the top row do not depend on the changed pixels.
+    The rows below the band change by the same values as its last row.
+*/
+static void updateIntegralTable(Mat& table, const Mat& band, Point origin, int height)
+{
+    const int x0 = origin.x, y0 = origin.y, cols = band.cols;
+    const Scalar corner = getIntegralValue(table, y0, x0);
+    Mat top = table(Rect(x0, y0, cols, 1));
+    Mat delta = table(Rect(x0, y0 + height, cols, 1)).clone();
+
+    for( int i = 1; i <= height; i++ )
+    {
+        Mat row = table(Rect(x0, y0 + i, cols, 1));
+        Scalar left = getIntegralValue(table, y0 + i, x0) - corner;
+        add(band.row(i), top, row);
+        add(row, left, row);
+    }
+
+    if( y0 + height + 1 < table.rows )
+    {
+        subtract(table(Rect(x0, y0 + height, cols, 1)), delta, delta);
+        for( int y = y0 + height + 1; y < table.rows; y++ )
+        {
+            Mat row = table(Rect(x0, y, cols, 1));
+            add(row, delta, row);
+        }
+    }
+}
+
+template<typename ST> static void
+boxSums_( const Mat& table, const Rect* boxes, const Range& range, double* dst )
+{
+    const int cn = table.channels();
+    for( int i = range.start; i < range.end; i++ )
+    {
+        const Rect& r = boxes[i];
+        const ST* p0 = table.ptr<ST>(r.y) + r.x*cn;
+        const ST* p1 = p0 + r.width*cn;
+        const ST* p2 = table.ptr<ST>(r.y + r.height) + r.x*cn;
+        const ST* p3 = p2 + r.width*cn;
+        double* d = dst + (size_t)i*cn;
+        for( int c = 0; c < cn; c++ )
+            d[c] = (double)p0[c] - (double)p1[c] - (double)p2[c] + (double)p3[c];
+    }
+}
+
+static void integralBoxSums( const Mat& table, const std::vector<Rect>& boxes, OutputArray _dst )
+{
+    const int n = (int)boxes.size();
+    if( n == 0 )
+    {
+        _dst.release();
+        return;
+    }
+    _dst.create(n, 1, CV_MAKETYPE(CV_64F, table.channels()));
+    Mat dst = _dst.getMat();
+    CV_Assert( dst.isContinuous() );
+
+    parallel_for_(Range(0, n), [&](const Range& range)
+    {
+        switch( table.depth() )
+        {
+        case CV_32S: boxSums_<int>(table, &boxes[0], range, dst.ptr<double>()); break;
+        case CV_32F: boxSums_<float>(table, &boxes[0], range, dst.ptr<double>()); break;
+        case CV_64F: boxSums_<double>(table, &boxes[0], range, dst.ptr<double>()); break;
+        default: CV_Error(Error::StsUnsupportedFormat, "");
+        }
+    }, n / 4096.);
+}
+
+class IntegralImageImpl CV_FINAL : public IntegralImage
+{
+public:
+    IntegralImageImpl(bool _squares, int _sdepth, int _sqdepth)
+        : squares(_squares), sdepth(_sdepth), sqdepth(_sqdepth), imageType(-1)
+    {
+    }
+
+    void compute(InputArray image) CV_OVERRIDE;
+    void update(InputArray image, const Rect& roi) CV_OVERRIDE;
+
+    void getSum(OutputArray _sum) const CV_OVERRIDE { _sum.assign(sum); }
+    void getSqSum(OutputArray _sqsum) const CV_OVERRIDE { _sqsum.assign(sqsum); }
+
+    void boxSums(const std::vector<Rect>& boxes, OutputArray sums) const CV_OVERRIDE;
+    void boxStats(const std::vector<Rect>& boxes, OutputArray means, OutputArray variances) const CV_OVERRIDE;
+
+private:
+    void checkBoxes(const std::vector<Rect>& boxes) const;
+
+    bool squares;
+    int sdepth, sqdepth;
+    Mat sum, sqsum;
+    Size imageSize;
+    int imageType;
+};
+
+void IntegralImageImpl::compute(InputArray _image)
+{
+    CV_INSTRUMENT_REGION();
+
+    Mat image = _image.getMat();
+    CV_Assert( !image.empty() && image.dims <= 2 );
+
+    if( squares )
+        integral(image, sum, sqsum, sdepth, sqdepth);
+    else
+        integral(image, sum, sdepth);
+    imageSize = image.size();
+    imageType = image.type();
+}
+
+void IntegralImageImpl::update(InputArray _image, const Rect& _roi)
+{
+    CV_INSTRUMENT_REGION();
+
+    Mat image = _image.getMat();
+    if( sum.empty() || image.size() != imageSize || image.type() != imageType )
+    {
+        compute(image);
+        return;
+    }
+
+    Rect roi = _roi & Rect(Point(), imageSize);
+    if( roi.empty() )
+        return;
+
+    Mat band(image, Rect(roi.x, roi.y, imageSize.width - roi.x, roi.height)), bandSum, bandSqSum;
+    if( squares )
+        integral(band, bandSum, bandSqSum, sum.depth(), sqsum.depth());
+    else
+        integral(band, bandSum, sum.depth());
+
+    updateIntegralTable(sum, bandSum, roi.tl(), roi.height);
+    if( squares )
+        updateIntegralTable(sqsum, bandSqSum, roi.tl(), roi.height);
+}
+
+void IntegralImageImpl::checkBoxes(const std::vector<Rect>& boxes) const
+{
+    CV_Assert( !sum.empty() );
+    for( size_t i = 0; i < boxes.size(); i++ )
+    {
+        const Rect& r = boxes[i];
+        CV_Assert( 0 <= r.x && 0 <= r.width && r.x + r.width <= imageSize.width &&
+                   0 <= r.y && 0 <= r.height && r.y + r.height <= imageSize.height );
+    }
+}
+
+void IntegralImageImpl::boxSums(const std::vector<Rect>& boxes, OutputArray _sums) const
+{
+    CV_INSTRUMENT_REGION();
+
+    checkBoxes(boxes);
+    integralBoxSums(sum, boxes, _sums);
+}
+
+void IntegralImageImpl::boxStats(const std::vector<Rect>& boxes, OutputArray _means, OutputArray _variances) const
+{
+    CV_INSTRUMENT_REGION();
+
+    checkBoxes(boxes);
+    CV_Assert( !_variances.needed() || !sqsum.empty() );
+
+    const int n = (int)boxes.size(), cn = sum.channels();
+    integralBoxSums(sum, boxes, _means);
+    if( _variances.needed() )
+        integralBoxSums(sqsum, boxes, _variances);
+    if( n == 0 )
+        return;
+
+    Mat means = _means.getMat(), variances;
+    if( _variances.needed() )
+        variances = _variances.getMat();
+
+    for( int i = 0; i < n; i++ )
+    {
+        const int area = boxes[i].area();
+        const double scale = area > 0 ? 1./area : 0.;
+        double* m = means.ptr<double>(i);
+        double* v = variances.empty() ? 0 : variances.ptr<double>(i);
+        for( int c = 0; c < cn; c++ )
+        {
+            m[c] *= scale;
+            if( v )
+                v[c] = std::max(v[c]*scale - m[c]*m[c], 0.);
+        }
+    }
+}
+
+}
+
+cv::Ptr<cv::IntegralImage> cv::createIntegralImage(bool squares, int sdepth, int sqdepth)
+{
+    return makePtr<IntegralImageImpl>(squares, sdepth, sqdepth);
+}
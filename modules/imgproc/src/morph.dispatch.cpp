@@ -47,6 +47,7 @@
 #include "hal_replacement.hpp"
 #include "opencv2/core/hal/intrin.hpp"
 #include <opencv2/core/utils/configuration.private.hpp>
+#include "filter.hpp"
 
 #include "morph.simd.hpp"
 #include "morph.simd_declarations.hpp" // defines CV_CPU_DISPATCH_MODES_ALL=AVX2,...,BASELINE based on CMakeLists.txt content
@@ -444,17 +445,27 @@ static void ocvMorph(int op, int src_type, int dst_type,
     Mat kernel(Size(kernel_width, kernel_height), kernel_type, kernel_data, kernel_step);
     Point anchor(anchor_x, anchor_y);
     Vec<double, 4> borderVal(borderValue);
-    Ptr<FilterEngine> f = createMorphologyFilter(op, src_type, kernel, anchor, borderType, borderType, borderVal);
+    auto createEngine = [&]()
+    {
+        return createMorphologyFilter(op, src_type, kernel, anchor, borderType, borderType, borderVal);
+    };
     Mat src(Size(width, height), src_type, src_data, src_step);
     Mat dst(Size(width, height), dst_type, dst_data, dst_step);
+    Ptr<FilterEngine> f;
     {
         Point ofs(roi_x, roi_y);
         Size wsz(roi_width, roi_height);
-        f->apply( src, dst, wsz, ofs );
+        if (!applyFilterTiled(createEngine, src, dst, wsz, ofs, kernel.size()))
+        {
+            f = createEngine();
+            f->apply( src, dst, wsz, ofs );
+        }
     }
     {
         Point ofs(roi_x2, roi_y2);
         Size wsz(roi_width2, roi_height2);
+        if( iterations > 1 && !f )
+            f = createEngine();
         for( int i = 1; i < iterations; i++ )
             f->apply( dst, dst, wsz, ofs );
     }
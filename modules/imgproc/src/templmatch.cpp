@@ -563,73 +563,50 @@ static bool ocl_matchTemplate( InputArray _img, InputArray _templ, OutputArray _
 
 #include "opencv2/core/hal/hal.hpp"
 
-void crossCorr( const Mat& img, const Mat& _templ, Mat& corr,
-                Point anchor, double delta, int borderType )
+/*
+    The correlation is computed by blocks of blocksize, every block uses the DFT of dftsize.
+    The template spectra depend on the layout only, so they can be reused for images of the same size.
+*/
+static void getCrossCorrLayout( Size corrSize, Size templSize, int depth, int tdepth, int cdepth,
+                                Size& blocksize, Size& dftsize, int& maxDepth )
 {
     const double blockScale = 4.5;
     const int minBlockSize = 256;
-    std::vector<uchar> buf;
 
-    Mat templ = _templ;
-    int depth = img.depth(), cn = img.channels();
-    int tdepth = templ.depth(), tcn = templ.channels();
-    int cdepth = corr.depth(), ccn = corr.channels();
+    maxDepth = depth > CV_8S ? CV_64F : std::max(std::max(CV_32F, tdepth), cdepth);
 
-    CV_Assert( img.dims <= 2 && templ.dims <= 2 && corr.dims <= 2 );
+    blocksize.width = cvRound(templSize.width*blockScale);
+    blocksize.width = std::max( blocksize.width, minBlockSize - templSize.width + 1 );
+    blocksize.width = std::min( blocksize.width, corrSize.width );
+    blocksize.height = cvRound(templSize.height*blockScale);
+    blocksize.height = std::max( blocksize.height, minBlockSize - templSize.height + 1 );
+    blocksize.height = std::min( blocksize.height, corrSize.height );
 
-    if( depth != tdepth && tdepth != std::max(CV_32F, depth) )
-    {
-        _templ.convertTo(templ, std::max(CV_32F, depth));
-        tdepth = templ.depth();
-    }
-
-    CV_Assert( depth == tdepth || tdepth == CV_32F);
-    CV_Assert( corr.rows <= img.rows + templ.rows - 1 &&
-               corr.cols <= img.cols + templ.cols - 1 );
-
-    CV_Assert( ccn == 1 || delta == 0 );
-
-    int maxDepth = depth > CV_8S ? CV_64F : std::max(std::max(CV_32F, tdepth), cdepth);
-    Size blocksize, dftsize;
-
-    blocksize.width = cvRound(templ.cols*blockScale);
-    blocksize.width = std::max( blocksize.width, minBlockSize - templ.cols + 1 );
-    blocksize.width = std::min( blocksize.width, corr.cols );
-    blocksize.height = cvRound(templ.rows*blockScale);
-    blocksize.height = std::max( blocksize.height, minBlockSize - templ.rows + 1 );
-    blocksize.height = std::min( blocksize.height, corr.rows );
-
-    dftsize.width = std::max(getOptimalDFTSize(blocksize.width + templ.cols - 1), 2);
-    dftsize.height = getOptimalDFTSize(blocksize.height + templ.rows - 1);
+    dftsize.width = std::max(getOptimalDFTSize(blocksize.width + templSize.width - 1), 2);
+    dftsize.height = getOptimalDFTSize(blocksize.height + templSize.height - 1);
     if( dftsize.width <= 0 || dftsize.height <= 0 )
         CV_Error( cv::Error::StsOutOfRange, "the input arrays are too big" );
 
     // recompute block size
-    blocksize.width = dftsize.width - templ.cols + 1;
-    blocksize.width = MIN( blocksize.width, corr.cols );
-    blocksize.height = dftsize.height - templ.rows + 1;
-    blocksize.height = MIN( blocksize.height, corr.rows );
-
-    Mat dftTempl( dftsize.height*tcn, dftsize.width, maxDepth );
-    Mat dftImg( dftsize, maxDepth );
+    blocksize.width = dftsize.width - templSize.width + 1;
+    blocksize.width = MIN( blocksize.width, corrSize.width );
+    blocksize.height = dftsize.height - templSize.height + 1;
+    blocksize.height = MIN( blocksize.height, corrSize.height );
+}
 
-    int i, k, bufSize = 0;
+// computes DFT of each template plane, the planes are stacked vertically
+static void getCrossCorrTemplateDFT( const Mat& templ, Size dftsize, int maxDepth, Mat& dftTempl )
+{
+    int tdepth = templ.depth(), tcn = templ.channels();
+    std::vector<uchar> buf;
     if( tcn > 1 && tdepth != maxDepth )
-        bufSize = templ.cols*templ.rows*CV_ELEM_SIZE(tdepth);
+        buf.resize(templ.cols*templ.rows*CV_ELEM_SIZE(tdepth));
 
-    if( cn > 1 && depth != maxDepth )
-        bufSize = std::max( bufSize, (blocksize.width + templ.cols - 1)*
-            (blocksize.height + templ.rows - 1)*CV_ELEM_SIZE(depth));
-
-    if( (ccn > 1 || cn > 1) && cdepth != maxDepth )
-        bufSize = std::max( bufSize, blocksize.width*blocksize.height*CV_ELEM_SIZE(cdepth));
-
-    buf.resize(bufSize);
+    dftTempl.create( dftsize.height*tcn, dftsize.width, maxDepth );
 
     Ptr<hal::DFT2D> c = hal::DFT2D::create(dftsize.width, dftsize.height, dftTempl.depth(), 1, 1, CV_HAL_DFT_IS_INPLACE, templ.rows);
 
-    // compute DFT of each template plane
-    for( k = 0; k < tcn; k++ )
+    for( int k = 0; k < tcn; k++ )
     {
         int yofs = k*dftsize.height;
         Mat src = templ;
@@ -653,9 +630,40 @@ void crossCorr( const Mat& img, const Mat& _templ, Mat& corr,
         }
         c->apply(dst.data, (int)dst.step, dst.data, (int)dst.step);
     }
+}
 
-    int tileCountX = (corr.cols + blocksize.width - 1)/blocksize.width;
-    int tileCountY = (corr.rows + blocksize.height - 1)/blocksize.height;
+/*
+    Correlates the image with several templates of the same size given by their spectra:
+    the DFT of every image block is computed once and multiplied by each template spectrum.
+    All the correlation maps have the same size and type.
+*/
+static void crossCorrBlocks( const Mat& img, Size templSize, const std::vector<Mat>& dftTempls,
+                             const std::vector<Mat>& corrs, Point anchor, double delta, int borderType,
+                             Size blocksize, Size dftsize, int maxDepth )
+{
+    std::vector<uchar> buf;
+    int depth = img.depth(), cn = img.channels();
+    int tcn = dftTempls[0].rows / dftsize.height;
+    int cdepth = corrs[0].depth(), ccn = corrs[0].channels();
+    Size corrSize = corrs[0].size();
+    size_t ntempls = dftTempls.size();
+
+    Mat dftImg( dftsize, maxDepth );
+    // with several templates the image spectrum is kept, the products go to a separate buffer
+    Mat dftProd = ntempls > 1 ? Mat( dftsize, maxDepth ) : dftImg;
+
+    int i, k, bufSize = 0;
+    if( cn > 1 && depth != maxDepth )
+        bufSize = (blocksize.width + templSize.width - 1)*
+            (blocksize.height + templSize.height - 1)*CV_ELEM_SIZE(depth);
+
+    if( (ccn > 1 || cn > 1) && cdepth != maxDepth )
+        bufSize = std::max( bufSize, blocksize.width*blocksize.height*CV_ELEM_SIZE(cdepth));
+
+    buf.resize(bufSize);
+
+    int tileCountX = (corrSize.width + blocksize.width - 1)/blocksize.width;
+    int tileCountY = (corrSize.height + blocksize.height - 1)/blocksize.height;
     int tileCount = tileCountX * tileCountY;
 
     Size wholeSize = img.size();
@@ -673,7 +681,7 @@ void crossCorr( const Mat& img, const Mat& _templ, Mat& corr,
     Ptr<hal::DFT2D> cF, cR;
     int f = CV_HAL_DFT_IS_INPLACE;
     int f_inv = f | CV_HAL_DFT_INVERSE | CV_HAL_DFT_SCALE;
-    cF = hal::DFT2D::create(dftsize.width, dftsize.height, maxDepth, 1, 1, f, blocksize.height + templ.rows - 1);
+    cF = hal::DFT2D::create(dftsize.width, dftsize.height, maxDepth, 1, 1, f, blocksize.height + templSize.height - 1);
     cR = hal::DFT2D::create(dftsize.width, dftsize.height, maxDepth, 1, 1, f_inv, blocksize.height);
 
     // calculate correlation by blocks
@@ -682,9 +690,9 @@ void crossCorr( const Mat& img, const Mat& _templ, Mat& corr,
         int x = (i%tileCountX)*blocksize.width;
         int y = (i/tileCountX)*blocksize.height;
 
-        Size bsz(std::min(blocksize.width, corr.cols - x),
-                 std::min(blocksize.height, corr.rows - y));
-        Size dsz(bsz.width + templ.cols - 1, bsz.height + templ.rows - 1);
+        Size bsz(std::min(blocksize.width, corrSize.width - x),
+                 std::min(blocksize.height, corrSize.height - y));
+        Size dsz(bsz.width + templSize.width - 1, bsz.height + templSize.height - 1);
         int x0 = x - anchor.x + roiofs.x, y0 = y - anchor.y + roiofs.y;
         int x1 = std::max(0, x0), y1 = std::max(0, y0);
         int x2 = std::min(img0.cols, x0 + dsz.width);
@@ -692,7 +700,6 @@ void crossCorr( const Mat& img, const Mat& _templ, Mat& corr,
         Mat src0(img0, Range(y1, y2), Range(x1, x2));
         Mat dst(dftImg, Rect(0, 0, dsz.width, dsz.height));
         Mat dst1(dftImg, Rect(x1-x0, y1-y0, x2-x1, y2-y1));
-        Mat cdst(corr, Rect(x, y, bsz.width, bsz.height));
 
         for( k = 0; k < cn; k++ )
         {
@@ -718,47 +725,82 @@ void crossCorr( const Mat& img, const Mat& _templ, Mat& corr,
             else
                 dft( dftImg, dftImg, 0, dsz.height );
 
-            Mat dftTempl1(dftTempl, Rect(0, tcn > 1 ? k*dftsize.height : 0,
-                                         dftsize.width, dftsize.height));
-            mulSpectrums(dftImg, dftTempl1, dftImg, 0, true);
+            for( size_t t = 0; t < ntempls; t++ )
+            {
+                Mat cdst(corrs[t], Rect(x, y, bsz.width, bsz.height));
+                Mat dftTempl1(dftTempls[t], Rect(0, tcn > 1 ? k*dftsize.height : 0,
+                                                 dftsize.width, dftsize.height));
+                mulSpectrums(dftImg, dftTempl1, dftProd, 0, true);
 
-            if (bsz.height == blocksize.height)
-                cR->apply(dftImg.data, (int)dftImg.step, dftImg.data, (int)dftImg.step);
-            else
-                dft( dftImg, dftImg, DFT_INVERSE + DFT_SCALE, bsz.height );
+                if (bsz.height == blocksize.height)
+                    cR->apply(dftProd.data, (int)dftProd.step, dftProd.data, (int)dftProd.step);
+                else
+                    dft( dftProd, dftProd, DFT_INVERSE + DFT_SCALE, bsz.height );
 
-            src = dftImg(Rect(0, 0, bsz.width, bsz.height));
+                src = dftProd(Rect(0, 0, bsz.width, bsz.height));
 
-            if( ccn > 1 )
-            {
-                if( cdepth != maxDepth )
+                if( ccn > 1 )
                 {
-                    Mat plane(bsz, cdepth, &buf[0]);
-                    src.convertTo(plane, cdepth, 1, delta);
-                    src = plane;
+                    if( cdepth != maxDepth )
+                    {
+                        Mat plane(bsz, cdepth, &buf[0]);
+                        src.convertTo(plane, cdepth, 1, delta);
+                        src = plane;
+                    }
+                    int pairs[] = {0, k};
+                    mixChannels(&src, 1, &cdst, 1, pairs, 1);
                 }
-                int pairs[] = {0, k};
-                mixChannels(&src, 1, &cdst, 1, pairs, 1);
-            }
-            else
-            {
-                if( k == 0 )
-                    src.convertTo(cdst, cdepth, 1, delta);
                 else
                 {
-                    if( maxDepth != cdepth )
+                    if( k == 0 )
+                        src.convertTo(cdst, cdepth, 1, delta);
+                    else
                     {
-                        Mat plane(bsz, cdepth, &buf[0]);
-                        src.convertTo(plane, cdepth);
-                        src = plane;
+                        if( maxDepth != cdepth )
+                        {
+                            Mat plane(bsz, cdepth, &buf[0]);
+                            src.convertTo(plane, cdepth);
+                            src = plane;
+                        }
+                        add(src, cdst, cdst);
                     }
-                    add(src, cdst, cdst);
                 }
             }
         }
     }
 }
 
+void crossCorr( const Mat& img, const Mat& _templ, Mat& corr,
+                Point anchor, double delta, int borderType )
+{
+    Mat templ = _templ;
+    int depth = img.depth();
+    int tdepth = templ.depth();
+    int cdepth = corr.depth(), ccn = corr.channels();
+
+    CV_Assert( img.dims <= 2 && templ.dims <= 2 && corr.dims <= 2 );
+
+    if( depth != tdepth && tdepth != std::max(CV_32F, depth) )
+    {
+        _templ.convertTo(templ, std::max(CV_32F, depth));
+        tdepth = templ.depth();
+    }
+
+    CV_Assert( depth == tdepth || tdepth == CV_32F);
+    CV_Assert( corr.rows <= img.rows + templ.rows - 1 &&
+               corr.cols <= img.cols + templ.cols - 1 );
+
+    CV_Assert( ccn == 1 || delta == 0 );
+
+    Size blocksize, dftsize;
+    int maxDepth;
+    getCrossCorrLayout(corr.size(), templ.size(), depth, tdepth, cdepth, blocksize, dftsize, maxDepth);
+
+    std::vector<Mat> dftTempl(1), corrs(1, corr);
+    getCrossCorrTemplateDFT(templ, dftsize, maxDepth, dftTempl[0]);
+    crossCorrBlocks(img, templ.size(), dftTempl, corrs, anchor, delta, borderType, blocksize, dftsize, maxDepth);
+}
+
 static void matchTemplateMask( InputArray _img, InputArray _templ, OutputArray _result, int method, InputArray _mask )
 {
     CV_Assert(_mask.depth() == CV_8U || _mask.depth() == CV_32F);
@@ -903,7 +945,25 @@ static void matchTemplateMask( InputArray _img, InputArray _templ, OutputArray _
     }
 }
 
-static void common_matchTemplate( Mat& img, Mat& templ, Mat& result, int method, int cn )
+static void getMatchTemplateStats( const Mat& templ, int method, Scalar& templMean, Scalar& templSdv )
+{
+    if( method == cv::TM_CCOEFF )
+        templMean = mean(templ);
+    else if( method != cv::TM_CCORR )
+        meanStdDev( templ, templMean, templSdv );
+}
+
+static void getMatchTemplateIntegral( const Mat& img, int method, Mat& sum, Mat& sqsum )
+{
+    if( method == cv::TM_CCOEFF )
+        integral(img, sum, CV_64F);
+    else if( method != cv::TM_CCORR )
+        integral(img, sum, sqsum, CV_64F);
+}
+
+// turns the cross-correlation into the result of the method using the image integrals and the template statistics
+static void normalizeMatchTemplate( const Mat& sum, const Mat& sqsum, Size templSize, const Scalar& _templMean,
+                                    const Scalar& templSdv, Mat& result, int method, int cn )
 {
     if( method == cv::TM_CCORR )
         return;
@@ -914,23 +974,14 @@ static void common_matchTemplate( Mat& img, Mat& templ, Mat& result, int method,
                     method == cv::TM_SQDIFF_NORMED ||
                     method == cv::TM_CCOEFF_NORMED;
 
-    double invArea = 1./((double)templ.rows * templ.cols);
+    double invArea = 1./((double)templSize.height * templSize.width);
 
-    Mat sum, sqsum;
-    Scalar templMean, templSdv;
+    Scalar templMean = _templMean;
     double *q0 = 0, *q1 = 0, *q2 = 0, *q3 = 0;
     double templNorm = 0, templSum2 = 0;
 
-    if( method == cv::TM_CCOEFF )
+    if( method != cv::TM_CCOEFF )
     {
-        integral(img, sum, CV_64F);
-        templMean = mean(templ);
-    }
-    else
-    {
-        integral(img, sum, sqsum, CV_64F);
-        meanStdDev( templ, templMean, templSdv );
-
         templNorm = templSdv[0]*templSdv[0] + templSdv[1]*templSdv[1] + templSdv[2]*templSdv[2] + templSdv[3]*templSdv[3];
 
         if( templNorm < DBL_EPSILON && method == cv::TM_CCOEFF_NORMED )
@@ -953,16 +1004,16 @@ static void common_matchTemplate( Mat& img, Mat& templ, Mat& result, int method,
 
         CV_Assert(sqsum.data != NULL);
         q0 = (double*)sqsum.data;
-        q1 = q0 + templ.cols*cn;
-        q2 = (double*)(sqsum.data + templ.rows*sqsum.step);
-        q3 = q2 + templ.cols*cn;
+        q1 = q0 + templSize.width*cn;
+        q2 = (double*)(sqsum.data + templSize.height*sqsum.step);
+        q3 = q2 + templSize.width*cn;
     }
 
     CV_Assert(sum.data != NULL);
     double* p0 = (double*)sum.data;
-    double* p1 = p0 + templ.cols*cn;
-    double* p2 = (double*)(sum.data + templ.rows*sum.step);
-    double* p3 = p2 + templ.cols*cn;
+    double* p1 = p0 + templSize.width*cn;
+    double* p2 = (double*)(sum.data + templSize.height*sum.step);
+    double* p3 = p2 + templSize.width*cn;
 
     int sumstep = sum.data ? (int)(sum.step / sizeof(double)) : 0;
     int sqstep = sqsum.data ? (int)(sqsum.step / sizeof(double)) : 0;
@@ -1027,6 +1078,18 @@ static void common_matchTemplate( Mat& img, Mat& templ, Mat& result, int method,
         }
     }
 }
+
+static void common_matchTemplate( Mat& img, Mat& templ, Mat& result, int method, int cn )
+{
+    if( method == cv::TM_CCORR )
+        return;
+
+    Mat sum, sqsum;
+    Scalar templMean, templSdv;
+    getMatchTemplateStats(templ, method, templMean, templSdv);
+    getMatchTemplateIntegral(img, method, sum, sqsum);
+    normalizeMatchTemplate(sum, sqsum, templ.size(), templMean, templSdv, result, method, cn);
+}
 }
 
 
@@ -1193,6 +1256,190 @@ void cv::matchTemplate( InputArray _img, InputArray _templ, OutputArray _result,
     common_matchTemplate(img, templ, result, method, cn);
 }
 
+namespace cv
+{
+
+class TemplateMatcherImpl CV_FINAL : public TemplateMatcher
+{
+public:
+    TemplateMatcherImpl(int _method, bool _shareImageDFT)
+        : method(-1), shareImageDFT(_shareImageDFT), imageType(-1)
+    {
+        setMethod(_method);
+    }
+
+    void setTemplates(InputArrayOfArrays _templs) CV_OVERRIDE;
+    int getTemplatesCount() const CV_OVERRIDE { return (int)templs.size(); }
+    void match(InputArray image, OutputArrayOfArrays results) CV_OVERRIDE;
+
+    void setMethod(int _method) CV_OVERRIDE
+    {
+        CV_Assert( cv::TM_SQDIFF <= _method && _method <= cv::TM_CCOEFF_NORMED );
+        if( method != _method )
+        {
+            method = _method;
+            updateStats();
+        }
+    }
+    int getMethod() const CV_OVERRIDE { return method; }
+
+    void setShareImageDFT(bool share) CV_OVERRIDE
+    {
+        if( shareImageDFT != share )
+        {
+            shareImageDFT = share;
+            collectGarbage();
+        }
+    }
+    bool getShareImageDFT() const CV_OVERRIDE { return shareImageDFT; }
+
+    void collectGarbage() CV_OVERRIDE
+    {
+        groups.clear();
+        imageSize = Size();
+        imageType = -1;
+    }
+
+private:
+    // templates of the same size matched with one image DFT
+    struct TemplateGroup
+    {
+        Size templSize;
+        std::vector<int> templIdx;
+        std::vector<Mat> dftTempls;
+        Size blocksize, dftsize;
+        int maxDepth;
+    };
+
+    void updateStats();
+    void updateSpectra(Size size, int type);
+
+    int method;
+    bool shareImageDFT;
+    std::vector<Mat> templs;
+    std::vector<Scalar> templMean, templSdv;
+
+    // the spectra are valid for this image size and type
+    std::vector<TemplateGroup> groups;
+    Size imageSize;
+    int imageType;
+};
+
+void TemplateMatcherImpl::setTemplates(InputArrayOfArrays _templs)
+{
+    CV_INSTRUMENT_REGION();
+
+    std::vector<Mat> t;
+    _templs.getMatVector(t);
+    CV_Assert( !t.empty() );
+
+    int type = t[0].type(), depth = CV_MAT_DEPTH(type);
+    CV_Assert( (depth == CV_8U || depth == CV_32F) && CV_MAT_CN(type) <= 4 );
+    templs.resize(t.size());
+    for( size_t i = 0; i < t.size(); i++ )
+    {
+        CV_Assert( t[i].type() == type && t[i].dims <= 2 && !t[i].empty() );
+        t[i].copyTo(templs[i]);
+    }
+    collectGarbage();
+    updateStats();
+}
+
+void TemplateMatcherImpl::updateStats()
+{
+    templMean.assign(templs.size(), Scalar());
+    templSdv.assign(templs.size(), Scalar());
+    for( size_t i = 0; i < templs.size(); i++ )
+        getMatchTemplateStats(templs[i], method, templMean[i], templSdv[i]);
+}
+
+void TemplateMatcherImpl::updateSpectra(Size size, int type)
+{
+    if( size == imageSize && type == imageType )
+        return;
+    collectGarbage();
+
+    for( size_t i = 0; i < templs.size(); i++ )
+    {
+        size_t g = 0;
+        if( shareImageDFT )
+            for( ; g < groups.size() && groups[g].templSize != templs[i].size(); g++ )
+                ;
+        else
+            g = groups.size();
+        if( g == groups.size() )
+        {
+            groups.push_back(TemplateGroup());
+            groups[g].templSize = templs[i].size();
+        }
+        groups[g].templIdx.push_back((int)i);
+    }
+
+    int depth = CV_MAT_DEPTH(type);
+    for( size_t g = 0; g < groups.size(); g++ )
+    {
+        TemplateGroup& group = groups[g];
+        Size corrSize(size.width - group.templSize.width + 1, size.height - group.templSize.height + 1);
+        getCrossCorrLayout(corrSize, group.templSize, depth, depth, CV_32F,
+                           group.blocksize, group.dftsize, group.maxDepth);
+        group.dftTempls.resize(group.templIdx.size());
+        for( size_t j = 0; j < group.templIdx.size(); j++ )
+            getCrossCorrTemplateDFT(templs[group.templIdx[j]], group.dftsize, group.maxDepth, group.dftTempls[j]);
+    }
+    imageSize = size;
+    imageType = type;
+}
+
+void TemplateMatcherImpl::match(InputArray _image, OutputArrayOfArrays _results)
+{
+    CV_INSTRUMENT_REGION();
+
+    CV_Assert( !templs.empty() );
+    CV_Assert( _results.kind() == _InputArray::STD_VECTOR_MAT );
+
+    Mat img = _image.getMat();
+    int cn = img.channels();
+    CV_Assert( img.type() == templs[0].type() && img.dims <= 2 );
+    for( size_t i = 0; i < templs.size(); i++ )
+        CV_Assert( img.rows >= templs[i].rows && img.cols >= templs[i].cols );
+
+    updateSpectra(img.size(), img.type());
+
+    Mat sum, sqsum;
+    getMatchTemplateIntegral(img, method, sum, sqsum);
+
+    _results.create((int)templs.size(), 1, CV_32F, -1, true);
+    for( size_t g = 0; g < groups.size(); g++ )
+    {
+        const TemplateGroup& group = groups[g];
+        Size corrSize(img.cols - group.templSize.width + 1, img.rows - group.templSize.height + 1);
+        std::vector<Mat> corrs(group.templIdx.size());
+        for( size_t j = 0; j < corrs.size(); j++ )
+        {
+            _results.create(corrSize, CV_32F, group.templIdx[j], true);
+            corrs[j] = _results.getMat(group.templIdx[j]);
+        }
+
+        crossCorrBlocks(img, group.templSize, group.dftTempls, corrs, Point(0, 0), 0, 0,
+                        group.blocksize, group.dftsize, group.maxDepth);
+
+        for( size_t j = 0; j < corrs.size(); j++ )
+        {
+            int idx = group.templIdx[j];
+            normalizeMatchTemplate(sum, sqsum, group.templSize, templMean[idx], templSdv[idx], corrs[j], method, cn);
+        }
+    }
+}
+
+}
+
+cv::Ptr<cv::TemplateMatcher> cv::createTemplateMatcher(InputArrayOfArrays templs, int method, bool shareImageDFT)
+{
+    Ptr<TemplateMatcher> matcher = makePtr<TemplateMatcherImpl>(method, shareImageDFT);
+    matcher->setTemplates(templs);
+    return matcher;
+}
+
 CV_IMPL void
 cvMatchTemplate( const CvArr* _img, const CvArr* _templ, CvArr* _result, int method )
 {
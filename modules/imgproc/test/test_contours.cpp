@@ -534,6 +534,59 @@ TEST(Imgproc_FindContours, regression_4363_shared_nbd)
     }
 }
 
+TEST(Imgproc_FindContours, parallel_stripes)
+{
+    // large images are processed in parallel stripes, the result must match the sequential scan
+    const int modes[] = { RETR_EXTERNAL, RETR_LIST, RETR_CCOMP, RETR_TREE };
+    const int methods[] = { CHAIN_APPROX_NONE, CHAIN_APPROX_SIMPLE };
+    const int nthreads = getNumThreads();
+    RNG& rng = theRNG();
+
+    for (int iter = 0; iter < 3; iter++)
+    {
+        Mat img(520 + iter * 7, 640 - iter * 5, CV_8UC1);
+        if (iter < 2)
+        {
+            randu(img, 0, 256);
+            cv::threshold(img, img, iter == 0 ? 128 : 200, 255, THRESH_BINARY);
+        }
+        else
+        {
+            // nested blobs with holes across the stripe bounds
+            img.setTo(Scalar::all(0));
+            for (int i = 0; i < 300; i++)
+            {
+                Point center(rng.uniform(0, img.cols), rng.uniform(0, img.rows));
+                int radius = rng.uniform(2, 120);
+                for (int r = radius, color = 255; r > 0; r -= rng.uniform(1, 12), color ^= 255)
+                    circle(img, center, r, Scalar::all(color), FILLED, i % 2 ? LINE_8 : LINE_4);
+            }
+        }
+
+        for (size_t m = 0; m < sizeof(modes)/sizeof(modes[0]); m++)
+        for (size_t a = 0; a < sizeof(methods)/sizeof(methods[0]); a++)
+        {
+            SCOPED_TRACE(cv::format("iter=%d mode=%d method=%d", iter, modes[m], methods[a]));
+            vector<vector<Point> > ref, dst;
+            vector<Vec4i> refHierarchy, dstHierarchy;
+
+            setNumThreads(1);
+            findContours(img, ref, refHierarchy, modes[m], methods[a], Point(3, -2));
+            setNumThreads(4);
+            findContours(img, dst, dstHierarchy, modes[m], methods[a], Point(3, -2));
+            setNumThreads(nthreads);
+
+            ASSERT_EQ(ref.size(), dst.size());
+            ASSERT_EQ(refHierarchy.size(), dstHierarchy.size());
+            for (size_t i = 0; i < ref.size(); i++)
+            {
+                ASSERT_EQ(ref[i], dst[i]) << "contour " << i;
+                ASSERT_EQ(refHierarchy[i], dstHierarchy[i]) << "contour " << i;
+            }
+        }
+    }
+}
+
 TEST(Imgproc_PointPolygonTest, regression_10222)
 {
     vector<Point> contour;
@@ -1865,6 +1865,73 @@ TEST(Imgproc_EigenValsVecs, accuracy) { CV_EigenValVecTest test; test.safe_run()
 TEST(Imgproc_PreCornerDetect, accuracy) { CV_PreCornerDetectTest test; test.safe_run(); }
 TEST(Imgproc_Integral, accuracy) { CV_IntegralTest test; test.safe_run(); }
 
+TEST(Imgproc_Integral, incremental_update)
+{
+    const int types[] = { CV_8UC1, CV_8UC3, CV_32FC1, CV_64FC2 };
+    RNG& rng = theRNG();
+
+    for (size_t t = 0; t < sizeof(types)/sizeof(types[0]); t++)
+    {
+        const int type = types[t];
+        const bool exact = CV_MAT_DEPTH(type) == CV_8U;
+        SCOPED_TRACE(cv::format("type=%d", type));
+
+        Mat img(97, 131, type);
+        rng.fill(img, RNG::UNIFORM, 0, 256);
+        Ptr<IntegralImage> ii = createIntegralImage();
+        ii->compute(img);
+
+        for (int iter = 0; iter < 20; iter++)
+        {
+            Rect roi(rng.uniform(0, img.cols), rng.uniform(0, img.rows), rng.uniform(1, 40), rng.uniform(1, 40));
+            roi &= Rect(0, 0, img.cols, img.rows);
+            rng.fill(img(roi), RNG::UNIFORM, 0, 256);
+            ii->update(img, roi);
+
+            Mat sum, sqsum, refSum, refSqSum;
+            ii->getSum(sum);
+            ii->getSqSum(sqsum);
+            integral(img, refSum, refSqSum);
+            ASSERT_EQ(refSum.type(), sum.type());
+            ASSERT_EQ(refSqSum.type(), sqsum.type());
+            if (exact)
+            {
+                EXPECT_EQ(0, cvtest::norm(refSum, sum, NORM_INF)) << "iter " << iter;
+                EXPECT_EQ(0, cvtest::norm(refSqSum, sqsum, NORM_INF)) << "iter " << iter;
+            }
+            else
+            {
+                EXPECT_LE(cvtest::norm(refSum, sum, NORM_INF | NORM_RELATIVE), 1e-9) << "iter " << iter;
+                EXPECT_LE(cvtest::norm(refSqSum, sqsum, NORM_INF | NORM_RELATIVE), 1e-9) << "iter " << iter;
+            }
+        }
+
+        std::vector<Rect> boxes;
+        for (int i = 0; i < 100; i++)
+        {
+            Point pt(rng.uniform(0, img.cols), rng.uniform(0, img.rows));
+            boxes.push_back(Rect(pt, Size(rng.uniform(0, img.cols - pt.x + 1), rng.uniform(0, img.rows - pt.y + 1))));
+        }
+        Mat sums, means, variances;
+        ii->boxSums(boxes, sums);
+        ii->boxStats(boxes, means, variances);
+        ASSERT_EQ((int)boxes.size(), sums.rows);
+        ASSERT_EQ(CV_MAKETYPE(CV_64F, img.channels()), means.type());
+        for (size_t i = 0; i < boxes.size(); i++)
+        {
+            Scalar refSum = cv::sum(img(boxes[i])), refMean, refSdv;
+            if (!boxes[i].empty())
+                meanStdDev(img(boxes[i]), refMean, refSdv);
+            for (int c = 0; c < img.channels(); c++)
+            {
+                EXPECT_NEAR(refSum[c], sums.at<double>((int)i, c), 1e-6 * (1 + fabs(refSum[c]))) << "box " << i;
+                EXPECT_NEAR(refMean[c], means.at<double>((int)i, c), 1e-6) << "box " << i;
+                EXPECT_NEAR(refSdv[c] * refSdv[c], variances.at<double>((int)i, c), 1e-4) << "box " << i;
+            }
+        }
+    }
+}
+
 //////////////////////////////////////////////////////////////////////////////////
 
 class CV_FilterSupportedFormatsTest : public cvtest::BaseTest
@@ -2380,4 +2447,73 @@ TEST(Imgproc, morphologyEx_small_input_22893)
     ASSERT_EQ(0, cvtest::norm(result, gold, NORM_INF));
 }
 
+// sets OPENCV_IMGPROC_FILTER_TILING_MIN_PIXELS for the scope, tiling is disabled by default
+struct ScopedFilterTilingMinPixels
+{
+    explicit ScopedFilterTilingMinPixels(size_t minPixels)
+    {
+        const char* old = getenv("OPENCV_IMGPROC_FILTER_TILING_MIN_PIXELS");
+        oldValue = old ? old : "0";
+        set(std::to_string(minPixels));
+    }
+    ~ScopedFilterTilingMinPixels() { set(oldValue); }
+
+    static void set(const std::string& value)
+    {
+#ifdef _WIN32
+        _putenv_s("OPENCV_IMGPROC_FILTER_TILING_MIN_PIXELS", value.c_str());
+#else
+        setenv("OPENCV_IMGPROC_FILTER_TILING_MIN_PIXELS", value.c_str(), 1);
+#endif
+    }
+
+    std::string oldValue;
+};
+
+typedef testing::TestWithParam<int> Imgproc_Filter_Tiled;
+
+// large images are filtered by 2D tiles, the result must match processing of small row strips
+TEST_P(Imgproc_Filter_Tiled, large_image_bitexact)
+{
+    const int borderType = GetParam();
+    ScopedFilterTilingMinPixels tiling(1 << 20);  // the whole image only, not the reference strips
+    Mat src(1037, 2111, CV_8UC3);
+    randu(src, 0, 256);
+
+    Mat kernel2D(5, 5, CV_32F);
+    randu(kernel2D, -1, 1);
+    Mat kernelX = getGaussianKernel(7, 1.5, CV_32F), kernelY = getGaussianKernel(5, 1.1, CV_32F);
+    Mat element = getStructuringElement(MORPH_ELLIPSE, Size(5, 5));
+
+    for (int op = 0; op < 4; op++)
+    {
+        SCOPED_TRACE(op);
+        auto apply = [&](const Mat& s, Mat& d)
+        {
+            switch (op)
+            {
+            case 0: cv::filter2D(s, d, CV_16S, kernel2D, Point(-1, -1), 3, borderType); break;
+            case 1: cv::sepFilter2D(s, d, CV_32F, kernelX, kernelY, Point(-1, -1), 0, borderType); break;
+            case 2: cv::erode(s, d, element, Point(-1, -1), 1, borderType); break;
+            default: cv::dilate(s, d, element, Point(1, 3), 1, borderType); break;
+            }
+        };
+
+        Mat dst;
+        apply(src, dst);
+
+        Mat ref(dst.size(), dst.type());
+        for (int y = 0; y < src.rows; y += 97)
+        {
+            const Range rows(y, std::min(y + 97, src.rows));
+            Mat refStrip = ref.rowRange(rows);
+            apply(src.rowRange(rows), refStrip);
+            ASSERT_EQ(ref.rowRange(rows).data, refStrip.data);
+        }
+        EXPECT_EQ(0, cvtest::norm(ref, dst, NORM_INF));
+    }
+}
+
+INSTANTIATE_TEST_CASE_P(/**/, Imgproc_Filter_Tiled, testing::Values(BORDER_REFLECT_101, BORDER_REPLICATE, BORDER_CONSTANT));
+
 }} // namespace
@@ -541,5 +541,64 @@ TEST(Imgproc_FloodFill, maskValue)
     ASSERT_EQ(1, cvtest::norm(mask.rowRange(1, n-1).colRange(1, n-1), NORM_INF));
 }
 
+TEST(Imgproc_FloodFill, multiSeed)
+{
+    // the result must match the floodFill calls for every seed with the same mask
+    const int types[] = { CV_8UC1, CV_8UC3, CV_32SC1, CV_32FC3 };
+    const int nthreads = getNumThreads();
+    RNG& rng = theRNG();
+
+    for (size_t t = 0; t < sizeof(types)/sizeof(types[0]); t++)
+    for (int connectivity = 4; connectivity <= 8; connectivity += 4)
+    for (int mode = 0; mode < 4; mode++)
+    {
+        // 0: simple, 1: floating range, 2: different lo and up diffs, 3: fixed range
+        const Scalar loDiff = Scalar::all(mode == 0 ? 0 : 1), upDiff = Scalar::all(mode == 0 ? 0 : mode == 2 ? 2 : 1);
+        const int flags = connectivity | (mode == 3 ? FLOODFILL_FIXED_RANGE : 0) |
+                          (t % 2 ? FLOODFILL_MASK_ONLY | (255 << 8) : 0);
+        SCOPED_TRACE(cv::format("type=%d connectivity=%d mode=%d", types[t], connectivity, mode));
+
+        Mat img0(300, 257, types[t]), mask0 = Mat::zeros(img0.rows + 2, img0.cols + 2, CV_8UC1);
+        randu(img0, 0, mode == 0 ? 3 : 12);
+        for (int i = 0; i < 20; i++)
+            line(mask0, Point(rng.uniform(0, mask0.cols), rng.uniform(0, mask0.rows)),
+                 Point(rng.uniform(0, mask0.cols), rng.uniform(0, mask0.rows)), Scalar::all(1));
+
+        std::vector<Point> seeds;
+        for (int i = 0; i < 300; i++)
+            seeds.push_back(Point(rng.uniform(0, img0.cols), rng.uniform(0, img0.rows)));
+        seeds.push_back(seeds[0]);
+
+        Mat img = img0.clone(), mask = mask0.clone();
+        std::vector<int> areas;
+        std::vector<Rect> rects;
+        int total = 0;
+        for (size_t i = 0; i < seeds.size(); i++)
+        {
+            Rect rect;
+            areas.push_back(floodFill(img, mask, seeds[i], Scalar::all(100), &rect, loDiff, upDiff, flags));
+            rects.push_back(rect);
+            total += areas.back();
+        }
+
+        for (int threads = 1; threads <= 4; threads += 3)
+        {
+            Mat img1 = img0.clone(), mask1 = mask0.clone();
+            std::vector<int> areas1;
+            std::vector<Rect> rects1;
+
+            setNumThreads(threads);
+            int total1 = floodFillMulti(img1, mask1, seeds, Scalar::all(100), areas1, rects1, loDiff, upDiff, flags);
+            setNumThreads(nthreads);
+
+            EXPECT_EQ(total, total1);
+            EXPECT_EQ(0, cvtest::norm(img, img1, NORM_INF));
+            EXPECT_EQ(0, cvtest::norm(mask, mask1, NORM_INF));
+            EXPECT_EQ(areas, areas1);
+            EXPECT_EQ(rects, rects1);
+        }
+    }
+}
+
 }} // namespace
 /* End of file. */
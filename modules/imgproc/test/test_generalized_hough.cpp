@@ -0,0 +1,104 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "test_precomp.hpp"
+
+namespace opencv_test { namespace {
+
+static void drawStar(Mat& img, Point2d center, double scale, double angle)
+{
+    std::vector<Point> pts;
+    for (int i = 0; i < 10; i++)
+    {
+        const double r = (i % 2 ? 20 : 45) * scale, a = (i * 36 + angle) * CV_PI / 180;
+        pts.push_back(Point(cvRound(center.x + r * cos(a)), cvRound(center.y + r * sin(a))));
+    }
+    fillPoly(img, std::vector<std::vector<Point> >(1, pts), Scalar::all(255));
+}
+
+static void detectWithThreads(const Ptr<GeneralizedHough>& alg, const Mat& img, int nthreads,
+                              std::vector<Vec4f>& positions, std::vector<Vec3i>& votes)
+{
+    const int prevThreads = getNumThreads();
+    setNumThreads(nthreads);
+    alg->detect(img, positions, votes);
+    setNumThreads(prevThreads);
+}
+
+static bool hasPosition(const std::vector<Vec4f>& positions, Point2f center, float scale, float scaleEps)
+{
+    for (size_t i = 0; i < positions.size(); i++)
+    {
+        if (fabs(positions[i][0] - center.x) <= 2 && fabs(positions[i][1] - center.y) <= 2 &&
+            fabs(positions[i][2] - scale) <= scaleEps)
+            return true;
+    }
+    return false;
+}
+
+class Imgproc_GeneralizedHough : public testing::Test
+{
+protected:
+    void SetUp() CV_OVERRIDE
+    {
+        templ = Mat::zeros(110, 110, CV_8UC1);
+        drawStar(templ, Point2d(55, 55), 1.0, 0);
+
+        img = Mat::zeros(240, 320, CV_8UC1);
+        drawStar(img, Point2d(100, 120), 1.0, 0);
+        drawStar(img, Point2d(220, 110), 1.2, 30);
+    }
+
+    Mat templ, img;
+};
+
+TEST_F(Imgproc_GeneralizedHough, Ballard)
+{
+    Ptr<GeneralizedHoughBallard> alg = createGeneralizedHoughBallard();
+    alg->setVotesThreshold(30);
+    alg->setTemplate(templ);
+
+    for (int dp = 1; dp <= 2; dp++)
+    {
+        alg->setDp(dp);
+
+        // the votes are accumulated in parallel, the result must not depend on the number of threads
+        std::vector<Vec4f> positions, positions4;
+        std::vector<Vec3i> votes, votes4;
+        detectWithThreads(alg, img, 1, positions, votes);
+        detectWithThreads(alg, img, 4, positions4, votes4);
+
+        EXPECT_TRUE(hasPosition(positions, Point2f(100, 120), 1.0f, 0.0f)) << "dp=" << dp;
+        EXPECT_EQ(0, cvtest::norm(positions, positions4, NORM_INF)) << "dp=" << dp;
+        EXPECT_EQ(0, cvtest::norm(votes, votes4, NORM_INF)) << "dp=" << dp;
+    }
+}
+
+TEST_F(Imgproc_GeneralizedHough, Guil)
+{
+    Ptr<GeneralizedHoughGuil> alg = createGeneralizedHoughGuil();
+    alg->setMinDist(20);
+    alg->setDp(2);
+    alg->setAngleThresh(300);
+    alg->setMinScale(0.8);
+    alg->setMaxScale(1.4);
+    alg->setScaleStep(0.05);
+    alg->setScaleThresh(100);
+    alg->setPosThresh(20);
+    alg->setTemplate(templ);
+
+    std::vector<Vec4f> positions, positions4;
+    std::vector<Vec3i> votes, votes4;
+    detectWithThreads(alg, img, 1, positions, votes);
+    detectWithThreads(alg, img, 4, positions4, votes4);
+
+    EXPECT_TRUE(hasPosition(positions, Point2f(100, 120), 1.0f, 0.0f));
+    EXPECT_TRUE(hasPosition(positions, Point2f(220, 110), 1.2f, 0.1f));
+
+    ASSERT_EQ(positions.size(), positions4.size());
+    EXPECT_EQ(0, cvtest::norm(positions, positions4, NORM_INF));
+    EXPECT_EQ(0, cvtest::norm(votes, votes4, NORM_INF));
+}
+
+}} // namespace
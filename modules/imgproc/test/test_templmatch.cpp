@@ -425,4 +425,55 @@ TEST(Imgproc_MatchTemplate, bug_9597) {
         cv::minMaxLoc(result, &minValue, NULL, NULL, NULL);
         ASSERT_GE(minValue, 0);
 }
+
+TEST(Imgproc_MatchTemplate, template_matcher)
+{
+    const int types[] = { CV_8UC1, CV_8UC3, CV_32FC1 };
+    const Size templSizes[] = { Size(15, 11), Size(24, 24), Size(15, 11), Size(40, 7), Size(24, 24), Size(15, 11) };
+    // one frame size per type, then a small frame to check that the spectra are rebuilt for a new size
+    const Size imageSizes[] = { Size(200, 160), Size(160, 120), Size(128, 96) };
+    const Size smallSize(96, 64);
+    RNG& rng = theRNG();
+
+    for (size_t t = 0; t < sizeof(types)/sizeof(types[0]); t++)
+    {
+        std::vector<Mat> templs;
+        for (size_t i = 0; i < sizeof(templSizes)/sizeof(templSizes[0]); i++)
+        {
+            Mat templ(templSizes[i], types[t]);
+            rng.fill(templ, RNG::UNIFORM, 0, 256);
+            templs.push_back(templ);
+        }
+        // flat template
+        templs.back().setTo(Scalar::all(100));
+
+        for (int method = TM_SQDIFF; method <= TM_CCOEFF_NORMED; method++)
+        for (int share = 0; share < 2; share++)
+        {
+            Ptr<TemplateMatcher> matcher = createTemplateMatcher(templs, method, share != 0);
+            ASSERT_EQ((int)templs.size(), matcher->getTemplatesCount());
+
+            for (int f = 0; f < 2; f++)
+            {
+                SCOPED_TRACE(cv::format("type=%d method=%d share=%d frame=%d", types[t], method, share, f));
+                Mat img(f == 0 ? imageSizes[t] : smallSize, types[t]);
+                rng.fill(img, RNG::UNIFORM, 0, 256);
+                templs[1].copyTo(img(Rect(30, 20, templs[1].cols, templs[1].rows)));
+
+                std::vector<Mat> results;
+                matcher->match(img, results);
+                ASSERT_EQ(templs.size(), results.size());
+                for (size_t i = 0; i < templs.size(); i++)
+                {
+                    Mat ref;
+                    matchTemplate(img, templs[i], ref, method);
+                    ASSERT_EQ(ref.size(), results[i].size()) << "template " << i;
+                    ASSERT_EQ(CV_32FC1, results[i].type()) << "template " << i;
+                    EXPECT_EQ(0, cvtest::norm(ref, results[i], NORM_INF)) << "template " << i;
+                }
+            }
+        }
+    }
+}
+
 } // namespace